@@ -0,0 +1,200 @@
+/*
+ * Host Benchmark - Shared definitions
+ *
+ * Timing and JSON output helpers shared by the benchmark sections.
+ * Every section prints one JSON object member so a run produces a single
+ * document that can be diffed against a previous run.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BENCH_MAX_CORPUS 64
+
+/**
+ * @brief Benchmark run configuration
+ */
+typedef struct {
+    const char *corpus[BENCH_MAX_CORPUS];   // Expressions to measure
+    int corpus_count;
+    int iterations;                         // Repetitions per measurement
+} bench_config_t;
+
+/**
+ * @brief Sink for computed values so the compiler cannot drop the work
+ */
+extern volatile double bench_sink;
+
+/**
+ * @brief Monotonic time in nanoseconds
+ * @return Current time
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * @brief Start a top-level JSON member ("name": {)
+ * @param name Section name
+ */
+void bench_section_begin(const char *name);
+
+/**
+ * @brief Close the current top-level JSON member
+ */
+void bench_section_end(void);
+
+/**
+ * @brief Print a JSON string literal with escaping
+ * @param str String to print
+ */
+void bench_json_string(const char *str);
+
+/**
+ * @brief Evaluator section: per-phase timing over the corpus
+ * @param config Run configuration
+ */
+void bench_evaluator(const bench_config_t *config);
+
+/**
+ * @brief Batch section: evaluate_rpn_batch() against per-value loops
+ * @param config Run configuration
+ */
+void bench_batch(const bench_config_t *config);
+
+/**
+ * @brief Lexer section: longest-match lexer against the old table scan
+ * @param config Run configuration
+ */
+void bench_lexer(const bench_config_t *config);
+
+/**
+ * @brief VM section: bytecode VM against the token interpreter
+ * @param config Run configuration
+ */
+void bench_vm(const bench_config_t *config);
+
+/**
+ * @brief Precision section: apply_function() accuracy in eval_num_t
+ * @param config Run configuration
+ */
+void bench_precision(const bench_config_t *config);
+
+/**
+ * @brief Fast math section: fast_math.c kernels against libm
+ * @param config Run configuration
+ */
+void bench_fast_math(const bench_config_t *config);
+
+/**
+ * @brief Degree trig section: DEG-mode trig against convert-then-call
+ * @param config Run configuration
+ */
+void bench_degree_trig(const bench_config_t *config);
+
+/**
+ * @brief Factorial section: table and gamma against the old loop
+ * @param config Run configuration
+ */
+void bench_factorial(const bench_config_t *config);
+
+/**
+ * @brief Integration section: cost and accuracy of integrate_expression()
+ * @param config Run configuration
+ */
+void bench_integration(const bench_config_t *config);
+
+/**
+ * @brief Differentiation section: accuracy and cost of differentiate_rpn()
+ * @param config Run configuration
+ */
+void bench_differentiation(const bench_config_t *config);
+
+/**
+ * @brief Autodiff section: evaluate_rpn_dual() accuracy and cost
+ * @param config Run configuration
+ */
+void bench_autodiff(const bench_config_t *config);
+
+/**
+ * @brief Solver section: evaluations to converge on hard equations
+ * @param config Run configuration
+ */
+void bench_solver(const bench_config_t *config);
+
+/**
+ * @brief Table section: lazy TABLE rows against eager evaluation
+ * @param config Run configuration
+ */
+void bench_table(const bench_config_t *config);
+
+/**
+ * @brief Statistics section: accuracy and cost of the STAT accumulators
+ * @param config Run configuration
+ */
+void bench_statistics(const bench_config_t *config);
+
+/**
+ * @brief Regression section: model accuracy and model switch cost
+ * @param config Run configuration
+ */
+void bench_regression(const bench_config_t *config);
+
+/**
+ * @brief Quantiles section: introselect and P² against a full sort
+ * @param config Run configuration
+ */
+void bench_quantiles(const bench_config_t *config);
+
+/**
+ * @brief Distributions section: erf/erfc, normal, binomial and Poisson
+ *        accuracy, and list throughput
+ * @param config Run configuration
+ */
+void bench_distributions(const bench_config_t *config);
+
+/**
+ * @brief Matrix section: operations per second for each size, with
+ *        determinant and inverse accuracy
+ * @param config Run configuration
+ */
+void bench_matrix(const bench_config_t *config);
+
+/**
+ * @brief Eigen section: iterations, worst-case time and its bound, and
+ *        residuals of the eigen and SVD solvers for each size
+ * @param config Run configuration
+ */
+void bench_eigen(const bench_config_t *config);
+
+/**
+ * @brief Vector section: fused against separate kernels, angle accuracy
+ *        and vector expression evaluation time
+ * @param config Run configuration
+ */
+void bench_vector(const bench_config_t *config);
+
+/**
+ * @brief Complex section: real and complex evaluation of the corpus,
+ *        complex expression timing and principal-branch accuracy
+ * @param config Run configuration
+ */
+void bench_complex(const bench_config_t *config);
+
+/**
+ * @brief Base-N section: integer formatters against snprintf, values
+ *        exact through a double, and base-N expression timing
+ * @param config Run configuration
+ */
+void bench_base_n(const bench_config_t *config);
+
+/**
+ * @brief Polynomial section: iterations and worst-case time per degree,
+ *        multiple roots, and closed-form accuracy against the textbook
+ *        quadratic
+ * @param config Run configuration
+ */
+void bench_polynomial(const bench_config_t *config);
+
+#endif /* BENCH_H */
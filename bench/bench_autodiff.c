@@ -0,0 +1,143 @@
+/*
+ * Host Benchmark - Forward-mode automatic differentiation
+ *
+ * For each expression evaluate_rpn_dual() is run over sample points in
+ * a range and its derivative compared with the analytic derivative in
+ * long double (error relative to max(|f'|, 1)). Timing puts one dual
+ * evaluation next to one plain evaluate_rpn() and one Richardson
+ * derivative from differentiate_rpn(); the dual pass should cost less
+ * than two plain evaluations.
+ */
+
+#include "bench.h"
+#include "differentiation.h"
+#include <math.h>
+#include <stdio.h>
+
+#define SAMPLES 256
+
+typedef struct {
+    const char *expression;
+    double lo, hi;
+    long double (*derivative)(long double x);
+} autodiff_case_t;
+
+static long double d_sin_exp(long double x) { return expl(x) * (sinl(x) + cosl(x)); }
+static long double d_cubic(long double x) { return 3 * x * x - 2; }
+static long double d_ln_sqrt(long double x) { return (2 - logl(x)) / (2 * x * sqrtl(x)); }
+static long double d_atan_tanh(long double x)
+{
+    return 2 * atanl(x) / (1 + x * x) + 1 - tanhl(x) * tanhl(x);
+}
+static long double d_lorentz(long double x) { return -2 * x / ((1 + x * x) * (1 + x * x)); }
+static long double d_sinh_cosh(long double x) { return coshl(2 * x); }
+static long double d_x_pow_x(long double x) { return powl(x, x) * (logl(x) + 1); }
+static long double d_sqrt_asin(long double x) { return 1 - x * asinl(x) / sqrtl(1 - x * x); }
+static long double d_log_cos(long double x)
+{
+    return cosl(x) / (x * logl(10.0L)) - log10l(x) * sinl(x);
+}
+static long double d_acos_abs(long double x)
+{
+    return -1 / (2 * sqrtl(1 - x * x / 4)) + (x > 0 ? 1 : -1);
+}
+// x! psi(x + 1), with psi from a central difference of lgammal
+static long double d_factorial(long double x)
+{
+    const long double h = 1e-6L;
+    return tgammal(x + 1) * (lgammal(x + 1 + h) - lgammal(x + 1 - h)) / (2 * h);
+}
+
+static const autodiff_case_t autodiff_suite[] = {
+    { "sin(X)*exp(X)",          -3.0, 3.0,  d_sin_exp },
+    { "X^3-2*X+1",              -5.0, 5.0,  d_cubic },
+    { "ln(X)/sqrt(X)",          0.1, 10.0,  d_ln_sqrt },
+    { "atan(X)^2+tanh(X)",      -4.0, 4.0,  d_atan_tanh },
+    { "1/(1+X^2)",              -3.0, 3.0,  d_lorentz },
+    { "sinh(X)*cosh(X)",        -3.0, 3.0,  d_sinh_cosh },
+    { "X^X",                    0.2, 4.0,   d_x_pow_x },
+    { "sqrt(1-X^2)*asin(X)",    -0.9, 0.9,  d_sqrt_asin },
+    { "log(X)*cos(X)",          0.5, 10.0,  d_log_cos },
+    { "acos(X/2)+abs(X)",       -1.9, 1.9,  d_acos_abs },
+    { "X!",                     0.1, 10.0,  d_factorial },
+};
+
+#define SUITE_SIZE (int)(sizeof(autodiff_suite) / sizeof(autodiff_suite[0]))
+
+void bench_autodiff(const bench_config_t *config)
+{
+    const int reps = config->iterations / 1000 > 0 ? config->iterations / 1000 : 1;
+    eval_context_t context = { .deg_mode = false };
+    rpn_queue_t rpn;
+    double xs[SAMPLES];
+
+    bench_section_begin("autodiff");
+
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        const autodiff_case_t *c = &autodiff_suite[i];
+        double max_error = 0.0, worst_x = 0.0;
+        double value, derivative;
+        int failures = 0;
+
+        if (parse_expression_to_rpn(c->expression, &rpn) != 0) {
+            continue;
+        }
+        optimize_rpn(&rpn, context.deg_mode);
+
+        // Midpoints of SAMPLES equal cells, so no sample lands on x = 0
+        for (int k = 0; k < SAMPLES; k++) {
+            xs[k] = c->lo + (c->hi - c->lo) * (k + 0.5) / SAMPLES;
+            context.variables.x = xs[k];
+            if (evaluate_rpn_dual(&rpn, &context, &value, &derivative) != 0) {
+                failures++;
+                continue;
+            }
+            long double reference = c->derivative(xs[k]);
+            double error = (double)(fabsl(derivative - reference) / fmaxl(fabsl(reference), 1.0L));
+            if (error > max_error) {
+                max_error = error;
+                worst_x = xs[k];
+            }
+        }
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int k = 0; k < SAMPLES; k++) {
+                context.variables.x = xs[k];
+                evaluate_rpn(&rpn, &context, &value);
+                bench_sink = value;
+            }
+        }
+        double eval_ns = (double)(bench_now_ns() - start) / ((double)reps * SAMPLES);
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int k = 0; k < SAMPLES; k++) {
+                context.variables.x = xs[k];
+                evaluate_rpn_dual(&rpn, &context, &value, &derivative);
+                bench_sink = derivative;
+            }
+        }
+        double dual_ns = (double)(bench_now_ns() - start) / ((double)reps * SAMPLES);
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int k = 0; k < SAMPLES; k++) {
+                diff_result_t numeric;
+                differentiate_rpn(&rpn, &context, xs[k], &numeric);
+                bench_sink = numeric.value;
+            }
+        }
+        double richardson_ns = (double)(bench_now_ns() - start) / ((double)reps * SAMPLES);
+
+        printf("%s\n    ", i == 0 ? "" : ",");
+        bench_json_string(c->expression);
+        printf(": {\"range\": [%g, %g], \"failures\": %d, \"max_error\": %.3e, \"worst_x\": %.17g,"
+               "\n      \"eval_ns\": %.1f, \"dual_ns\": %.1f, \"dual_over_eval\": %.2f,"
+               " \"richardson_ns\": %.1f}",
+               c->lo, c->hi, failures, max_error, worst_x,
+               eval_ns, dual_ns, dual_ns / eval_ns, richardson_ns);
+    }
+
+    bench_section_end();
+}
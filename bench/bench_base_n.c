@@ -0,0 +1,182 @@
+/*
+ * Host Benchmark - Base-N
+ *
+ * Times the integer formatters against snprintf of the same 64-bit
+ * value (there is no binary conversion, so BIN has no reference) and
+ * against "%.10g" of the value as a double, which is what showing it
+ * through the real evaluator would cost, and counts how many of the
+ * values survive the trip through a double. The values are random with
+ * random lengths, so short and long numbers are mixed. The expressions
+ * are timed from the string to the formatted result and from a parsed
+ * program.
+ */
+
+#include "bench.h"
+#include "base_n.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VALUE_SET 256
+
+static int64_t values[VALUE_SET];
+
+static uint64_t rng_state;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+// 64-bit values cut to a random length, half of them negative
+static void fill_values(void)
+{
+    for (int i = 0; i < VALUE_SET; i++) {
+        uint64_t value = rng_next() >> (rng_next() % 64);
+        values[i] = i % 2 ? -(int64_t)(value >> 1) : (int64_t)(value >> 1);
+    }
+}
+
+static const struct {
+    base_n_radix_t radix;
+    const char *format;     // snprintf reference, NULL if there is none
+} radixes[] = {
+    { BASE_N_DEC, "%" PRId64 },
+    { BASE_N_HEX, "%" PRIX64 },
+    { BASE_N_OCT, "%" PRIo64 },
+    { BASE_N_BIN, NULL },
+};
+
+static void print_formatters(int reps)
+{
+    const int count = (int)(sizeof(radixes) / sizeof(radixes[0]));
+    char buffer[BASE_N_FORMAT_SIZE], reference[BASE_N_FORMAT_SIZE];
+    uint64_t start;
+    double sum = 0.0;
+
+    printf("\n    \"formatters\": [");
+    for (int r = 0; r < count; r++) {
+        bool matches = true;
+        for (int i = 0; i < VALUE_SET && radixes[r].format != NULL; i++) {
+            // DEC is signed; the other radixes print the 64-bit pattern
+            base_n_format(values[i], radixes[r].radix, 64, buffer, sizeof(buffer));
+            if (radixes[r].radix == BASE_N_DEC) {
+                snprintf(reference, sizeof(reference), radixes[r].format, values[i]);
+            } else {
+                snprintf(reference, sizeof(reference), radixes[r].format, (uint64_t)values[i]);
+            }
+            matches = matches && strcmp(buffer, reference) == 0;
+        }
+
+        start = bench_now_ns();
+        for (int k = 0; k < reps; k++) {
+            for (int i = 0; i < VALUE_SET; i++) {
+                sum += base_n_format(values[i], radixes[r].radix, 64, buffer, sizeof(buffer));
+            }
+        }
+        double ns = (double)(bench_now_ns() - start) / ((double)reps * VALUE_SET);
+
+        printf("%s\n      {\"radix\": \"%s\", \"ns_per_format\": %.2f",
+               r ? "," : "", base_n_radix_name(radixes[r].radix), ns);
+        if (radixes[r].format != NULL) {
+            start = bench_now_ns();
+            for (int k = 0; k < reps; k++) {
+                for (int i = 0; i < VALUE_SET; i++) {
+                    sum += radixes[r].radix == BASE_N_DEC ?
+                           snprintf(reference, sizeof(reference), radixes[r].format, values[i]) :
+                           snprintf(reference, sizeof(reference), radixes[r].format, (uint64_t)values[i]);
+                }
+            }
+            ns = (double)(bench_now_ns() - start) / ((double)reps * VALUE_SET);
+            printf(", \"snprintf_ns\": %.2f, \"matches\": %s", ns, matches ? "true" : "false");
+        }
+        printf("}");
+    }
+    printf("\n    ]");
+
+    int exact = 0;
+    start = bench_now_ns();
+    for (int k = 0; k < reps; k++) {
+        for (int i = 0; i < VALUE_SET; i++) {
+            sum += snprintf(reference, sizeof(reference), "%.10g", (double)values[i]);
+        }
+    }
+    double double_ns = (double)(bench_now_ns() - start) / ((double)reps * VALUE_SET);
+    for (int i = 0; i < VALUE_SET; i++) {
+        // Exact through a double only up to 2^53 in magnitude
+        double d = (double)values[i];
+        exact += d >= -0x1p63 && d < 0x1p63 && (int64_t)d == values[i];
+    }
+    bench_sink = sum;
+    printf(",\n    \"double_format_ns\": %.2f, \"double_exact\": %d, \"values\": %d",
+           double_ns, exact, VALUE_SET);
+}
+
+static const char *const expressions[] = {
+    "hFFFFFFFFFFFFFFFF and not(hFF)",
+    "d9007199254740993*3",
+    "(b1011 << 60) xor hDEADBEEF",
+    "-9223372036854775807-1 >> 3",
+    "(Ans + 123456789) / 7 or o777",
+};
+
+static void print_expressions(int iterations)
+{
+    const int count = (int)(sizeof(expressions) / sizeof(expressions[0]));
+    const base_n_context_t context = { .radix = BASE_N_DEC, .bits = 64, .ans = 1 };
+    static base_n_program_t parsed;
+    char buffer[BASE_N_FORMAT_SIZE];
+
+    printf(",\n    \"expressions\": [");
+    for (int e = 0; e < count; e++) {
+        int64_t value = 0;
+        uint64_t sum = 0;
+        int err = base_n_parse(expressions[e], &context, &parsed);
+        if (err == 0) {
+            err = base_n_evaluate(&parsed, &context, &value);
+        }
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(expressions[e]);
+        if (err != 0) {
+            printf(", \"error\": %d}", err);
+            continue;
+        }
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < iterations; i++) {
+            base_n_evaluate_expression(expressions[e], &context, &value);
+            sum += base_n_format(value, BASE_N_HEX, 64, buffer, sizeof(buffer));
+        }
+        double ns = (double)(bench_now_ns() - start) / iterations;
+
+        start = bench_now_ns();
+        for (int i = 0; i < iterations; i++) {
+            base_n_evaluate(&parsed, &context, &value);
+            sum += (uint64_t)value;
+        }
+        double program_ns = (double)(bench_now_ns() - start) / iterations;
+        bench_sink = (double)sum;
+
+        base_n_format(value, BASE_N_DEC, 64, buffer, sizeof(buffer));
+        printf(", \"result\": \"%s\", \"ns_per_eval\": %.1f, \"program_ns_per_eval\": %.1f}",
+               buffer, ns, program_ns);
+    }
+    printf("\n    ]");
+}
+
+void bench_base_n(const bench_config_t *config)
+{
+    const int reps = config->iterations / 100 > 0 ? config->iterations / 100 : 1;
+
+    bench_section_begin("base_n");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    fill_values();
+
+    print_formatters(reps);
+    print_expressions(config->iterations);
+
+    bench_section_end();
+}
@@ -0,0 +1,100 @@
+/*
+ * Host Benchmark - Batch evaluation
+ *
+ * Compares evaluate_rpn_batch() against the per-value paths a TABLE or
+ * plotting loop would otherwise use: evaluate_expression() (cached) and
+ * evaluate_rpn() on a pre-compiled queue.
+ */
+
+#include "bench.h"
+#include "expression_evaluator.h"
+#include <math.h>
+#include <stdio.h>
+
+#define BATCH_POINTS 1024
+
+static const char *batch_corpus[] = {
+    "X^2-3*X+2",
+    "2*π*sqrt(2)*X",
+    "sqrt(abs(X))*X+1",
+    "sin(X)*cos(X)+tan(X/4)",
+    "1/(X-3)",
+};
+
+void bench_batch(const bench_config_t *config)
+{
+    static double xs[BATCH_POINTS], out_batch[BATCH_POINTS], out_scalar[BATCH_POINTS];
+    const int reps = config->iterations / 100 > 0 ? config->iterations / 100 : 1;
+    eval_context_t context = { .deg_mode = true };
+
+    for (int i = 0; i < BATCH_POINTS; i++) {
+        xs[i] = -8.0 + i / 64.0;    // Exact grid, hits X=3 once
+    }
+
+    bench_section_begin("batch");
+    printf("\n    \"points\": %d,\n    \"repetitions\": %d,\n    \"expressions\": [",
+           BATCH_POINTS, reps);
+
+    for (size_t e = 0; e < sizeof(batch_corpus) / sizeof(batch_corpus[0]); e++) {
+        const char *expr = batch_corpus[e];
+        rpn_queue_t rpn;
+        uint64_t start;
+        int failures = 0;
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(expr);
+
+        int err = parse_expression_to_rpn(expr, &rpn);
+        if (err < 0) {
+            printf(", \"error\": %d}", err);
+            continue;
+        }
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int i = 0; i < BATCH_POINTS; i++) {
+                context.variables.x = xs[i];
+                if (evaluate_expression(expr, &context, &out_scalar[i]) < 0) {
+                    out_scalar[i] = NAN;
+                }
+            }
+        }
+        double expression_ns = (double)(bench_now_ns() - start) / reps / BATCH_POINTS;
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int i = 0; i < BATCH_POINTS; i++) {
+                context.variables.x = xs[i];
+                if (evaluate_rpn(&rpn, &context, &out_scalar[i]) < 0) {
+                    out_scalar[i] = NAN;
+                }
+            }
+        }
+        double rpn_ns = (double)(bench_now_ns() - start) / reps / BATCH_POINTS;
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            failures = evaluate_rpn_batch(&rpn, &context, xs, out_batch, BATCH_POINTS);
+        }
+        double batch_ns = (double)(bench_now_ns() - start) / reps / BATCH_POINTS;
+        bench_sink = out_batch[BATCH_POINTS / 2];
+
+        // Batch results must match the scalar evaluator bit for bit
+        int mismatches = 0;
+        for (int i = 0; i < BATCH_POINTS; i++) {
+            bool both_failed = isnan(out_batch[i]) && isnan(out_scalar[i]);
+            if (!both_failed && out_batch[i] != out_scalar[i]) {
+                mismatches++;
+            }
+        }
+
+        printf(", \"expression_ns\": %.1f, \"rpn_ns\": %.1f, \"batch_ns\": %.1f,"
+               " \"speedup_vs_expression\": %.2f, \"speedup_vs_rpn\": %.2f,"
+               " \"failed\": %d, \"mismatches\": %d}",
+               expression_ns, rpn_ns, batch_ns,
+               expression_ns / batch_ns, rpn_ns / batch_ns, failures, mismatches);
+    }
+
+    printf("\n    ]");
+    bench_section_end();
+}
@@ -0,0 +1,192 @@
+/*
+ * Host Benchmark - Complex numbers
+ *
+ * The complex evaluator runs the same RPN programs as evaluate_rpn(), so
+ * for every corpus expression both are timed on one parsed program: the
+ * real figure is what COMP mode pays and must not move when the complex
+ * path changes. Complex expressions are timed on their own, and the
+ * principal-branch kernels are checked against the C library's csqrt,
+ * clog and cpow, including points on the negative real axis.
+ */
+
+#include "bench.h"
+#include "complex_number.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+
+#define BRANCH_SAMPLES 4096
+
+static const eval_context_t context = {
+    .variables = {
+        .ans = 1.5, .x = 2.25, .y = -0.75,
+        .a = 3.0, .b = 4.0, .c = 5.0, .d = 6.0, .m = 0.5
+    },
+    .deg_mode = true
+};
+
+static const char *const complex_expressions[] = {
+    "(3+4i)/(1-2i)",
+    "sqrt(-4)+2i*X",
+    "ln(-1)",
+    "(1+i)^10",
+    "i^i",
+    "2∠30+3∠45",
+    "abs(3+4i)*arg(1+i)",
+    "e^(iπ)+conj(A+Bi)",
+};
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+static double time_real(const rpn_queue_t *rpn, int n)
+{
+    double result;
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < n; i++) {
+        evaluate_rpn(rpn, &context, &result);
+        bench_sink = result;
+    }
+    return (double)(bench_now_ns() - start) / n;
+}
+
+static double time_complex(const rpn_queue_t *rpn, int n)
+{
+    complex_t result;
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < n; i++) {
+        complex_evaluate_rpn(rpn, &context, NULL, &result);
+        bench_sink = result.re;
+    }
+    return (double)(bench_now_ns() - start) / n;
+}
+
+static void print_corpus(const bench_config_t *config)
+{
+    double real_total = 0.0, complex_total = 0.0;
+    bool first = true;
+
+    printf("\n    \"corpus\": [");
+    for (int e = 0; e < config->corpus_count; e++) {
+        rpn_queue_t rpn;
+        double value;
+        complex_t z;
+        if (parse_expression_to_rpn(config->corpus[e], &rpn) != 0 ||
+            evaluate_rpn(&rpn, &context, &value) != 0 ||
+            complex_evaluate_rpn(&rpn, &context, NULL, &z) != 0) {
+            continue;
+        }
+        double real_ns = time_real(&rpn, config->iterations);
+        double complex_ns = time_complex(&rpn, config->iterations);
+        real_total += real_ns;
+        complex_total += complex_ns;
+
+        printf("%s\n      {\"expr\": ", first ? "" : ",");
+        bench_json_string(config->corpus[e]);
+        printf(", \"real_ns\": %.1f, \"complex_ns\": %.1f, \"same_value\": %s}",
+               real_ns, complex_ns, z.re == value && z.im == 0.0 ? "true" : "false");
+        first = false;
+    }
+    printf("\n    ],\n    \"corpus_real_ns\": %.1f, \"corpus_complex_ns\": %.1f",
+           real_total, complex_total);
+}
+
+static void print_expressions(const bench_config_t *config)
+{
+    const int count = (int)(sizeof(complex_expressions) / sizeof(complex_expressions[0]));
+
+    printf(",\n    \"expressions\": [");
+    for (int e = 0; e < count; e++) {
+        rpn_queue_t rpn;
+        complex_t z = { NAN, NAN };
+        int err = parse_expression_to_rpn(complex_expressions[e], &rpn);
+        if (err == 0) {
+            err = complex_evaluate_rpn(&rpn, &context, NULL, &z);
+        }
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(complex_expressions[e]);
+        if (err != 0) {
+            printf(", \"error\": %d}", err);
+            continue;
+        }
+        printf(", \"re\": %.15g, \"im\": %.15g, \"ns_per_eval\": %.1f}",
+               z.re, z.im, time_complex(&rpn, config->iterations));
+    }
+    printf("\n    ]");
+}
+
+static double relative_error(complex_t z, double complex reference)
+{
+    double scale = cabs(reference);
+    double error = hypot(z.re - creal(reference), z.im - cimag(reference));
+    return scale > 0.0 ? error / scale : error;
+}
+
+// Random points over several decades; every fourth is real, every
+// eighth a negative real, so the cut is exercised
+static complex_t branch_point(int k)
+{
+    double magnitude = pow(10.0, 8.0 * rng_uniform() - 4.0);
+    double angle = (2.0 * rng_uniform() - 1.0) * 3.14159265358979323846;
+    complex_t z = { magnitude * cos(angle), magnitude * sin(angle) };
+    if (k % 4 == 0) {
+        z.re = k % 8 == 0 ? -magnitude : magnitude;
+        z.im = 0.0;
+    }
+    return z;
+}
+
+static void print_branches(void)
+{
+    double sqrt_error = 0.0, ln_error = 0.0, pow_error = 0.0, divide_error = 0.0;
+
+    for (int k = 0; k < BRANCH_SAMPLES; k++) {
+        complex_t z = branch_point(k);
+        complex_t w = { 4.0 * rng_uniform() - 2.0, k % 2 ? 2.0 * rng_uniform() - 1.0 : 0.0 };
+        double complex cz = CMPLX(z.re, z.im);
+        double complex cw = CMPLX(w.re, w.im);
+        complex_t out;
+        double error;
+
+        error = relative_error(complex_sqrt(z), csqrt(cz));
+        sqrt_error = error > sqrt_error ? error : sqrt_error;
+
+        complex_ln(z, &out);
+        error = relative_error(out, clog(cz));
+        ln_error = error > ln_error ? error : ln_error;
+
+        if (complex_pow(z, w, &out) == 0) {
+            error = relative_error(out, cpow(cz, cw));
+            pow_error = error > pow_error ? error : pow_error;
+        }
+        if (complex_divide(w, z, &out) == 0) {
+            error = relative_error(out, cw / cz);
+            divide_error = error > divide_error ? error : divide_error;
+        }
+    }
+
+    printf(",\n    \"branches\": {\"samples\": %d, \"sqrt_max_rel_error\": %.3e, "
+           "\"ln_max_rel_error\": %.3e, \"pow_max_rel_error\": %.3e, "
+           "\"divide_max_rel_error\": %.3e}",
+           BRANCH_SAMPLES, sqrt_error, ln_error, pow_error, divide_error);
+}
+
+void bench_complex(const bench_config_t *config)
+{
+    bench_section_begin("complex");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    print_corpus(config);
+    print_expressions(config);
+    print_branches();
+
+    bench_section_end();
+}
@@ -0,0 +1,186 @@
+/*
+ * Host Benchmark - Degree-mode trigonometry
+ *
+ * Compares apply_function() in DEG mode with the convert-then-call path
+ * it replaced (sin(x * pi / 180) and asin(x) * 180 / pi through the RAD
+ * path of apply_function()):
+ *
+ * - special: multiples of 15 degrees in [-720, 720] and the inverse trig
+ *   values of the multiples of 30 and 45 degrees; counts results equal
+ *   to the exact value rounded to the evaluator type
+ * - accuracy: max relative error on random angles against long double
+ * - timing: ns per call on small and large angles
+ */
+
+#include "bench.h"
+#include "expression_evaluator.h"
+#include <math.h>
+#include <stdio.h>
+
+#define RANDOM_SAMPLES 100000
+#define TIMING_SAMPLES 1024
+
+#define PI_L 3.141592653589793238462643383279502884L
+
+// The DEG path apply_function() used before: convert, then call the RAD path
+static eval_num_t legacy_degrees(function_type_t func, eval_num_t x)
+{
+    switch (func) {
+        case FUNC_SIN:
+        case FUNC_COS:
+        case FUNC_TAN:
+            return apply_function(func, x * EVAL_NUM_PI / 180, false);
+        default:
+            return apply_function(func, x, false) * 180 / EVAL_NUM_PI;
+    }
+}
+
+// Long double reference with the exact reduction modulo 360
+static long double reference_degrees(function_type_t func, long double x)
+{
+    long double rad = fmodl(x, 360.0L) * (PI_L / 180.0L);
+
+    switch (func) {
+        case FUNC_SIN: return sinl(rad);
+        case FUNC_COS: return cosl(rad);
+        case FUNC_TAN: return tanl(rad);
+        case FUNC_ASIN: return asinl(x) * (180.0L / PI_L);
+        case FUNC_ACOS: return acosl(x) * (180.0L / PI_L);
+        default: return atanl(x) * (180.0L / PI_L);
+    }
+}
+
+// Exact value rounded to eval_num_t; zeros of sin/cos/tan become exact 0
+static eval_num_t rounded_reference(function_type_t func, long double x)
+{
+    long double reference = reference_degrees(func, x);
+    return fabsl(reference) < 1e-12L ? 0 : (eval_num_t)reference;
+}
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+static const struct {
+    const char *name;
+    function_type_t func;
+    double lo, hi;
+} trig_cases[] = {
+    {"sin",         FUNC_SIN,  -360.0, 360.0},
+    {"sin(large)",  FUNC_SIN,  -1e5,   1e5},
+    {"cos",         FUNC_COS,  -360.0, 360.0},
+    {"cos(large)",  FUNC_COS,  -1e5,   1e5},
+    {"tan",         FUNC_TAN,  -360.0, 360.0},
+    {"asin",        FUNC_ASIN, -1.0,   1.0},
+    {"acos",        FUNC_ACOS, -1.0,   1.0},
+    {"atan",        FUNC_ATAN, -100.0, 100.0},
+};
+
+// Inputs whose inverse trig results are multiples of 30 or 45 degrees
+static const double asin_special_inputs[] = {
+    0.0, 0.5, -0.5, EVAL_NUM_SQRT1_2, -EVAL_NUM_SQRT1_2,
+    EVAL_NUM_SQRT3_2, -EVAL_NUM_SQRT3_2, 1.0, -1.0,
+};
+
+static const double atan_special_inputs[] = {
+    0.0, 1.0, -1.0, EVAL_NUM_SQRT3, -EVAL_NUM_SQRT3, EVAL_NUM_INV_SQRT3, -EVAL_NUM_INV_SQRT3,
+};
+
+static void count_special(function_type_t func, int *total, int *legacy_exact, int *exact)
+{
+    *total = *legacy_exact = *exact = 0;
+
+    if (func == FUNC_SIN || func == FUNC_COS || func == FUNC_TAN) {
+        for (int deg = -720; deg <= 720; deg += 15) {
+            bool tan_pole = func == FUNC_TAN && (deg % 180 + 180) % 180 == 90;
+            if ((deg % 30 != 0 && deg % 45 != 0) || tan_pole) {
+                continue;
+            }
+            eval_num_t expected = rounded_reference(func, deg);
+            (*total)++;
+            *legacy_exact += legacy_degrees(func, deg) == expected;
+            *exact += apply_function(func, deg, true) == expected;
+        }
+        return;
+    }
+
+    const double *inputs = func == FUNC_ATAN ? atan_special_inputs : asin_special_inputs;
+    const int count = func == FUNC_ATAN ?
+        (int)(sizeof(atan_special_inputs) / sizeof(atan_special_inputs[0])) :
+        (int)(sizeof(asin_special_inputs) / sizeof(asin_special_inputs[0]));
+
+    for (int i = 0; i < count; i++) {
+        eval_num_t x = (eval_num_t)inputs[i];
+        // The whole-degree angle the input stands for, e.g. 45 for SQRT1_2
+        eval_num_t expected = (eval_num_t)nearbyintl(reference_degrees(func, x));
+        (*total)++;
+        *legacy_exact += legacy_degrees(func, x) == expected;
+        *exact += apply_function(func, x, true) == expected;
+    }
+}
+
+static double time_calls(function_type_t func, const eval_num_t *inputs, int reps, bool legacy)
+{
+    uint64_t start = bench_now_ns();
+
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            bench_sink = legacy ? legacy_degrees(func, inputs[i])
+                                : apply_function(func, inputs[i], true);
+        }
+    }
+    return (double)(bench_now_ns() - start) / ((double)reps * TIMING_SAMPLES);
+}
+
+void bench_degree_trig(const bench_config_t *config)
+{
+    const int reps = config->iterations / 200 > 0 ? config->iterations / 200 : 1;
+    eval_num_t inputs[TIMING_SAMPLES];
+
+    bench_section_begin("degree_trig");
+    printf("\n    \"functions\": [");
+
+    for (size_t f = 0; f < sizeof(trig_cases) / sizeof(trig_cases[0]); f++) {
+        const function_type_t func = trig_cases[f].func;
+        const double lo = trig_cases[f].lo, hi = trig_cases[f].hi;
+        double legacy_max = 0.0, max = 0.0;
+        int total, legacy_exact, exact;
+
+        count_special(func, &total, &legacy_exact, &exact);
+
+        rng_state = 0x9E3779B97F4A7C15ULL;
+        for (int i = 0; i < RANDOM_SAMPLES; i++) {
+            eval_num_t x = (eval_num_t)(lo + rng_uniform() * (hi - lo));
+            long double reference = reference_degrees(func, x);
+            long double scale = fabsl(reference) > 1e-3L ? fabsl(reference) : 1e-3L;
+            double legacy_error = (double)(fabsl(legacy_degrees(func, x) - reference) / scale);
+            double error = (double)(fabsl(apply_function(func, x, true) - reference) / scale);
+            if (legacy_error > legacy_max) legacy_max = legacy_error;
+            if (error > max) max = error;
+        }
+
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            inputs[i] = (eval_num_t)(lo + rng_uniform() * (hi - lo));
+        }
+        double legacy_ns = time_calls(func, inputs, reps, true);
+        double ns = time_calls(func, inputs, reps, false);
+
+        printf("%s\n      {\"function\": ", f ? "," : "");
+        bench_json_string(trig_cases[f].name);
+        printf(", \"domain\": [%g, %g], \"special_angles\": %d,"
+               " \"legacy_exact\": %d, \"exact\": %d,"
+               "\n       \"legacy_max_rel_error\": %.3e, \"max_rel_error\": %.3e,"
+               " \"legacy_ns\": %.2f, \"ns\": %.2f, \"speedup\": %.2f}",
+               lo, hi, total, legacy_exact, exact, legacy_max, max,
+               legacy_ns, ns, legacy_ns / ns);
+    }
+
+    printf("\n    ]");
+    bench_section_end();
+}
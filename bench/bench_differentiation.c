@@ -0,0 +1,70 @@
+/*
+ * Host Benchmark - Numerical differentiation
+ *
+ * Runs differentiate_rpn() on a suite of functions with known
+ * derivatives, including large x and a point close to a pole of tan.
+ * Reports the relative error against the analytic derivative, the
+ * extrapolation error estimate, the evaluations spent and the time per
+ * derivative. Compilation is excluded from the timing.
+ */
+
+#include "bench.h"
+#include "differentiation.h"
+#include <math.h>
+#include <stdio.h>
+
+typedef struct {
+    const char *expression;
+    double x;
+    double exact;
+} derivative_case_t;
+
+static const derivative_case_t derivative_suite[] = {
+    { "sin(X)",         1.0,    0.54030230586813971740 },
+    { "exp(X)",         2.0,    7.38905609893064951175 },
+    { "ln(X)",          0.5,    2.0 },
+    { "sqrt(X)",        4.0,    0.25 },
+    { "1/(1+X^2)",      0.5,    -0.64 },
+    { "X^3",            1000.0, 3.0e6 },
+    { "exp(X)",         50.0,   5.18470552858707246e21 },
+    { "sinh(X)",        -3.0,   10.0676619957777658 },
+    { "atan(X)",        10.0,   1.0 / 101.0 },
+    { "tan(X)",         1.5,    199.85004452649250 },
+};
+
+#define SUITE_SIZE (int)(sizeof(derivative_suite) / sizeof(derivative_suite[0]))
+
+void bench_differentiation(const bench_config_t *config)
+{
+    const int reps = config->iterations / 10 > 0 ? config->iterations / 10 : 1;
+    eval_context_t context = { .deg_mode = false };
+    rpn_queue_t function;
+
+    bench_section_begin("differentiation");
+
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        const derivative_case_t *c = &derivative_suite[i];
+        diff_result_t result = {0};
+        int status;
+
+        status = parse_expression_to_rpn(c->expression, &function);
+        if (status == 0) {
+            optimize_rpn(&function, context.deg_mode);
+        }
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps && status == 0; r++) {
+            status = differentiate_rpn(&function, &context, c->x, &result);
+        }
+        double ns = (double)(bench_now_ns() - start) / reps;
+
+        printf("%s\n    ", i == 0 ? "" : ",");
+        bench_json_string(c->expression);
+        printf(": {\"x\": %g, \"status\": %d, \"value\": %.17g, \"rel_error\": %.3e,"
+               " \"error_estimate\": %.3e, \"evaluations\": %d, \"ns\": %.1f}",
+               c->x, status, result.value, fabs(result.value - c->exact) / fabs(c->exact),
+               result.error_estimate, result.evaluations, ns);
+    }
+
+    bench_section_end();
+}
@@ -0,0 +1,336 @@
+/*
+ * Host Benchmark - Probability distributions
+ *
+ * erf, erfc and the scaled erfc against the long double libm functions,
+ * with libm's double erfc timed alongside. Normal CD and inverse normal
+ * are checked out to the far lower tail, the inverse as the error in x
+ * implied by its long double CD residual. The binomial and Poisson PD
+ * are checked against long double log-gamma for moderate parameters;
+ * for n = 10^6 and 10^9, where that reference is itself too coarse, the
+ * PD is summed over +-12 standard deviations and compared with 1, next to
+ * the same sum for the PD as a difference of double log-gammas. The CDs
+ * are checked against a long double running sum, and timed at the mean,
+ * their worst case. Throughput is for the list versions over 10^5 x.
+ */
+
+#include "bench.h"
+#include "distributions.h"
+#include "special_functions.h"
+#include <math.h>
+#include <stdio.h>
+
+#define RANDOM_SAMPLES 100000
+#define LIST_LENGTH    100000
+
+static const long double SQRT1_2_L = 0.707106781186547524400844362104849039L;
+
+static double list_x[LIST_LENGTH];
+static double list_out[LIST_LENGTH];
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+static double relative_error(double value, long double reference)
+{
+    if (reference == 0.0L) {
+        return value == 0.0 ? 0.0 : INFINITY;
+    }
+    return (double)(fabsl(value - reference) / fabsl(reference));
+}
+
+typedef struct {
+    double max;
+    double worst;
+} max_error_t;
+
+static void track(max_error_t *error, double value, double x)
+{
+    if (value > error->max) {
+        error->max = value;
+        error->worst = x;
+    }
+}
+
+// Max relative error of fn over x uniform in [lo, hi]
+static max_error_t check_unary(double (*fn)(double), long double (*reference)(long double),
+                           double lo, double hi)
+{
+    max_error_t error = {0};
+
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        double x = lo + rng_uniform() * (hi - lo);
+        track(&error, relative_error(fn(x), reference(x)), x);
+    }
+    return error;
+}
+
+static long double erfcx_reference(long double x)
+{
+    return erfcl(x) * expl(x * x);
+}
+
+static double time_unary(double (*fn)(double), const double *inputs, int count, int reps)
+{
+    uint64_t start = bench_now_ns();
+
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < count; i++) {
+            bench_sink = fn(inputs[i]);
+        }
+    }
+    return (double)(bench_now_ns() - start) / ((double)reps * count);
+}
+
+static long double normal_cd_reference(long double z)
+{
+    return 0.5L * erfcl(-z * SQRT1_2_L);
+}
+
+static long double binomial_reference(double x, double n, double p)
+{
+    return expl(lgammal(n + 1.0L) - lgammal(x + 1.0L) - lgammal(n - x + 1.0L) +
+                x * logl(p) + (n - x) * log1pl(-(long double)p));
+}
+
+static long double poisson_reference(double x, double lambda)
+{
+    return expl(x * logl(lambda) - lambda - lgammal(x + 1.0L));
+}
+
+// The PD as a difference of double log-gammas, for comparison
+static double binomial_lgamma(double x, double n, double p)
+{
+    return exp(sf_lgamma(n + 1.0) - sf_lgamma(x + 1.0) - sf_lgamma(n - x + 1.0) +
+               x * log(p) + (n - x) * log1p(-p));
+}
+
+static double poisson_lgamma(double x, double lambda)
+{
+    return exp(x * log(lambda) - lambda - sf_lgamma(x + 1.0));
+}
+
+static void print_erf(int reps)
+{
+    max_error_t erf_error = check_unary(sf_erf, erfl, -6.0, 6.0);
+    max_error_t erfc_error = check_unary(sf_erfc, erfcl, -6.0, 26.0);
+    max_error_t erfcx_error = check_unary(sf_erfcx, erfcx_reference, 0.0, 100.0);
+
+    for (int i = 0; i < LIST_LENGTH; i++) {
+        list_x[i] = -6.0 + rng_uniform() * 32.0;
+    }
+    double sf_ns = time_unary(sf_erfc, list_x, LIST_LENGTH, reps);
+    double libm_ns = time_unary(erfc, list_x, LIST_LENGTH, reps);
+
+    printf("\n    \"erf\": {\"range\": [-6, 6], \"max_rel_error\": %.3e, \"worst_x\": %.17g},",
+           erf_error.max, erf_error.worst);
+    printf("\n    \"erfc\": {\"range\": [-6, 26], \"max_rel_error\": %.3e, \"worst_x\": %.17g,"
+           " \"sf_ns\": %.2f, \"libm_ns\": %.2f},",
+           erfc_error.max, erfc_error.worst, sf_ns, libm_ns);
+    printf("\n    \"erfcx\": {\"range\": [0, 100], \"max_rel_error\": %.3e, \"worst_x\": %.17g},",
+           erfcx_error.max, erfcx_error.worst);
+}
+
+static void print_normal(void)
+{
+    max_error_t cd_error = {0}, inverse_error = {0};
+
+    // Lower tail down to P ~ 1e-300
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        double z = -37.0 + rng_uniform() * 40.0;
+        track(&cd_error, relative_error(dist_normal_cd(-INFINITY, z, 0.0, 1.0),
+                                        normal_cd_reference(z)), z);
+    }
+
+    // Areas log-uniform in [1e-300, 1/2] and uniform in (0, 1); the error
+    // in x is the CD residual over the density, relative where |x| >= 1 and
+    // absolute below, since near x = 0 the area itself only has absolute
+    // precision
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        double p = i % 2 ? pow(10.0, -300.0 * rng_uniform()) * 0.5 : rng_uniform();
+        if (p == 0.0) {
+            continue;
+        }
+        double x = dist_inverse_normal(p, 0.0, 1.0);
+        long double density = expl(-0.5L * x * x) / sqrtl(2.0L * 3.14159265358979323846264L);
+        long double dx = (normal_cd_reference(x) - p) / density;
+        track(&inverse_error, (double)(fabsl(dx) / fmax(fabs(x), 1.0)), p);
+    }
+
+    printf("\n    \"normal_cd\": {\"range\": [-37, 3], \"max_rel_error\": %.3e, \"worst_z\": %.17g},",
+           cd_error.max, cd_error.worst);
+    printf("\n    \"inverse_normal\": {\"areas\": [1e-300, 1], \"max_error\": %.3e,"
+           " \"worst_area\": %.17g},", inverse_error.max, inverse_error.worst);
+}
+
+static void print_discrete_pd(void)
+{
+    static const double trials[] = {10.0, 100.0, 1000.0};
+    static const double probabilities[] = {0.01, 0.3, 0.5, 0.97};
+    static const double lambdas[] = {0.5, 30.0, 1000.0};
+    max_error_t binomial = {0}, poisson = {0};
+
+    // Relative error wherever the reference is at least 1e-280
+    for (size_t t = 0; t < sizeof(trials) / sizeof(trials[0]); t++) {
+        for (size_t j = 0; j < sizeof(probabilities) / sizeof(probabilities[0]); j++) {
+            for (double x = 0.0; x <= trials[t]; x++) {
+                long double reference = binomial_reference(x, trials[t], probabilities[j]);
+                if (reference >= 1e-280L) {
+                    track(&binomial, relative_error(dist_binomial_pd(x, trials[t], probabilities[j]),
+                                                    reference), x);
+                }
+            }
+        }
+    }
+    for (size_t l = 0; l < sizeof(lambdas) / sizeof(lambdas[0]); l++) {
+        for (double x = 0.0; x <= 3.0 * lambdas[l] + 50.0; x++) {
+            long double reference = poisson_reference(x, lambdas[l]);
+            if (reference >= 1e-280L) {
+                track(&poisson, relative_error(dist_poisson_pd(x, lambdas[l]), reference), x);
+            }
+        }
+    }
+
+    printf("\n    \"binomial_pd\": {\"trials\": [10, 100, 1000], \"max_rel_error\": %.3e,"
+           " \"worst_x\": %.17g},", binomial.max, binomial.worst);
+    printf("\n    \"poisson_pd\": {\"lambda\": [0.5, 30, 1000], \"max_rel_error\": %.3e,"
+           " \"worst_x\": %.17g},", poisson.max, poisson.worst);
+
+    // Large parameters: the PD should sum to 1 over the bulk
+    printf("\n    \"pd_sum_error\": [");
+    for (int i = 0; i < 4; i++) {
+        bool is_binomial = i < 2;
+        double n = i % 2 ? 1e9 : 1e6;
+        double mean = is_binomial ? 0.5 * n : n;
+        double sd = is_binomial ? sqrt(0.25 * n) : sqrt(n);
+        long double saddle = 0.0L, lgamma_form = 0.0L;
+        for (double x = floor(mean - 12.0 * sd); x <= mean + 12.0 * sd; x++) {
+            saddle += is_binomial ? dist_binomial_pd(x, n, 0.5) : dist_poisson_pd(x, n);
+            lgamma_form += is_binomial ? binomial_lgamma(x, n, 0.5) : poisson_lgamma(x, n);
+        }
+        printf("%s\n      {\"distribution\": \"%s\", \"n\": %.0e, \"saddle_point\": %.3e,"
+               " \"lgamma_difference\": %.3e}", i ? "," : "", is_binomial ? "binomial" : "poisson",
+               n, (double)fabsl(saddle - 1.0L), (double)fabsl(lgamma_form - 1.0L));
+    }
+    printf("\n    ],");
+}
+
+static void print_discrete_cd(int reps)
+{
+    max_error_t binomial = {0}, poisson = {0};
+    long double sum = 0.0L;
+
+    for (double x = 0.0; x <= 1000.0; x++) {
+        sum += binomial_reference(x, 1000.0, 0.3);
+        track(&binomial, relative_error(dist_binomial_cd(x, 1000.0, 0.3), sum), x);
+    }
+    sum = 0.0L;
+    for (double x = 0.0; x <= 300.0; x++) {
+        sum += poisson_reference(x, 100.0);
+        track(&poisson, relative_error(dist_poisson_cd(x, 100.0), sum), x);
+    }
+
+    // At the mean, where the most terms are summed
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < reps; r++) {
+        bench_sink = dist_binomial_cd(5e5 + r % 2, 1e6, 0.5);
+    }
+    double binomial_ns = (double)(bench_now_ns() - start) / reps;
+    start = bench_now_ns();
+    for (int r = 0; r < reps; r++) {
+        bench_sink = dist_poisson_cd(1e6 + r % 2, 1e6);
+    }
+    double poisson_ns = (double)(bench_now_ns() - start) / reps;
+
+    printf("\n    \"binomial_cd\": {\"trials\": 1000, \"p\": 0.3, \"max_rel_error\": %.3e,"
+           " \"worst_x\": %.17g, \"ns_at_mean_n1e6\": %.0f},",
+           binomial.max, binomial.worst, binomial_ns);
+    printf("\n    \"poisson_cd\": {\"lambda\": 100, \"max_rel_error\": %.3e, \"worst_x\": %.17g,"
+           " \"ns_at_mean_lambda1e6\": %.0f},", poisson.max, poisson.worst, poisson_ns);
+}
+
+typedef enum {
+    LIST_NORMAL_PD,
+    LIST_NORMAL_CD,
+    LIST_INVERSE_NORMAL,
+    LIST_BINOMIAL_PD,
+    LIST_BINOMIAL_CD,
+    LIST_POISSON_PD,
+    LIST_POISSON_CD,
+    LIST_COUNT
+} list_function_t;
+
+static const char *const list_names[LIST_COUNT] = {
+    "normal_pd", "normal_cd", "inverse_normal",
+    "binomial_pd", "binomial_cd", "poisson_pd", "poisson_cd"
+};
+
+static void run_list(list_function_t func)
+{
+    switch (func) {
+        case LIST_NORMAL_PD:
+            dist_normal_pd_list(list_x, list_out, LIST_LENGTH, 10.0, 2.0);
+            break;
+        case LIST_NORMAL_CD:
+            dist_normal_cd_list(list_x, list_out, LIST_LENGTH, 10.0, 2.0);
+            break;
+        case LIST_INVERSE_NORMAL:
+            dist_inverse_normal_list(list_x, list_out, LIST_LENGTH, 10.0, 2.0);
+            break;
+        case LIST_BINOMIAL_PD:
+            dist_binomial_pd_list(list_x, list_out, LIST_LENGTH, 100.0, 0.3);
+            break;
+        case LIST_BINOMIAL_CD:
+            dist_binomial_cd_list(list_x, list_out, LIST_LENGTH, 100.0, 0.3);
+            break;
+        case LIST_POISSON_PD:
+            dist_poisson_pd_list(list_x, list_out, LIST_LENGTH, 30.0);
+            break;
+        default:
+            dist_poisson_cd_list(list_x, list_out, LIST_LENGTH, 30.0);
+            break;
+    }
+}
+
+static void print_lists(int reps)
+{
+    printf("\n    \"list_ns_per_x\": {");
+    for (int f = 0; f < LIST_COUNT; f++) {
+        // Areas for the inverse, counts for the discrete ones, else N(10, 2) values
+        for (int i = 0; i < LIST_LENGTH; i++) {
+            double u = rng_uniform();
+            list_x[i] = f == LIST_INVERSE_NORMAL ? u : f >= LIST_BINOMIAL_PD ? floor(u * 60.0)
+                                                                          : 2.0 + u * 16.0;
+        }
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            run_list((list_function_t)f);
+        }
+        double ns = (double)(bench_now_ns() - start) / ((double)reps * LIST_LENGTH);
+        bench_sink = list_out[LIST_LENGTH / 2];
+        printf("%s\"%s\": %.2f", f ? ", " : "", list_names[f], ns);
+    }
+    printf("}");
+}
+
+void bench_distributions(const bench_config_t *config)
+{
+    const int reps = config->iterations / 2000 > 0 ? config->iterations / 2000 : 1;
+
+    bench_section_begin("distributions");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    print_erf(reps);
+    print_normal();
+    print_discrete_pd();
+    print_discrete_cd(config->iterations / 100 > 0 ? config->iterations / 100 : 1);
+    print_lists(reps);
+
+    bench_section_end();
+}
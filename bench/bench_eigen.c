@@ -0,0 +1,283 @@
+/*
+ * Host Benchmark - Eigenvalues and SVD
+ *
+ * For each size from 2x2 to MATRIX_MAX_DIM, the symmetric Jacobi and
+ * general Hessenberg-QR eigen solvers and the one-sided Jacobi SVD run
+ * over a set of random matrices. The general set mixes in companion
+ * matrices of polynomials with clustered roots and perturbed Jordan
+ * blocks, which take the most QR steps; the SVD set includes rank
+ * deficient matrices. Each matrix is timed as the best of a few runs,
+ * and the section reports the most iterations and the slowest call
+ * seen, with the residuals |A v - lambda v| / |A| and |A - U S V^T| / |A|.
+ * The integer, clustered and Jordan cases are reported apart: they have
+ * repeated eigenvalues, and one of multiplicity k is only determined to
+ * about eps^(1/k), which their residual reflects.
+ *
+ * The bound projects the slowest call out to the iteration cap: it adds
+ * the time per iteration (the least-squares slope of time on iteration
+ * count) for every iteration the cap still allows. A call gives up at
+ * the cap, so that is the figure the UI can budget.
+ */
+
+#include "bench.h"
+#include "eigen.h"
+#include <math.h>
+#include <stdio.h>
+
+#define EIGEN_SET     256
+#define TIMING_RUNS   5
+#define TIMING_CALLS  8
+
+typedef enum {
+    SOLVER_SYMMETRIC,
+    SOLVER_GENERAL,
+    SOLVER_SVD,
+    SOLVER_COUNT
+} solver_t;
+
+static const char *const solver_names[SOLVER_COUNT] = {
+    "symmetric_jacobi", "hessenberg_qr", "svd_jacobi",
+};
+
+static matrix_t inputs[EIGEN_SET];
+static double call_ns[EIGEN_SET];
+static int call_iterations[EIGEN_SET];
+static eigen_result_t eigen;
+static svd_result_t svd;
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+// Companion matrix of the monic polynomial with the given roots
+static void companion(matrix_t *m, const double *roots, int n)
+{
+    double coeffs[MATRIX_MAX_DIM + 1] = { 1.0 };     // Descending powers
+    for (int r = 0; r < n; r++) {
+        for (int i = r + 1; i > 0; i--) {
+            coeffs[i] -= roots[r] * coeffs[i - 1];
+        }
+    }
+    matrix_init(m, n, n);
+    for (int j = 0; j < n; j++) {
+        m->data[j] = -coeffs[j + 1];
+        if (j + 1 < n) {
+            m->data[(j + 1) * n + j] = 1.0;
+        }
+    }
+}
+
+static void fill_inputs(solver_t solver, int n)
+{
+    for (int s = 0; s < EIGEN_SET; s++) {
+        matrix_t *m = &inputs[s];
+        matrix_init(m, n, n);
+        for (int i = 0; i < n * n; i++) {
+            m->data[i] = 2.0 * rng_uniform() - 1.0;
+        }
+        if (solver == SOLVER_SYMMETRIC) {
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < i; j++) {
+                    m->data[i * n + j] = m->data[j * n + i];
+                }
+            }
+        } else if (solver == SOLVER_GENERAL && s % 4 == 1) {
+            // Roots in two tight clusters
+            double roots[MATRIX_MAX_DIM];
+            for (int i = 0; i < n; i++) {
+                roots[i] = (i % 2 ? 1.0 : -2.0) + 1e-3 * rng_uniform();
+            }
+            companion(m, roots, n);
+        } else if (solver == SOLVER_GENERAL && s % 4 == 2) {
+            // Small integers, whose repeated structure stalls plain shifts
+            for (int i = 0; i < n * n; i++) {
+                m->data[i] = floor(3.0 * m->data[i]);
+            }
+        } else if (solver == SOLVER_GENERAL && s % 4 == 3) {
+            // Jordan block with a tiny perturbation in the corner
+            matrix_init(m, n, n);
+            for (int i = 0; i < n; i++) {
+                m->data[i * n + i] = 0.5;
+                if (i + 1 < n) {
+                    m->data[i * n + i + 1] = 1.0;
+                }
+            }
+            m->data[(n - 1) * n] = 1e-10 * rng_uniform();
+        } else if (solver == SOLVER_SVD && s % 4 == 1) {
+            // Rank one less than full: the last row repeats the first
+            for (int j = 0; j < n; j++) {
+                m->data[(n - 1) * n + j] = m->data[j];
+            }
+        }
+    }
+}
+
+static double frobenius(const matrix_t *a)
+{
+    double sum = 0.0;
+    for (int i = 0; i < a->rows * a->cols; i++) {
+        sum += a->data[i] * a->data[i];
+    }
+    return sqrt(sum);
+}
+
+// Largest |A v - lambda v| over the real eigenpairs, relative to |A|
+static double eigen_residual(const matrix_t *a)
+{
+    int n = a->rows;
+    double worst = 0.0;
+    for (int j = 0; j < n; j++) {
+        if (eigen.imag[j] != 0.0) {
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            double sum = -eigen.real[j] * eigen.vectors.data[i * n + j];
+            for (int k = 0; k < n; k++) {
+                sum += a->data[i * n + k] * eigen.vectors.data[k * n + j];
+            }
+            worst = fabs(sum) > worst ? fabs(sum) : worst;
+        }
+    }
+    return worst / frobenius(a);
+}
+
+// Largest element of A - U S V^T, relative to |A|
+static double svd_residual(const matrix_t *a)
+{
+    int n = a->rows;
+    double worst = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = a->data[i * n + j];
+            for (int k = 0; k < svd.k; k++) {
+                sum -= svd.u.data[i * n + k] * svd.values[k] * svd.v.data[j * n + k];
+            }
+            worst = fabs(sum) > worst ? fabs(sum) : worst;
+        }
+    }
+    return worst / frobenius(a);
+}
+
+static int run_solver(solver_t solver, const matrix_t *a, int *iterations)
+{
+    int status;
+    switch (solver) {
+        case SOLVER_SYMMETRIC:
+            status = eigen_symmetric(a, &eigen);
+            *iterations = eigen.iterations;
+            break;
+        case SOLVER_GENERAL:
+            status = eigen_general(a, &eigen);
+            *iterations = eigen.iterations;
+            break;
+        default:
+            status = svd_jacobi(a, &svd);
+            *iterations = svd.sweeps;
+            break;
+    }
+    return status;
+}
+
+static void print_solver(solver_t solver, int n)
+{
+    fill_inputs(solver, n);
+
+    int failures = 0;
+    int max_iterations = 0;
+    long total_iterations = 0;
+    double worst_ns = 0.0;
+    double worst_residual = 0.0;
+    double worst_clustered = 0.0;
+
+    for (int s = 0; s < EIGEN_SET; s++) {
+        const matrix_t *a = &inputs[s];
+        int iterations = 0;
+        if (run_solver(solver, a, &iterations) != 0) {
+            failures++;
+            call_iterations[s] = -1;
+            continue;
+        }
+        double residual = solver == SOLVER_SVD ? svd_residual(a) : eigen_residual(a);
+        if (solver == SOLVER_GENERAL && s % 4 != 0) {
+            worst_clustered = residual > worst_clustered ? residual : worst_clustered;
+        } else {
+            worst_residual = residual > worst_residual ? residual : worst_residual;
+        }
+
+        double best_ns = INFINITY;
+        for (int r = 0; r < TIMING_RUNS; r++) {
+            uint64_t start = bench_now_ns();
+            for (int c = 0; c < TIMING_CALLS; c++) {
+                run_solver(solver, a, &iterations);
+            }
+            double ns = (double)(bench_now_ns() - start) / TIMING_CALLS;
+            best_ns = ns < best_ns ? ns : best_ns;
+        }
+        bench_sink = eigen.real[0] + svd.values[0];
+
+        total_iterations += iterations;
+        max_iterations = iterations > max_iterations ? iterations : max_iterations;
+        worst_ns = best_ns > worst_ns ? best_ns : worst_ns;
+        call_ns[s] = best_ns;
+        call_iterations[s] = iterations;
+    }
+
+    // Time per iteration: the least-squares slope of time on iterations
+    double mean_ns = 0.0, mean_iterations = 0.0;
+    int timed = 0;
+    for (int s = 0; s < EIGEN_SET; s++) {
+        if (call_iterations[s] >= 0) {
+            mean_ns += call_ns[s];
+            mean_iterations += call_iterations[s];
+            timed++;
+        }
+    }
+    mean_ns /= timed;
+    mean_iterations /= timed;
+    double covariance = 0.0, variance = 0.0;
+    for (int s = 0; s < EIGEN_SET; s++) {
+        if (call_iterations[s] >= 0) {
+            double di = call_iterations[s] - mean_iterations;
+            covariance += di * (call_ns[s] - mean_ns);
+            variance += di * di;
+        }
+    }
+    double ns_per_iteration = variance > 0.0 ? covariance / variance : 0.0;
+
+    int cap = solver == SOLVER_GENERAL ? EIGEN_MAX_QR_ITERATIONS * n : EIGEN_MAX_SWEEPS;
+    double bound_ns = worst_ns + (cap - max_iterations) * ns_per_iteration;
+    printf("%s\"%s\": {\"mean_iterations\": %.2f, \"max_iterations\": %d, \"failures\": %d,"
+           " \"ns_per_iteration\": %.1f, \"worst_ns\": %.0f, \"bound_ns\": %.0f, \"max_residual\": %.3e",
+           solver ? ", " : "", solver_names[solver], (double)total_iterations / EIGEN_SET,
+           max_iterations, failures, ns_per_iteration, worst_ns, bound_ns, worst_residual);
+    if (solver == SOLVER_GENERAL) {
+        printf(", \"max_residual_clustered\": %.3e", worst_clustered);
+    }
+    printf("}");
+}
+
+void bench_eigen(const bench_config_t *config)
+{
+    (void)config;
+
+    bench_section_begin("eigen");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    printf("\n    \"sizes\": [");
+    for (int n = 2; n <= MATRIX_MAX_DIM; n++) {
+        printf("%s\n      {\"n\": %d, ", n > 2 ? "," : "", n);
+        for (int solver = 0; solver < SOLVER_COUNT; solver++) {
+            print_solver((solver_t)solver, n);
+        }
+        printf("}");
+    }
+    printf("\n    ]");
+
+    bench_section_end();
+}
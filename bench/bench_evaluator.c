@@ -0,0 +1,122 @@
+/*
+ * Host Benchmark - Expression evaluator phases
+ *
+ * Times tokenize_expression(), parse_tokens_to_rpn() (shunting-yard) and
+ * evaluate_rpn() separately for each corpus expression, plus the cached
+ * evaluate_expression() path used on every '=' press (bytecode from the
+ * compile cache run by the VM) and evaluate_rpn() on the constant-folded
+ * program.
+ */
+
+#include "bench.h"
+#include "expression_evaluator.h"
+#include <stdio.h>
+
+// Context shared by all sections: DEG mode with non-trivial variables
+static const eval_context_t bench_context = {
+    .variables = {
+        .ans = 1.5, .x = 2.25, .y = -0.75,
+        .a = 3.0, .b = 4.0, .c = 5.0, .d = 6.0, .m = 0.5
+    },
+    .deg_mode = true
+};
+
+void bench_evaluator(const bench_config_t *config)
+{
+    const int n = config->iterations;
+    double sum_tokenize = 0, sum_shunt = 0, sum_eval = 0, sum_cached = 0;
+    int measured = 0;
+
+    expression_cache_clear();
+
+    bench_section_begin("evaluator");
+    printf("\n    \"iterations\": %d,\n    \"expressions\": [", n);
+
+    for (int e = 0; e < config->corpus_count; e++) {
+        const char *expr = config->corpus[e];
+        token_t tokens[MAX_TOKENS];
+        rpn_queue_t rpn;
+        double result = 0.0;
+        uint64_t start;
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(expr);
+
+        int token_count = tokenize_expression(expr, tokens, MAX_TOKENS);
+        int err = token_count < 0 ? token_count : parse_tokens_to_rpn(tokens, token_count, &rpn);
+        if (err == 0) {
+            err = evaluate_rpn(&rpn, &bench_context, &result);
+        }
+        if (err < 0) {
+            printf(", \"error\": %d}", err);
+            continue;
+        }
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            bench_sink = tokenize_expression(expr, tokens, MAX_TOKENS);
+        }
+        double tokenize_ns = (double)(bench_now_ns() - start) / n;
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            bench_sink = parse_tokens_to_rpn(tokens, token_count, &rpn);
+        }
+        double shunt_ns = (double)(bench_now_ns() - start) / n;
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            evaluate_rpn(&rpn, &bench_context, &result);
+            bench_sink = result;
+        }
+        double eval_ns = (double)(bench_now_ns() - start) / n;
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            evaluate_expression(expr, &bench_context, &result);
+            bench_sink = result;
+        }
+        double cached_ns = (double)(bench_now_ns() - start) / n;
+
+        // Same program after constant folding
+        rpn_queue_t folded = rpn;
+        double folded_result = 0.0;
+        int folded_tokens = optimize_rpn(&folded, bench_context.deg_mode);
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            evaluate_rpn(&folded, &bench_context, &folded_result);
+            bench_sink = folded_result;
+        }
+        double folded_ns = (double)(bench_now_ns() - start) / n;
+
+        double total_ns = tokenize_ns + shunt_ns + eval_ns;
+        printf(", \"result\": %.17g, \"tokens\": %d, \"rpn\": %d,"
+               " \"tokenize_ns\": %.1f, \"shunt_ns\": %.1f, \"eval_ns\": %.1f,"
+               " \"ns_per_eval\": %.1f, \"evals_per_sec\": %.0f, \"cached_ns\": %.1f,"
+               " \"folded_tokens\": %d, \"eval_folded_ns\": %.1f, \"folded_matches\": %s}",
+               result, token_count, rpn.count,
+               tokenize_ns, shunt_ns, eval_ns,
+               total_ns, 1e9 / total_ns, cached_ns,
+               folded_tokens, folded_ns, folded_result == result ? "true" : "false");
+
+        sum_tokenize += tokenize_ns;
+        sum_shunt += shunt_ns;
+        sum_eval += eval_ns;
+        sum_cached += cached_ns;
+        measured++;
+    }
+
+    printf("\n    ]");
+    if (measured > 0) {
+        double total = (sum_tokenize + sum_shunt + sum_eval) / measured;
+        expr_cache_stats_t stats;
+        expression_cache_get_stats(&stats);
+        printf(",\n    \"summary\": {\"measured\": %d, \"tokenize_ns\": %.1f, \"shunt_ns\": %.1f,"
+               " \"eval_ns\": %.1f, \"ns_per_eval\": %.1f, \"evals_per_sec\": %.0f,"
+               " \"cached_ns\": %.1f, \"cache_hits\": %u, \"cache_misses\": %u}",
+               measured, sum_tokenize / measured, sum_shunt / measured,
+               sum_eval / measured, total, 1e9 / total, sum_cached / measured,
+               stats.hits, stats.misses);
+    }
+    bench_section_end();
+}
@@ -0,0 +1,132 @@
+/*
+ * Host Benchmark - Factorial and gamma
+ *
+ * Integer factorials: the table lookup against the multiplication loop
+ * apply_function() used before, both timed over 0!..170! and checked
+ * against a long double product. Real arguments: sf_factorial() and
+ * sf_lgamma() against the long double libm gamma functions, with libm's
+ * double tgamma() timed alongside for scale. The lgamma error is
+ * relative where |lgamma| >= 1 and absolute below that.
+ */
+
+#include "bench.h"
+#include "special_functions.h"
+#include <math.h>
+#include <stdio.h>
+
+#define RANDOM_SAMPLES 100000
+#define TIMING_SAMPLES 1024
+
+// The loop FUNC_FACTORIAL used before the table
+static double factorial_loop(double n)
+{
+    if (n < 0 || n != floor(n) || n > SF_FACTORIAL_TABLE_MAX) {
+        return NAN;
+    }
+
+    double result = 1;
+    for (int i = 2; i <= (int)n; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+static double relative_error(double value, long double reference)
+{
+    return (double)(fabsl(value - reference) / fabsl(reference));
+}
+
+static double time_unary(double (*fn)(double), const double *inputs, int count, int reps)
+{
+    uint64_t start = bench_now_ns();
+
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < count; i++) {
+            bench_sink = fn(inputs[i]);
+        }
+    }
+    return (double)(bench_now_ns() - start) / ((double)reps * count);
+}
+
+void bench_factorial(const bench_config_t *config)
+{
+    const int reps = config->iterations / 100 > 0 ? config->iterations / 100 : 1;
+    double integers[SF_FACTORIAL_TABLE_MAX + 1];
+    double reals[TIMING_SAMPLES];
+    double loop_max = 0.0, table_max = 0.0;
+    long double exact = 1.0L;
+
+    bench_section_begin("factorial");
+
+    for (int n = 0; n <= SF_FACTORIAL_TABLE_MAX; n++) {
+        if (n > 1) {
+            exact *= n;
+        }
+        integers[n] = n;
+        loop_max = fmax(loop_max, relative_error(factorial_loop(n), exact));
+        table_max = fmax(table_max, relative_error(sf_factorial(n), exact));
+    }
+
+    double loop_ns = time_unary(factorial_loop, integers, SF_FACTORIAL_TABLE_MAX + 1, reps);
+    double table_ns = time_unary(sf_factorial, integers, SF_FACTORIAL_TABLE_MAX + 1, reps);
+
+    printf("\n    \"integer\": {\"range\": [0, %d], \"loop_ns\": %.2f, \"table_ns\": %.2f,"
+           " \"speedup\": %.1f, \"loop_max_rel_error\": %.3e, \"table_max_rel_error\": %.3e},",
+           SF_FACTORIAL_TABLE_MAX, loop_ns, table_ns, loop_ns / table_ns, loop_max, table_max);
+
+    // x! for real x in [-20, 170]; skip the poles at the negative integers
+    double gamma_max = 0.0, gamma_worst = 0.0, gamma_sum = 0.0;
+    int gamma_samples = 0;
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        double x = -20.0 + rng_uniform() * 190.0;
+        if (x < 0 && fabs(x - nearbyint(x)) < 1e-6) {
+            continue;
+        }
+        // x! is Gamma at the rounded x + 1, so the reference uses that too
+        double error = relative_error(sf_factorial(x), tgammal((long double)(x + 1.0)));
+        gamma_sum += error;
+        gamma_samples++;
+        if (error > gamma_max) {
+            gamma_max = error;
+            gamma_worst = x;
+        }
+    }
+
+    double lgamma_max = 0.0, lgamma_worst = 0.0;
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        double x = pow(10.0, -3.0 + rng_uniform() * 9.0);
+        long double reference = lgammal((long double)x);
+        // Absolute below 1, where the zeros at 1 and 2 make relative error meaningless
+        double error = (double)(fabsl(sf_lgamma(x) - reference) / fmaxl(fabsl(reference), 1.0L));
+        if (error > lgamma_max) {
+            lgamma_max = error;
+            lgamma_worst = x;
+        }
+    }
+
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        reals[i] = 0.5 + rng_uniform() * 169.0;
+    }
+    double gamma_ns = time_unary(sf_gamma, reals, TIMING_SAMPLES, reps / 10 + 1);
+    double libm_ns = time_unary(tgamma, reals, TIMING_SAMPLES, reps / 10 + 1);
+
+    printf("\n    \"real\": {\"range\": [-20, 170], \"samples\": %d, \"max_rel_error\": %.3e,"
+           " \"worst_x\": %.17g, \"mean_rel_error\": %.3e,"
+           "\n             \"gamma_ns\": %.2f, \"libm_tgamma_ns\": %.2f},",
+           gamma_samples, gamma_max, gamma_worst, gamma_sum / gamma_samples, gamma_ns, libm_ns);
+    printf("\n    \"lgamma\": {\"range\": [1e-3, 1e6], \"max_error\": %.3e, \"worst_x\": %.17g}",
+           lgamma_max, lgamma_worst);
+
+    bench_section_end();
+}
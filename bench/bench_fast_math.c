@@ -0,0 +1,265 @@
+/*
+ * Host Benchmark - Fast math kernels
+ *
+ * Compares the fast_math.c kernels with libm on cost per call and on
+ * accuracy. Inputs are drawn from each function's full domain with a
+ * fixed-seed generator (log-uniform magnitudes where the domain spans
+ * many decades), and both results are measured in double ULPs against
+ * the long double libm result.
+ *
+ * Cycles come from the time stamp counter on x86 and are omitted on
+ * other hosts; ns per call is always reported.
+ */
+
+#include "bench.h"
+#include "fast_math.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define ACCURACY_SAMPLES 200000
+#define TIMING_SAMPLES   1024
+
+typedef enum {
+    DIST_UNIFORM,       // lo..hi
+    DIST_LOG,           // 10^lo..10^hi
+    DIST_LOG_SIGNED,    // +/-(10^lo..10^hi)
+} input_dist_t;
+
+typedef struct {
+    const char *name;
+    double (*fast_fn)(double);
+    double (*libm_fn)(double);
+    long double (*reference_fn)(long double);
+    input_dist_t dist;
+    double lo, hi;
+} unary_case_t;
+
+static const unary_case_t unary_cases[] = {
+    {"sin",   fm_sin,   sin,   sinl,   DIST_UNIFORM,    -6.3, 6.3},
+    {"sin(large)", fm_sin, sin, sinl,  DIST_LOG_SIGNED, 0.0, 5.9},
+    {"cos",   fm_cos,   cos,   cosl,   DIST_UNIFORM,    -6.3, 6.3},
+    {"cos(large)", fm_cos, cos, cosl,  DIST_LOG_SIGNED, 0.0, 5.9},
+    {"tan",   fm_tan,   tan,   tanl,   DIST_UNIFORM,    -6.3, 6.3},
+    {"tan(large)", fm_tan, tan, tanl,  DIST_LOG_SIGNED, 0.0, 5.9},
+    {"asin",  fm_asin,  asin,  asinl,  DIST_UNIFORM,    -1.0, 1.0},
+    {"acos",  fm_acos,  acos,  acosl,  DIST_UNIFORM,    -1.0, 1.0},
+    {"atan",  fm_atan,  atan,  atanl,  DIST_LOG_SIGNED, -10.0, 10.0},
+    {"exp",   fm_exp,   exp,   expl,   DIST_UNIFORM,    -745.0, 709.7},
+    {"ln",    fm_log,   log,   logl,   DIST_LOG,        -307.0, 308.0},
+    {"ln(near 1)", fm_log, log, logl,  DIST_UNIFORM,    0.7, 1.4},
+    {"log",   fm_log10, log10, log10l, DIST_LOG,        -307.0, 308.0},
+    {"sinh",  fm_sinh,  sinh,  sinhl,  DIST_UNIFORM,    -710.47, 710.47},
+    {"sinh(small)", fm_sinh, sinh, sinhl, DIST_UNIFORM, -2.0, 2.0},
+    {"cosh",  fm_cosh,  cosh,  coshl,  DIST_UNIFORM,    -710.47, 710.47},
+    {"tanh",  fm_tanh,  tanh,  tanhl,  DIST_UNIFORM,    -20.0, 20.0},
+};
+
+typedef struct {
+    double max_ulps;
+    double worst_x;
+    double sum_ulps;
+    int samples;
+} ulp_stats_t;
+
+static uint64_t rng_state;
+
+// xorshift64*, fixed seed so runs are comparable
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+static double sample_input(input_dist_t dist, double lo, double hi)
+{
+    double t = rng_uniform();
+
+    switch (dist) {
+        case DIST_LOG:
+            return pow(10.0, lo + t * (hi - lo));
+        case DIST_LOG_SIGNED:
+            return (rng_uniform() < 0.5 ? -1.0 : 1.0) * pow(10.0, lo + t * (hi - lo));
+        default:
+            return lo + t * (hi - lo);
+    }
+}
+
+static uint64_t read_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Error of value in ULPs of the correctly rounded double reference
+static double ulp_error(double value, long double reference)
+{
+    double rounded = (double)reference;
+
+    if (isnan(value) || isnan(rounded)) {
+        return isnan(value) == isnan(rounded) ? 0.0 : INFINITY;
+    }
+    if (isinf(rounded) || isinf(value)) {
+        return value == rounded ? 0.0 : INFINITY;
+    }
+
+    double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+    if (fabs(rounded) < DBL_MIN) {
+        ulp = 0x1p-1074;   // Subnormal results are graded in absolute ULPs
+    }
+    return (double)(fabsl((long double)value - reference) / ulp);
+}
+
+static void record(ulp_stats_t *stats, double ulps, double x)
+{
+    if (ulps > stats->max_ulps) {
+        stats->max_ulps = ulps;
+        stats->worst_x = x;
+    }
+    if (isfinite(ulps)) {
+        stats->sum_ulps += ulps;
+        stats->samples++;
+    }
+}
+
+static void print_stats(const char *label, const ulp_stats_t *stats)
+{
+    printf("\"%s\": {\"max_ulps\": %.3f, \"mean_ulps\": %.4f, \"worst_x\": %.17g}",
+           label, stats->max_ulps,
+           stats->samples ? stats->sum_ulps / stats->samples : 0.0, stats->worst_x);
+}
+
+static void print_timing(const char *label, uint64_t ns, uint64_t cycles, long calls)
+{
+    printf("\"%s\": {\"ns\": %.2f", label, (double)ns / calls);
+#ifdef BENCH_HAVE_TSC
+    printf(", \"cycles\": %.1f", (double)cycles / calls);
+#else
+    (void)cycles;
+#endif
+    printf("}");
+}
+
+static void bench_unary(const unary_case_t *c, int reps, bool first)
+{
+    ulp_stats_t fast = {0}, libm = {0};
+    double inputs[TIMING_SAMPLES];
+
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < ACCURACY_SAMPLES; i++) {
+        double x = sample_input(c->dist, c->lo, c->hi);
+        long double reference = c->reference_fn(x);
+        record(&fast, ulp_error(c->fast_fn(x), reference), x);
+        record(&libm, ulp_error(c->libm_fn(x), reference), x);
+    }
+
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        inputs[i] = sample_input(c->dist, c->lo, c->hi);
+    }
+
+    uint64_t t0 = bench_now_ns(), c0 = read_cycles();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            bench_sink = c->libm_fn(inputs[i]);
+        }
+    }
+    uint64_t libm_ns = bench_now_ns() - t0, libm_cycles = read_cycles() - c0;
+
+    t0 = bench_now_ns();
+    c0 = read_cycles();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            bench_sink = c->fast_fn(inputs[i]);
+        }
+    }
+    uint64_t fast_ns = bench_now_ns() - t0, fast_cycles = read_cycles() - c0;
+
+    long calls = (long)reps * TIMING_SAMPLES;
+    printf("%s\n      {\"function\": ", first ? "" : ",");
+    bench_json_string(c->name);
+    printf(", \"domain\": [%g, %g], ", c->lo, c->hi);
+    print_timing("libm_time", libm_ns, libm_cycles, calls);
+    printf(", ");
+    print_timing("fast_time", fast_ns, fast_cycles, calls);
+    printf(", \"speedup\": %.2f,\n       ", (double)libm_ns / fast_ns);
+    print_stats("libm_error", &libm);
+    printf(", ");
+    print_stats("fast_error", &fast);
+    printf("}");
+}
+
+// pow takes x log-uniform in [1e-10, 1e10] and y uniform in [-30, 30]
+static void bench_pow(int reps)
+{
+    ulp_stats_t fast = {0}, libm = {0};
+    double xs[TIMING_SAMPLES], ys[TIMING_SAMPLES];
+
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < ACCURACY_SAMPLES; i++) {
+        double x = sample_input(DIST_LOG, -10.0, 10.0);
+        double y = sample_input(DIST_UNIFORM, -30.0, 30.0);
+        long double reference = powl(x, y);
+        record(&fast, ulp_error(fm_pow(x, y), reference), x);
+        record(&libm, ulp_error(pow(x, y), reference), x);
+    }
+
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        xs[i] = sample_input(DIST_LOG, -10.0, 10.0);
+        ys[i] = sample_input(DIST_UNIFORM, -30.0, 30.0);
+    }
+
+    uint64_t t0 = bench_now_ns(), c0 = read_cycles();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            bench_sink = pow(xs[i], ys[i]);
+        }
+    }
+    uint64_t libm_ns = bench_now_ns() - t0, libm_cycles = read_cycles() - c0;
+
+    t0 = bench_now_ns();
+    c0 = read_cycles();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TIMING_SAMPLES; i++) {
+            bench_sink = fm_pow(xs[i], ys[i]);
+        }
+    }
+    uint64_t fast_ns = bench_now_ns() - t0, fast_cycles = read_cycles() - c0;
+
+    long calls = (long)reps * TIMING_SAMPLES;
+    printf(",\n      {\"function\": \"^\", \"domain\": [1e-10, 1e10], ");
+    print_timing("libm_time", libm_ns, libm_cycles, calls);
+    printf(", ");
+    print_timing("fast_time", fast_ns, fast_cycles, calls);
+    printf(", \"speedup\": %.2f,\n       ", (double)libm_ns / fast_ns);
+    print_stats("libm_error", &libm);
+    printf(", ");
+    print_stats("fast_error", &fast);
+    printf("}");
+}
+
+void bench_fast_math(const bench_config_t *config)
+{
+    const int reps = config->iterations / 200 > 0 ? config->iterations / 200 : 1;
+
+    bench_section_begin("fast_math");
+    printf("\n    \"accuracy_samples\": %d, \"timing_calls\": %ld,\n    \"functions\": [",
+           ACCURACY_SAMPLES, (long)reps * TIMING_SAMPLES);
+
+    for (size_t f = 0; f < sizeof(unary_cases) / sizeof(unary_cases[0]); f++) {
+        bench_unary(&unary_cases[f], reps, f == 0);
+    }
+    bench_pow(reps);
+
+    printf("\n    ]");
+    bench_section_end();
+}
@@ -0,0 +1,71 @@
+/*
+ * Host Benchmark - Numerical integration
+ *
+ * Runs integrate_expression() with the default tolerance and budget on
+ * a suite of definite integrals with known values: smooth, oscillatory,
+ * and singular or non-smooth at an endpoint. Reports the rule used, the
+ * integrand evaluations spent, the error against the exact value and the
+ * integrand throughput (evaluations per second of integration time).
+ */
+
+#include "bench.h"
+#include "integration.h"
+#include <math.h>
+#include <stdio.h>
+
+#define PI 3.14159265358979323846
+
+typedef struct {
+    const char *expression;
+    double a, b;
+    double exact;
+} integral_case_t;
+
+static const integral_case_t integral_suite[] = {
+    { "X^2",                0.0, 1.0,               1.0 / 3.0 },
+    { "sin(X)",             0.0, PI,              2.0 },
+    { "exp(-(X^2))",         0.0, 1.0,               0.74682413281242702540 },
+    { "1/(1+X^2)",          0.0, 1.0,               PI / 4.0 },
+    { "sin(20*X)^2",        0.0, PI,              PI / 2.0 },
+    { "exp(X)*cos(5*X)",    0.0, 2.0,               -1.0499599667762327 },
+    { "sqrt(X)",            0.0, 1.0,               2.0 / 3.0 },
+    { "sqrt(1-X^2)",        -1.0, 1.0,              PI / 2.0 },
+    { "1/sqrt(X)",          0.0, 1.0,               2.0 },
+    { "ln(X)",              0.0, 1.0,               -1.0 },
+    { "ln(X)/sqrt(X)",      0.0, 1.0,               -4.0 },
+    { "1/sqrt(1-X^2)",      -1.0, 1.0,              PI },
+};
+
+#define SUITE_SIZE (int)(sizeof(integral_suite) / sizeof(integral_suite[0]))
+
+void bench_integration(const bench_config_t *config)
+{
+    const int reps = config->iterations / 1000 > 0 ? config->iterations / 1000 : 1;
+    eval_context_t context = { .deg_mode = false };
+
+    bench_section_begin("integration");
+
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        const integral_case_t *c = &integral_suite[i];
+        integration_result_t result;
+        int status = 0;
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            status = integrate_expression(c->expression, &context, c->a, c->b, NULL, &result);
+        }
+        double ns = (double)(bench_now_ns() - start) / reps;
+
+        printf("%s\n    ", i == 0 ? "" : ",");
+        bench_json_string(c->expression);
+        printf(": {\"status\": %d, \"method\": \"%s\", \"value\": %.17g, \"abs_error\": %.3e,"
+               " \"error_estimate\": %.3e,\n      \"evaluations\": %d, \"subdivisions\": %d,"
+               " \"us\": %.1f, \"evals_per_sec\": %.0f}",
+               status, result.method == INTEGRATION_TANH_SINH ? "tanh_sinh" : "gauss_kronrod",
+               result.value, fabs(result.value - c->exact), result.error_estimate,
+               result.evaluations, result.subdivisions, ns / 1000.0,
+               result.evaluations / (ns * 1e-9));
+    }
+
+    bench_section_end();
+}
@@ -0,0 +1,300 @@
+/*
+ * Host Benchmark - Identifier lexer
+ *
+ * Compares tokenize_expression() against a frozen copy of the previous
+ * tokenizer, which scanned the function, constant and variable tables
+ * with strlen/strncmp at every position. The expressions are close to
+ * the 128-byte input buffer limit.
+ */
+
+#include "bench.h"
+#include "expression_evaluator.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#ifndef M_E
+#define M_E 2.7182818284590452354
+#endif
+
+#define LOG_ERR(...) do { } while (0)
+
+/* ---- Baseline tokenizer (pattern-table scan), kept for comparison ---- */
+
+// Function name patterns for parsing
+static const struct {
+    const char* pattern;
+    function_type_t type;
+} function_patterns[] = {
+    {"sin⁻¹", FUNC_ASIN}, {"cos⁻¹", FUNC_ACOS}, {"tan⁻¹", FUNC_ATAN},
+    {"sin", FUNC_SIN}, {"cos", FUNC_COS}, {"tan", FUNC_TAN},
+    {"sinh", FUNC_SINH}, {"cosh", FUNC_COSH}, {"tanh", FUNC_TANH},
+    {"log", FUNC_LOG}, {"ln", FUNC_LN}, {"log10", FUNC_LOG10},
+    {"sqrt", FUNC_SQRT}, {"abs", FUNC_ABS}, {"exp", FUNC_EXP}
+};
+// Constant patterns
+static const struct {
+    const char* pattern;
+    constant_type_t type;
+    double value;
+} constant_patterns[] = {
+    {"π", CONST_PI, M_PI},
+    {"pi", CONST_PI, M_PI},
+    {"e", CONST_E, M_E}
+};
+// Variable patterns
+static const struct {
+    const char* pattern;
+    variable_type_t type;
+} variable_patterns[] = {
+    {"Ans", VAR_ANS},
+    {"X", VAR_X}, {"Y", VAR_Y},
+    {"A", VAR_A}, {"B", VAR_B}, {"C", VAR_C}, {"D", VAR_D},
+    {"M", VAR_M}
+};
+
+// Tokenizer helper functions
+static int skip_whitespace(const char *expr, int pos)
+{
+    while (expr[pos] && isspace(expr[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+static int parse_number(const char *expr, int pos, double *number)
+{
+    char *endptr;
+    *number = strtod(&expr[pos], &endptr);
+    return endptr - expr;
+}
+
+static int parse_function(const char *expr, int pos, function_type_t *function)
+{
+    for (size_t i = 0; i < sizeof(function_patterns) / sizeof(function_patterns[0]); i++) {
+        int len = strlen(function_patterns[i].pattern);
+        if (strncmp(&expr[pos], function_patterns[i].pattern, len) == 0) {
+            *function = function_patterns[i].type;
+            return pos + len;
+        }
+    }
+    return -1; // Not found
+}
+
+static int parse_constant(const char *expr, int pos, constant_type_t *constant)
+{
+    for (size_t i = 0; i < sizeof(constant_patterns) / sizeof(constant_patterns[0]); i++) {
+        int len = strlen(constant_patterns[i].pattern);
+        if (strncmp(&expr[pos], constant_patterns[i].pattern, len) == 0) {
+            *constant = constant_patterns[i].type;
+            return pos + len;
+        }
+    }
+    return -1; // Not found
+}
+
+static int parse_variable(const char *expr, int pos, variable_type_t *variable)
+{
+    for (size_t i = 0; i < sizeof(variable_patterns) / sizeof(variable_patterns[0]); i++) {
+        int len = strlen(variable_patterns[i].pattern);
+        if (strncmp(&expr[pos], variable_patterns[i].pattern, len) == 0) {
+            *variable = variable_patterns[i].type;
+            return pos + len;
+        }
+    }
+    return -1; // Not found
+}
+
+// Tokenize expression into tokens (baseline)
+static int legacy_tokenize_expression(const char *expression, token_t *tokens, int max_tokens)
+{
+    int pos = 0;
+    int token_count = 0;
+    int len = strlen(expression);
+    bool expect_number = true; // Expect number or unary operator at start
+    
+    while (pos < len && token_count < max_tokens - 1) {
+        pos = skip_whitespace(expression, pos);
+        if (pos >= len) break;
+        
+        char ch = expression[pos];
+        
+        // Numbers
+        if (isdigit(ch) || ch == '.') {
+            double number;
+            int new_pos = parse_number(expression, pos, &number);
+            if (new_pos > pos) {
+                tokens[token_count].type = TOKEN_NUMBER;
+                tokens[token_count].value.number = number;
+                token_count++;
+                pos = new_pos;
+                expect_number = false;
+                continue;
+            }
+        }
+        
+        // Functions
+        function_type_t function;
+        int func_pos = parse_function(expression, pos, &function);
+        if (func_pos > 0) {
+            tokens[token_count].type = TOKEN_FUNCTION;
+            tokens[token_count].value.function = function;
+            token_count++;
+            pos = func_pos;
+            expect_number = true;
+            continue;
+        }
+        
+        // Constants
+        constant_type_t constant;
+        int const_pos = parse_constant(expression, pos, &constant);
+        if (const_pos > 0) {
+            tokens[token_count].type = TOKEN_CONSTANT;
+            tokens[token_count].value.constant = constant;
+            token_count++;
+            pos = const_pos;
+            expect_number = false;
+            continue;
+        }
+        
+        // Variables
+        variable_type_t variable;
+        int var_pos = parse_variable(expression, pos, &variable);
+        if (var_pos > 0) {
+            tokens[token_count].type = TOKEN_VARIABLE;
+            tokens[token_count].value.variable = variable;
+            token_count++;
+            pos = var_pos;
+            expect_number = false;
+            continue;
+        }
+        
+        // Operators and parentheses
+        switch (ch) {
+            case '+':
+            case '*':
+            case '/':
+            case '^':
+                if (expect_number && ch != '-') {
+                    return ERR_SYNTAX_ERROR;
+                }
+                tokens[token_count].type = TOKEN_OPERATOR;
+                tokens[token_count].value.operator = ch;
+                token_count++;
+                pos++;
+                expect_number = true;
+                break;
+                
+            case '-':
+                if (expect_number) {
+                    // Unary minus
+                    tokens[token_count].type = TOKEN_UNARY_MINUS;
+                    token_count++;
+                } else {
+                    // Binary minus
+                    tokens[token_count].type = TOKEN_OPERATOR;
+                    tokens[token_count].value.operator = ch;
+                    token_count++;
+                }
+                pos++;
+                expect_number = true;
+                break;
+                
+            case '(':
+                tokens[token_count].type = TOKEN_LEFT_PAREN;
+                token_count++;
+                pos++;
+                expect_number = true;
+                break;
+                
+            case ')':
+                if (expect_number) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                tokens[token_count].type = TOKEN_RIGHT_PAREN;
+                token_count++;
+                pos++;
+                expect_number = false;
+                break;
+                
+            case '!':
+                // Factorial operator (postfix)
+                if (expect_number) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                tokens[token_count].type = TOKEN_FUNCTION;
+                tokens[token_count].value.function = FUNC_FACTORIAL;
+                token_count++;
+                pos++;
+                expect_number = false;
+                break;
+                
+            default:
+                LOG_ERR("Unknown character: %c at position %d", ch, pos);
+                return ERR_SYNTAX_ERROR;
+        }
+    }
+    
+    // Add end marker
+    tokens[token_count].type = TOKEN_END;
+    return token_count;
+}
+
+/* ---- Benchmark ---- */
+
+static const char *lexer_corpus[] = {
+    // Names both tokenizers accept
+    "sin(X)+cos(X)-tan(X)+log(Ans)*sqrt(A)+abs(B)-exp(C)+ln(D)*sin⁻¹(0.5)+cos⁻¹(M)+tan⁻¹(Y)+π*e-pi",
+    "sqrt(Ans*Ans+X*X)+sqrt(Y*Y+A*A)+sqrt(B*B+C*C)+sqrt(D*D+M*M)+abs(X-Y)+abs(A-B)",
+    // Names only the longest-match lexer reaches (sinh, log10)
+    "sinh(X)+cosh(X)-tanh(X)+log10(Ans)*sqrt(A)+abs(B)-exp(C)+ln(D)+sin⁻¹(0.5)+asin(0.5)+π",
+};
+
+void bench_lexer(const bench_config_t *config)
+{
+    const int n = config->iterations;
+
+    bench_section_begin("lexer");
+    printf("\n    \"iterations\": %d,\n    \"expressions\": [", n);
+
+    for (size_t e = 0; e < sizeof(lexer_corpus) / sizeof(lexer_corpus[0]); e++) {
+        const char *expr = lexer_corpus[e];
+        token_t tokens[MAX_TOKENS];
+        uint64_t start;
+
+        int new_count = tokenize_expression(expr, tokens, MAX_TOKENS);
+        int legacy_count = legacy_tokenize_expression(expr, tokens, MAX_TOKENS);
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            bench_sink = legacy_tokenize_expression(expr, tokens, MAX_TOKENS);
+        }
+        double legacy_ns = (double)(bench_now_ns() - start) / n;
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            bench_sink = tokenize_expression(expr, tokens, MAX_TOKENS);
+        }
+        double new_ns = (double)(bench_now_ns() - start) / n;
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(expr);
+        printf(", \"bytes\": %zu, \"tokens\": %d, \"legacy_tokens\": %d,"
+               " \"legacy_ns\": %.1f, \"lexer_ns\": %.1f",
+               strlen(expr), new_count, legacy_count, legacy_ns, new_ns);
+        // A baseline that stopped at a syntax error did not do comparable work
+        if (legacy_count >= 0) {
+            printf(", \"speedup\": %.2f}", legacy_ns / new_ns);
+        } else {
+            printf(", \"speedup\": null}");
+        }
+    }
+
+    printf("\n    ]");
+    bench_section_end();
+}
@@ -0,0 +1,148 @@
+/*
+ * Host Benchmark Runner
+ *
+ * Runs every benchmark section over a corpus of representative
+ * expressions and prints the results as one JSON document on stdout.
+ *
+ * Usage: evaluator_bench [corpus.txt] [-n iterations]
+ *   corpus.txt  One expression per line (default: built-in corpus)
+ *   -n          Repetitions per measurement (default: 20000)
+ */
+
+#include "bench.h"
+#include "eval_numeric.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 20000
+
+volatile double bench_sink;
+
+static bool first_section = true;
+
+// Built-in corpus: nested parens, DEG-mode trig, factorials, variables
+static const char *default_corpus[] = {
+    "1+2*3-4/5",
+    "((1+2)*(3+4))/((5-6)*(7+8))",
+    "sin(30)+cos(60)*tan(45)",
+    "2^10-sqrt(2)*π",
+    "10!/(3!*7!)",
+    "X^2-3*X+2",
+    "Ans*X+A*B-C/D",
+    "ln(e^2)+log(1000)",
+    "abs(-5.5)*exp(1)",
+    "sqrt(sqrt(sqrt(256)))+((((X))))",
+    "2*π*sqrt(2)*X",
+};
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void bench_section_begin(const char *name)
+{
+    printf("%s\n  ", first_section ? "" : ",");
+    bench_json_string(name);
+    printf(": {");
+    first_section = false;
+}
+
+void bench_section_end(void)
+{
+    printf("\n  }");
+}
+
+void bench_json_string(const char *str)
+{
+    putchar('"');
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            putchar('\\');
+            putchar(*str);
+        } else if ((unsigned char)*str < 0x20) {
+            printf("\\u%04x", (unsigned char)*str);
+        } else {
+            putchar(*str);
+        }
+    }
+    putchar('"');
+}
+
+// Load one expression per line; blank lines and '#' comments are skipped
+static int load_corpus(const char *path, bench_config_t *config)
+{
+    static char lines[BENCH_MAX_CORPUS][256];
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    config->corpus_count = 0;
+    while (config->corpus_count < BENCH_MAX_CORPUS &&
+           fgets(lines[config->corpus_count], sizeof(lines[0]), file)) {
+        char *line = lines[config->corpus_count];
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        config->corpus[config->corpus_count++] = line;
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench_config_t config = { .iterations = DEFAULT_ITERATIONS };
+
+    for (size_t i = 0; i < sizeof(default_corpus) / sizeof(default_corpus[0]); i++) {
+        config.corpus[config.corpus_count++] = default_corpus[i];
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.iterations = atoi(argv[++i]);
+        } else if (load_corpus(argv[i], &config) != 0) {
+            fprintf(stderr, "Cannot read corpus file: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (config.iterations <= 0 || config.corpus_count == 0) {
+        fprintf(stderr, "Nothing to run\n");
+        return 1;
+    }
+
+    printf("{\n  \"numeric_type\": \"%s\",", EVAL_NUM_NAME);
+    bench_evaluator(&config);
+    bench_batch(&config);
+    bench_lexer(&config);
+    bench_vm(&config);
+    bench_precision(&config);
+    bench_fast_math(&config);
+    bench_degree_trig(&config);
+    bench_factorial(&config);
+    bench_integration(&config);
+    bench_differentiation(&config);
+    bench_autodiff(&config);
+    bench_solver(&config);
+    bench_table(&config);
+    bench_statistics(&config);
+    bench_regression(&config);
+    bench_quantiles(&config);
+    bench_distributions(&config);
+    bench_matrix(&config);
+    bench_eigen(&config);
+    bench_vector(&config);
+    bench_complex(&config);
+    bench_base_n(&config);
+    bench_polynomial(&config);
+    printf("\n}\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Host Benchmark - Matrices
+ *
+ * Operations per second of add, multiply, transpose, determinant and
+ * inverse for each square size from 2x2 to MATRIX_MAX_DIM, over a set of
+ * random matrices made well conditioned by a dominant diagonal. 2x2 to
+ * 4x4 run the unrolled kernels and the larger sizes the run-time sized
+ * one. The determinant is checked against a long double LU of the same
+ * matrix, and the inverse by the largest element of A A^-1 - I.
+ */
+
+#include "bench.h"
+#include "matrix.h"
+#include <math.h>
+#include <stdio.h>
+
+#define MATRIX_SET 64
+
+static matrix_t inputs[MATRIX_SET];
+static matrix_t result;
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+// Entries in [-1, 1] with n added to the diagonal
+static void fill_inputs(int n)
+{
+    for (int m = 0; m < MATRIX_SET; m++) {
+        matrix_init(&inputs[m], n, n);
+        for (int i = 0; i < n * n; i++) {
+            inputs[m].data[i] = 2.0 * rng_uniform() - 1.0;
+        }
+        for (int i = 0; i < n; i++) {
+            inputs[m].data[i * n + i] += n;
+        }
+    }
+}
+
+// Determinant by long double Gaussian elimination with partial pivoting
+static long double reference_determinant(const matrix_t *a)
+{
+    int n = a->rows;
+    long double lu[MATRIX_MAX_DIM][MATRIX_MAX_DIM];
+    long double det = 1.0L;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            lu[i][j] = a->data[i * n + j];
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        int p = k;
+        for (int i = k + 1; i < n; i++) {
+            if (fabsl(lu[i][k]) > fabsl(lu[p][k])) {
+                p = i;
+            }
+        }
+        if (p != k) {
+            for (int j = 0; j < n; j++) {
+                long double t = lu[k][j];
+                lu[k][j] = lu[p][j];
+                lu[p][j] = t;
+            }
+            det = -det;
+        }
+        det *= lu[k][k];
+        for (int i = k + 1; i < n; i++) {
+            long double l = lu[i][k] / lu[k][k];
+            for (int j = k + 1; j < n; j++) {
+                lu[i][j] -= l * lu[k][j];
+            }
+        }
+    }
+    return det;
+}
+
+typedef enum {
+    OP_ADD,
+    OP_MULTIPLY,
+    OP_TRANSPOSE,
+    OP_DETERMINANT,
+    OP_INVERSE,
+    OP_COUNT
+} matrix_op_t;
+
+static const char *const op_names[OP_COUNT] = {
+    "add", "multiply", "transpose", "determinant", "inverse",
+};
+
+static void run_op(matrix_op_t op, int m)
+{
+    const matrix_t *a = &inputs[m];
+    const matrix_t *b = &inputs[(m + 1) % MATRIX_SET];
+    double det;
+
+    switch (op) {
+        case OP_ADD: matrix_add(a, b, &result); break;
+        case OP_MULTIPLY: matrix_multiply(a, b, &result); break;
+        case OP_TRANSPOSE: matrix_transpose(a, &result); break;
+        case OP_DETERMINANT:
+            matrix_determinant(a, &det);
+            result.data[0] = det;
+            break;
+        default: matrix_inverse(a, &result); break;
+    }
+}
+
+static void print_size(int n, int reps)
+{
+    fill_inputs(n);
+
+    // Accuracy over the whole set
+    double det_error = 0.0;
+    double inverse_residual = 0.0;
+    for (int m = 0; m < MATRIX_SET; m++) {
+        double det;
+        matrix_determinant(&inputs[m], &det);
+        long double reference = reference_determinant(&inputs[m]);
+        double error = (double)(fabsl(det - reference) / fabsl(reference));
+        det_error = error > det_error ? error : det_error;
+
+        matrix_t inverse, product;
+        matrix_inverse(&inputs[m], &inverse);
+        matrix_multiply(&inputs[m], &inverse, &product);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                double residual = fabs(matrix_get(&product, i, j) - (i == j ? 1.0 : 0.0));
+                inverse_residual = residual > inverse_residual ? residual : inverse_residual;
+            }
+        }
+    }
+
+    printf("%s\n      {\"n\": %d, \"ops_per_sec\": {", n > 2 ? "," : "", n);
+    for (int op = 0; op < OP_COUNT; op++) {
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int m = 0; m < MATRIX_SET; m++) {
+                run_op((matrix_op_t)op, m);
+            }
+        }
+        double ns = (double)(bench_now_ns() - start) / ((double)reps * MATRIX_SET);
+        bench_sink = result.data[0];
+        printf("%s\"%s\": %.0f", op ? ", " : "", op_names[op], 1e9 / ns);
+    }
+    printf("}, \"det_max_rel_error\": %.3e, \"inverse_max_residual\": %.3e}",
+           det_error, inverse_residual);
+}
+
+void bench_matrix(const bench_config_t *config)
+{
+    const int reps = config->iterations / 20 > 0 ? config->iterations / 20 : 1;
+
+    bench_section_begin("matrix");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    printf("\n    \"matrix_bytes\": %zu, \"sizes\": [", sizeof(matrix_t));
+    for (int n = 2; n <= MATRIX_MAX_DIM; n++) {
+        print_size(n, reps);
+    }
+    printf("\n    ]");
+
+    bench_section_end();
+}
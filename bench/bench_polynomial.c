@@ -0,0 +1,281 @@
+/*
+ * Host Benchmark - Polynomial equations
+ *
+ * For each degree from 2 to POLY_MAX_DEGREE, poly_solve() runs over a
+ * set of polynomials multiplied out from random roots in [-5, 5], real
+ * or in conjugate pairs. Every fourth has a double root, reported apart:
+ * a root of multiplicity k is only determined to about eps^(1/k). Each
+ * polynomial is timed as the best of a few runs; the section reports the
+ * mean and most Aberth iterations, the slowest call and, as for the
+ * eigen solvers, a bound that adds the time per iteration for every
+ * iteration POLY_MAX_ITERATIONS still allows. The root error is the
+ * distance to the nearest computed root over max(1, |root|).
+ *
+ * The quadratic and cubic closed forms are also checked on roots many
+ * decades apart, against the textbook formula and a long double
+ * reference.
+ */
+
+#include "bench.h"
+#include "polynomial.h"
+#include <math.h>
+#include <stdio.h>
+
+#define POLY_SET      256
+#define TIMING_RUNS   5
+#define TIMING_CALLS  8
+
+typedef struct {
+    double coeffs[POLY_MAX_DEGREE + 1];
+    complex_t roots[POLY_MAX_DEGREE];
+} poly_case_t;
+
+static poly_case_t cases[POLY_SET];
+static poly_roots_t solved;
+static double call_ns[POLY_SET];
+static int call_iterations[POLY_SET];
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+// Multiply the coefficients (highest first, degree d) by x^2 + bx + c
+static int multiply(double *coeffs, int d, double b, double c, bool quadratic)
+{
+    double out[POLY_MAX_DEGREE + 1] = { 0.0 };
+    for (int k = 0; k <= d; k++) {
+        out[k] += coeffs[k];
+        out[k + 1] += coeffs[k] * b;
+        if (quadratic) {
+            out[k + 2] += coeffs[k] * c;
+        }
+    }
+    d += quadratic ? 2 : 1;
+    for (int k = 0; k <= d; k++) {
+        coeffs[k] = out[k];
+    }
+    return d;
+}
+
+static void fill_cases(int n)
+{
+    for (int s = 0; s < POLY_SET; s++) {
+        poly_case_t *p = &cases[s];
+        int count = 0, d = 0;
+        p->coeffs[0] = 1.0;
+
+        while (count < n) {
+            double re = 10.0 * rng_uniform() - 5.0;
+            if (count + 2 <= n && rng_uniform() < 0.5) {
+                double im = 5.0 * rng_uniform() + 0.1;
+                p->roots[count++] = (complex_t){ re, im };
+                p->roots[count++] = (complex_t){ re, -im };
+                d = multiply(p->coeffs, d, -2.0 * re, re * re + im * im, true);
+            } else {
+                // The double root of every fourth case
+                if (s % 4 == 0 && count == 1 && p->roots[0].im == 0.0) {
+                    re = p->roots[0].re;
+                }
+                p->roots[count++] = (complex_t){ re, 0.0 };
+                d = multiply(p->coeffs, d, -re, 0.0, false);
+            }
+        }
+    }
+}
+
+static double root_error(const poly_case_t *p, int n)
+{
+    double worst = 0.0;
+    for (int i = 0; i < n; i++) {
+        double nearest = INFINITY;
+        for (int j = 0; j < n; j++) {
+            double d = hypot(solved.roots[j].re - p->roots[i].re,
+                             solved.roots[j].im - p->roots[i].im);
+            nearest = d < nearest ? d : nearest;
+        }
+        double error = nearest / fmax(1.0, complex_abs(p->roots[i]));
+        worst = error > worst ? error : worst;
+    }
+    return worst;
+}
+
+static void print_degree(int n)
+{
+    int failures = 0, max_iterations = 0;
+    long total_iterations = 0;
+    double worst_ns = 0.0, worst_error = 0.0, worst_double = 0.0;
+
+    fill_cases(n);
+    for (int s = 0; s < POLY_SET; s++) {
+        const poly_case_t *p = &cases[s];
+        if (poly_solve(p->coeffs, n, &solved) != 0) {
+            failures++;
+            call_iterations[s] = -1;
+            continue;
+        }
+        double error = root_error(p, n);
+        bool has_double = s % 4 == 0 && p->roots[0].im == 0.0 && p->roots[1].im == 0.0 &&
+                          p->roots[0].re == p->roots[1].re;
+        if (has_double) {
+            worst_double = error > worst_double ? error : worst_double;
+        } else {
+            worst_error = error > worst_error ? error : worst_error;
+        }
+
+        double best_ns = INFINITY;
+        for (int r = 0; r < TIMING_RUNS; r++) {
+            uint64_t start = bench_now_ns();
+            for (int c = 0; c < TIMING_CALLS; c++) {
+                poly_solve(p->coeffs, n, &solved);
+            }
+            double ns = (double)(bench_now_ns() - start) / TIMING_CALLS;
+            best_ns = ns < best_ns ? ns : best_ns;
+        }
+        bench_sink = solved.roots[0].re;
+
+        total_iterations += solved.iterations;
+        max_iterations = solved.iterations > max_iterations ? solved.iterations : max_iterations;
+        worst_ns = best_ns > worst_ns ? best_ns : worst_ns;
+        call_ns[s] = best_ns;
+        call_iterations[s] = solved.iterations;
+    }
+
+    // Time per iteration: the least-squares slope of time on iterations
+    double mean_ns = 0.0, mean_iterations = 0.0;
+    int timed = 0;
+    for (int s = 0; s < POLY_SET; s++) {
+        if (call_iterations[s] >= 0) {
+            mean_ns += call_ns[s];
+            mean_iterations += call_iterations[s];
+            timed++;
+        }
+    }
+    mean_ns /= timed;
+    mean_iterations /= timed;
+    double covariance = 0.0, variance = 0.0;
+    for (int s = 0; s < POLY_SET; s++) {
+        if (call_iterations[s] >= 0) {
+            double di = call_iterations[s] - mean_iterations;
+            covariance += di * (call_ns[s] - mean_ns);
+            variance += di * di;
+        }
+    }
+    double ns_per_iteration = variance > 0.0 ? covariance / variance : 0.0;
+
+    // The closed forms do not iterate, so their slowest call is the bound
+    double bound_ns = max_iterations > 0 ?
+                      worst_ns + (POLY_MAX_ITERATIONS - max_iterations) * ns_per_iteration : worst_ns;
+    printf("%s\n      {\"degree\": %d, \"mean_iterations\": %.2f, \"max_iterations\": %d,"
+           " \"failures\": %d, \"mean_ns\": %.0f, \"ns_per_iteration\": %.1f, \"worst_ns\": %.0f,"
+           " \"bound_ns\": %.0f, \"max_root_error\": %.3e, \"max_root_error_double\": %.3e}",
+           n > POLY_MIN_DEGREE ? "," : "", n, (double)total_iterations / POLY_SET, max_iterations,
+           failures, mean_ns, ns_per_iteration, worst_ns, bound_ns, worst_error, worst_double);
+}
+
+// Iterations for (x - 1)^n, the slowest case for Aberth
+static void print_multiple_roots(void)
+{
+    printf(",\n    \"multiple_root_iterations\": {");
+    for (int n = 4; n <= POLY_MAX_DEGREE; n++) {
+        double coeffs[POLY_MAX_DEGREE + 1] = { 1.0 };
+        for (int d = 0; d < n; d++) {
+            multiply(coeffs, d, -1.0, 0.0, false);
+        }
+        int status = poly_solve(coeffs, n, &solved);
+        printf("%s\"%d\": %d", n > 4 ? ", " : "", n, status == 0 ? solved.iterations : status);
+    }
+    printf("}");
+}
+
+// Smaller root of x^2 + bx + c, in long double with the stable formula
+static long double reference_small_root(double b, double c)
+{
+    long double disc = (long double)b * b - 4.0L * c;
+    long double q = -0.5L * ((long double)b + copysignl(sqrtl(disc), b));
+    return c / q;
+}
+
+// Newton steps in long double from a double root of a cubic
+static long double reference_cubic_root(const double *coeffs, double x)
+{
+    long double z = x;
+    for (int step = 0; step < 4; step++) {
+        long double p = coeffs[0], dp = 0.0L;
+        for (int k = 1; k <= 3; k++) {
+            dp = dp * z + p;
+            p = p * z + coeffs[k];
+        }
+        if (dp == 0.0L) {
+            break;
+        }
+        z -= p / dp;
+    }
+    return z;
+}
+
+static void print_closed_forms(void)
+{
+    double naive_error = 0.0, stable_error = 0.0, cubic_error = 0.0;
+
+    for (int s = 0; s < POLY_SET; s++) {
+        // Roots 1 and up to 1e12 apart
+        double big = pow(10.0, 12.0 * rng_uniform()) * (s % 2 ? 1.0 : -1.0);
+        double small = 2.0 * rng_uniform() - 1.0;
+        double b = -(big + small), c = big * small;
+        long double reference = reference_small_root(b, c);
+        complex_t roots[2];
+
+        // The textbook root with the smaller magnitude, which cancels
+        double disc = b * b - 4.0 * c;
+        double naive = b < 0.0 ? (-b - sqrt(disc)) / 2.0 : (-b + sqrt(disc)) / 2.0;
+        double error = (double)fabsl((naive - reference) / reference);
+        naive_error = error > naive_error ? error : naive_error;
+
+        poly_quadratic(1.0, b, c, roots);
+        double stable = fabs(roots[0].re) < fabs(roots[1].re) ? roots[0].re : roots[1].re;
+        error = (double)fabsl((stable - reference) / reference);
+        stable_error = error > stable_error ? error : stable_error;
+
+        // A cubic whose leading coefficient is up to 1e-12 of the rest
+        double coeffs[4] = { pow(10.0, -12.0 * rng_uniform()), 1.0, small, -2.0 };
+        complex_t cubic[3];
+        if (poly_cubic(coeffs[0], coeffs[1], coeffs[2], coeffs[3], cubic) == 0) {
+            for (int k = 0; k < 3; k++) {
+                if (cubic[k].im != 0.0) {
+                    continue;
+                }
+                long double x = reference_cubic_root(coeffs, cubic[k].re);
+                error = (double)fabsl((cubic[k].re - x) / x);
+                cubic_error = error > cubic_error ? error : cubic_error;
+            }
+        }
+    }
+
+    printf(",\n    \"closed_forms\": {\"quadratic_textbook_max_rel_error\": %.3e,"
+           " \"quadratic_max_rel_error\": %.3e, \"cubic_real_max_rel_error\": %.3e}",
+           naive_error, stable_error, cubic_error);
+}
+
+void bench_polynomial(const bench_config_t *config)
+{
+    (void)config;
+
+    bench_section_begin("polynomial");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    printf("\n    \"degrees\": [");
+    for (int n = POLY_MIN_DEGREE; n <= POLY_MAX_DEGREE; n++) {
+        print_degree(n);
+    }
+    printf("\n    ]");
+    print_multiple_roots();
+    print_closed_forms();
+
+    bench_section_end();
+}
@@ -0,0 +1,129 @@
+/*
+ * Host Benchmark - Evaluator accuracy
+ *
+ * Reports how accurate apply_function() is under the configured numeric
+ * backend. Build with -DEVAL_NUMERIC=float to measure the
+ * CONFIG_CALC_EVAL_FLOAT backend the single-precision boards use. Each
+ * function is sampled over its domain with eval_num_t inputs, through the
+ * same apply_function() call the evaluators make, including the degree
+ * mode paths, and compared against a long double reference on the same
+ * input.
+ *
+ * max_error is relative where |reference| >= 1 and absolute below that,
+ * so zeros of sin/tan/ln do not dominate. ULPs are in eval_num_t ULPs of
+ * the reference and skip samples with |reference| < ULP_MIN_MAGNITUDE.
+ */
+
+#include "bench.h"
+#include "expression_evaluator.h"
+#include <math.h>
+#include <stdio.h>
+
+#define PRECISION_SAMPLES 20000
+#define ULP_MIN_MAGNITUDE 1e-3
+
+#define PI_L 3.141592653589793238462643383279502884L
+
+// Degree arguments are reduced exactly before the conversion to radians
+static long double sin_deg_l(long double x) { return sinl(fmodl(x, 360.0L) * PI_L / 180.0L); }
+static long double tan_deg_l(long double x) { return tanl(fmodl(x, 180.0L) * PI_L / 180.0L); }
+static long double asin_deg_l(long double x) { return asinl(x) * 180.0L / PI_L; }
+
+static long double factorial_l(long double n)
+{
+    long double result = 1.0L;
+    for (int i = 2; i <= (int)n; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+static const struct {
+    const char *name;
+    function_type_t func;
+    bool deg_mode;
+    long double (*reference)(long double);
+    double lo, hi;
+    bool integer;
+} precision_cases[] = {
+    {"sin",      FUNC_SIN,   false, sinl,       -6.3, 6.3, false},
+    {"sin(deg)", FUNC_SIN,   true,  sin_deg_l,  -360.0, 360.0, false},
+    {"sin(deg,large)", FUNC_SIN, true, sin_deg_l, 1e4, 1e5, false},
+    {"cos",      FUNC_COS,   false, cosl,       -6.3, 6.3, false},
+    {"tan",      FUNC_TAN,   false, tanl,       -1.5, 1.5, false},
+    {"tan(deg)", FUNC_TAN,   true,  tan_deg_l,  -89.0, 89.0, false},
+    {"asin",     FUNC_ASIN,  false, asinl,      -1.0, 1.0, false},
+    {"asin(deg)", FUNC_ASIN, true,  asin_deg_l, -1.0, 1.0, false},
+    {"acos",     FUNC_ACOS,  false, acosl,      -1.0, 1.0, false},
+    {"atan",     FUNC_ATAN,  false, atanl,      -100.0, 100.0, false},
+    {"ln",       FUNC_LN,    false, logl,       1e-6, 1e6, false},
+    {"log",      FUNC_LOG,   false, log10l,     1e-6, 1e6, false},
+    {"sqrt",     FUNC_SQRT,  false, sqrtl,      0.0, 1e6, false},
+    {"exp",      FUNC_EXP,   false, expl,       -80.0, 80.0, false},
+    {"sinh",     FUNC_SINH,  false, sinhl,      -80.0, 80.0, false},
+    {"cosh",     FUNC_COSH,  false, coshl,      -80.0, 80.0, false},
+    {"tanh",     FUNC_TANH,  false, tanhl,      -10.0, 10.0, false},
+    {"!",        FUNC_FACTORIAL, false, factorial_l, 0.0, 34.0, true},
+};
+
+// Distance between a result and the reference in eval_num_t ULPs
+static double eval_ulps(eval_num_t value, long double reference)
+{
+    int exponent;
+    frexpl(reference, &exponent);
+    long double ulp = ldexpl(EVAL_NUM_EPSILON, exponent - 1);
+    return (double)(fabsl((long double)value - reference) / ulp);
+}
+
+void bench_precision(const bench_config_t *config)
+{
+    (void)config;
+
+    bench_section_begin("precision");
+    printf("\n    \"samples\": %d,\n    \"functions\": [", PRECISION_SAMPLES);
+
+    for (size_t f = 0; f < sizeof(precision_cases) / sizeof(precision_cases[0]); f++) {
+        double max_error = 0.0, max_ulps = 0.0, sum_ulps = 0.0, worst_x = 0.0;
+        int ulp_samples = 0;
+        int samples = precision_cases[f].integer ?
+                      (int)precision_cases[f].hi + 1 : PRECISION_SAMPLES;
+
+        for (int i = 0; i < samples; i++) {
+            double t = precision_cases[f].integer ? i : (double)i / (samples - 1);
+            eval_num_t x = (eval_num_t)(precision_cases[f].integer ? t :
+                                        precision_cases[f].lo +
+                                        t * (precision_cases[f].hi - precision_cases[f].lo));
+            eval_num_t value = apply_function(precision_cases[f].func, x,
+                                              precision_cases[f].deg_mode);
+            long double reference = precision_cases[f].reference((long double)x);
+
+            if (!isfinite(reference) || !isfinite(value)) {
+                continue;
+            }
+
+            double error = (double)(fabsl(value - reference) / fmaxl(fabsl(reference), 1.0L));
+            if (error > max_error) {
+                max_error = error;
+                worst_x = x;
+            }
+            if (fabsl(reference) >= ULP_MIN_MAGNITUDE) {
+                double ulps = eval_ulps(value, reference);
+                sum_ulps += ulps;
+                ulp_samples++;
+                if (ulps > max_ulps) {
+                    max_ulps = ulps;
+                }
+            }
+        }
+
+        printf("%s\n      {\"function\": ", f ? "," : "");
+        bench_json_string(precision_cases[f].name);
+        printf(", \"domain\": [%g, %g], \"max_error\": %.3e, \"worst_x\": %.9g,"
+               " \"max_ulps\": %.2f, \"mean_ulps\": %.3f}",
+               precision_cases[f].lo, precision_cases[f].hi,
+               max_error, worst_x, max_ulps, ulp_samples ? sum_ulps / ulp_samples : 0.0);
+    }
+
+    printf("\n    ]");
+    bench_section_end();
+}
@@ -0,0 +1,197 @@
+/*
+ * Host Benchmark - Quantiles
+ *
+ * Exact mode: a full column of random samples must give exactly the
+ * quartiles of a sorted copy, in less time than sorting it.
+ * Streaming mode: 10^5 samples from several distributions and orders go
+ * through the P² markers; the estimated Q1, median and Q3 are ranked in
+ * a sorted copy to get the rank error (fraction of n) and the value error
+ * (fraction of the true interquartile range). Time and memory are
+ * reported against storing everything and sorting it with qsort().
+ */
+
+#include "bench.h"
+#include "quantiles.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STREAM_SAMPLES  100000
+#define PI              3.14159265358979323846
+
+typedef enum {
+    DIST_UNIFORM,
+    DIST_NORMAL,
+    DIST_EXPONENTIAL,
+    DIST_SORTED,
+    DIST_REVERSED,
+    DIST_COUNT
+} distribution_t;
+
+static const char *const dist_names[DIST_COUNT] = {
+    "uniform", "normal", "exponential", "sorted", "reversed"
+};
+
+static double samples[STREAM_SAMPLES];
+static double sorted[STREAM_SAMPLES];
+static quantile_state_t state;
+static uint64_t rng_state;
+
+// xorshift64*, so every run sees the same data
+static double uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 2685821657736338717ull) >> 11) * 0x1.0p-53;
+}
+
+static void generate(distribution_t dist, double *out, int n)
+{
+    rng_state = 88172645463325252ull;
+    for (int i = 0; i < n; i++) {
+        double u = uniform();
+        switch (dist) {
+            case DIST_NORMAL:
+                out[i] = sqrt(-2.0 * log(1.0 - u)) * cos(2.0 * PI * uniform());
+                break;
+            case DIST_EXPONENTIAL:
+                out[i] = -log(1.0 - u);
+                break;
+            case DIST_SORTED:
+                out[i] = i;
+                break;
+            case DIST_REVERSED:
+                out[i] = n - i;
+                break;
+            default:
+                out[i] = u;
+                break;
+        }
+    }
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double sorted_median(const double *a, int lo, int n)
+{
+    return n % 2 != 0 ? a[lo + n / 2] : 0.5 * (a[lo + n / 2 - 1] + a[lo + n / 2]);
+}
+
+// Fraction of the sorted data below value, minus the target fraction
+static double rank_error(const double *a, int n, double value, double fraction)
+{
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return fabs((double)lo / (n - 1) - fraction);
+}
+
+static void bench_exact(const bench_config_t *config)
+{
+    const int n = QUANTILE_EXACT_CAPACITY;
+    const int reps = config->iterations > 0 ? config->iterations : 1;
+    quantile_summary_t summary = {0};
+    int mismatches = 0;
+
+    generate(DIST_NORMAL, samples, n);
+
+    // Every size up to the capacity must match the sorted definition
+    for (int size = 1; size <= n; size++) {
+        quantile_reset(&state);
+        for (int i = 0; i < size; i++) {
+            quantile_add(&state, samples[i], 1.0);
+            sorted[i] = samples[i];
+        }
+        qsort(sorted, size, sizeof(double), compare_doubles);
+        quantile_get(&state, &summary);
+
+        int half = size / 2;
+        double q1 = half > 0 ? sorted_median(sorted, 0, half) : sorted[0];
+        double q3 = half > 0 ? sorted_median(sorted, size - half, half) : sorted[0];
+        mismatches += summary.min != sorted[0] || summary.max != sorted[size - 1] ||
+                      summary.median != sorted_median(sorted, 0, size) ||
+                      summary.q1 != q1 || summary.q3 != q3 || !summary.exact;
+    }
+
+    // Time on freshly added (unordered) data each repetition
+    uint64_t select_ns = 0, sort_ns = 0;
+    for (int r = 0; r < reps / 10 + 1; r++) {
+        quantile_reset(&state);
+        for (int i = 0; i < n; i++) {
+            quantile_add(&state, samples[i], 1.0);
+            sorted[i] = samples[i];
+        }
+        uint64_t start = bench_now_ns();
+        quantile_get(&state, &summary);
+        select_ns += bench_now_ns() - start;
+
+        start = bench_now_ns();
+        qsort(sorted, n, sizeof(double), compare_doubles);
+        bench_sink += sorted_median(sorted, 0, n);
+        sort_ns += bench_now_ns() - start;
+    }
+
+    printf("\n    \"exact\": {\"samples\": %d, \"mismatches\": %d, \"select_ns\": %.0f, \"qsort_ns\": %.0f},",
+           n, mismatches, (double)select_ns / (reps / 10 + 1), (double)sort_ns / (reps / 10 + 1));
+}
+
+void bench_quantiles(const bench_config_t *config)
+{
+    bench_section_begin("quantiles");
+    bench_exact(config);
+
+    printf("\n    \"state_bytes\": %zu, \"p2_bytes\": %zu, \"sort_bytes\": %zu,",
+           sizeof(quantile_state_t), 2 * QUANTILE_MARKERS * sizeof(double),
+           STREAM_SAMPLES * sizeof(double));
+
+    for (int d = 0; d < DIST_COUNT; d++) {
+        quantile_summary_t summary = {0};
+        const int n = STREAM_SAMPLES;
+
+        generate((distribution_t)d, samples, n);
+
+        uint64_t start = bench_now_ns();
+        quantile_reset(&state);
+        for (int i = 0; i < n; i++) {
+            quantile_add(&state, samples[i], 1.0);
+        }
+        int status = quantile_get(&state, &summary);
+        double stream_ns = (double)(bench_now_ns() - start);
+
+        for (int i = 0; i < n; i++) {
+            sorted[i] = samples[i];
+        }
+        start = bench_now_ns();
+        qsort(sorted, n, sizeof(double), compare_doubles);
+        double sort_ns = (double)(bench_now_ns() - start);
+
+        double iqr = sorted[3 * (n - 1) / 4] - sorted[(n - 1) / 4];
+        const double estimates[3] = { summary.q1, summary.median, summary.q3 };
+        const double exact[3] = { sorted[(n - 1) / 4], sorted[(n - 1) / 2], sorted[3 * (n - 1) / 4] };
+        double max_rank_error = 0.0, max_value_error = 0.0;
+        for (int q = 0; q < 3; q++) {
+            max_rank_error = fmax(max_rank_error, rank_error(sorted, n, estimates[q], 0.25 * (q + 1)));
+            max_value_error = fmax(max_value_error, fabs(estimates[q] - exact[q]) / iqr);
+        }
+
+        printf("%s\n    ", d == 0 ? "" : ",");
+        bench_json_string(dist_names[d]);
+        printf(": {\"samples\": %d, \"status\": %d, \"exact\": %s, \"max_rank_error\": %.2e,"
+               " \"max_value_error_iqr\": %.2e, \"ns_per_sample\": %.1f, \"qsort_ns_per_sample\": %.1f}",
+               n, status, summary.exact ? "true" : "false", max_rank_error, max_value_error,
+               stream_ns / n, sort_ns / n);
+    }
+
+    bench_section_end();
+}
@@ -0,0 +1,135 @@
+/*
+ * Host Benchmark - Regression
+ *
+ * Fits each STAT regression model to 100000 points lying exactly on a
+ * known curve, plus a line far from the origin, and reports the relative
+ * error of the coefficients and of ŷ and x̂ at one point, with r. The cost
+ * of a model switch, regression_fit() from the shared moment sums, is
+ * timed against re-reading the data to rebuild that model's sums.
+ */
+
+#include "bench.h"
+#include "statistics.h"
+#include <math.h>
+#include <stdio.h>
+
+#define REG_SAMPLES 100000
+
+typedef struct {
+    const char *name;
+    regression_model_t model;
+    double a, b, c;         // Exact coefficients
+    double x_lo, x_hi;      // Sample range
+    double x_check;         // Point for ŷ and x̂
+} regression_case_t;
+
+static const regression_case_t regression_suite[] = {
+    { "linear",         REG_LINEAR,     2.0,  3.0,  0.0,  1.0,   100.0, 50.0 },
+    { "linear_offset",  REG_LINEAR,     -7.0, 2.0,  0.0,  1e9,   1e9 + 1e5, 1e9 + 12345.5 },
+    { "quadratic",      REG_QUADRATIC,  1.0,  -2.0, 0.5,  1.0,   100.0, 50.0 },
+    { "log",            REG_LOG,        1.0,  2.0,  0.0,  1.0,   100.0, 50.0 },
+    { "e_exp",          REG_EXP,        3.0,  0.05, 0.0,  1.0,   100.0, 50.0 },
+    { "ab_exp",         REG_AB_EXP,     3.0,  1.05, 0.0,  1.0,   100.0, 50.0 },
+    { "power",          REG_POWER,      2.0,  1.5,  0.0,  1.0,   100.0, 50.0 },
+    { "inverse",        REG_INVERSE,    4.0,  5.0,  0.0,  1.0,   100.0, 50.0 },
+};
+
+#define SUITE_SIZE (int)(sizeof(regression_suite) / sizeof(regression_suite[0]))
+
+static double xs[REG_SAMPLES];
+static double ys[REG_SAMPLES];
+static stat_accumulator_t acc;
+
+static double model_y(const regression_case_t *c, double x)
+{
+    switch (c->model) {
+        case REG_QUADRATIC: return c->a + c->b * x + c->c * x * x;
+        case REG_LOG:       return c->a + c->b * log(x);
+        case REG_EXP:       return c->a * exp(c->b * x);
+        case REG_AB_EXP:    return c->a * pow(c->b, x);
+        case REG_POWER:     return c->a * pow(x, c->b);
+        case REG_INVERSE:   return c->a + c->b / x;
+        default:            return c->a + c->b * x;
+    }
+}
+
+static double rel_error(double value, double exact)
+{
+    return exact != 0.0 ? fabs(value - exact) / fabs(exact) : fabs(value);
+}
+
+// The model's sums rebuilt from the data, as a STAT editor without
+// shared accumulators would on every model change
+static double rescan_slope(regression_model_t model)
+{
+    double su = 0.0, sv = 0.0, suu = 0.0, suv = 0.0;
+    for (int i = 0; i < REG_SAMPLES; i++) {
+        double u = model == REG_LOG || model == REG_POWER ? log(xs[i]) :
+                   model == REG_INVERSE ? 1.0 / xs[i] : xs[i];
+        double v = model == REG_EXP || model == REG_AB_EXP || model == REG_POWER ?
+                   log(ys[i]) : ys[i];
+        su += u;
+        sv += v;
+        suu += u * u;
+        suv += u * v;
+    }
+    return (REG_SAMPLES * suv - su * sv) / (REG_SAMPLES * suu - su * su);
+}
+
+void bench_regression(const bench_config_t *config)
+{
+    const int reps = config->iterations > 0 ? config->iterations : 1;
+    const int rescan_reps = config->iterations / 2000 > 0 ? config->iterations / 2000 : 1;
+
+    bench_section_begin("regression");
+
+    for (int k = 0; k < SUITE_SIZE; k++) {
+        const regression_case_t *c = &regression_suite[k];
+        regression_fit_t fit;
+        int status = 0;
+
+        stat_reset(&acc);
+        for (int i = 0; i < REG_SAMPLES; i++) {
+            xs[i] = c->x_lo + (c->x_hi - c->x_lo) * i / (REG_SAMPLES - 1);
+            ys[i] = model_y(c, xs[i]);
+            status |= stat_add(&acc, xs[i], ys[i], 1.0);
+        }
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            status |= regression_fit(&acc.regression, c->model, &fit);
+            bench_sink += fit.b;
+        }
+        double fit_ns = (double)(bench_now_ns() - start) / reps;
+
+        start = bench_now_ns();
+        for (int r = 0; r < rescan_reps; r++) {
+            bench_sink += rescan_slope(c->model);
+        }
+        double rescan_ns = (double)(bench_now_ns() - start) / rescan_reps;
+
+        double y_check = model_y(c, c->x_check);
+        double x1 = NAN, x2 = NAN;
+        status |= regression_predict_x(&fit, y_check, &x1, &x2);
+        // The quadratic has two x for each y; compare the nearer one
+        double x_hat = fabs(x2 - c->x_check) < fabs(x1 - c->x_check) ? x2 : x1;
+
+        // r is undefined for the quadratic model
+        char r_text[32] = "null";
+        if (!isnan(fit.r)) {
+            snprintf(r_text, sizeof(r_text), "%.17g", fit.r);
+        }
+
+        printf("%s\n    ", k == 0 ? "" : ",");
+        bench_json_string(c->name);
+        printf(": {\"model\": \"%s\", \"status\": %d, \"a_rel_error\": %.3e, \"b_rel_error\": %.3e,"
+               " \"c_rel_error\": %.3e, \"r\": %s, \"y_hat_rel_error\": %.3e,"
+               " \"x_hat_rel_error\": %.3e, \"fit_ns\": %.1f, \"rescan_ns\": %.0f}",
+               regression_model_name(c->model), status, rel_error(fit.a, c->a),
+               rel_error(fit.b, c->b), rel_error(fit.c, c->c), r_text,
+               rel_error(regression_predict_y(&fit, c->x_check), y_check),
+               rel_error(x_hat, c->x_check), fit_ns, rescan_ns);
+    }
+
+    bench_section_end();
+}
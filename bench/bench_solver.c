@@ -0,0 +1,89 @@
+/*
+ * Host Benchmark - Equation solver
+ *
+ * Runs solve_expression() from a fixed initial guess on equations that
+ * are hard for plain Newton: multiple (flat) roots, a Newton step that
+ * diverges or lands far away, functions undefined on part of the line,
+ * oscillating trig and discontinuities with no root at all. Reports the
+ * status, the root and its distance from the expected one, the residual
+ * and the iterations and evaluations to converge. The wall-clock budget
+ * is driven by the benchmark clock.
+ */
+
+#include "bench.h"
+#include "solver.h"
+#include <math.h>
+#include <stdio.h>
+
+typedef struct {
+    const char *equation;
+    double x0;
+    double expected;        // NAN when there is no root to find
+} solve_case_t;
+
+static const solve_case_t solve_suite[] = {
+    { "X^2=2",                  1.0,    1.41421356237309504880 },
+    { "cos(X)=X",               0.0,    0.73908513321516064166 },
+    { "(X-1)^3",                0.0,    1.0 },
+    { "(X-2)^4*(X+1)",          3.0,    2.0 },
+    { "exp(X)-1-X-X^2/2",       1.0,    0.0 },
+    { "X^10=1",                 0.5,    1.0 },
+    { "atan(X)",                3.0,    0.0 },
+    { "X*exp(0-X)",             2.0,    0.0 },
+    { "ln(X)=5",                1.0,    148.41315910257660342 },
+    { "sqrt(X)=3",              0.0,    9.0 },
+    { "tan(X)=X",               4.4,    4.49340945790906417531 },
+    { "sin(10*X)=X/3",          1.0,    NAN },
+    { "sin(X)=0.999999",        0.0,    NAN },
+    { "abs(X-3)=X/10",          0.0,    2.72727272727272727273 },
+    { "1/(X-2)",                1.0,    NAN },
+    { "X/abs(X)+0.5",           1.0,    NAN },
+    { "X^2+1",                  0.0,    NAN },
+};
+
+#define SUITE_SIZE (int)(sizeof(solve_suite) / sizeof(solve_suite[0]))
+
+static int64_t bench_uptime_ms(void)
+{
+    return (int64_t)(bench_now_ns() / 1000000);
+}
+
+void bench_solver(const bench_config_t *config)
+{
+    const int reps = config->iterations / 1000 > 0 ? config->iterations / 1000 : 1;
+    eval_context_t context = { .deg_mode = false };
+    solver_config_t solver_config;
+
+    solver_config_default(&solver_config);
+    solver_config.uptime_ms = bench_uptime_ms;
+
+    bench_section_begin("solver");
+
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        const solve_case_t *c = &solve_suite[i];
+        solver_result_t result;
+        int status = 0;
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            status = solve_expression(c->equation, &context, c->x0, &solver_config, &result);
+        }
+        double ns = (double)(bench_now_ns() - start) / reps;
+
+        printf("%s\n    ", i == 0 ? "" : ",");
+        bench_json_string(c->equation);
+        printf(": {\"x0\": %g, \"status\": %d, \"root\": %.17g, \"root_error\": ",
+               c->x0, status, result.root);
+        if (isnan(c->expected)) {
+            printf("null");
+        } else {
+            printf("%.3e", fabs(result.root - c->expected));
+        }
+        printf(", \"residual\": %.3e,\n      \"iterations\": %d, \"evaluations\": %d,"
+               " \"out_of_budget\": %s, \"us\": %.1f}",
+               result.residual, result.iterations, result.evaluations,
+               result.out_of_budget ? "true" : "false", ns / 1000.0);
+    }
+
+    bench_section_end();
+}
@@ -0,0 +1,96 @@
+/*
+ * Host Benchmark - Streaming statistics
+ *
+ * Streams 50000 samples of 1e9 + {4, 7, 13, 16} (the classic case that
+ * defeats the textbook Σx² formula) through the STAT accumulators, then
+ * removes every other sample again. Reports the relative error of the
+ * sample standard deviation against the exact value, next to the naive
+ * raw-sum formula, the time per add, remove and summary, and the bytes
+ * of state used whatever the sample count.
+ */
+
+#include "bench.h"
+#include "statistics.h"
+#include <math.h>
+#include <stdio.h>
+
+#define STAT_SAMPLES    50000
+#define STAT_OFFSET     1e9
+
+static const double stat_pattern[4] = { 4.0, 7.0, 13.0, 16.0 };
+
+static double sample_x(int i)
+{
+    return STAT_OFFSET + stat_pattern[i % 4];
+}
+
+// y falls as x rises, so Σxy is exercised with a negative covariance
+static double sample_y(int i)
+{
+    return 2.0 * STAT_OFFSET - 3.0 * stat_pattern[i % 4];
+}
+
+void bench_statistics(const bench_config_t *config)
+{
+    const int reps = config->iterations / 2000 > 0 ? config->iterations / 2000 : 1;
+    stat_accumulator_t acc;
+    stat_summary_t summary;
+    int status = 0;
+    double naive_sum = 0.0, naive_sum2 = 0.0;
+
+    bench_section_begin("statistics");
+
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < reps; r++) {
+        stat_reset(&acc);
+        for (int i = 0; i < STAT_SAMPLES; i++) {
+            status |= stat_add(&acc, sample_x(i), sample_y(i), 1.0);
+        }
+    }
+    double add_ns = (double)(bench_now_ns() - start) / ((double)reps * STAT_SAMPLES);
+
+    for (int i = 0; i < STAT_SAMPLES; i++) {
+        naive_sum += sample_x(i);
+        naive_sum2 += sample_x(i) * sample_x(i);
+    }
+
+    start = bench_now_ns();
+    for (int r = 0; r < reps * 1000; r++) {
+        stat_get_summary(&acc, &summary);
+        bench_sink += summary.sample_sd_x;
+    }
+    double summary_ns = (double)(bench_now_ns() - start) / (reps * 1000.0);
+
+    // Pattern variance 22.5 (population), over n - 1 for the sample
+    const double n = STAT_SAMPLES;
+    const double exact_sd = sqrt(22.5 * n / (n - 1.0));
+    const double naive_sd = sqrt(fmax((naive_sum2 - naive_sum * naive_sum / n) / (n - 1.0), 0.0));
+    const double exact_sum_xy_rel = fabs(summary.sum_xy - n * (STAT_OFFSET * 2.0 * STAT_OFFSET
+        + STAT_OFFSET * (2.0 * 10.0 - 3.0 * 10.0) - 3.0 * (22.5 + 100.0))) /
+        (n * 2.0 * STAT_OFFSET * STAT_OFFSET);
+
+    printf("\n    \"samples\": %d, \"status\": %d, \"state_bytes\": %zu,",
+           STAT_SAMPLES, status, sizeof(stat_accumulator_t));
+    printf("\n    \"sample_sd_x\": %.17g, \"welford_rel_error\": %.3e, \"naive_rel_error\": %.3e,",
+           summary.sample_sd_x, fabs(summary.sample_sd_x - exact_sd) / exact_sd,
+           fabs(naive_sd - exact_sd) / exact_sd);
+    printf("\n    \"sum_xy_rel_error\": %.3e, \"add_ns\": %.2f, \"summary_ns\": %.2f,",
+           exact_sum_xy_rel, add_ns, summary_ns);
+
+    // Remove the 7s and 16s: {4, 13} remain, population variance 20.25,
+    // and, with the samples streamed past the exact column, the maximum
+    // is unknown until a 16 or more comes back
+    start = bench_now_ns();
+    for (int i = 1; i < STAT_SAMPLES; i += 2) {
+        status |= stat_remove(&acc, sample_x(i), sample_y(i), 1.0);
+    }
+    double remove_ns = (double)(bench_now_ns() - start) / (STAT_SAMPLES / 2);
+    stat_get_summary(&acc, &summary);
+
+    printf("\n    \"remove_ns\": %.2f, \"after_remove_pop_sd_rel_error\": %.3e,"
+           " \"after_remove_min_x\": %.17g, \"after_remove_max_x_known\": %s",
+           remove_ns, fabs(summary.pop_sd_x - 4.5) / 4.5, summary.min_x,
+           isnan(summary.max_x) ? "false" : "true");
+
+    bench_section_end();
+}
@@ -0,0 +1,130 @@
+/*
+ * Host Benchmark - Function table
+ *
+ * Builds a 10000-row TABLE of f(X) and g(X) two ways: eagerly, one
+ * evaluate_expression() and snprintf() per cell as calculator_execute()
+ * would, and lazily with table.c, where only the rows on screen are
+ * fetched and formatted. Reports time to the first screen, the cost of
+ * scrolling one row and one page with a full redraw each time, random
+ * jumps, the blocks evaluated and the RAM the table needs. Every lazy
+ * row is checked against the eager value.
+ */
+
+#include "bench.h"
+#include "table.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TABLE_ROWS      10000
+#define TABLE_START     0.0
+#define TABLE_STEP      0.1
+#define VISIBLE_ROWS    9
+#define JUMPS           1000
+
+static const char *table_f = "X^2-3*X+2";
+static const char *table_g = "sin(X)*exp(0-X/100)";
+
+static table_t table;
+static char eager_text[TABLE_ROWS][2][16];
+
+// Fetch and format one screen of rows, as the TABLE renderer does
+static void draw_screen(int top)
+{
+    char line[48];
+    for (int i = 0; i < VISIBLE_ROWS; i++) {
+        const table_row_t *row = table_get_row(&table, top + i);
+        if (row == NULL) {
+            break;
+        }
+        snprintf(line, sizeof(line), "%.6g %.6g %.6g", row->x, row->fx, row->gx);
+        bench_sink += line[0];
+    }
+}
+
+void bench_table(const bench_config_t *config)
+{
+    const int reps = config->iterations / 2000 > 0 ? config->iterations / 2000 : 1;
+    const double end = TABLE_START + (TABLE_ROWS - 1) * TABLE_STEP;
+    eval_context_t context = { .deg_mode = false };
+    int status = 0;
+
+    bench_section_begin("table");
+
+    // Eager: every cell through the string-in, string-out path
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < TABLE_ROWS; i++) {
+            double fx, gx;
+            context.variables.x = TABLE_START + i * TABLE_STEP;
+            if (evaluate_expression(table_f, &context, &fx) != 0) {
+                fx = NAN;
+            }
+            if (evaluate_expression(table_g, &context, &gx) != 0) {
+                gx = NAN;
+            }
+            snprintf(eager_text[i][0], sizeof(eager_text[i][0]), "%.6g", fx);
+            snprintf(eager_text[i][1], sizeof(eager_text[i][1]), "%.6g", gx);
+        }
+    }
+    double eager_ns = (double)(bench_now_ns() - start) / reps;
+
+    // Lazy: compile, then draw the first screen
+    start = bench_now_ns();
+    for (int r = 0; r < reps && status == 0; r++) {
+        status = table_init(&table, table_f, table_g, &context, TABLE_START, end, TABLE_STEP);
+        if (status == 0) {
+            draw_screen(0);
+        }
+    }
+    double first_screen_ns = (double)(bench_now_ns() - start) / reps;
+
+    // Scroll to the bottom one row at a time, redrawing every step
+    const int steps = TABLE_ROWS - VISIBLE_ROWS;
+    table_init(&table, table_f, table_g, &context, TABLE_START, end, TABLE_STEP);
+    start = bench_now_ns();
+    for (int top = 0; top <= steps; top++) {
+        draw_screen(top);
+    }
+    double row_scroll_ns = (double)(bench_now_ns() - start) / (steps + 1);
+    uint32_t scroll_blocks = table.blocks_evaluated;
+
+    // Page back up to the top
+    start = bench_now_ns();
+    int pages = 0;
+    for (int top = steps; top >= 0; top -= VISIBLE_ROWS, pages++) {
+        draw_screen(top);
+    }
+    double page_scroll_ns = (double)(bench_now_ns() - start) / pages;
+
+    // Random jumps anywhere in the table
+    srand(1);
+    start = bench_now_ns();
+    for (int j = 0; j < JUMPS; j++) {
+        draw_screen(rand() % (steps + 1));
+    }
+    double jump_ns = (double)(bench_now_ns() - start) / JUMPS;
+
+    // The lazy rows must print exactly like the eager ones
+    int mismatches = 0;
+    char text[16];
+    for (int i = 0; i < TABLE_ROWS; i++) {
+        const table_row_t *row = table_get_row(&table, i);
+        snprintf(text, sizeof(text), "%.6g", row->fx);
+        mismatches += strcmp(text, eager_text[i][0]) != 0;
+        snprintf(text, sizeof(text), "%.6g", row->gx);
+        mismatches += strcmp(text, eager_text[i][1]) != 0;
+    }
+
+    printf("\n    \"rows\": %d, \"status\": %d, \"table_bytes\": %zu,"
+           " \"eager_text_bytes\": %zu,",
+           table_row_count(&table), status, sizeof(table_t), sizeof(eager_text));
+    printf("\n    \"eager_all_rows_ns\": %.0f, \"lazy_first_screen_ns\": %.0f,",
+           eager_ns, first_screen_ns);
+    printf("\n    \"row_scroll_ns\": %.1f, \"page_scroll_ns\": %.1f, \"random_jump_ns\": %.1f,",
+           row_scroll_ns, page_scroll_ns, jump_ns);
+    printf("\n    \"blocks_per_full_scroll\": %u, \"mismatches\": %d",
+           scroll_blocks, mismatches);
+
+    bench_section_end();
+}
@@ -0,0 +1,207 @@
+/*
+ * Host Benchmark - Vectors
+ *
+ * Compares the fused angle and unit-vector kernels with the same result
+ * built from separate calls (the dot product, two norms and acos; a norm
+ * then one division per component), for 2D and 3D vectors over a set of
+ * random pairs. The angle is checked against a long double atan2 of
+ * |a x b| and a.b, which stays accurate for nearly parallel vectors. The
+ * last entries time whole vector expressions, parsed each time as VECTOR
+ * mode does and from a parsed program.
+ */
+
+#include "bench.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+
+#define VECTOR_SET 256
+
+static vector_t inputs[VECTOR_SET];
+
+static uint64_t rng_state;
+
+static double rng_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1p-53;
+}
+
+// Components in [-10, 10]
+static void fill_inputs(int dim)
+{
+    for (int m = 0; m < VECTOR_SET; m++) {
+        inputs[m].dim = (uint8_t)dim;
+        for (int i = 0; i < dim; i++) {
+            inputs[m].v[i] = 20.0 * rng_uniform() - 10.0;
+        }
+    }
+}
+
+static long double reference_angle(const vector_t *a, const vector_t *b)
+{
+    long double ax = a->v[0], ay = a->v[1], az = a->dim == 3 ? a->v[2] : 0.0;
+    long double bx = b->v[0], by = b->v[1], bz = b->dim == 3 ? b->v[2] : 0.0;
+    long double cx = ay * bz - az * by;
+    long double cy = az * bx - ax * bz;
+    long double cz = ax * by - ay * bx;
+    return atan2l(sqrtl(cx * cx + cy * cy + cz * cz), ax * bx + ay * by + az * bz);
+}
+
+static double separate_angle(const vector_t *a, const vector_t *b)
+{
+    double dot, norm_a, norm_b;
+    vector_dot(a, b, &dot);
+    vector_norm(a, &norm_a);
+    vector_norm(b, &norm_b);
+    double cosine = dot / (norm_a * norm_b);
+    return acos(cosine > 1.0 ? 1.0 : (cosine < -1.0 ? -1.0 : cosine));
+}
+
+static void separate_unit(const vector_t *a, vector_t *out)
+{
+    double norm;
+    vector_norm(a, &norm);
+    out->dim = a->dim;
+    for (int i = 0; i < a->dim; i++) {
+        out->v[i] = a->v[i] / norm;
+    }
+}
+
+typedef enum {
+    KERNEL_ANGLE,
+    KERNEL_ANGLE_SEPARATE,
+    KERNEL_UNIT,
+    KERNEL_UNIT_SEPARATE,
+    KERNEL_DOT,
+    KERNEL_CROSS,
+    KERNEL_COUNT
+} vector_kernel_t;
+
+static const char *const kernel_names[KERNEL_COUNT] = {
+    "angle", "angle_separate", "unit", "unit_separate", "dot", "cross",
+};
+
+static double run_kernel(vector_kernel_t kernel, const vector_t *a, const vector_t *b)
+{
+    vector_t out;
+    double value = 0.0;
+
+    switch (kernel) {
+        case KERNEL_ANGLE: vector_angle(a, b, &value); break;
+        case KERNEL_ANGLE_SEPARATE: value = separate_angle(a, b); break;
+        case KERNEL_UNIT:
+            vector_unit(a, &out);
+            value = out.v[0];
+            break;
+        case KERNEL_UNIT_SEPARATE:
+            separate_unit(a, &out);
+            value = out.v[0];
+            break;
+        case KERNEL_DOT: vector_dot(a, b, &value); break;
+        default:
+            vector_cross(a, b, &out);
+            value = out.v[0];
+            break;
+    }
+    return value;
+}
+
+static void print_dim(int dim, int reps)
+{
+    fill_inputs(dim);
+
+    double fused_error = 0.0, separate_error = 0.0;
+    for (int m = 0; m < VECTOR_SET; m++) {
+        const vector_t *a = &inputs[m];
+        const vector_t *b = &inputs[(m + 1) % VECTOR_SET];
+        long double reference = reference_angle(a, b);
+        double angle;
+        vector_angle(a, b, &angle);
+        double error = (double)fabsl(angle - reference);
+        fused_error = error > fused_error ? error : fused_error;
+        error = (double)fabsl(separate_angle(a, b) - reference);
+        separate_error = error > separate_error ? error : separate_error;
+    }
+
+    printf("%s\n      {\"dim\": %d, \"ns_per_op\": {", dim > 2 ? "," : "", dim);
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        double sum = 0.0;
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            for (int m = 0; m < VECTOR_SET; m++) {
+                sum += run_kernel((vector_kernel_t)k, &inputs[m], &inputs[(m + 1) % VECTOR_SET]);
+            }
+        }
+        double ns = (double)(bench_now_ns() - start) / ((double)reps * VECTOR_SET);
+        bench_sink = sum;
+        printf("%s\"%s\": %.2f", k ? ", " : "", kernel_names[k], ns);
+    }
+    printf("}, \"angle_max_abs_error\": %.3e, \"angle_separate_max_abs_error\": %.3e}",
+           fused_error, separate_error);
+}
+
+static const char *const expressions[] = {
+    "2*VctA-VctB/2",
+    "VctA*VctB",
+    "angle(VctA,VctB)",
+    "dot(unitV(VctA),VctB)+abs(VctA*VctB)",
+};
+
+static void print_expressions(int reps)
+{
+    static vector_t vectors[VECTOR_COUNT];
+    eval_context_t context = { .deg_mode = true };
+    const int count = (int)(sizeof(expressions) / sizeof(expressions[0]));
+
+    fill_inputs(3);
+    printf(",\n    \"expressions\": [");
+    for (int e = 0; e < count; e++) {
+        rpn_queue_t rpn;
+        vector_t result;
+        double sum = 0.0;
+        parse_expression_to_rpn(expressions[e], &rpn);
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            vectors[VECTOR_A] = inputs[r % VECTOR_SET];
+            vectors[VECTOR_B] = inputs[(r + 1) % VECTOR_SET];
+            vector_evaluate_expression(expressions[e], &context, vectors, &result);
+            sum += result.v[0];
+        }
+        double parsed_ns = (double)(bench_now_ns() - start) / reps;
+
+        start = bench_now_ns();
+        for (int r = 0; r < reps; r++) {
+            vectors[VECTOR_A] = inputs[r % VECTOR_SET];
+            vectors[VECTOR_B] = inputs[(r + 1) % VECTOR_SET];
+            vector_evaluate_rpn(&rpn, &context, vectors, &result);
+            sum += result.v[0];
+        }
+        double rpn_ns = (double)(bench_now_ns() - start) / reps;
+        bench_sink = sum;
+
+        printf("%s\n      {\"expression\": \"%s\", \"ns_per_eval\": %.1f, \"rpn_ns_per_eval\": %.1f}",
+               e ? "," : "", expressions[e], parsed_ns, rpn_ns);
+    }
+    printf("\n    ]");
+}
+
+void bench_vector(const bench_config_t *config)
+{
+    const int reps = config->iterations / 10 > 0 ? config->iterations / 10 : 1;
+
+    bench_section_begin("vector");
+    rng_state = 0x9E3779B97F4A7C15ULL;
+
+    printf("\n    \"vector_bytes\": %zu, \"dims\": [", sizeof(vector_t));
+    for (int dim = 2; dim <= VECTOR_MAX_DIM; dim++) {
+        print_dim(dim, reps);
+    }
+    printf("\n    ]");
+    print_expressions(config->iterations);
+
+    bench_section_end();
+}
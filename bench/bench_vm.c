@@ -0,0 +1,107 @@
+/*
+ * Host Benchmark - Bytecode VM
+ *
+ * Compares the token interpreter (evaluate_rpn) with the bytecode VM
+ * (expr_vm_execute, which evaluate_expression() runs from its compile
+ * cache), and reports the RAM each compiled form needs. Most of the main
+ * corpus folds to a single constant, which would only time the dispatch
+ * of one OP_CONST, so this section uses its own corpus of expressions in
+ * the variables and nested functions that survive constant folding.
+ * Per-function stack usage is written by the compiler to the .su files
+ * next to the object files (-fstack-usage).
+ */
+
+#include "bench.h"
+#include "expression_vm.h"
+#include <stdio.h>
+
+static const char *const vm_corpus[] = {
+    "X^2-3*X+2",
+    "Ans*X+A*B-C/D",
+    "A*X^3+B*X^2+C*X+D",
+    "(X+1)*(X+2)*(X+3)*(X+4)",
+    "sqrt(X*X+Y*Y)",
+    "sin(X)*cos(Y)+M",
+    "sin(cos(tan(X)))",
+    "atan(Y/X)+asin(M)",
+    "exp(-X^2/2)/sqrt(2*π)",
+    "ln(abs(X-Y)+1)*M",
+    "M*(1+Y/12)^(12*X)",
+    "sinh(X)-cosh(Y)+tanh(M)",
+};
+
+#define VM_CORPUS_SIZE (int)(sizeof(vm_corpus) / sizeof(vm_corpus[0]))
+
+void bench_vm(const bench_config_t *config)
+{
+    const int n = config->iterations;
+    const eval_context_t context = {
+        .variables = { .ans = 1.5, .x = 2.25, .y = -0.75, .a = 3.0, .b = 4.0,
+                       .c = 5.0, .d = 6.0, .m = 0.5 },
+        .deg_mode = true
+    };
+    double sum_rpn = 0, sum_vm = 0;
+    int measured = 0;
+
+    bench_section_begin("vm");
+    printf("\n    \"rpn_queue_bytes\": %zu, \"program_bytes\": %zu,"
+           " \"rpn_value_stack_bytes\": %zu, \"vm_value_stack_bytes\": %zu,"
+           "\n    \"expressions\": [",
+           sizeof(rpn_queue_t), sizeof(expr_program_t),
+           MAX_TOKENS * sizeof(double), EXPR_VM_MAX_STACK * sizeof(double));
+
+    for (int e = 0; e < VM_CORPUS_SIZE; e++) {
+        const char *expr = vm_corpus[e];
+        rpn_queue_t rpn;
+        expr_program_t program;
+        double rpn_result = 0.0, vm_result = 0.0;
+        uint64_t start;
+
+        printf("%s\n      {\"expr\": ", e ? "," : "");
+        bench_json_string(expr);
+
+        int err = parse_expression_to_rpn(expr, &rpn);
+        if (err == 0) {
+            optimize_rpn(&rpn, context.deg_mode);
+            err = expr_vm_compile(&rpn, &program);
+        }
+        if (err < 0) {
+            printf(", \"error\": %d}", err);
+            continue;
+        }
+
+        int rpn_err = evaluate_rpn(&rpn, &context, &rpn_result);
+        int vm_err = expr_vm_execute(&program, &context, &vm_result);
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            evaluate_rpn(&rpn, &context, &rpn_result);
+            bench_sink = rpn_result;
+        }
+        double rpn_ns = (double)(bench_now_ns() - start) / n;
+
+        start = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            expr_vm_execute(&program, &context, &vm_result);
+            bench_sink = vm_result;
+        }
+        double vm_ns = (double)(bench_now_ns() - start) / n;
+
+        printf(", \"rpn_tokens\": %d, \"code_bytes\": %d, \"constants\": %d, \"max_depth\": %d,"
+               " \"rpn_ns\": %.1f, \"vm_ns\": %.1f, \"speedup\": %.2f, \"matches\": %s}",
+               rpn.count, program.code_size, program.constant_count, program.max_depth,
+               rpn_ns, vm_ns, rpn_ns / vm_ns,
+               (rpn_err == vm_err && rpn_result == vm_result) ? "true" : "false");
+
+        sum_rpn += rpn_ns;
+        sum_vm += vm_ns;
+        measured++;
+    }
+
+    printf("\n    ]");
+    if (measured > 0) {
+        printf(",\n    \"summary\": {\"rpn_ns\": %.1f, \"vm_ns\": %.1f, \"speedup\": %.2f}",
+               sum_rpn / measured, sum_vm / measured, sum_rpn / sum_vm);
+    }
+    bench_section_end();
+}
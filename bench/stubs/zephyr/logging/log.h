@@ -0,0 +1,31 @@
+/*
+ * Zephyr logging stub for host builds
+ *
+ * The math modules only use the logging macros, so on plain Linux they
+ * compile to nothing. This keeps the benchmark free of I/O noise.
+ */
+
+#ifndef BENCH_STUB_ZEPHYR_LOG_H
+#define BENCH_STUB_ZEPHYR_LOG_H
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERR  1
+#define LOG_LEVEL_WRN  2
+#define LOG_LEVEL_INF  3
+#define LOG_LEVEL_DBG  4
+
+#define LOG_MODULE_REGISTER(...)
+#define LOG_MODULE_DECLARE(...)
+
+// Arguments are still consumed, like Zephyr does for disabled levels
+static inline void bench_log_discard(const char *fmt, ...)
+{
+    (void)fmt;
+}
+
+#define LOG_ERR(...) bench_log_discard(__VA_ARGS__)
+#define LOG_WRN(...) bench_log_discard(__VA_ARGS__)
+#define LOG_INF(...) bench_log_discard(__VA_ARGS__)
+#define LOG_DBG(...) bench_log_discard(__VA_ARGS__)
+
+#endif /* BENCH_STUB_ZEPHYR_LOG_H */
@@ -0,0 +1,445 @@
+/*
+ * Base-N Integers Implementation
+ */
+
+#include "base_n.h"
+#include <string.h>
+
+// Program token types
+enum {
+    BASE_N_LITERAL,
+    BASE_N_ANS,
+    BASE_N_UNARY,
+    BASE_N_BINARY
+};
+
+// Operator codes; the rest are the characters themselves (+ - * /)
+#define OP_AND      '&'
+#define OP_OR       '|'
+#define OP_XOR      '^'
+#define OP_XNOR     'x'
+#define OP_SHL      '<'
+#define OP_SHR      '>'
+#define OP_NOT      '~'
+#define OP_NEG      'n'
+#define OP_PAREN    '('
+
+// Words of the expression syntax
+static const struct {
+    const char *text;
+    uint8_t length;
+    uint8_t type;
+    uint8_t op;
+} words[] = {
+    { "and", 3, BASE_N_BINARY, OP_AND },
+    { "or", 2, BASE_N_BINARY, OP_OR },
+    { "xor", 3, BASE_N_BINARY, OP_XOR },
+    { "xnor", 4, BASE_N_BINARY, OP_XNOR },
+    { "not", 3, BASE_N_UNARY, OP_NOT },
+    { "neg", 3, BASE_N_UNARY, OP_NEG },
+    { "<<", 2, BASE_N_BINARY, OP_SHL },
+    { ">>", 2, BASE_N_BINARY, OP_SHR },
+    { "Ans", 3, BASE_N_ANS, 0 },
+};
+
+static const char digit_chars[16] = "0123456789ABCDEF";
+
+// "00" ... "99", two decimal digits per division
+static const char digit_pairs[200] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+// Evaluation stack and compiled program, kept off the caller's stack
+static int64_t stack[MAX_TOKENS];
+static base_n_program_t program;
+
+int64_t base_n_wrap(uint64_t value, int bits)
+{
+    if (bits >= BASE_N_MAX_BITS) {
+        return (int64_t)value;
+    }
+    uint64_t sign = 1ull << (bits - 1);
+    value &= (sign << 1) - 1;
+    return (int64_t)(value ^ sign) - (int64_t)sign;
+}
+
+// The word as an unsigned bit pattern
+static uint64_t word_pattern(int64_t value, int bits)
+{
+    if (bits >= BASE_N_MAX_BITS) {
+        return (uint64_t)value;
+    }
+    return (uint64_t)value & ((1ull << bits) - 1);
+}
+
+const char *base_n_radix_name(base_n_radix_t radix)
+{
+    switch (radix) {
+        case BASE_N_HEX: return "HEX";
+        case BASE_N_BIN: return "BIN";
+        case BASE_N_OCT: return "OCT";
+        default: return "DEC";
+    }
+}
+
+static int digit_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int prefix_radix(char c)
+{
+    switch (c) {
+        case 'd': return BASE_N_DEC;
+        case 'h': return BASE_N_HEX;
+        case 'b': return BASE_N_BIN;
+        case 'o': return BASE_N_OCT;
+        default: return 0;
+    }
+}
+
+// Read the digits at *text as an unsigned literal that must fit the word
+static int parse_literal(const char **text, int radix, int bits, int64_t *value)
+{
+    const uint64_t limit = bits >= BASE_N_MAX_BITS ? UINT64_MAX : (1ull << bits) - 1;
+    const char *p = *text;
+    uint64_t sum = 0;
+    int digit;
+
+    if (digit_value(*p) < 0) {
+        return ERR_SYNTAX_ERROR;
+    }
+    while ((digit = digit_value(*p)) >= 0) {
+        if (digit >= radix) {
+            return ERR_SYNTAX_ERROR;
+        }
+        if (sum > (limit - (uint64_t)digit) / (uint64_t)radix) {
+            return ERR_OVERFLOW;
+        }
+        sum = sum * (uint64_t)radix + (uint64_t)digit;
+        p++;
+    }
+    *text = p;
+    *value = base_n_wrap(sum, bits);
+    return 0;
+}
+
+static int precedence(uint8_t op)
+{
+    switch (op) {
+        case OP_OR: return 1;
+        case OP_XOR: case OP_XNOR: return 2;
+        case OP_AND: return 3;
+        case OP_SHL: case OP_SHR: return 4;
+        case '+': case '-': return 5;
+        case '*': case '/': return 6;
+        case OP_NOT: case OP_NEG: return 7;
+        default: return 0;
+    }
+}
+
+static int emit(base_n_program_t *out, uint8_t type, uint8_t op, int64_t value)
+{
+    if (out->count >= MAX_TOKENS) {
+        return ERR_STACK_OVERFLOW;
+    }
+    out->tokens[out->count].type = type;
+    out->tokens[out->count].op = op;
+    out->tokens[out->count].value = value;
+    out->count++;
+    return 0;
+}
+
+// Move an operator from the operator stack to the program
+static int emit_operator(base_n_program_t *out, uint8_t op)
+{
+    return emit(out, op == OP_NOT || op == OP_NEG ? BASE_N_UNARY : BASE_N_BINARY, op, 0);
+}
+
+// Index of the operator word or Ans at text, or -1
+static int match_word(const char *text)
+{
+    for (int w = 0; w < (int)(sizeof(words) / sizeof(words[0])); w++) {
+        if (strncmp(text, words[w].text, words[w].length) == 0) {
+            return w;
+        }
+    }
+    return -1;
+}
+
+int base_n_parse(const char *expression, const base_n_context_t *context,
+                 base_n_program_t *out)
+{
+    uint8_t ops[MAX_TOKENS];
+    int top = -1;
+    bool expect_operand = true;
+    const char *p = expression;
+    int status = 0;
+
+    out->count = 0;
+    while (*p != '\0') {
+        int w = match_word(p);
+        uint8_t type = BASE_N_BINARY;
+        uint8_t op = (uint8_t)*p;
+
+        if (*p == ' ') {
+            p++;
+            continue;
+        }
+        if (w >= 0) {
+            type = words[w].type;
+            op = words[w].op;
+            p += words[w].length;
+        } else if (digit_value(*p) >= 0 || prefix_radix(*p) != 0) {
+            // A literal, in the radix of its prefix if it has one
+            int radix = prefix_radix(*p) != 0 ? prefix_radix(*p++) : (int)context->radix;
+            int64_t value;
+            if (!expect_operand) {
+                return ERR_SYNTAX_ERROR;
+            }
+            status = parse_literal(&p, radix, context->bits, &value);
+            if (status == 0) {
+                status = emit(out, BASE_N_LITERAL, 0, value);
+            }
+            if (status != 0) {
+                return status;
+            }
+            expect_operand = false;
+            continue;
+        } else if (strchr("+-*/()", *p) != NULL) {
+            p++;
+        } else {
+            return ERR_SYNTAX_ERROR;
+        }
+
+        if (op == '-' && expect_operand) {
+            type = BASE_N_UNARY;
+            op = OP_NEG;
+        }
+
+        if (op == ')') {
+            if (expect_operand) {
+                return ERR_SYNTAX_ERROR;
+            }
+            while (top >= 0 && ops[top] != OP_PAREN) {
+                if ((status = emit_operator(out, ops[top--])) != 0) {
+                    return status;
+                }
+            }
+            if (top < 0) {
+                return ERR_MISMATCHED_PARENS;
+            }
+            top--;
+            continue;
+        }
+        if (type == BASE_N_ANS) {
+            if (!expect_operand) {
+                return ERR_SYNTAX_ERROR;
+            }
+            if ((status = emit(out, BASE_N_ANS, 0, 0)) != 0) {
+                return status;
+            }
+            expect_operand = false;
+            continue;
+        }
+
+        if (op == OP_PAREN || type == BASE_N_UNARY) {
+            // Prefix operators bind to what follows, so nothing is popped
+            if (!expect_operand) {
+                return ERR_SYNTAX_ERROR;
+            }
+        } else {
+            if (expect_operand) {
+                return ERR_SYNTAX_ERROR;
+            }
+            // Left associative: pop everything that binds at least as tightly
+            while (top >= 0 && precedence(ops[top]) >= precedence(op)) {
+                if ((status = emit_operator(out, ops[top--])) != 0) {
+                    return status;
+                }
+            }
+        }
+        if (top >= MAX_TOKENS - 1) {
+            return ERR_STACK_OVERFLOW;
+        }
+        ops[++top] = op;
+        expect_operand = true;
+    }
+
+    if (expect_operand) {
+        return ERR_SYNTAX_ERROR;
+    }
+    while (top >= 0) {
+        if (ops[top] == OP_PAREN) {
+            return ERR_MISMATCHED_PARENS;
+        }
+        if ((status = emit_operator(out, ops[top--])) != 0) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+// a op b in the word; the arithmetic is done unsigned so it wraps
+// without undefined behaviour
+static int apply_base_n_operator(uint8_t op, int64_t a, int64_t b, int bits, int64_t *out)
+{
+    switch (op) {
+        case '+': *out = base_n_wrap((uint64_t)a + (uint64_t)b, bits); break;
+        case '-': *out = base_n_wrap((uint64_t)a - (uint64_t)b, bits); break;
+        case '*': *out = base_n_wrap((uint64_t)a * (uint64_t)b, bits); break;
+        case '/':
+            if (b == 0) {
+                return ERR_DIVISION_BY_ZERO;
+            }
+            // The most negative word divided by -1 wraps to itself
+            *out = b == -1 ? base_n_wrap(0 - (uint64_t)a, bits) : base_n_wrap((uint64_t)(a / b), bits);
+            break;
+        case OP_AND: *out = a & b; break;
+        case OP_OR: *out = a | b; break;
+        case OP_XOR: *out = a ^ b; break;
+        case OP_XNOR: *out = ~(a ^ b); break;
+        case OP_SHL:
+        case OP_SHR:
+            if (b < 0) {
+                return ERR_DOMAIN_ERROR;
+            }
+            if (b >= bits) {
+                *out = op == OP_SHL || a >= 0 ? 0 : -1;
+            } else if (op == OP_SHL) {
+                *out = base_n_wrap((uint64_t)a << b, bits);
+            } else {
+                // Arithmetic shift without relying on signed >>
+                *out = a < 0 ? ~(int64_t)(~(uint64_t)a >> b) : (int64_t)((uint64_t)a >> b);
+            }
+            break;
+        default:
+            return ERR_SYNTAX_ERROR;
+    }
+    return 0;
+}
+
+int base_n_evaluate(const base_n_program_t *in, const base_n_context_t *context,
+                    int64_t *result)
+{
+    const int bits = context->bits;
+    int top = -1;
+
+    for (int i = 0; i < in->count; i++) {
+        uint8_t op = in->tokens[i].op;
+        int status;
+
+        switch (in->tokens[i].type) {
+            case BASE_N_LITERAL:
+            case BASE_N_ANS:
+                if (top >= MAX_TOKENS - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                stack[++top] = in->tokens[i].type == BASE_N_LITERAL ?
+                               in->tokens[i].value : base_n_wrap((uint64_t)context->ans, bits);
+                break;
+
+            case BASE_N_UNARY:
+                if (top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                stack[top] = op == OP_NOT ? ~stack[top] : base_n_wrap(0 - (uint64_t)stack[top], bits);
+                break;
+
+            case BASE_N_BINARY:
+                if (top < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                top--;
+                status = apply_base_n_operator(op, stack[top], stack[top + 1], bits, &stack[top]);
+                if (status != 0) {
+                    return status;
+                }
+                break;
+
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+    }
+
+    if (top != 0) {
+        return ERR_SYNTAX_ERROR;
+    }
+    *result = stack[0];
+    return 0;
+}
+
+int base_n_evaluate_expression(const char *expression, const base_n_context_t *context,
+                               int64_t *result)
+{
+    int status = base_n_parse(expression, context, &program);
+    if (status != 0) {
+        return status;
+    }
+    return base_n_evaluate(&program, context, result);
+}
+
+// Digits of a power-of-two radix, 1, 3 or 4 bits each, written backwards
+// from end
+static char *format_power_of_two(uint64_t pattern, int shift, char *end)
+{
+    const uint64_t mask = (1u << shift) - 1;
+    do {
+        *--end = digit_chars[pattern & mask];
+        pattern >>= shift;
+    } while (pattern != 0);
+    return end;
+}
+
+// Decimal digits of magnitude, two per division, written backwards from end
+static char *format_decimal(uint64_t magnitude, char *end)
+{
+    while (magnitude >= 100) {
+        const char *pair = &digit_pairs[(magnitude % 100) * 2];
+        magnitude /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (magnitude >= 10) {
+        *--end = digit_pairs[magnitude * 2 + 1];
+        *--end = digit_pairs[magnitude * 2];
+    } else {
+        *--end = (char)('0' + magnitude);
+    }
+    return end;
+}
+
+int base_n_format(int64_t value, base_n_radix_t radix, int bits, char *buffer, size_t size)
+{
+    char digits[BASE_N_FORMAT_SIZE];
+    char *end = digits + sizeof(digits);
+    char *start;
+
+    switch (radix) {
+        case BASE_N_HEX: start = format_power_of_two(word_pattern(value, bits), 4, end); break;
+        case BASE_N_OCT: start = format_power_of_two(word_pattern(value, bits), 3, end); break;
+        case BASE_N_BIN: start = format_power_of_two(word_pattern(value, bits), 1, end); break;
+        default:
+            start = format_decimal(value < 0 ? 0 - (uint64_t)value : (uint64_t)value, end);
+            if (value < 0) {
+                *--start = '-';
+            }
+            break;
+    }
+
+    size_t length = (size_t)(end - start);
+    if (length + 1 > size) {
+        return ERR_OVERFLOW;
+    }
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    return (int)length;
+}
@@ -0,0 +1,125 @@
+/*
+ * Base-N Integers
+ *
+ * BASE-N mode works on two's-complement integers of 8, 16, 32 or 64
+ * bits. The evaluator here is a specialization of the shunting-yard
+ * evaluator with int64_t values throughout: its own lexer reads the
+ * literals straight into integers, so hFFFFFFFFFFFFFFFF and 2^53+1 are
+ * exact where the double evaluator would round them, and the formatters
+ * write digits with shifts and a two-digit table rather than snprintf.
+ *
+ * Literals are in the current radix unless prefixed: d (decimal),
+ * h (hex), b (binary) or o (octal), as on the fx-991. Hex digits are
+ * A-F; the prefixes and operator words are lower case, so "bA" cannot
+ * be read two ways. From loosest to tightest binding the operators are
+ * or, xor/xnor, and, the shifts << and >>, + and -, * and /, and the
+ * prefix not, neg and unary minus. Ans is the only variable, since A-F
+ * are digits.
+ *
+ * Every result is reduced to the word size and sign-extended, so + - *
+ * and << wrap as the hardware would. / truncates toward zero and >> is
+ * arithmetic. A literal that does not fit in the word is an overflow.
+ * DEC shows the signed value; HEX, OCT and BIN show the bit pattern.
+ */
+
+#ifndef BASE_N_H
+#define BASE_N_H
+
+#include "expression_evaluator.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define BASE_N_MAX_BITS     64
+#define BASE_N_FORMAT_SIZE  (BASE_N_MAX_BITS + 1)  // 64 binary digits and the NUL
+
+/**
+ * @brief Display and default literal radix
+ */
+typedef enum {
+    BASE_N_BIN = 2,
+    BASE_N_OCT = 8,
+    BASE_N_DEC = 10,
+    BASE_N_HEX = 16
+} base_n_radix_t;
+
+/**
+ * @brief Base-N evaluation context
+ */
+typedef struct {
+    base_n_radix_t radix;   // Radix of unprefixed literals
+    uint8_t bits;           // Word size: 8, 16, 32 or 64
+    int64_t ans;            // Value of Ans
+} base_n_context_t;
+
+/**
+ * @brief Compiled base-N expression
+ */
+typedef struct {
+    struct {
+        uint8_t type;       // Literal, Ans, unary or binary operator
+        uint8_t op;         // Operator code
+        int64_t value;      // Literal value, already in the word
+    } tokens[MAX_TOKENS];
+    int count;
+} base_n_program_t;
+
+/**
+ * @brief Reduce a value to the word size
+ * @param value Value; only the low bits are kept
+ * @param bits Word size
+ * @return The low bits sign-extended to 64 bits
+ */
+int64_t base_n_wrap(uint64_t value, int bits);
+
+/**
+ * @brief Parse an expression into a program
+ * @param expression Input expression, for example "hFF and not(b1010)"
+ * @param context Radix of unprefixed literals and word size
+ * @param program Output program
+ * @return 0 on success, ERR_SYNTAX_ERROR for a character or digit the
+ *         radix does not have, ERR_OVERFLOW for a literal wider than the
+ *         word, ERR_MISMATCHED_PARENS, ERR_STACK_OVERFLOW
+ */
+int base_n_parse(const char *expression, const base_n_context_t *context,
+                 base_n_program_t *program);
+
+/**
+ * @brief Evaluate a program
+ * @param program Program from base_n_parse()
+ * @param context Word size and Ans
+ * @param result Output value, within the word
+ * @return 0 on success, ERR_DIVISION_BY_ZERO, ERR_DOMAIN_ERROR for a
+ *         negative shift count, ERR_SYNTAX_ERROR
+ */
+int base_n_evaluate(const base_n_program_t *program, const base_n_context_t *context,
+                    int64_t *result);
+
+/**
+ * @brief Parse and evaluate an expression
+ * @param expression Input expression
+ * @param context Radix, word size and Ans
+ * @param result Output value, within the word
+ * @return 0 on success, negative error code on failure
+ */
+int base_n_evaluate_expression(const char *expression, const base_n_context_t *context,
+                               int64_t *result);
+
+/**
+ * @brief Format a value in a radix, without leading zeros
+ * @param value Value within the word
+ * @param radix Output radix; only DEC has a sign
+ * @param bits Word size, the width of the HEX, OCT and BIN pattern
+ * @param buffer Output buffer, BASE_N_FORMAT_SIZE always fits
+ * @param size Size of buffer
+ * @return Length written, or ERR_OVERFLOW if buffer is too small
+ */
+int base_n_format(int64_t value, base_n_radix_t radix, int bits, char *buffer, size_t size);
+
+/**
+ * @brief Name of a radix for the status line
+ * @param radix Radix
+ * @return "DEC", "HEX", "BIN" or "OCT"
+ */
+const char *base_n_radix_name(base_n_radix_t radix);
+
+#endif /* BASE_N_H */
@@ -0,0 +1,309 @@
+/*
+ * Complex Numbers Implementation
+ */
+
+#include "complex_number.h"
+#include <math.h>
+
+#define PI          3.14159265358979323846
+#define LN10        2.30258509299404568402
+#define DEG_PER_RAD (180.0 / PI)
+
+// Evaluation stack and compiled program, kept off the caller's stack
+static complex_t stack[MAX_TOKENS];
+static rpn_queue_t program;
+
+static bool is_finite(complex_t z)
+{
+    return isfinite(z.re) && isfinite(z.im);
+}
+
+static complex_t real(double x)
+{
+    return (complex_t){ x, 0.0 };
+}
+
+double complex_abs(complex_t z)
+{
+    return hypot(z.re, z.im);
+}
+
+// Principal argument in radians; -0 from a negated real is still on
+// the positive side of the cut
+static double arg_radians(complex_t z)
+{
+    return atan2(z.im == 0.0 ? 0.0 : z.im, z.re);
+}
+
+double complex_arg(complex_t z, bool deg_mode)
+{
+    if (!deg_mode) {
+        return arg_radians(z);
+    }
+    if (z.im == 0.0) {
+        return z.re < 0.0 ? 180.0 : 0.0;
+    }
+    if (z.re == 0.0) {
+        return z.im > 0.0 ? 90.0 : -90.0;
+    }
+    return arg_radians(z) * DEG_PER_RAD;
+}
+
+complex_t complex_multiply(complex_t a, complex_t b)
+{
+    return (complex_t){ a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+}
+
+int complex_divide(complex_t a, complex_t b, complex_t *out)
+{
+    if (b.re == 0.0 && b.im == 0.0) {
+        return ERR_DIVISION_BY_ZERO;
+    }
+    // Divide through by the larger part of b so |b|^2 is never formed
+    if (fabs(b.re) >= fabs(b.im)) {
+        double r = b.im / b.re;
+        double d = b.re + b.im * r;
+        *out = (complex_t){ (a.re + a.im * r) / d, (a.im - a.re * r) / d };
+    } else {
+        double r = b.re / b.im;
+        double d = b.re * r + b.im;
+        *out = (complex_t){ (a.re * r + a.im) / d, (a.im * r - a.re) / d };
+    }
+    return is_finite(*out) ? 0 : ERR_OVERFLOW;
+}
+
+complex_t complex_sqrt(complex_t z)
+{
+    if (z.im == 0.0) {
+        return z.re >= 0.0 ? real(sqrt(z.re)) : (complex_t){ 0.0, sqrt(-z.re) };
+    }
+    // t = sqrt((|re| + |z|) / 2), halved first so the sum cannot overflow
+    double t = sqrt(0.5 * fabs(z.re) + 0.5 * complex_abs(z));
+    if (z.re >= 0.0) {
+        return (complex_t){ t, z.im / (2.0 * t) };
+    }
+    return (complex_t){ fabs(z.im) / (2.0 * t), copysign(t, z.im) };
+}
+
+int complex_ln(complex_t z, complex_t *out)
+{
+    if (z.re == 0.0 && z.im == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+    if (z.im == 0.0 && z.re > 0.0) {
+        *out = real(log(z.re));
+    } else {
+        *out = (complex_t){ log(complex_abs(z)), arg_radians(z) };
+    }
+    return 0;
+}
+
+complex_t complex_exp(complex_t z)
+{
+    if (z.im == 0.0) {
+        return real(exp(z.re));
+    }
+    double magnitude = exp(z.re);
+    return (complex_t){ magnitude * cos(z.im), magnitude * sin(z.im) };
+}
+
+int complex_pow(complex_t z, complex_t w, complex_t *out)
+{
+    bool integer = w.im == 0.0 && isfinite(w.re) && w.re == floor(w.re);
+
+    // Real results stay on the real function
+    if (z.im == 0.0 && w.im == 0.0 && (z.re > 0.0 || integer)) {
+        if (z.re == 0.0 && w.re < 0.0) {
+            return ERR_DIVISION_BY_ZERO;
+        }
+        *out = real(pow(z.re, w.re));
+        return isfinite(out->re) ? 0 : ERR_OVERFLOW;
+    }
+    if (z.re == 0.0 && z.im == 0.0) {
+        if (w.re <= 0.0) {
+            return ERR_DOMAIN_ERROR;
+        }
+        *out = real(0.0);
+        return 0;
+    }
+
+    if (integer && fabs(w.re) <= COMPLEX_MAX_SQUARING_EXPONENT) {
+        // Repeated squaring keeps Gaussian integers exact
+        unsigned n = (unsigned)fabs(w.re);
+        complex_t power = real(1.0);
+        complex_t base = z;
+        while (n != 0) {
+            if (n & 1u) {
+                power = complex_multiply(power, base);
+            }
+            base = complex_multiply(base, base);
+            n >>= 1;
+        }
+        if (w.re < 0.0) {
+            return complex_divide(real(1.0), power, out);
+        }
+        *out = power;
+    } else {
+        complex_t log_z;
+        complex_ln(z, &log_z);
+        *out = complex_exp(complex_multiply(w, log_z));
+    }
+    return is_finite(*out) ? 0 : ERR_OVERFLOW;
+}
+
+complex_t complex_polar(double r, double theta, bool deg_mode)
+{
+    if (deg_mode) {
+        // Quarter turns are exact: 2∠90 is 2i, not 1.2e-16+2i
+        double quarters = fmod(theta, 360.0) / 90.0;
+        if (quarters == floor(quarters)) {
+            static const double cosines[4] = { 1.0, 0.0, -1.0, 0.0 };
+            int k = ((int)quarters + 4) % 4;
+            return (complex_t){ r * cosines[k], r * cosines[(k + 3) % 4] };
+        }
+        theta /= DEG_PER_RAD;
+    }
+    return (complex_t){ r * cos(theta), r * sin(theta) };
+}
+
+// a op b; r∠θ needs real operands
+static int apply_complex_operator(char op, complex_t a, complex_t b, bool deg_mode,
+                                  complex_t *out)
+{
+    switch (op) {
+        case '+': *out = (complex_t){ a.re + b.re, a.im + b.im }; break;
+        case '-': *out = (complex_t){ a.re - b.re, a.im - b.im }; break;
+        case '*': *out = complex_multiply(a, b); break;
+        case '/': return complex_divide(a, b, out);
+        case '^': return complex_pow(a, b, out);
+        case OPERATOR_POLAR:
+            if (a.im != 0.0 || b.im != 0.0) {
+                return ERR_DOMAIN_ERROR;
+            }
+            *out = complex_polar(a.re, b.re, deg_mode);
+            break;
+        default:
+            return ERR_SYNTAX_ERROR;
+    }
+    return is_finite(*out) ? 0 : ERR_OVERFLOW;
+}
+
+// func(z); functions without a complex form need a real argument
+static int apply_complex_function(function_type_t func, complex_t z, bool deg_mode,
+                                  complex_t *out)
+{
+    int status = 0;
+
+    switch (func) {
+        case FUNC_ABS: *out = real(complex_abs(z)); break;
+        case FUNC_ARG: *out = real(complex_arg(z, deg_mode)); break;
+        case FUNC_CONJ: *out = (complex_t){ z.re, -z.im }; break;
+        case FUNC_SQRT: *out = complex_sqrt(z); break;
+        case FUNC_EXP: *out = complex_exp(z); break;
+        case FUNC_LN: status = complex_ln(z, out); break;
+        case FUNC_LOG:
+        case FUNC_LOG10:
+            status = complex_ln(z, out);
+            out->re /= LN10;
+            out->im /= LN10;
+            break;
+        default: {
+            if (z.im != 0.0) {
+                return ERR_DOMAIN_ERROR;
+            }
+            eval_num_t value = apply_function(func, z.re, deg_mode);
+            if (!isfinite(value)) {
+                return ERR_DOMAIN_ERROR;
+            }
+            *out = real(value);
+            return 0;
+        }
+    }
+    if (status != 0) {
+        return status;
+    }
+    return is_finite(*out) ? 0 : ERR_OVERFLOW;
+}
+
+int complex_evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                         const complex_t *ans, complex_t *result)
+{
+    int top = -1;
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        const token_t *token = &rpn_queue->tokens[i];
+        int status = 0;
+
+        switch (token->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+            case TOKEN_IMAGINARY:
+                if (top >= MAX_TOKENS - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                top++;
+                if (token->type == TOKEN_NUMBER) {
+                    stack[top] = real(token->value.number);
+                } else if (token->type == TOKEN_CONSTANT) {
+                    stack[top] = real(get_constant_value(token->value.constant));
+                } else if (token->type == TOKEN_IMAGINARY) {
+                    stack[top] = (complex_t){ 0.0, token->value.number };
+                } else if (token->value.variable == VAR_ANS && ans != NULL) {
+                    stack[top] = *ans;
+                } else {
+                    stack[top] = real(get_variable_value(token->value.variable,
+                                                         &context->variables));
+                }
+                break;
+
+            case TOKEN_OPERATOR:
+                if (top < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                top--;
+                status = apply_complex_operator(token->value.operator, stack[top], stack[top + 1],
+                                                context->deg_mode, &stack[top]);
+                break;
+
+            case TOKEN_UNARY_MINUS:
+                if (top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                stack[top].re = -stack[top].re;
+                stack[top].im = -stack[top].im;
+                break;
+
+            case TOKEN_FUNCTION:
+                if (top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                status = apply_complex_function(token->value.function, stack[top],
+                                                context->deg_mode, &stack[top]);
+                break;
+
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (top != 0) {
+        return ERR_SYNTAX_ERROR;
+    }
+    *result = stack[0];
+    return 0;
+}
+
+int complex_evaluate_expression(const char *expression, const eval_context_t *context,
+                                const complex_t *ans, complex_t *result)
+{
+    int status = parse_expression_to_rpn(expression, &program);
+    if (status != 0) {
+        return status;
+    }
+    return complex_evaluate_rpn(&program, context, ans, result);
+}
@@ -0,0 +1,135 @@
+/*
+ * Complex Numbers
+ *
+ * Complex arithmetic and the complex evaluator for CMPLX mode. A complex
+ * number is a pair of doubles passed by value; nothing is allocated.
+ *
+ * complex_evaluate_rpn() runs the same RPN programs as evaluate_rpn(),
+ * from the same tokenizer and shunting-yard parser, over a stack of
+ * complex values. The real evaluators are untouched: the imaginary unit
+ * i and the polar operator r∠θ are their own tokens, which the real
+ * path rejects, so its dispatch does no extra work.
+ *
+ * sqrt, ln, log and ^ take principal branches: arg in (-pi, pi], sqrt
+ * with a non-negative real part, and z^w = exp(w ln z). Real operands
+ * with a real result (sqrt(4), 2^0.5, ln(3)) go straight to the real
+ * libm function, so no rounding leaks into a zero imaginary part, and a
+ * complex base with an integer exponent up to
+ * COMPLEX_MAX_SQUARING_EXPONENT is computed by repeated squaring, so
+ * (1+i)^10 is exactly 32i. Trigonometric and the other functions accept
+ * real arguments only. "4i" and "iπ" multiply without the '*'.
+ */
+
+#ifndef COMPLEX_NUMBER_H
+#define COMPLEX_NUMBER_H
+
+#include "expression_evaluator.h"
+
+#define COMPLEX_MAX_SQUARING_EXPONENT 1024  // Larger integer powers use exp(w ln z)
+
+/**
+ * @brief Complex number re + im i
+ */
+typedef struct {
+    double re;
+    double im;
+} complex_t;
+
+/**
+ * @brief Modulus |z|, without overflow in the squares
+ * @param z Complex number
+ * @return |z|
+ */
+double complex_abs(complex_t z);
+
+/**
+ * @brief Principal argument, exact on the axes in degrees
+ * @param z Complex number
+ * @param deg_mode True for degrees, false for radians
+ * @return arg z in (-pi, pi] or (-180, 180], 0 for z = 0
+ */
+double complex_arg(complex_t z, bool deg_mode);
+
+/**
+ * @brief Product a b
+ * @param a First factor
+ * @param b Second factor
+ * @return a b
+ */
+complex_t complex_multiply(complex_t a, complex_t b);
+
+/**
+ * @brief Quotient a / b by Smith's method, which does not overflow in
+ *        |b|^2
+ * @param a Dividend
+ * @param b Divisor
+ * @param out Output quotient
+ * @return 0 on success, ERR_DIVISION_BY_ZERO if b = 0, ERR_OVERFLOW
+ */
+int complex_divide(complex_t a, complex_t b, complex_t *out);
+
+/**
+ * @brief Principal square root, with a non-negative real part
+ * @param z Complex number
+ * @return sqrt(z)
+ */
+complex_t complex_sqrt(complex_t z);
+
+/**
+ * @brief Principal natural logarithm ln|z| + i arg z
+ * @param z Complex number
+ * @param out Output logarithm
+ * @return 0 on success, ERR_DOMAIN_ERROR for z = 0
+ */
+int complex_ln(complex_t z, complex_t *out);
+
+/**
+ * @brief Exponential e^z
+ * @param z Complex number
+ * @return e^z
+ */
+complex_t complex_exp(complex_t z);
+
+/**
+ * @brief Principal power z^w
+ * @param z Base
+ * @param w Exponent
+ * @param out Output power
+ * @return 0 on success, ERR_DIVISION_BY_ZERO for 0 to a negative integer
+ *         power, ERR_DOMAIN_ERROR for 0 to another power with a
+ *         non-positive real part, ERR_OVERFLOW
+ */
+int complex_pow(complex_t z, complex_t w, complex_t *out);
+
+/**
+ * @brief Number from polar form r∠θ
+ * @param r Modulus
+ * @param theta Argument, in degrees if deg_mode
+ * @param deg_mode True if theta is in degrees
+ * @return r (cos θ + i sin θ), exact at the special angles in degrees
+ */
+complex_t complex_polar(double r, double theta, bool deg_mode);
+
+/**
+ * @brief Evaluate an RPN program over complex values
+ * @param rpn_queue RPN tokens from parse_expression_to_rpn()
+ * @param context Evaluation context (real variables, angle mode)
+ * @param ans Value of Ans, or NULL to take it from the context
+ * @param result Output value
+ * @return 0 on success, negative error code on failure
+ */
+int complex_evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                         const complex_t *ans, complex_t *result);
+
+/**
+ * @brief Parse and evaluate an expression over complex values
+ * @param expression Input expression, for example "(3+4i)/(1-2i)"
+ * @param context Evaluation context
+ * @param ans Value of Ans, or NULL to take it from the context
+ * @param result Output value
+ * @return 0 on success, negative error code on failure
+ */
+int complex_evaluate_expression(const char *expression, const eval_context_t *context,
+                                const complex_t *ans, complex_t *result);
+
+#endif /* COMPLEX_NUMBER_H */
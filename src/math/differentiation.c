@@ -0,0 +1,115 @@
+/*
+ * Numerical Differentiation Implementation
+ */
+
+#include "differentiation.h"
+#include <math.h>
+
+// One Richardson pass with first step h
+static int richardson(const rpn_queue_t *function, const eval_context_t *context,
+                      double x, double h, diff_result_t *result)
+{
+    double xs[DIFF_EVALUATIONS];
+    double fs[DIFF_EVALUATIONS];
+    double steps[DIFF_LEVELS];
+    double tableau[DIFF_LEVELS];
+
+    // Halving steps; (x + h) - x makes each one exactly the distance
+    // between the sample points
+    for (int k = 0; k < DIFF_LEVELS; k++, h *= 0.5) {
+        steps[k] = (x + h) - x;
+        xs[2 * k] = x + steps[k];
+        xs[2 * k + 1] = x - steps[k];
+    }
+
+    int failed = evaluate_rpn_batch(function, context, xs, fs, DIFF_EVALUATIONS);
+    if (failed != 0) {
+        return failed < 0 ? failed : ERR_DOMAIN_ERROR;
+    }
+
+    for (int k = 0; k < DIFF_LEVELS; k++) {
+        tableau[k] = (fs[2 * k] - fs[2 * k + 1]) / (2.0 * steps[k]);
+    }
+
+    // Richardson extrapolation in place: after round j, tableau[k] holds
+    // the estimate from steps k..k+j with the h^2..h^2j terms removed
+    double previous = tableau[0];
+    double factor = 4.0;
+    for (int j = 1; j < DIFF_LEVELS; j++, factor *= 4.0) {
+        previous = tableau[0];
+        for (int k = 0; k < DIFF_LEVELS - j; k++) {
+            tableau[k] = tableau[k + 1] + (tableau[k + 1] - tableau[k]) / (factor - 1.0);
+        }
+    }
+
+    if (!isfinite(tableau[0])) {
+        return ERR_OVERFLOW;
+    }
+    result->value = tableau[0];
+    result->error_estimate = fabs(tableau[0] - previous);
+    return 0;
+}
+
+int differentiate_rpn(const rpn_queue_t *function, const eval_context_t *context,
+                      double x, diff_result_t *result)
+{
+    *result = (diff_result_t){0};
+    if (!isfinite(x)) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    // A step proportional to |x| keeps the probes inside domains that end
+    // near x, such as ln(X) or sqrt(X) at small positive x
+    double h = DIFF_STEP_SCALE * fmax(fabs(x), DIFF_STEP_FLOOR);
+    diff_result_t pass = {0};
+    int status = ERR_DOMAIN_ERROR;
+    int evaluations = 0;
+
+    for (int p = 0; p < DIFF_MAX_PASSES; p++, h *= DIFF_RETRY_SHRINK) {
+        int pass_status = richardson(function, context, x, h, &pass);
+        evaluations += DIFF_EVALUATIONS;
+
+        if (pass_status != 0) {
+            // Keep an earlier pass; otherwise a probe left the domain or
+            // overflowed and the next pass brings them closer to x
+            if (status == 0) {
+                break;
+            }
+            status = pass_status;
+            continue;
+        }
+
+        // f varies faster than the step suggests (exp(X) at large X, near
+        // a pole): smaller steps while they improve the error estimate
+        if (status == 0 && pass.error_estimate >= result->error_estimate) {
+            break;
+        }
+        result->value = pass.value;
+        result->error_estimate = pass.error_estimate;
+        status = 0;
+        if (result->error_estimate <= DIFF_RETRY_TOLERANCE * fabs(result->value)) {
+            break;
+        }
+    }
+
+    result->evaluations = evaluations;
+    return status;
+}
+
+int differentiate_expression(const char *expression, const eval_context_t *context,
+                             double x, diff_result_t *result)
+{
+    // Static: an rpn_queue_t is ~1 KB
+    static rpn_queue_t function;
+
+    // Callers may log the counters even when the expression does not parse
+    *result = (diff_result_t){0};
+
+    int status = parse_expression_to_rpn(expression, &function);
+    if (status != 0) {
+        return status;
+    }
+    optimize_rpn(&function, context->deg_mode);
+
+    return differentiate_rpn(&function, context, x, result);
+}
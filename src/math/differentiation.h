@@ -0,0 +1,80 @@
+/*
+ * Numerical Differentiation
+ *
+ * d/dX of an expression at a point for the differentiation key. The
+ * expression is compiled once and each pass evaluates all its sample
+ * points in a single evaluate_rpn_batch() call.
+ *
+ * Central differences D(h) = (f(x + h) - f(x - h)) / 2h at steps h, h/2,
+ * h/4 and h/8 are combined by Richardson extrapolation; each round
+ * cancels the next even power of h in the error series, leaving an
+ * O(h^8) truncation error. The first step scales with
+ * max(|x|, DIFF_STEP_FLOOR), so x + h and x - h stay well apart in
+ * floating point for large x and inside domains that end near a small x.
+ *
+ * A pass whose probes cannot be evaluated is repeated with a 16 times
+ * smaller step, up to DIFF_MAX_PASSES passes in all. A pass with a poor
+ * error estimate gets one such refining pass. Every pass costs
+ * DIFF_EVALUATIONS, and all of them are counted.
+ */
+
+#ifndef DIFFERENTIATION_H
+#define DIFFERENTIATION_H
+
+#include "expression_evaluator.h"
+
+#define DIFF_LEVELS         4                   // Central differences per derivative
+#define DIFF_EVALUATIONS    (2 * DIFF_LEVELS)
+
+// First step relative to max(|x|, DIFF_STEP_FLOOR): balances O(h^8)
+// truncation against rounding amplified by 1/h for the evaluator's precision
+#if defined(CONFIG_CALC_EVAL_FLOAT)
+#define DIFF_STEP_SCALE     0.25
+#define DIFF_STEP_FLOOR     0.0625
+#define DIFF_RETRY_TOLERANCE 1e-4       // Relative error estimate that triggers the retry
+#else
+#define DIFF_STEP_SCALE     0.0625
+#define DIFF_STEP_FLOOR     0.001
+#define DIFF_RETRY_TOLERANCE 1e-9
+#endif
+#define DIFF_RETRY_SHRINK   0.0625      // Step of each retry pass relative to the one before
+#define DIFF_MAX_PASSES     4
+
+/**
+ * @brief Derivative and its cost
+ */
+typedef struct {
+    double value;           // f'(x) estimate
+    double error_estimate;  // Change made by the last extrapolation round
+    int evaluations;        // Function evaluations spent
+} diff_result_t;
+
+/**
+ * @brief Differentiate a compiled expression in X at x
+ *
+ * Uses the static batch workspace of evaluate_rpn_batch() and is
+ * therefore not reentrant.
+ *
+ * @param function RPN program in the variable X
+ * @param context Evaluation context; variables.x is replaced by the samples
+ * @param x Point to differentiate at
+ * @param result Derivative, error estimate and evaluation count
+ * @return 0 on success, negative error code if f cannot be evaluated
+ *         around x
+ */
+int differentiate_rpn(const rpn_queue_t *function, const eval_context_t *context,
+                      double x, diff_result_t *result);
+
+/**
+ * @brief Compile an expression in X and differentiate it at x
+ * @param expression Expression in the variable X
+ * @param context Evaluation context (variables, angle mode)
+ * @param x Point to differentiate at
+ * @param result Derivative, error estimate and evaluation count; zeroed
+ *        when the expression does not parse
+ * @return 0 on success, negative error code on failure
+ */
+int differentiate_expression(const char *expression, const eval_context_t *context,
+                             double x, diff_result_t *result);
+
+#endif /* DIFFERENTIATION_H */
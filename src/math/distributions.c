@@ -0,0 +1,467 @@
+/*
+ * Probability Distributions Implementation
+ */
+
+#include "distributions.h"
+#include "special_functions.h"
+#include <float.h>
+#include <math.h>
+
+#define DIST_SQRT_2PI   2.50662827463100050242
+#define DIST_LN_2PI     1.83787706640934548356
+#define DIST_SQRT1_2    0.70710678118654752440
+#define DIST_MAX_TRIALS 9007199254740992.0  // 2^53; integers stay exact below
+#define GAUSSIAN_CUTOFF 40.0                // e^(-z^2 / 2) underflows beyond
+#define INV_NORMAL_LOW  0.02425             // Acklam's tail / central split
+#define STIRLERR_TABLE_MAX 15
+#define BD0_MAX_TERMS   64
+
+// Acklam's inverse normal: central region in r = (p - 1/2)^2, lower tail
+// in q = sqrt(-2 ln p); the denominators have a trailing 1
+static const double acklam_a[6] = {
+    -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+    1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00,
+};
+static const double acklam_b[5] = {
+    -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+    6.680131188771972e+01, -1.328068155288572e+01,
+};
+static const double acklam_c[6] = {
+    -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+    -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00,
+};
+static const double acklam_d[4] = {
+    7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+    3.754408661907416e+00,
+};
+
+// ln n! - ln(sqrt(2 pi n) (n / e)^n) for n = 0..15; 0 stands in at n = 0
+static const double stirlerr_table[STIRLERR_TABLE_MAX + 1] = {
+    0.00000000000000000e+00, 8.10614667953272611e-02, 4.13406959554092970e-02,
+    2.76779256849983384e-02, 2.07906721037650934e-02, 1.66446911898211931e-02,
+    1.38761288230707484e-02, 1.18967099458917695e-02, 1.04112652619720962e-02,
+    9.25546218271273285e-03, 8.33056343336287079e-03, 7.57367548795184059e-03,
+    6.94284010720952992e-03, 6.40899418800420714e-03, 5.95137011275884750e-03,
+    5.55473355196280105e-03,
+};
+
+static bool is_integer(double x)
+{
+    return x == floor(x);
+}
+
+static bool normal_valid(double mu, double sigma)
+{
+    return isfinite(mu) && sigma > 0.0 && isfinite(sigma);
+}
+
+static bool binomial_valid(double trials, double p)
+{
+    return trials >= 0.0 && trials <= DIST_MAX_TRIALS && is_integer(trials) &&
+           p >= 0.0 && p <= 1.0;
+}
+
+static bool poisson_valid(double lambda)
+{
+    return lambda >= 0.0 && isfinite(lambda);
+}
+
+// Horner with c[0] the leading coefficient
+static double horner(const double *c, int n, double x)
+{
+    double result = c[0];
+
+    for (int i = 1; i < n; i++) {
+        result = result * x + c[i];
+    }
+    return result;
+}
+
+// e^(-z^2 / 2), split like sf_erfc() so z^2 is never rounded
+static double gaussian(double z)
+{
+    if (fabs(z) > GAUSSIAN_CUTOFF) {
+        return 0.0;
+    }
+    double hi = (float)z;
+    return exp(-0.5 * hi * hi) * exp(-0.5 * (z - hi) * (z + hi));
+}
+
+// Standard normal P(Z <= z); the tails are e^(-z^2 / 2) times the scaled
+// erfc, so neither rounds against 1
+static double standard_cd(double z)
+{
+    double x = z * DIST_SQRT1_2;
+
+    if (x < -0.5) {
+        return 0.5 * gaussian(z) * sf_erfcx(-x);
+    }
+    if (x > 0.5) {
+        return 1.0 - 0.5 * gaussian(z) * sf_erfcx(x);
+    }
+    return 0.5 + 0.5 * sf_erf(x);
+}
+
+// Standard normal quantile for p in (0, 1)
+static double standard_inverse(double p)
+{
+    double x;
+
+    // Work in the lower tail; 1 - p is exact for p >= 1/2
+    if (p > 0.5) {
+        return -standard_inverse(1.0 - p);
+    }
+
+    if (p < INV_NORMAL_LOW) {
+        double q = sqrt(-2.0 * log(p));
+        x = horner(acklam_c, 6, q) / (horner(acklam_d, 4, q) * q + 1.0);
+    } else {
+        double q = p - 0.5;
+        double r = q * q;
+        x = horner(acklam_a, 6, r) * q / (horner(acklam_b, 5, r) * r + 1.0);
+    }
+
+    // Halley step on P(Z <= x) - p, with u the Newton correction
+    double density = gaussian(x);
+    if (density > 0.0) {
+        double u = (standard_cd(x) - p) * DIST_SQRT_2PI / density;
+        x -= u / (1.0 + 0.5 * x * u);
+    }
+    return x;
+}
+
+// Stirling series error ln n! - ln(sqrt(2 pi n) (n / e)^n), integer n
+static double stirlerr(double n)
+{
+    const double s0 = 1.0 / 12, s1 = 1.0 / 360, s2 = 1.0 / 1260,
+                 s3 = 1.0 / 1680, s4 = 1.0 / 1188;
+
+    if (n <= STIRLERR_TABLE_MAX) {
+        return stirlerr_table[(int)n];
+    }
+
+    // Fewer terms of the asymptotic series as n grows
+    double nn = n * n;
+    if (n > 500) {
+        return (s0 - s1 / nn) / n;
+    }
+    if (n > 80) {
+        return (s0 - (s1 - s2 / nn) / nn) / n;
+    }
+    if (n > 35) {
+        return (s0 - (s1 - (s2 - s3 / nn) / nn) / nn) / n;
+    }
+    return (s0 - (s1 - (s2 - (s3 - s4 / nn) / nn) / nn) / nn) / n;
+}
+
+// Deviance term x ln(x / m) + m - x; near x = m it is a series in
+// v = (x - m) / (x + m), where the closed form would cancel
+static double bd0(double x, double m)
+{
+    if (fabs(x - m) < 0.1 * (x + m)) {
+        double v = (x - m) / (x + m);
+        double s = (x - m) * v;
+        double ej = 2.0 * x * v;
+        v *= v;
+        for (int j = 1; j < BD0_MAX_TERMS; j++) {
+            ej *= v;
+            double next = s + ej / (2 * j + 1);
+            if (next == s) {
+                break;
+            }
+            s = next;
+        }
+        return s;
+    }
+    return x * log(x / m) + m - x;
+}
+
+// P(X = x) for valid trials n and p
+static double binomial_pd(double x, double n, double p)
+{
+    double q = 1.0 - p;
+
+    if (!is_integer(x)) {
+        return NAN;
+    }
+    if (x < 0.0 || x > n) {
+        return 0.0;
+    }
+    if (p == 0.0) {
+        return x == 0.0 ? 1.0 : 0.0;
+    }
+    if (q == 0.0) {
+        return x == n ? 1.0 : 0.0;
+    }
+    if (x == 0.0) {
+        return exp(n * log1p(-p));
+    }
+    if (x == n) {
+        return exp(n * log(p));
+    }
+
+    double lc = stirlerr(n) - stirlerr(x) - stirlerr(n - x) - bd0(x, n * p) - bd0(n - x, n * q);
+    double lf = DIST_LN_2PI + log(x) + log1p(-x / n);
+    return exp(lc - 0.5 * lf);
+}
+
+// P(X <= x) for valid trials n and p
+static double binomial_cd(double x, double n, double p)
+{
+    double q = 1.0 - p;
+
+    if (!is_integer(x)) {
+        return NAN;
+    }
+    if (x < 0.0) {
+        return 0.0;
+    }
+    if (x >= n || p == 0.0) {
+        return 1.0;
+    }
+    if (q == 0.0) {
+        return 0.0;
+    }
+
+    if (x < n * p) {
+        // Lower tail, terms falling from x: P(k - 1) = P(k) k q / ((n - k + 1) p)
+        double term = binomial_pd(x, n, p);
+        double sum = term;
+        for (double k = x; k > 0.0 && term > sum * DBL_EPSILON; k--) {
+            term *= k * q / ((n - k + 1.0) * p);
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Upper tail, terms falling from x + 1: P(k + 1) = P(k) (n - k) p / ((k + 1) q)
+    double term = binomial_pd(x + 1.0, n, p);
+    double sum = term;
+    for (double k = x + 1.0; k < n && term > sum * DBL_EPSILON; k++) {
+        term *= (n - k) * p / ((k + 1.0) * q);
+        sum += term;
+    }
+    return 1.0 - sum;
+}
+
+// P(X = x) for a valid lambda
+static double poisson_pd(double x, double lambda)
+{
+    if (!is_integer(x)) {
+        return NAN;
+    }
+    if (x < 0.0 || isinf(x)) {
+        return 0.0;
+    }
+    if (lambda == 0.0) {
+        return x == 0.0 ? 1.0 : 0.0;
+    }
+    if (x == 0.0) {
+        return exp(-lambda);
+    }
+    return exp(-stirlerr(x) - bd0(x, lambda)) / (DIST_SQRT_2PI * sqrt(x));
+}
+
+// P(X <= x) for a valid lambda
+static double poisson_cd(double x, double lambda)
+{
+    if (!is_integer(x)) {
+        return NAN;
+    }
+    if (x < 0.0) {
+        return 0.0;
+    }
+    if (lambda == 0.0) {
+        return 1.0;
+    }
+
+    if (x < lambda) {
+        // Lower tail: P(k - 1) = P(k) k / lambda
+        double term = poisson_pd(x, lambda);
+        double sum = term;
+        for (double k = x; k > 0.0 && term > sum * DBL_EPSILON; k--) {
+            term *= k / lambda;
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Upper tail: P(k + 1) = P(k) lambda / (k + 1)
+    double term = poisson_pd(x + 1.0, lambda);
+    double sum = term;
+    for (double k = x + 1.0; term > sum * DBL_EPSILON; k++) {
+        term *= lambda / (k + 1.0);
+        sum += term;
+    }
+    return 1.0 - sum;
+}
+
+static int fill_nan(double *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = NAN;
+    }
+    return ERR_DOMAIN_ERROR;
+}
+
+static int count_nan(const double *out, size_t n)
+{
+    int failed = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        failed += isnan(out[i]);
+    }
+    return failed;
+}
+
+int dist_normal_pd_list(const double *xs, double *out, size_t n, double mu, double sigma)
+{
+    if (!normal_valid(mu, sigma)) {
+        return fill_nan(out, n);
+    }
+
+    const double inv_sigma = 1.0 / sigma;
+    const double scale = inv_sigma / DIST_SQRT_2PI;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = gaussian((xs[i] - mu) * inv_sigma) * scale;
+    }
+    return count_nan(out, n);
+}
+
+int dist_normal_cd_list(const double *xs, double *out, size_t n, double mu, double sigma)
+{
+    if (!normal_valid(mu, sigma)) {
+        return fill_nan(out, n);
+    }
+
+    const double inv_sigma = 1.0 / sigma;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = standard_cd((xs[i] - mu) * inv_sigma);
+    }
+    return count_nan(out, n);
+}
+
+int dist_inverse_normal_list(const double *areas, double *out, size_t n, double mu, double sigma)
+{
+    if (!normal_valid(mu, sigma)) {
+        return fill_nan(out, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        double area = areas[i];
+        out[i] = area > 0.0 && area < 1.0 ? mu + sigma * standard_inverse(area) : NAN;
+    }
+    return count_nan(out, n);
+}
+
+int dist_binomial_pd_list(const double *xs, double *out, size_t n, double trials, double p)
+{
+    if (!binomial_valid(trials, p)) {
+        return fill_nan(out, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = binomial_pd(xs[i], trials, p);
+    }
+    return count_nan(out, n);
+}
+
+int dist_binomial_cd_list(const double *xs, double *out, size_t n, double trials, double p)
+{
+    if (!binomial_valid(trials, p)) {
+        return fill_nan(out, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = binomial_cd(xs[i], trials, p);
+    }
+    return count_nan(out, n);
+}
+
+int dist_poisson_pd_list(const double *xs, double *out, size_t n, double lambda)
+{
+    if (!poisson_valid(lambda)) {
+        return fill_nan(out, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = poisson_pd(xs[i], lambda);
+    }
+    return count_nan(out, n);
+}
+
+int dist_poisson_cd_list(const double *xs, double *out, size_t n, double lambda)
+{
+    if (!poisson_valid(lambda)) {
+        return fill_nan(out, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = poisson_cd(xs[i], lambda);
+    }
+    return count_nan(out, n);
+}
+
+double dist_normal_pd(double x, double mu, double sigma)
+{
+    double result;
+
+    dist_normal_pd_list(&x, &result, 1, mu, sigma);
+    return result;
+}
+
+double dist_normal_cd(double lower, double upper, double mu, double sigma)
+{
+    if (!normal_valid(mu, sigma) || !(lower <= upper)) {
+        return NAN;
+    }
+
+    // Difference of the upper-tail probabilities when both bounds are
+    // above the mean, so the small result is not lost against 1
+    double zl = (lower - mu) / sigma;
+    double zu = (upper - mu) / sigma;
+    if (zl > 0.0) {
+        return standard_cd(-zl) - standard_cd(-zu);
+    }
+    return standard_cd(zu) - standard_cd(zl);
+}
+
+double dist_inverse_normal(double area, double mu, double sigma)
+{
+    double result;
+
+    dist_inverse_normal_list(&area, &result, 1, mu, sigma);
+    return result;
+}
+
+double dist_binomial_pd(double x, double trials, double p)
+{
+    double result;
+
+    dist_binomial_pd_list(&x, &result, 1, trials, p);
+    return result;
+}
+
+double dist_binomial_cd(double x, double trials, double p)
+{
+    double result;
+
+    dist_binomial_cd_list(&x, &result, 1, trials, p);
+    return result;
+}
+
+double dist_poisson_pd(double x, double lambda)
+{
+    double result;
+
+    dist_poisson_pd_list(&x, &result, 1, lambda);
+    return result;
+}
+
+double dist_poisson_cd(double x, double lambda)
+{
+    double result;
+
+    dist_poisson_cd_list(&x, &result, 1, lambda);
+    return result;
+}
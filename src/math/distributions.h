@@ -0,0 +1,176 @@
+/*
+ * Probability Distributions
+ *
+ * The DIST functions: normal PD and CD, inverse normal, and binomial and
+ * Poisson PD and CD. Each comes as a single value and as a list version
+ * that evaluates many x against one set of parameters, checking the
+ * parameters once.
+ *
+ * - Normal CD from the erf/erfc series of special_functions.h, always
+ *   working in the tail that is small, so P(X <= -30) or P(X >= 30)
+ *   keeps full relative precision instead of rounding 1 - 5e-198 away.
+ * - Inverse normal: Acklam's rational approximation (relative error
+ *   below 1.2e-9), then one Halley step against the CD, which is cubic
+ *   and so brings it to the precision of the CD itself.
+ * - Binomial and Poisson PD in Loader's saddle-point form: the log of
+ *   the factorial ratio is written with the Stirling series error and
+ *   the deviance term bd0, rather than as a difference of log-gammas,
+ *   which would cancel about log10(n) digits away. Nothing is formed
+ *   that can overflow, for n up to 2^53.
+ * - Binomial and Poisson CD: the PD is summed from x towards the nearer
+ *   tail with the ratio between consecutive terms, stopping once the
+ *   terms no longer change the sum. That is a few standard deviations of
+ *   terms (about 9 sqrt(npq) at worst), not x or n of them, and the
+ *   smaller tail keeps its relative precision.
+ *
+ * Invalid parameters (sigma <= 0, p outside [0, 1], a non-integer or
+ * negative number of trials, lambda < 0) and x outside the domain (a
+ * non-integer count, an area outside (0, 1)) give NAN, which the
+ * evaluator reports as a math error.
+ */
+
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include "expression_evaluator.h"
+#include <stddef.h>
+
+/**
+ * @brief Normal probability density
+ * @param x Value
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return Density at x
+ */
+double dist_normal_pd(double x, double mu, double sigma);
+
+/**
+ * @brief Normal cumulative probability P(lower <= X <= upper)
+ * @param lower Lower bound, may be -INFINITY
+ * @param upper Upper bound, >= lower, may be INFINITY
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return Probability
+ */
+double dist_normal_cd(double lower, double upper, double mu, double sigma);
+
+/**
+ * @brief Inverse normal: the x with P(X <= x) = area
+ * @param area Left-tail area, in (0, 1)
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return x
+ */
+double dist_inverse_normal(double area, double mu, double sigma);
+
+/**
+ * @brief Binomial probability P(X = x)
+ * @param x Number of successes, an integer
+ * @param trials Number of trials, a non-negative integer
+ * @param p Success probability, in [0, 1]
+ * @return Probability; 0 for x outside [0, trials]
+ */
+double dist_binomial_pd(double x, double trials, double p);
+
+/**
+ * @brief Binomial cumulative probability P(X <= x)
+ * @param x Number of successes, an integer
+ * @param trials Number of trials, a non-negative integer
+ * @param p Success probability, in [0, 1]
+ * @return Probability
+ */
+double dist_binomial_cd(double x, double trials, double p);
+
+/**
+ * @brief Poisson probability P(X = x)
+ * @param x Count, an integer
+ * @param lambda Mean, >= 0
+ * @return Probability; 0 for negative x
+ */
+double dist_poisson_pd(double x, double lambda);
+
+/**
+ * @brief Poisson cumulative probability P(X <= x)
+ * @param x Count, an integer
+ * @param lambda Mean, >= 0
+ * @return Probability
+ */
+double dist_poisson_cd(double x, double lambda);
+
+/**
+ * @brief dist_normal_pd() for a list of x
+ * @param xs Values
+ * @param out Output densities (may alias xs)
+ * @param n Number of values
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid
+ *         parameters (every result NAN)
+ */
+int dist_normal_pd_list(const double *xs, double *out, size_t n, double mu, double sigma);
+
+/**
+ * @brief P(X <= x) of the normal distribution for a list of x
+ * @param xs Upper bounds
+ * @param out Output probabilities (may alias xs)
+ * @param n Number of values
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_normal_cd_list(const double *xs, double *out, size_t n, double mu, double sigma);
+
+/**
+ * @brief dist_inverse_normal() for a list of areas
+ * @param areas Left-tail areas
+ * @param out Output x (may alias areas)
+ * @param n Number of areas
+ * @param mu Mean
+ * @param sigma Standard deviation, > 0
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_inverse_normal_list(const double *areas, double *out, size_t n, double mu, double sigma);
+
+/**
+ * @brief dist_binomial_pd() for a list of x
+ * @param xs Numbers of successes
+ * @param out Output probabilities (may alias xs)
+ * @param n Number of values
+ * @param trials Number of trials
+ * @param p Success probability
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_binomial_pd_list(const double *xs, double *out, size_t n, double trials, double p);
+
+/**
+ * @brief dist_binomial_cd() for a list of x
+ * @param xs Numbers of successes
+ * @param out Output probabilities (may alias xs)
+ * @param n Number of values
+ * @param trials Number of trials
+ * @param p Success probability
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_binomial_cd_list(const double *xs, double *out, size_t n, double trials, double p);
+
+/**
+ * @brief dist_poisson_pd() for a list of x
+ * @param xs Counts
+ * @param out Output probabilities (may alias xs)
+ * @param n Number of values
+ * @param lambda Mean
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_poisson_pd_list(const double *xs, double *out, size_t n, double lambda);
+
+/**
+ * @brief dist_poisson_cd() for a list of x
+ * @param xs Counts
+ * @param out Output probabilities (may alias xs)
+ * @param n Number of values
+ * @param lambda Mean
+ * @return Number of NAN results, or ERR_DOMAIN_ERROR for invalid parameters
+ */
+int dist_poisson_cd_list(const double *xs, double *out, size_t n, double lambda);
+
+#endif /* DISTRIBUTIONS_H */
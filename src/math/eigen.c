@@ -0,0 +1,661 @@
+/*
+ * Eigenvalues and Singular Values Implementation
+ */
+
+#include "eigen.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define SYMMETRY_TOLERANCE  (16.0 * DBL_EPSILON)   // Relative to the largest element
+#define BALANCE_RADIX       2.0                     // Exact scaling in binary
+#define BALANCE_MAX_PASSES  32
+#define INVERSE_ITERATIONS  3                       // Full solves after the first
+#define INVERSE_SHIFT       1.5e-8                  // About sqrt(DBL_EPSILON)
+#define ROTATION_THETA_MAX  1e150                   // theta^2 would overflow beyond
+
+static bool all_finite(const double *data, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (!isfinite(data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double max_magnitude(const double *data, int count)
+{
+    double largest = 0.0;
+    for (int i = 0; i < count; i++) {
+        double magnitude = fabs(data[i]);
+        if (magnitude > largest) {
+            largest = magnitude;
+        }
+    }
+    return largest;
+}
+
+bool eigen_is_symmetric(const matrix_t *a)
+{
+    if (a->rows == 0 || a->rows != a->cols) {
+        return false;
+    }
+    int n = a->rows;
+    double tolerance = SYMMETRY_TOLERANCE * max_magnitude(a->data, n * n);
+
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            if (fabs(a->data[i * n + j] - a->data[j * n + i]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// tan of the smaller rotation angle that zeroes the pair, from
+// theta = cot(2 angle); sign(theta) / (|theta| + sqrt(theta^2 + 1))
+static double rotation_tangent(double theta)
+{
+    double magnitude = fabs(theta);
+    double t = magnitude > ROTATION_THETA_MAX ? 0.5 / magnitude
+                                              : 1.0 / (magnitude + sqrt(magnitude * magnitude + 1.0));
+    return theta < 0.0 ? -t : t;
+}
+
+// Flip each column of the n x n matrix so its largest component is positive
+static void normalize_signs(double *vectors, int n)
+{
+    for (int j = 0; j < n; j++) {
+        double largest = 0.0;
+        for (int i = 0; i < n; i++) {
+            if (fabs(vectors[i * n + j]) > fabs(largest)) {
+                largest = vectors[i * n + j];
+            }
+        }
+        if (largest < 0.0) {
+            for (int i = 0; i < n; i++) {
+                vectors[i * n + j] = -vectors[i * n + j];
+            }
+        }
+    }
+}
+
+// Order eigenvalues by descending real part, then descending imaginary
+// part, carrying the eigenvector columns along
+static void sort_eigenvalues(eigen_result_t *out)
+{
+    int n = out->n;
+    double *v = out->vectors.data;
+
+    for (int i = 1; i < n; i++) {
+        for (int j = i; j > 0; j--) {
+            bool before = out->real[j] > out->real[j - 1] ||
+                          (out->real[j] == out->real[j - 1] && out->imag[j] > out->imag[j - 1]);
+            if (!before) {
+                break;
+            }
+            double t = out->real[j]; out->real[j] = out->real[j - 1]; out->real[j - 1] = t;
+            t = out->imag[j]; out->imag[j] = out->imag[j - 1]; out->imag[j - 1] = t;
+            for (int r = 0; r < n; r++) {
+                t = v[r * n + j]; v[r * n + j] = v[r * n + j - 1]; v[r * n + j - 1] = t;
+            }
+        }
+    }
+}
+
+int eigen_symmetric(const matrix_t *a, eigen_result_t *out)
+{
+    if (a->rows == 0 || a->rows != a->cols) {
+        return ERR_DIMENSION;
+    }
+    int n = a->rows;
+    double w[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+    double *v = out->vectors.data;
+
+    // Mirror the upper triangle; V starts as the identity
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            w[i * n + j] = w[j * n + i] = a->data[i * n + j];
+        }
+    }
+    if (!all_finite(w, n * n)) {
+        return ERR_OVERFLOW;
+    }
+    matrix_init(&out->vectors, n, n);
+    for (int i = 0; i < n; i++) {
+        v[i * n + i] = 1.0;
+    }
+    out->n = (uint8_t)n;
+    out->iterations = 0;
+
+    // A sweep rotates every off-diagonal pair; one that is already small
+    // against its diagonal elements is left alone, which is the
+    // relative criterion that keeps small eigenvalues accurate
+    for (;;) {
+        bool rotated = false;
+        for (int p = 0; p < n - 1; p++) {
+            for (int q = p + 1; q < n; q++) {
+                double apq = w[p * n + q];
+                double app = w[p * n + p];
+                double aqq = w[q * n + q];
+                if (fabs(apq) <= DBL_EPSILON * sqrt(fabs(app) * fabs(aqq)) ||
+                    fabs(apq) < DBL_MIN) {
+                    continue;
+                }
+                rotated = true;
+
+                double t = rotation_tangent((aqq - app) / (2.0 * apq));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                double tau = s / (1.0 + c);
+
+                w[p * n + p] = app - t * apq;
+                w[q * n + q] = aqq + t * apq;
+                w[p * n + q] = w[q * n + p] = 0.0;
+                for (int r = 0; r < n; r++) {
+                    if (r != p && r != q) {
+                        double g = w[r * n + p];
+                        double h = w[r * n + q];
+                        w[r * n + p] = w[p * n + r] = g - s * (h + g * tau);
+                        w[r * n + q] = w[q * n + r] = h + s * (g - h * tau);
+                    }
+                    double g = v[r * n + p];
+                    double h = v[r * n + q];
+                    v[r * n + p] = g - s * (h + g * tau);
+                    v[r * n + q] = h + s * (g - h * tau);
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+        if (++out->iterations == EIGEN_MAX_SWEEPS) {
+            return ERR_NO_CONVERGENCE;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        out->real[i] = w[i * n + i];
+        out->imag[i] = 0.0;
+    }
+    normalize_signs(v, n);
+    sort_eigenvalues(out);
+    return all_finite(out->real, n) ? 0 : ERR_OVERFLOW;
+}
+
+// The Hessenberg stages index the packed n x n work matrix h
+#define H(i, j) h[(i) * n + (j)]
+
+// Scale rows and columns by powers of the radix until each row and its
+// column have similar norms, which leaves the eigenvalues exactly as
+// they were but makes them better conditioned for QR
+static void balance(double *h, int n)
+{
+    for (int pass = 0; pass < BALANCE_MAX_PASSES; pass++) {
+        bool done = true;
+        for (int i = 0; i < n; i++) {
+            double c = 0.0, r = 0.0;
+            for (int j = 0; j < n; j++) {
+                if (j != i) {
+                    c += fabs(H(j, i));
+                    r += fabs(H(i, j));
+                }
+            }
+            if (c == 0.0 || r == 0.0) {
+                continue;
+            }
+            double g = r / BALANCE_RADIX;
+            double f = 1.0;
+            double s = c + r;
+            while (c < g) {
+                f *= BALANCE_RADIX;
+                c *= BALANCE_RADIX * BALANCE_RADIX;
+            }
+            g = r * BALANCE_RADIX;
+            while (c > g) {
+                f /= BALANCE_RADIX;
+                c /= BALANCE_RADIX * BALANCE_RADIX;
+            }
+            if ((c + r) / f < 0.95 * s) {
+                done = false;
+                for (int j = 0; j < n; j++) {
+                    H(i, j) /= f;
+                    H(j, i) *= f;
+                }
+            }
+        }
+        if (done) {
+            break;
+        }
+    }
+}
+
+// Reduce to upper Hessenberg form by Gaussian elimination with the
+// largest pivot in each column, a similarity transform
+static void reduce_hessenberg(double *h, int n)
+{
+    for (int m = 1; m < n - 1; m++) {
+        double x = 0.0;
+        int pivot = m;
+        for (int j = m; j < n; j++) {
+            if (fabs(H(j, m - 1)) > fabs(x)) {
+                x = H(j, m - 1);
+                pivot = j;
+            }
+        }
+        if (pivot != m) {
+            for (int j = m - 1; j < n; j++) {
+                double t = H(pivot, j); H(pivot, j) = H(m, j); H(m, j) = t;
+            }
+            for (int j = 0; j < n; j++) {
+                double t = H(j, pivot); H(j, pivot) = H(j, m); H(j, m) = t;
+            }
+        }
+        if (x == 0.0) {
+            continue;
+        }
+        for (int i = m + 1; i < n; i++) {
+            double y = H(i, m - 1);
+            if (y == 0.0) {
+                continue;
+            }
+            y /= x;
+            H(i, m - 1) = 0.0;
+            for (int j = m; j < n; j++) {
+                H(i, j) -= y * H(m, j);
+            }
+            for (int j = 0; j < n; j++) {
+                H(j, m) += y * H(j, i);
+            }
+        }
+    }
+}
+
+// Francis double-shift QR on the Hessenberg matrix h (destroyed),
+// deflating 1x1 and 2x2 blocks from the bottom as the subdiagonal
+// vanishes; an exceptional shift every 10 steps breaks cycles
+static int hessenberg_qr(double *h, int n, double *wr, double *wi, int *iterations)
+{
+    double norm = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = i > 0 ? i - 1 : 0; j < n; j++) {
+            norm += fabs(H(i, j));
+        }
+    }
+
+    int nn = n - 1;
+    double shift = 0.0;
+    double p = 0.0, q = 0.0, r = 0.0, s, w, x, y, z;
+
+    while (nn >= 0) {
+        int its = 0;
+        int l;
+        do {
+            // Look for a negligible subdiagonal element
+            for (l = nn; l >= 1; l--) {
+                s = fabs(H(l - 1, l - 1)) + fabs(H(l, l));
+                if (s == 0.0) {
+                    s = norm;
+                }
+                if (fabs(H(l, l - 1)) <= DBL_EPSILON * s) {
+                    H(l, l - 1) = 0.0;
+                    break;
+                }
+            }
+            x = H(nn, nn);
+            if (l == nn) {
+                // One root
+                wr[nn] = x + shift;
+                wi[nn] = 0.0;
+                nn--;
+                continue;
+            }
+            y = H(nn - 1, nn - 1);
+            w = H(nn, nn - 1) * H(nn - 1, nn);
+            if (l == nn - 1) {
+                // Two roots, a real pair or a conjugate pair
+                p = 0.5 * (y - x);
+                q = p * p + w;
+                z = sqrt(fabs(q));
+                x += shift;
+                if (q >= 0.0) {
+                    z = p + copysign(z, p);
+                    wr[nn - 1] = wr[nn] = x + z;
+                    if (z != 0.0) {
+                        wr[nn] = x - w / z;
+                    }
+                    wi[nn - 1] = wi[nn] = 0.0;
+                } else {
+                    wr[nn - 1] = wr[nn] = x + p;
+                    wi[nn - 1] = z;
+                    wi[nn] = -z;
+                }
+                nn -= 2;
+                continue;
+            }
+
+            if (its == EIGEN_MAX_QR_ITERATIONS) {
+                return ERR_NO_CONVERGENCE;
+            }
+            if (its > 0 && its % 10 == 0) {
+                shift += x;
+                for (int i = 0; i <= nn; i++) {
+                    H(i, i) -= x;
+                }
+                s = fabs(H(nn, nn - 1)) + fabs(H(nn - 1, nn - 2));
+                y = x = 0.75 * s;
+                w = -0.4375 * s * s;
+            }
+            its++;
+            (*iterations)++;
+
+            // Start the bulge where two consecutive subdiagonal elements are small
+            int m;
+            for (m = nn - 2; m >= l; m--) {
+                z = H(m, m);
+                r = x - z;
+                s = y - z;
+                p = (r * s - w) / H(m + 1, m) + H(m, m + 1);
+                q = H(m + 1, m + 1) - z - r - s;
+                r = H(m + 2, m + 1);
+                s = fabs(p) + fabs(q) + fabs(r);
+                p /= s;
+                q /= s;
+                r /= s;
+                if (m == l) {
+                    break;
+                }
+                double u = fabs(H(m, m - 1)) * (fabs(q) + fabs(r));
+                double v = fabs(p) * (fabs(H(m - 1, m - 1)) + fabs(z) + fabs(H(m + 1, m + 1)));
+                if (u <= DBL_EPSILON * v) {
+                    break;
+                }
+            }
+            for (int i = m + 2; i <= nn; i++) {
+                H(i, i - 2) = 0.0;
+                if (i != m + 2) {
+                    H(i, i - 3) = 0.0;
+                }
+            }
+
+            // Chase the bulge down with 3x3 Householder reflections
+            for (int k = m; k <= nn - 1; k++) {
+                if (k != m) {
+                    p = H(k, k - 1);
+                    q = H(k + 1, k - 1);
+                    r = k != nn - 1 ? H(k + 2, k - 1) : 0.0;
+                    x = fabs(p) + fabs(q) + fabs(r);
+                    if (x != 0.0) {
+                        p /= x;
+                        q /= x;
+                        r /= x;
+                    }
+                }
+                s = copysign(sqrt(p * p + q * q + r * r), p);
+                if (s == 0.0) {
+                    continue;
+                }
+                if (k == m) {
+                    if (l != m) {
+                        H(k, k - 1) = -H(k, k - 1);
+                    }
+                } else {
+                    H(k, k - 1) = -s * x;
+                }
+                p += s;
+                x = p / s;
+                y = q / s;
+                z = r / s;
+                q /= p;
+                r /= p;
+                for (int j = k; j <= nn; j++) {
+                    p = H(k, j) + q * H(k + 1, j);
+                    if (k != nn - 1) {
+                        p += r * H(k + 2, j);
+                        H(k + 2, j) -= p * z;
+                    }
+                    H(k + 1, j) -= p * y;
+                    H(k, j) -= p * x;
+                }
+                int last = nn < k + 3 ? nn : k + 3;
+                for (int i = l; i <= last; i++) {
+                    p = x * H(i, k) + y * H(i, k + 1);
+                    if (k != nn - 1) {
+                        p += z * H(i, k + 2);
+                        H(i, k + 2) -= p * r;
+                    }
+                    H(i, k + 1) -= p * q;
+                    H(i, k) -= p;
+                }
+            }
+        } while (l < nn - 1);
+    }
+    return 0;
+}
+
+#undef H
+
+// Unit eigenvector of a for the real eigenvalue lambda by inverse
+// iteration with A - (lambda + delta) I. The shift delta is about
+// sqrt(eps) |A|: far enough from lambda that the factorization still
+// resolves it, for a defective eigenvalue too, yet each step multiplies
+// the wanted direction by about 1 / delta against the others, so three
+// steps are plenty. The first step solves U x = 1 only, which cannot
+// start orthogonal to the answer.
+static void inverse_iteration(const matrix_t *a, double lambda, matrix_t *shifted, double *x)
+{
+    int n = a->rows;
+    matrix_lu_t lu;
+
+    double delta = INVERSE_SHIFT * n * max_magnitude(a->data, n * n);
+    if (delta == 0.0) {
+        delta = INVERSE_SHIFT;
+    }
+    *shifted = *a;
+    for (int i = 0; i < n; i++) {
+        shifted->data[i * n + i] -= lambda + delta;
+    }
+    matrix_lu(shifted, &lu);
+    for (int i = 0; i < n; i++) {
+        if (lu.lu[i * n + i] == 0.0) {
+            lu.lu[i * n + i] = delta;
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        double sum = 1.0;
+        for (int j = i + 1; j < n; j++) {
+            sum -= lu.lu[i * n + j] * x[j];
+        }
+        x[i] = sum / lu.lu[i * n + i];
+    }
+    for (int step = 0;; step++) {
+        double norm = 0.0;
+        for (int i = 0; i < n; i++) {
+            norm += x[i] * x[i];
+        }
+        norm = sqrt(norm);
+        for (int i = 0; i < n; i++) {
+            x[i] /= norm;
+        }
+        if (step == INVERSE_ITERATIONS) {
+            break;
+        }
+        matrix_lu_solve(&lu, x, x);
+    }
+}
+
+int eigen_general(const matrix_t *a, eigen_result_t *out)
+{
+    if (a->rows == 0 || a->rows != a->cols) {
+        return ERR_DIMENSION;
+    }
+    int n = a->rows;
+    double h[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+
+    if (!all_finite(a->data, n * n)) {
+        return ERR_OVERFLOW;
+    }
+    memcpy(h, a->data, (size_t)(n * n) * sizeof(double));
+    out->n = (uint8_t)n;
+    out->iterations = 0;
+
+    balance(h, n);
+    reduce_hessenberg(h, n);
+    int status = hessenberg_qr(h, n, out->real, out->imag, &out->iterations);
+    if (status != 0) {
+        return status;
+    }
+    if (!all_finite(out->real, n) || !all_finite(out->imag, n)) {
+        return ERR_OVERFLOW;
+    }
+
+    // h is free again: the eigenvectors collect there while
+    // out->vectors holds A - lambda I
+    for (int j = 0; j < n; j++) {
+        double x[MATRIX_MAX_DIM];
+        if (out->imag[j] != 0.0) {
+            for (int i = 0; i < n; i++) {
+                x[i] = NAN;
+            }
+        } else {
+            inverse_iteration(a, out->real[j], &out->vectors, x);
+        }
+        for (int i = 0; i < n; i++) {
+            h[i * n + j] = x[i];
+        }
+    }
+    out->vectors.rows = (uint8_t)n;
+    out->vectors.cols = (uint8_t)n;
+    memcpy(out->vectors.data, h, (size_t)(n * n) * sizeof(double));
+    normalize_signs(out->vectors.data, n);
+    sort_eigenvalues(out);
+    return 0;
+}
+
+int svd_jacobi(const matrix_t *a, svd_result_t *out)
+{
+    if (a->rows == 0) {
+        return ERR_DIMENSION;
+    }
+    // Work on whichever of A and A^T has no more columns than rows
+    bool transposed = a->rows < a->cols;
+    int m = transposed ? a->cols : a->rows;     // Column length
+    int k = transposed ? a->rows : a->cols;     // Columns
+    int stride = a->cols;
+
+    // Row j of w is column j of the working matrix, and row j of vt is
+    // column j of V, so every rotation runs along contiguous memory
+    double w[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+    double vt[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+    for (int j = 0; j < k; j++) {
+        for (int i = 0; i < m; i++) {
+            w[j * m + i] = transposed ? a->data[j * stride + i] : a->data[i * stride + j];
+        }
+        for (int i = 0; i < k; i++) {
+            vt[j * k + i] = i == j ? 1.0 : 0.0;
+        }
+    }
+    if (!all_finite(w, m * k)) {
+        return ERR_OVERFLOW;
+    }
+    out->k = (uint8_t)k;
+    out->sweeps = 0;
+
+    // A column below rounding of the whole matrix is a zero singular
+    // value; rotating it against the others only stirs the rounding noise
+    double negligible = 0.0;
+    for (int i = 0; i < m * k; i++) {
+        negligible += w[i] * w[i];
+    }
+    negligible *= DBL_EPSILON * DBL_EPSILON;
+
+    // The dot products carry about m roundings, so a pair is orthogonal
+    // once their cosine is below that; a tighter test can cycle forever
+    // on the rounding of the last rotation
+    double tolerance = m * DBL_EPSILON;
+
+    for (;;) {
+        bool rotated = false;
+        for (int p = 0; p < k - 1; p++) {
+            for (int q = p + 1; q < k; q++) {
+                double *wp = &w[p * m];
+                double *wq = &w[q * m];
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (int i = 0; i < m; i++) {
+                    alpha += wp[i] * wp[i];
+                    beta += wq[i] * wq[i];
+                    gamma += wp[i] * wq[i];
+                }
+                if (fabs(gamma) <= tolerance * sqrt(alpha) * sqrt(beta) ||
+                    alpha <= negligible || beta <= negligible) {
+                    continue;
+                }
+                rotated = true;
+
+                double t = rotation_tangent((beta - alpha) / (2.0 * gamma));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int i = 0; i < m; i++) {
+                    double x = wp[i];
+                    double y = wq[i];
+                    wp[i] = c * x - s * y;
+                    wq[i] = s * x + c * y;
+                }
+                double *vp = &vt[p * k];
+                double *vq = &vt[q * k];
+                for (int i = 0; i < k; i++) {
+                    double x = vp[i];
+                    double y = vq[i];
+                    vp[i] = c * x - s * y;
+                    vq[i] = s * x + c * y;
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+        if (++out->sweeps == EIGEN_MAX_SWEEPS) {
+            return ERR_NO_CONVERGENCE;
+        }
+    }
+
+    // The column norms are the singular values; sort them descending
+    // with their columns
+    int order[MATRIX_MAX_DIM];
+    for (int j = 0; j < k; j++) {
+        double norm = 0.0;
+        for (int i = 0; i < m; i++) {
+            norm += w[j * m + i] * w[j * m + i];
+        }
+        out->values[j] = sqrt(norm);
+        order[j] = j;
+    }
+    for (int i = 1; i < k; i++) {
+        for (int j = i; j > 0 && out->values[order[j]] > out->values[order[j - 1]]; j--) {
+            int t = order[j]; order[j] = order[j - 1]; order[j - 1] = t;
+        }
+    }
+
+    // The working matrix is U Sigma V^T; for A^T the roles of U and V swap
+    matrix_t *u = transposed ? &out->v : &out->u;
+    matrix_t *v = transposed ? &out->u : &out->v;
+    double values[MATRIX_MAX_DIM];
+    matrix_init(u, m, k);
+    matrix_init(v, k, k);
+    for (int j = 0; j < k; j++) {
+        int src = order[j];
+        double sigma = out->values[src];
+        values[j] = sigma;
+        for (int i = 0; i < m; i++) {
+            u->data[i * k + j] = sigma > 0.0 ? w[src * m + i] / sigma : 0.0;
+        }
+        for (int i = 0; i < k; i++) {
+            v->data[i * k + j] = vt[src * k + i];
+        }
+    }
+    memcpy(out->values, values, (size_t)k * sizeof(double));
+    return all_finite(out->values, k) ? 0 : ERR_OVERFLOW;
+}
@@ -0,0 +1,165 @@
+/*
+ * Evaluator Numeric Type
+ *
+ * Selects the arithmetic type used on the evaluator's value stacks and
+ * the math kernels that go with it. Parsed literals, variables and the
+ * public results stay double; only the evaluation itself changes type.
+ *
+ * - CONFIG_CALC_EVAL_DOUBLE (default): IEEE double, libm double kernels
+ * - CONFIG_CALC_EVAL_FLOAT: IEEE single, libm float kernels. Intended
+ *   for cores whose FPU only implements single precision (Cortex-M33,
+ *   Cortex-M4F), where every double operation goes through soft-float.
+ *
+ * With CONFIG_CALC_FAST_MATH the double kernels come from fast_math.c
+ * instead of libm; sqrt, fabs and floor stay on libm, which maps them
+ * to single instructions on FPU targets.
+ *
+ * num_sin_pio4() and friends take an argument the caller has already
+ * reduced to [-pi/4, pi/4]. libm reduces anyway; the fast_math kernels
+ * skip straight to the polynomial.
+ */
+
+#ifndef EVAL_NUMERIC_H
+#define EVAL_NUMERIC_H
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(CONFIG_CALC_EVAL_FLOAT)
+
+typedef float eval_num_t;
+
+#define EVAL_NUM_NAME       "float"
+#define EVAL_NUM_MAX        FLT_MAX
+#define EVAL_NUM_EPSILON    FLT_EPSILON
+#define EVAL_NUM_PI         3.14159265358979323846f
+#define EVAL_NUM_LN10       2.30258509299404568402f
+
+// Degree-mode trig; see the DEG helpers in expression_evaluator.c
+#define EVAL_NUM_RAD_PER_DEG  0.01745329251994329576924f
+#define EVAL_NUM_DEG_PER_RAD  57.29577951308232087680f
+#define EVAL_NUM_SQRT1_2      0.70710678118654752440f
+#define EVAL_NUM_SQRT3_2      0.86602540378443864676f
+#define EVAL_NUM_SQRT3        1.73205080756887729353f
+#define EVAL_NUM_INV_SQRT3    0.57735026918962576451f
+#define EVAL_DEG_REDUCE_MAX   16777216.0f           // 2^24; x - 90 * n exact below
+
+static inline eval_num_t num_sin(eval_num_t x) { return sinf(x); }
+static inline eval_num_t num_cos(eval_num_t x) { return cosf(x); }
+static inline eval_num_t num_tan(eval_num_t x) { return tanf(x); }
+static inline eval_num_t num_sin_pio4(eval_num_t x) { return sinf(x); }
+static inline eval_num_t num_cos_pio4(eval_num_t x) { return cosf(x); }
+static inline eval_num_t num_tan_pio4(eval_num_t x) { return tanf(x); }
+static inline eval_num_t num_asin(eval_num_t x) { return asinf(x); }
+static inline eval_num_t num_acos(eval_num_t x) { return acosf(x); }
+static inline eval_num_t num_atan(eval_num_t x) { return atanf(x); }
+static inline eval_num_t num_log(eval_num_t x) { return logf(x); }
+static inline eval_num_t num_log10(eval_num_t x) { return log10f(x); }
+static inline eval_num_t num_sqrt(eval_num_t x) { return sqrtf(x); }
+static inline eval_num_t num_fabs(eval_num_t x) { return fabsf(x); }
+static inline eval_num_t num_exp(eval_num_t x) { return expf(x); }
+static inline eval_num_t num_sinh(eval_num_t x) { return sinhf(x); }
+static inline eval_num_t num_cosh(eval_num_t x) { return coshf(x); }
+static inline eval_num_t num_tanh(eval_num_t x) { return tanhf(x); }
+static inline eval_num_t num_floor(eval_num_t x) { return floorf(x); }
+static inline eval_num_t num_fmod(eval_num_t x, eval_num_t y) { return fmodf(x, y); }
+
+// Round |x| < 2^22 to the nearest integer; *mod4 gets it modulo 4
+static inline eval_num_t num_round_mod4(eval_num_t x, int *mod4)
+{
+    float shifted = x + 12582912.0f;    // 1.5 * 2^23
+    uint32_t bits;
+    memcpy(&bits, &shifted, sizeof(bits));
+    *mod4 = (int)(bits & 3);
+    return shifted - 12582912.0f;
+}
+static inline eval_num_t num_pow(eval_num_t x, eval_num_t y) { return powf(x, y); }
+
+#else
+
+typedef double eval_num_t;
+
+#define EVAL_NUM_NAME       "double"
+#define EVAL_NUM_MAX        DBL_MAX
+#define EVAL_NUM_EPSILON    DBL_EPSILON
+#define EVAL_NUM_PI         3.14159265358979323846
+#define EVAL_NUM_LN10       2.30258509299404568402
+
+// Degree-mode trig; see the DEG helpers in expression_evaluator.c
+#define EVAL_NUM_RAD_PER_DEG  0.01745329251994329576924
+#define EVAL_NUM_DEG_PER_RAD  57.29577951308232087680
+#define EVAL_NUM_SQRT1_2      0.70710678118654752440
+#define EVAL_NUM_SQRT3_2      0.86602540378443864676
+#define EVAL_NUM_SQRT3        1.73205080756887729353
+#define EVAL_NUM_INV_SQRT3    0.57735026918962576451
+#define EVAL_DEG_REDUCE_MAX   4503599627370496.0    // 2^52; x - 90 * n exact below
+
+#if defined(CONFIG_CALC_FAST_MATH)
+
+#include "fast_math.h"
+
+static inline eval_num_t num_sin(eval_num_t x) { return fm_sin(x); }
+static inline eval_num_t num_cos(eval_num_t x) { return fm_cos(x); }
+static inline eval_num_t num_tan(eval_num_t x) { return fm_tan(x); }
+static inline eval_num_t num_sin_pio4(eval_num_t x) { return fm_sin_pio4(x); }
+static inline eval_num_t num_cos_pio4(eval_num_t x) { return fm_cos_pio4(x); }
+static inline eval_num_t num_tan_pio4(eval_num_t x) { return fm_tan_pio4(x); }
+static inline eval_num_t num_asin(eval_num_t x) { return fm_asin(x); }
+static inline eval_num_t num_acos(eval_num_t x) { return fm_acos(x); }
+static inline eval_num_t num_atan(eval_num_t x) { return fm_atan(x); }
+static inline eval_num_t num_log(eval_num_t x) { return fm_log(x); }
+static inline eval_num_t num_log10(eval_num_t x) { return fm_log10(x); }
+static inline eval_num_t num_exp(eval_num_t x) { return fm_exp(x); }
+static inline eval_num_t num_sinh(eval_num_t x) { return fm_sinh(x); }
+static inline eval_num_t num_cosh(eval_num_t x) { return fm_cosh(x); }
+static inline eval_num_t num_tanh(eval_num_t x) { return fm_tanh(x); }
+static inline eval_num_t num_pow(eval_num_t x, eval_num_t y) { return fm_pow(x, y); }
+
+#else
+
+static inline eval_num_t num_sin(eval_num_t x) { return sin(x); }
+static inline eval_num_t num_cos(eval_num_t x) { return cos(x); }
+static inline eval_num_t num_tan(eval_num_t x) { return tan(x); }
+static inline eval_num_t num_sin_pio4(eval_num_t x) { return sin(x); }
+static inline eval_num_t num_cos_pio4(eval_num_t x) { return cos(x); }
+static inline eval_num_t num_tan_pio4(eval_num_t x) { return tan(x); }
+static inline eval_num_t num_asin(eval_num_t x) { return asin(x); }
+static inline eval_num_t num_acos(eval_num_t x) { return acos(x); }
+static inline eval_num_t num_atan(eval_num_t x) { return atan(x); }
+static inline eval_num_t num_log(eval_num_t x) { return log(x); }
+static inline eval_num_t num_log10(eval_num_t x) { return log10(x); }
+static inline eval_num_t num_exp(eval_num_t x) { return exp(x); }
+static inline eval_num_t num_sinh(eval_num_t x) { return sinh(x); }
+static inline eval_num_t num_cosh(eval_num_t x) { return cosh(x); }
+static inline eval_num_t num_tanh(eval_num_t x) { return tanh(x); }
+static inline eval_num_t num_pow(eval_num_t x, eval_num_t y) { return pow(x, y); }
+
+#endif
+
+static inline eval_num_t num_sqrt(eval_num_t x) { return sqrt(x); }
+static inline eval_num_t num_fabs(eval_num_t x) { return fabs(x); }
+static inline eval_num_t num_floor(eval_num_t x) { return floor(x); }
+static inline eval_num_t num_fmod(eval_num_t x, eval_num_t y) { return fmod(x, y); }
+
+// Round |x| < 2^51 to the nearest integer; *mod4 gets it modulo 4
+static inline eval_num_t num_round_mod4(eval_num_t x, int *mod4)
+{
+    double shifted = x + 6755399441055744.0;    // 1.5 * 2^52
+    uint64_t bits;
+    memcpy(&bits, &shifted, sizeof(bits));
+    *mod4 = (int)(bits & 3);
+    return shifted - 6755399441055744.0;
+}
+
+#endif
+
+// x^y for the '^' operator: a square is one multiply, which pow() only
+// matches where it is correctly rounded, so every evaluator squares alike
+static inline eval_num_t num_power(eval_num_t x, eval_num_t y)
+{
+    return y == 2 ? x * x : num_pow(x, y);
+}
+
+#endif /* EVAL_NUMERIC_H */
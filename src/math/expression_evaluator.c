@@ -4,11 +4,15 @@
  */
 
 #include "expression_evaluator.h"
+#include "expression_vm.h"
+#include "special_functions.h"
+#include "distributions.h"
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 #include <ctype.h>
 
 // Define math constants if not available
@@ -21,15 +25,6 @@
 
 LOG_MODULE_REGISTER(expression_evaluator, LOG_LEVEL_INF);
 
-// Error codes
-#define ERR_SYNTAX_ERROR        -1
-#define ERR_DIVISION_BY_ZERO    -2
-#define ERR_DOMAIN_ERROR        -3
-#define ERR_OVERFLOW            -4
-#define ERR_STACK_OVERFLOW      -5
-#define ERR_UNKNOWN_FUNCTION    -6
-#define ERR_MISMATCHED_PARENS   -7
-
 // Function name mapping
 static const char* function_names[FUNC_COUNT] = {
     "sin", "cos", "tan",
@@ -37,42 +32,29 @@ static const char* function_names[FUNC_COUNT] = {
     "log", "ln", "log10",
     "sqrt", "abs", "exp",
     "sinh", "cosh", "tanh",
-    "!"
+    "!",
+    "normpd", "normcd", "invnorm",
+    "dot", "angle", "unitV",
+    "arg", "conj"
 };
 
-// Function name patterns for parsing
-static const struct {
-    const char* pattern;
-    function_type_t type;
-} function_patterns[] = {
-    {"sin⁻¹", FUNC_ASIN}, {"cos⁻¹", FUNC_ACOS}, {"tan⁻¹", FUNC_ATAN},
-    {"sin", FUNC_SIN}, {"cos", FUNC_COS}, {"tan", FUNC_TAN},
-    {"sinh", FUNC_SINH}, {"cosh", FUNC_COSH}, {"tanh", FUNC_TANH},
-    {"log", FUNC_LOG}, {"ln", FUNC_LN}, {"log10", FUNC_LOG10},
-    {"sqrt", FUNC_SQRT}, {"abs", FUNC_ABS}, {"exp", FUNC_EXP}
-};
+// Compiled-expression cache (LRU, keyed by FNV-1a hash of the expression text
+// and the angle mode the program was constant-folded for). Entries hold VM
+// bytecode; RPN the VM cannot compile runs from the scratch queue uncached.
+typedef struct {
+    bool valid;
+    bool deg_mode;
+    uint32_t hash;
+    uint32_t last_used;
+    char expression[MAX_EXPRESSION_LENGTH];
+    expr_program_t program;
+} expr_cache_entry_t;
 
-// Constant patterns
-static const struct {
-    const char* pattern;
-    constant_type_t type;
-    double value;
-} constant_patterns[] = {
-    {"π", CONST_PI, M_PI},
-    {"pi", CONST_PI, M_PI},
-    {"e", CONST_E, M_E}
-};
-
-// Variable patterns
-static const struct {
-    const char* pattern;
-    variable_type_t type;
-} variable_patterns[] = {
-    {"Ans", VAR_ANS},
-    {"X", VAR_X}, {"Y", VAR_Y},
-    {"A", VAR_A}, {"B", VAR_B}, {"C", VAR_C}, {"D", VAR_D},
-    {"M", VAR_M}
-};
+static expr_cache_entry_t expr_cache[EXPR_CACHE_SIZE];
+static rpn_queue_t expr_scratch;        // Parse target until the program is known good
+static expr_program_t program_scratch;  // Bytecode for text too long to cache
+static uint32_t expr_cache_clock;
+static expr_cache_stats_t expr_cache_stats;
 
 int get_operator_precedence(char op)
 {
@@ -85,6 +67,8 @@ int get_operator_precedence(char op)
             return 2;
         case '^':
             return 3;
+        case OPERATOR_POLAR:
+            return 4;
         default:
             return 0;
     }
@@ -115,8 +99,7 @@ double get_constant_value(constant_type_t constant)
     }
 }
 
-// Get variable value from storage
-static double get_variable_value(variable_type_t var, const variable_storage_t *storage)
+double get_variable_value(variable_type_t var, const variable_storage_t *storage)
 {
     switch (var) {
         case VAR_ANS: return storage->ans;
@@ -131,62 +114,197 @@ static double get_variable_value(variable_type_t var, const variable_storage_t *
     }
 }
 
-// Calculate factorial
-static double factorial(double n)
+// x! = Gamma(x + 1); integers 0..170 are a table lookup
+static eval_num_t factorial(eval_num_t x)
 {
-    if (n < 0 || n != floor(n) || n > 170) {
-        return NAN; // Invalid input or would overflow
+    double result = sf_factorial(x);
+
+    // Out of range for eval_num_t (35! and up in float) is an overflow
+    return fabs(result) <= EVAL_NUM_MAX ? (eval_num_t)result : NAN;
+}
+
+// DEG-mode trig stays in degrees until the final kernel call. The
+// argument is reduced exactly to t in [-45, 45] plus a quadrant, so the
+// radian kernel only sees |x| <= pi/4 and multiples of 30 and 45 degrees
+// come out of a table exactly.
+typedef struct {
+    eval_num_t sin, cos, tan, cot;
+} special_angle_t;
+
+// Values at t = 0, 30 and 45 degrees; cot(0) is the pole of tan(90)
+static const special_angle_t special_angles[] = {
+    {0, 1, 0, NAN},
+    {0.5, EVAL_NUM_SQRT3_2, EVAL_NUM_INV_SQRT3, EVAL_NUM_SQRT3},
+    {EVAL_NUM_SQRT1_2, EVAL_NUM_SQRT1_2, 1, 1},
+};
+
+// Reduce finite degrees to t in [-45, 45] with deg = t + 90 * quadrant (mod 360)
+static eval_num_t reduce_degrees(eval_num_t deg, int *quadrant)
+{
+    if (num_fabs(deg) >= EVAL_DEG_REDUCE_MAX) {
+        deg = num_fmod(deg, 360);
     }
-    
-    double result = 1.0;
-    for (int i = 2; i <= (int)n; i++) {
-        result *= i;
+
+    // 90 * n is exact below the limit, so the difference is too
+    eval_num_t n = num_round_mod4(deg * (eval_num_t)(1.0 / 90), quadrant);
+    return deg - 90 * n;
+}
+
+// Table entry for t = 0, +-30 or +-45 degrees, NULL otherwise
+static const special_angle_t *find_special_angle(eval_num_t t)
+{
+    eval_num_t a = num_fabs(t);
+
+    if (a == 0) return &special_angles[0];
+    if (a == 30) return &special_angles[1];
+    if (a == 45) return &special_angles[2];
+    return NULL;
+}
+
+static eval_num_t sin_reduced_degrees(eval_num_t t)
+{
+    const special_angle_t *special = find_special_angle(t);
+
+    if (special) {
+        return t < 0 ? -special->sin : special->sin;
     }
-    return result;
+    return num_sin_pio4(t * EVAL_NUM_RAD_PER_DEG);
 }
 
-// Apply mathematical function
-static double apply_function(function_type_t func, double arg, bool deg_mode)
+static eval_num_t cos_reduced_degrees(eval_num_t t)
 {
-    // Convert angle to radians if in degree mode
-    double angle_arg = arg;
-    if (deg_mode && (func == FUNC_SIN || func == FUNC_COS || func == FUNC_TAN)) {
-        angle_arg = arg * M_PI / 180.0;
+    const special_angle_t *special = find_special_angle(t);
+
+    return special ? special->cos : num_cos_pio4(t * EVAL_NUM_RAD_PER_DEG);
+}
+
+// sin, cos or tan of an angle in degrees
+static eval_num_t trig_degrees(function_type_t func, eval_num_t deg)
+{
+    const special_angle_t *special;
+    eval_num_t result;
+    int quadrant;
+
+    if (!isfinite(deg)) {
+        return NAN;
     }
-    
-    double result;
+
+    eval_num_t t = reduce_degrees(deg, &quadrant);
     switch (func) {
-        case FUNC_SIN: result = sin(angle_arg); break;
-        case FUNC_COS: result = cos(angle_arg); break;
-        case FUNC_TAN: result = tan(angle_arg); break;
-        case FUNC_ASIN: 
-            result = asin(arg);
-            if (deg_mode) result = result * 180.0 / M_PI;
+        case FUNC_SIN:
+            result = (quadrant & 1) ? cos_reduced_degrees(t) : sin_reduced_degrees(t);
+            if (quadrant >= 2) result = -result;
             break;
-        case FUNC_ACOS:
-            result = acos(arg);
-            if (deg_mode) result = result * 180.0 / M_PI;
+        case FUNC_COS:
+            result = (quadrant & 1) ? sin_reduced_degrees(t) : cos_reduced_degrees(t);
+            if (quadrant == 1 || quadrant == 2) result = -result;
             break;
-        case FUNC_ATAN:
-            result = atan(arg);
-            if (deg_mode) result = result * 180.0 / M_PI;
+        default:
+            // tan has period 180: odd quadrants give -cot(t)
+            special = find_special_angle(t);
+            if (special) {
+                result = (quadrant & 1) ? -special->cot : special->tan;
+                if (t < 0) result = -result;
+            } else {
+                result = num_tan_pio4(t * EVAL_NUM_RAD_PER_DEG);
+                if (quadrant & 1) result = -1 / result;
+            }
             break;
-        case FUNC_LOG: result = log10(arg); break;
-        case FUNC_LN: result = log(arg); break;
-        case FUNC_LOG10: result = log10(arg); break;
-        case FUNC_SQRT: result = sqrt(arg); break;
-        case FUNC_ABS: result = fabs(arg); break;
-        case FUNC_EXP: result = exp(arg); break;
-        case FUNC_SINH: result = sinh(arg); break;
-        case FUNC_COSH: result = cosh(arg); break;
-        case FUNC_TANH: result = tanh(arg); break;
+    }
+
+    // sin(180) and friends would otherwise display as -0
+    return result == 0 ? 0 : result;
+}
+
+// Rounding in asin, acos or atan and the scale to degrees stays within this
+// many ulps, so only a result this close to a multiple of 15 can be one
+#define SNAP_ULPS 4
+
+// Snap an inverse trig result in degrees to the multiple of 15 it lies
+// within a few ulps of, when the forward function maps that back to x
+// exactly, so asin(0.5) = 30 and atan(1) = 45
+static eval_num_t snap_degrees(function_type_t forward, eval_num_t degrees, eval_num_t x)
+{
+    int quadrant;
+    eval_num_t nearest = 15 * num_round_mod4(degrees * (eval_num_t)(1.0 / 15), &quadrant);
+
+    if (num_fabs(degrees - nearest) <= SNAP_ULPS * EVAL_NUM_EPSILON * num_fabs(nearest) &&
+        trig_degrees(forward, nearest) == x) {
+        return nearest;
+    }
+    return degrees;
+}
+
+eval_num_t apply_function(function_type_t func, eval_num_t arg, bool deg_mode)
+{
+    if (deg_mode) {
+        switch (func) {
+            case FUNC_SIN:
+            case FUNC_COS:
+            case FUNC_TAN:
+                return trig_degrees(func, arg);
+            case FUNC_ASIN:
+                return snap_degrees(FUNC_SIN, num_asin(arg) * EVAL_NUM_DEG_PER_RAD, arg);
+            case FUNC_ACOS:
+                return snap_degrees(FUNC_COS, num_acos(arg) * EVAL_NUM_DEG_PER_RAD, arg);
+            case FUNC_ATAN:
+                return snap_degrees(FUNC_TAN, num_atan(arg) * EVAL_NUM_DEG_PER_RAD, arg);
+            default:
+                break;
+        }
+    }
+
+    eval_num_t result;
+    switch (func) {
+        case FUNC_SIN: result = num_sin(arg); break;
+        case FUNC_COS: result = num_cos(arg); break;
+        case FUNC_TAN: result = num_tan(arg); break;
+        case FUNC_ASIN: result = num_asin(arg); break;
+        case FUNC_ACOS: result = num_acos(arg); break;
+        case FUNC_ATAN: result = num_atan(arg); break;
+        case FUNC_LOG: result = num_log10(arg); break;
+        case FUNC_LN: result = num_log(arg); break;
+        case FUNC_LOG10: result = num_log10(arg); break;
+        case FUNC_SQRT: result = num_sqrt(arg); break;
+        case FUNC_ABS: result = num_fabs(arg); break;
+        case FUNC_EXP: result = num_exp(arg); break;
+        case FUNC_SINH: result = num_sinh(arg); break;
+        case FUNC_COSH: result = num_cosh(arg); break;
+        case FUNC_TANH: result = num_tanh(arg); break;
         case FUNC_FACTORIAL: result = factorial(arg); break;
+        case FUNC_NORM_PD: result = (eval_num_t)dist_normal_pd(arg, 0.0, 1.0); break;
+        case FUNC_NORM_CD: result = (eval_num_t)dist_normal_cd(-INFINITY, arg, 0.0, 1.0); break;
+        case FUNC_INV_NORM: result = (eval_num_t)dist_inverse_normal(arg, 0.0, 1.0); break;
+        // dot, angle, unitV, arg and conj only exist in the vector and complex evaluators
         default: return NAN;
     }
     
     return result;
 }
 
+// Apply binary operator; shared by the evaluators and the constant folder
+int apply_operator(char op, eval_num_t a, eval_num_t b, eval_num_t *result)
+{
+    switch (op) {
+        case '+': *result = a + b; break;
+        case '-': *result = a - b; break;
+        case '*': *result = a * b; break;
+        case '/':
+            if (num_fabs(b) < 1e-15) {
+                return ERR_DIVISION_BY_ZERO;
+            }
+            *result = a / b;
+            break;
+        case '^': *result = num_power(a, b); break;
+        default: return ERR_SYNTAX_ERROR;
+    }
+    
+    if (!isfinite(*result)) {
+        return ERR_OVERFLOW;
+    }
+    return 0;
+}
+
 // Tokenizer helper functions
 static int skip_whitespace(const char *expr, int pos)
 {
@@ -203,44 +321,162 @@ static int parse_number(const char *expr, int pos, double *number)
     return endptr - expr;
 }
 
-static int parse_function(const char *expr, int pos, function_type_t *function)
+// Identifier lexer: a hand-built DFA over the fixed vocabulary of function,
+// constant and variable names. Each branch follows one input byte, and the
+// longest accepted name wins (sinh over sin, log10 over log, exp over e).
+#define LEX_ACCEPT(n, tok_type, field, val) \
+    do { token->type = (tok_type); token->value.field = (val); len = (n); } while (0)
+
+// UTF-8 superscript minus one: U+207B U+00B9
+static bool is_inverse_suffix(const char *s)
 {
-    for (int i = 0; i < sizeof(function_patterns) / sizeof(function_patterns[0]); i++) {
-        int len = strlen(function_patterns[i].pattern);
-        if (strncmp(&expr[pos], function_patterns[i].pattern, len) == 0) {
-            *function = function_patterns[i].type;
-            return pos + len;
-        }
-    }
-    return -1; // Not found
+    return (uint8_t)s[0] == 0xE2 && (uint8_t)s[1] == 0x81 && (uint8_t)s[2] == 0xBB &&
+           (uint8_t)s[3] == 0xC2 && (uint8_t)s[4] == 0xB9;
 }
 
-static int parse_constant(const char *expr, int pos, constant_type_t *constant)
+// sin/cos/tan followed by optional 'h' or '⁻¹'; s points past the 3 letters
+static int lex_trig_suffix(const char *s, token_t *token, function_type_t base,
+                           function_type_t hyperbolic, function_type_t inverse)
 {
-    for (int i = 0; i < sizeof(constant_patterns) / sizeof(constant_patterns[0]); i++) {
-        int len = strlen(constant_patterns[i].pattern);
-        if (strncmp(&expr[pos], constant_patterns[i].pattern, len) == 0) {
-            *constant = constant_patterns[i].type;
-            return pos + len;
-        }
+    int len;
+
+    LEX_ACCEPT(3, TOKEN_FUNCTION, function, base);
+    if (s[0] == 'h') {
+        LEX_ACCEPT(4, TOKEN_FUNCTION, function, hyperbolic);
+    } else if (is_inverse_suffix(s)) {
+        LEX_ACCEPT(8, TOKEN_FUNCTION, function, inverse);
     }
-    return -1; // Not found
+    return len;
 }
 
-static int parse_variable(const char *expr, int pos, variable_type_t *variable)
+// Match the longest identifier at s; returns its length in bytes or 0
+static int lex_identifier(const char *s, token_t *token)
 {
-    for (int i = 0; i < sizeof(variable_patterns) / sizeof(variable_patterns[0]); i++) {
-        int len = strlen(variable_patterns[i].pattern);
-        if (strncmp(&expr[pos], variable_patterns[i].pattern, len) == 0) {
-            *variable = variable_patterns[i].type;
-            return pos + len;
-        }
+    int len = 0;
+
+    switch ((uint8_t)s[0]) {
+        case 's':
+            if (s[1] == 'i' && s[2] == 'n') {
+                len = lex_trig_suffix(&s[3], token, FUNC_SIN, FUNC_SINH, FUNC_ASIN);
+            } else if (s[1] == 'q' && s[2] == 'r' && s[3] == 't') {
+                LEX_ACCEPT(4, TOKEN_FUNCTION, function, FUNC_SQRT);
+            }
+            break;
+        case 'c':
+            if (s[1] == 'o' && s[2] == 's') {
+                len = lex_trig_suffix(&s[3], token, FUNC_COS, FUNC_COSH, FUNC_ACOS);
+            } else if (s[1] == 'o' && s[2] == 'n' && s[3] == 'j') {
+                LEX_ACCEPT(4, TOKEN_FUNCTION, function, FUNC_CONJ);
+            }
+            break;
+        case 't':
+            if (s[1] == 'a' && s[2] == 'n') {
+                len = lex_trig_suffix(&s[3], token, FUNC_TAN, FUNC_TANH, FUNC_ATAN);
+            }
+            break;
+        case 'a':
+            if (s[1] == 'b' && s[2] == 's') {
+                LEX_ACCEPT(3, TOKEN_FUNCTION, function, FUNC_ABS);
+            } else if (s[1] == 's' && s[2] == 'i' && s[3] == 'n') {
+                LEX_ACCEPT(4, TOKEN_FUNCTION, function, FUNC_ASIN);
+            } else if (s[1] == 'c' && s[2] == 'o' && s[3] == 's') {
+                LEX_ACCEPT(4, TOKEN_FUNCTION, function, FUNC_ACOS);
+            } else if (s[1] == 't' && s[2] == 'a' && s[3] == 'n') {
+                LEX_ACCEPT(4, TOKEN_FUNCTION, function, FUNC_ATAN);
+            } else if (s[1] == 'n' && s[2] == 'g' && s[3] == 'l' && s[4] == 'e') {
+                LEX_ACCEPT(5, TOKEN_FUNCTION, function, FUNC_ANGLE);
+            } else if (s[1] == 'r' && s[2] == 'g') {
+                LEX_ACCEPT(3, TOKEN_FUNCTION, function, FUNC_ARG);
+            }
+            break;
+        case 'd':
+            if (s[1] == 'o' && s[2] == 't') {
+                LEX_ACCEPT(3, TOKEN_FUNCTION, function, FUNC_DOT);
+            }
+            break;
+        case 'u':
+            if (s[1] == 'n' && s[2] == 'i' && s[3] == 't' && s[4] == 'V') {
+                LEX_ACCEPT(5, TOKEN_FUNCTION, function, FUNC_UNIT_V);
+            }
+            break;
+        case 'l':
+            if (s[1] == 'n') {
+                LEX_ACCEPT(2, TOKEN_FUNCTION, function, FUNC_LN);
+            } else if (s[1] == 'o' && s[2] == 'g') {
+                LEX_ACCEPT(3, TOKEN_FUNCTION, function, FUNC_LOG);
+                if (s[3] == '1' && s[4] == '0') {
+                    LEX_ACCEPT(5, TOKEN_FUNCTION, function, FUNC_LOG10);
+                }
+            }
+            break;
+        case 'e':
+            LEX_ACCEPT(1, TOKEN_CONSTANT, constant, CONST_E);
+            if (s[1] == 'x' && s[2] == 'p') {
+                LEX_ACCEPT(3, TOKEN_FUNCTION, function, FUNC_EXP);
+            }
+            break;
+        case 'n':
+            if (s[1] == 'o' && s[2] == 'r' && s[3] == 'm') {
+                if (s[4] == 'p' && s[5] == 'd') {
+                    LEX_ACCEPT(6, TOKEN_FUNCTION, function, FUNC_NORM_PD);
+                } else if (s[4] == 'c' && s[5] == 'd') {
+                    LEX_ACCEPT(6, TOKEN_FUNCTION, function, FUNC_NORM_CD);
+                }
+            }
+            break;
+        case 'i':
+            // The imaginary unit; its value is the imaginary part
+            LEX_ACCEPT(1, TOKEN_IMAGINARY, number, 1.0);
+            if (s[1] == 'n' && s[2] == 'v' && s[3] == 'n' && s[4] == 'o' && s[5] == 'r' &&
+                s[6] == 'm') {
+                LEX_ACCEPT(7, TOKEN_FUNCTION, function, FUNC_INV_NORM);
+            }
+            break;
+        case 'p':
+            if (s[1] == 'i') {
+                LEX_ACCEPT(2, TOKEN_CONSTANT, constant, CONST_PI);
+            }
+            break;
+        case 0xCF:  // UTF-8 lead byte of π (U+03C0)
+            if ((uint8_t)s[1] == 0x80) {
+                LEX_ACCEPT(2, TOKEN_CONSTANT, constant, CONST_PI);
+            }
+            break;
+        case 0xE2:  // UTF-8 lead byte of ∠ (U+2220), the polar form r∠θ
+            if ((uint8_t)s[1] == 0x88 && (uint8_t)s[2] == 0xA0) {
+                LEX_ACCEPT(3, TOKEN_OPERATOR, operator, OPERATOR_POLAR);
+            }
+            break;
+        case 'A':
+            LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_A);
+            if (s[1] == 'n' && s[2] == 's') {
+                LEX_ACCEPT(3, TOKEN_VARIABLE, variable, VAR_ANS);
+            }
+            break;
+        case 'X': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_X); break;
+        case 'Y': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_Y); break;
+        case 'B': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_B); break;
+        case 'C': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_C); break;
+        case 'D': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_D); break;
+        case 'M': LEX_ACCEPT(1, TOKEN_VARIABLE, variable, VAR_M); break;
+        case 'V':
+            if (s[1] == 'c' && s[2] == 't') {
+                if (s[3] >= 'A' && s[3] <= 'D') {
+                    LEX_ACCEPT(4, TOKEN_VECTOR, vector, (vector_name_t)(VECTOR_A + (s[3] - 'A')));
+                }
+                if (s[3] == 'A' && s[4] == 'n' && s[5] == 's') {
+                    LEX_ACCEPT(6, TOKEN_VECTOR, vector, VECTOR_ANS);
+                }
+            }
+            break;
+        default:
+            break;
     }
-    return -1; // Not found
+
+    return len;
 }
 
-// Tokenize expression into tokens
-static int tokenize_expression(const char *expression, token_t *tokens, int max_tokens)
+int tokenize_expression(const char *expression, token_t *tokens, int max_tokens)
 {
     int pos = 0;
     int token_count = 0;
@@ -267,39 +503,28 @@ static int tokenize_expression(const char *expression, token_t *tokens, int max_
             }
         }
         
-        // Functions
-        function_type_t function;
-        int func_pos = parse_function(expression, pos, &function);
-        if (func_pos > 0) {
-            tokens[token_count].type = TOKEN_FUNCTION;
-            tokens[token_count].value.function = function;
-            token_count++;
-            pos = func_pos;
-            expect_number = true;
-            continue;
-        }
-        
-        // Constants
-        constant_type_t constant;
-        int const_pos = parse_constant(expression, pos, &constant);
-        if (const_pos > 0) {
-            tokens[token_count].type = TOKEN_CONSTANT;
-            tokens[token_count].value.constant = constant;
-            token_count++;
-            pos = const_pos;
-            expect_number = false;
-            continue;
-        }
-        
-        // Variables
-        variable_type_t variable;
-        int var_pos = parse_variable(expression, pos, &variable);
-        if (var_pos > 0) {
-            tokens[token_count].type = TOKEN_VARIABLE;
-            tokens[token_count].value.variable = variable;
+        // Functions, constants and variables (single longest-match pass)
+        int ident_len = lex_identifier(&expression[pos], &tokens[token_count]);
+        if (ident_len > 0) {
+            token_type_t type = tokens[token_count].type;
+            if (type == TOKEN_OPERATOR && expect_number) {
+                return ERR_SYNTAX_ERROR;
+            }
+            bool after_i = token_count > 0 && tokens[token_count - 1].type == TOKEN_IMAGINARY &&
+                           type != TOKEN_OPERATOR;
+            if ((type == TOKEN_IMAGINARY || after_i) && !expect_number) {
+                // i next to an operand multiplies it: 4i is 4*i, iπ is i*π
+                if (token_count + 1 >= max_tokens - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                tokens[token_count + 1] = tokens[token_count];
+                tokens[token_count].type = TOKEN_OPERATOR;
+                tokens[token_count].value.operator = '*';
+                token_count++;
+            }
+            expect_number = (type == TOKEN_FUNCTION || type == TOKEN_OPERATOR);
             token_count++;
-            pos = var_pos;
-            expect_number = false;
+            pos += ident_len;
             continue;
         }
         
@@ -351,6 +576,16 @@ static int tokenize_expression(const char *expression, token_t *tokens, int max_
                 expect_number = false;
                 break;
                 
+            case ',':
+                if (expect_number) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                tokens[token_count].type = TOKEN_COMMA;
+                token_count++;
+                pos++;
+                expect_number = true;
+                break;
+                
             case '!':
                 // Factorial operator (postfix)
                 if (expect_number) {
@@ -377,8 +612,6 @@ static int tokenize_expression(const char *expression, token_t *tokens, int max_
 int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue)
 {
     token_t tokens[MAX_TOKENS];
-    token_t operator_stack[MAX_TOKENS];
-    int stack_top = -1;
     
     // Tokenize the expression
     int token_count = tokenize_expression(expression, tokens, MAX_TOKENS);
@@ -386,16 +619,26 @@ int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue)
         return token_count; // Error code
     }
     
+    return parse_tokens_to_rpn(tokens, token_count, rpn_queue);
+}
+
+int parse_tokens_to_rpn(const token_t *tokens, int token_count, rpn_queue_t *rpn_queue)
+{
+    token_t operator_stack[MAX_TOKENS];
+    int stack_top = -1;
+    
     rpn_queue->count = 0;
     
     // Shunting-yard algorithm
     for (int i = 0; i < token_count; i++) {
-        token_t *token = &tokens[i];
+        const token_t *token = &tokens[i];
         
         switch (token->type) {
             case TOKEN_NUMBER:
             case TOKEN_CONSTANT:
             case TOKEN_VARIABLE:
+            case TOKEN_VECTOR:
+            case TOKEN_IMAGINARY:
                 // Numbers, constants, and variables go directly to output
                 if (rpn_queue->count >= MAX_TOKENS) {
                     return ERR_STACK_OVERFLOW;
@@ -475,6 +718,20 @@ int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue)
                 }
                 break;
                 
+            case TOKEN_COMMA:
+                // Finish the argument so far; the function stays on the
+                // stack under its left parenthesis
+                while (stack_top >= 0 && operator_stack[stack_top].type != TOKEN_LEFT_PAREN) {
+                    if (rpn_queue->count >= MAX_TOKENS) {
+                        return ERR_STACK_OVERFLOW;
+                    }
+                    rpn_queue->tokens[rpn_queue->count++] = operator_stack[stack_top--];
+                }
+                if (stack_top < 0) {
+                    return ERR_MISMATCHED_PARENS;
+                }
+                break;
+                
             case TOKEN_END:
                 // End of input - should not happen here
                 break;
@@ -497,7 +754,7 @@ int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue)
 
 int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, double *result)
 {
-    double stack[MAX_TOKENS];
+    eval_num_t stack[MAX_TOKENS];
     int stack_top = -1;
     
     for (int i = 0; i < rpn_queue->count; i++) {
@@ -528,32 +785,23 @@ int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, do
                 stack[++stack_top] = get_variable_value(token->value.variable, &context->variables);
                 break;
                 
+            case TOKEN_VECTOR:
+                // Vectors only evaluate through vector_evaluate_rpn()
+                return ERR_DIMENSION;
+                
             case TOKEN_OPERATOR: {
                 // Pop two operands and apply operator
                 if (stack_top < 1) {
                     return ERR_SYNTAX_ERROR;
                 }
                 
-                double b = stack[stack_top--];
-                double a = stack[stack_top--];
-                double op_result;
-                
-                switch (token->value.operator) {
-                    case '+': op_result = a + b; break;
-                    case '-': op_result = a - b; break;
-                    case '*': op_result = a * b; break;
-                    case '/':
-                        if (fabs(b) < 1e-15) {
-                            return ERR_DIVISION_BY_ZERO;
-                        }
-                        op_result = a / b;
-                        break;
-                    case '^': op_result = pow(a, b); break;
-                    default: return ERR_SYNTAX_ERROR;
-                }
+                eval_num_t b = stack[stack_top--];
+                eval_num_t a = stack[stack_top--];
+                eval_num_t op_result;
                 
-                if (!isfinite(op_result)) {
-                    return ERR_OVERFLOW;
+                int op_error = apply_operator(token->value.operator, a, b, &op_result);
+                if (op_error < 0) {
+                    return op_error;
                 }
                 
                 stack[++stack_top] = op_result;
@@ -574,8 +822,8 @@ int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, do
                     return ERR_SYNTAX_ERROR;
                 }
                 
-                double arg = stack[stack_top--];
-                double func_result = apply_function(token->value.function, arg, context->deg_mode);
+                eval_num_t arg = stack[stack_top--];
+                eval_num_t func_result = apply_function(token->value.function, arg, context->deg_mode);
                 
                 if (!isfinite(func_result)) {
                     return ERR_DOMAIN_ERROR;
@@ -598,21 +846,547 @@ int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, do
     return 0;
 }
 
+// Value of a number, constant or variable token
+static eval_num_t operand_value(const token_t *token, const eval_context_t *context)
+{
+    switch (token->type) {
+        case TOKEN_CONSTANT:
+            return get_constant_value(token->value.constant);
+        case TOKEN_VARIABLE:
+            return get_variable_value(token->value.variable, &context->variables);
+        default:
+            return token->value.number;
+    }
+}
+
+// Derivative of a function at arg given its value there; NaN where the
+// derivative does not exist. DEG-mode trig differentiates with respect
+// to degrees, hence the pi/180 factors.
+static eval_num_t function_derivative(function_type_t func, eval_num_t arg,
+                                      eval_num_t value, bool deg_mode)
+{
+    const eval_num_t angle = deg_mode ? EVAL_NUM_RAD_PER_DEG : 1;
+
+    switch (func) {
+        case FUNC_SIN: return apply_function(FUNC_COS, arg, deg_mode) * angle;
+        case FUNC_COS: return -apply_function(FUNC_SIN, arg, deg_mode) * angle;
+        case FUNC_TAN: return (1 + value * value) * angle;
+        case FUNC_ASIN: return 1 / (num_sqrt((1 - arg) * (1 + arg)) * angle);
+        case FUNC_ACOS: return -1 / (num_sqrt((1 - arg) * (1 + arg)) * angle);
+        case FUNC_ATAN: return 1 / ((1 + arg * arg) * angle);
+        case FUNC_LOG:
+        case FUNC_LOG10: return 1 / (arg * EVAL_NUM_LN10);
+        case FUNC_LN: return 1 / arg;
+        case FUNC_SQRT: return (eval_num_t)0.5 / value;
+        case FUNC_ABS: return arg > 0 ? 1 : (arg < 0 ? -1 : NAN);
+        case FUNC_EXP: return value;
+        case FUNC_SINH: return num_cosh(arg);
+        case FUNC_COSH: return num_sinh(arg);
+        case FUNC_TANH: return (1 - value) * (1 + value);
+        case FUNC_FACTORIAL: return value * (eval_num_t)sf_digamma((double)arg + 1.0);
+        case FUNC_NORM_PD: return -arg * value;
+        case FUNC_NORM_CD: return (eval_num_t)dist_normal_pd(arg, 0.0, 1.0);
+        case FUNC_INV_NORM: return 1 / (eval_num_t)dist_normal_pd(value, 0.0, 1.0);
+        default: return NAN;
+    }
+}
+
+// Derivative of a op b from the operands, their derivatives and the result
+static eval_num_t operator_derivative(char op, eval_num_t a, eval_num_t da,
+                                      eval_num_t b, eval_num_t db, eval_num_t result)
+{
+    switch (op) {
+        case '+': return da + db;
+        case '-': return da - db;
+        case '*': return da * b + a * db;
+        case '/': return (da - result * db) / b;
+        case '^': {
+            eval_num_t d = 0;
+            if (da != 0) {
+                // b a^(b - 1), taken from the result unless a is zero
+                eval_num_t slope = a != 0 ? b * (result / a)
+                                          : (b == 1 ? 1 : (b > 1 ? 0 : NAN));
+                d += slope * da;
+            }
+            if (db != 0 && result != 0) {
+                d += result * num_log(a) * db;     // NaN for a < 0: no real derivative
+            }
+            return d;
+        }
+        default: return NAN;
+    }
+}
+
+// Dual-number stack for evaluate_rpn_dual()
+static eval_num_t dual_value[MAX_TOKENS];
+static eval_num_t dual_deriv[MAX_TOKENS];
+
+int evaluate_rpn_dual(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                      double *result, double *derivative)
+{
+    int stack_top = -1;
+    
+    for (int i = 0; i < rpn_queue->count; i++) {
+        const token_t *token = &rpn_queue->tokens[i];
+        
+        switch (token->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+                if (stack_top >= MAX_TOKENS - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                stack_top++;
+                dual_value[stack_top] = operand_value(token, context);
+                dual_deriv[stack_top] = token->type == TOKEN_VARIABLE &&
+                                        token->value.variable == VAR_X ? 1 : 0;
+                break;
+                
+            case TOKEN_OPERATOR: {
+                if (stack_top < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                
+                eval_num_t b = dual_value[stack_top];
+                eval_num_t db = dual_deriv[stack_top--];
+                eval_num_t a = dual_value[stack_top];
+                eval_num_t da = dual_deriv[stack_top];
+                eval_num_t op_result;
+                
+                int op_error = apply_operator(token->value.operator, a, b, &op_result);
+                if (op_error < 0) {
+                    return op_error;
+                }
+                
+                dual_value[stack_top] = op_result;
+                dual_deriv[stack_top] = (da == 0 && db == 0) ? 0 :
+                    operator_derivative(token->value.operator, a, da, b, db, op_result);
+                break;
+            }
+            
+            case TOKEN_UNARY_MINUS:
+                if (stack_top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                dual_value[stack_top] = -dual_value[stack_top];
+                dual_deriv[stack_top] = -dual_deriv[stack_top];
+                break;
+                
+            case TOKEN_FUNCTION: {
+                if (stack_top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                
+                eval_num_t arg = dual_value[stack_top];
+                eval_num_t func_result = apply_function(token->value.function, arg, context->deg_mode);
+                
+                if (!isfinite(func_result)) {
+                    return ERR_DOMAIN_ERROR;
+                }
+                
+                // Chain rule; subtrees without X skip the derivative kernel
+                eval_num_t du = dual_deriv[stack_top];
+                dual_value[stack_top] = func_result;
+                dual_deriv[stack_top] = du == 0 ? 0 :
+                    function_derivative(token->value.function, arg, func_result,
+                                        context->deg_mode) * du;
+                break;
+            }
+                
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+    }
+    
+    if (stack_top != 0) {
+        return ERR_SYNTAX_ERROR;
+    }
+    
+    // f is fine but f' does not exist (sqrt(X) at 0) or overflowed
+    if (!isfinite(dual_deriv[0])) {
+        return ERR_DOMAIN_ERROR;
+    }
+    
+    *result = dual_value[0];
+    *derivative = dual_deriv[0];
+    return 0;
+}
+
+// Structure-of-arrays value stack for evaluate_rpn_batch(): depth rows of
+// batch_lanes values each, so deeper programs run narrower blocks
+#define RPN_BATCH_CAPACITY (RPN_BATCH_MAX_DEPTH * RPN_BATCH_BLOCK)
+static eval_num_t batch_stack[RPN_BATCH_CAPACITY];
+
+// Per lane 0 while every intermediate value was finite, NaN from the first
+// one that was not. Kept in eval_num_t so the checks vectorize with the ops.
+static eval_num_t batch_poison[RPN_BATCH_BLOCK];
+
+// Check stack balance of an RPN program and return its maximum depth
+static int rpn_stack_depth(const rpn_queue_t *rpn_queue)
+{
+    int depth = 0;
+    int max_depth = 0;
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        switch (rpn_queue->tokens[i].type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+                depth++;
+                break;
+            case TOKEN_OPERATOR:
+                if (depth < 2) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                depth--;
+                break;
+            case TOKEN_UNARY_MINUS:
+            case TOKEN_FUNCTION:
+                if (depth < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                break;
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+        if (depth > max_depth) {
+            max_depth = depth;
+        }
+    }
+
+    return (depth == 1) ? max_depth : ERR_SYNTAX_ERROR;
+}
+
+// Poison lanes whose value is NaN or infinite: v * 0 is 0 only for finite v
+static inline void poison_non_finite(const eval_num_t *restrict v, int m)
+{
+    for (int j = 0; j < m; j++) {
+        batch_poison[j] += v[j] * 0;
+    }
+}
+
+// Apply a binary operator lane-wise: a[j] = a[j] op b[j]
+static void apply_operator_block(char op, eval_num_t *restrict a, const eval_num_t *restrict b, int m)
+{
+    switch (op) {
+        case '+':
+            for (int j = 0; j < m; j++) a[j] += b[j];
+            break;
+        case '-':
+            for (int j = 0; j < m; j++) a[j] -= b[j];
+            break;
+        case '*':
+            for (int j = 0; j < m; j++) a[j] *= b[j];
+            break;
+        case '/':
+            for (int j = 0; j < m; j++) {
+                batch_poison[j] += num_fabs(b[j]) < 1e-15 ? (eval_num_t)NAN : 0;
+                a[j] /= b[j];
+            }
+            break;
+        case '^': {
+            // Exponents are nearly always constants, so squares take a
+            // vector loop and only other powers go through pow() per lane
+            bool squares = true;
+            for (int j = 0; j < m; j++) squares &= b[j] == 2;
+            if (squares) {
+                for (int j = 0; j < m; j++) a[j] *= a[j];
+            } else {
+                for (int j = 0; j < m; j++) a[j] = num_power(a[j], b[j]);
+            }
+            break;
+        }
+        default:
+            for (int j = 0; j < m; j++) batch_poison[j] = NAN;
+            return;
+    }
+    poison_non_finite(a, m);
+}
+
+// Apply a function lane-wise; cheap kernels get their own loop
+static void apply_function_block(function_type_t func, eval_num_t *restrict v, int m, bool deg_mode)
+{
+    switch (func) {
+        case FUNC_SQRT:
+            for (int j = 0; j < m; j++) v[j] = num_sqrt(v[j]);
+            break;
+        case FUNC_ABS:
+            for (int j = 0; j < m; j++) v[j] = num_fabs(v[j]);
+            break;
+        default:
+            for (int j = 0; j < m; j++) v[j] = apply_function(func, v[j], deg_mode);
+            break;
+    }
+    poison_non_finite(v, m);
+}
+
+// Evaluate one block of m <= lanes inputs; stack row k starts at k * lanes
+static void evaluate_rpn_block(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                               const double *xs, double *out, int m, int lanes)
+{
+    eval_num_t *top = batch_stack - lanes;
+
+    memset(batch_poison, 0, sizeof(batch_poison));
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        const token_t *token = &rpn_queue->tokens[i];
+        eval_num_t value;
+
+        switch (token->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+                top += lanes;
+                if (token->type == TOKEN_VARIABLE && token->value.variable == VAR_X) {
+                    for (int j = 0; j < m; j++) top[j] = xs[j];
+                    break;
+                }
+                value = operand_value(token, context);
+                for (int j = 0; j < m; j++) top[j] = value;
+                break;
+
+            case TOKEN_OPERATOR:
+                apply_operator_block(token->value.operator, top - lanes, top, m);
+                top -= lanes;
+                break;
+
+            case TOKEN_UNARY_MINUS:
+                for (int j = 0; j < m; j++) top[j] = -top[j];
+                break;
+
+            case TOKEN_FUNCTION:
+                apply_function_block(token->value.function, top, m, context->deg_mode);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    for (int j = 0; j < m; j++) {
+        out[j] = isnan(batch_poison[j]) ? NAN : batch_stack[j];
+    }
+}
+
+int evaluate_rpn_batch(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                       const double *xs, double *out, size_t n)
+{
+    int depth = rpn_stack_depth(rpn_queue);
+    int failures = 0;
+
+    if (depth < 0) {
+        return depth;
+    }
+
+    // Full blocks up to RPN_BATCH_MAX_DEPTH, narrower ones past it; depth
+    // cannot exceed MAX_TOKENS, which leaves at least RPN_BATCH_CAPACITY /
+    // MAX_TOKENS lanes
+    int lanes = RPN_BATCH_CAPACITY / depth;
+    if (lanes > RPN_BATCH_BLOCK) {
+        lanes = RPN_BATCH_BLOCK;
+    }
+
+    for (size_t i = 0; i < n; i += lanes) {
+        int m = (n - i < (size_t)lanes) ? (int)(n - i) : lanes;
+
+        evaluate_rpn_block(rpn_queue, context, &xs[i], &out[i], m, lanes);
+        for (int j = 0; j < m; j++) {
+            failures += isnan(batch_poison[j]) ? 1 : 0;
+        }
+    }
+
+    return failures;
+}
+
+int optimize_rpn(rpn_queue_t *rpn_queue, bool deg_mode)
+{
+    // For each value on the simulated stack: index of the first output
+    // token of its subtree, and whether that subtree is a lone constant
+    int8_t start[MAX_TOKENS];
+    bool is_const[MAX_TOKENS];
+    int top = -1;
+    int out = 0;
+
+    // Leave malformed programs alone; evaluate_rpn() reports the error
+    if (rpn_stack_depth(rpn_queue) < 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        token_t token = rpn_queue->tokens[i];
+        eval_num_t a, b, value;
+        int arity;
+        bool foldable;
+
+        switch (token.type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+                rpn_queue->tokens[out] = token;
+                top++;
+                start[top] = out++;
+                is_const[top] = (token.type != TOKEN_VARIABLE);
+                continue;
+            case TOKEN_OPERATOR:
+                arity = 2;
+                break;
+            default:
+                arity = 1;
+                break;
+        }
+
+        foldable = is_const[top] && (arity == 1 || is_const[top - 1]);
+        if (foldable) {
+            b = operand_value(&rpn_queue->tokens[start[top]], NULL);
+            a = (arity == 2) ? operand_value(&rpn_queue->tokens[start[top - 1]], NULL) : b;
+
+            if (token.type == TOKEN_OPERATOR) {
+                // Division by zero and overflow stay runtime errors
+                foldable = apply_operator(token.value.operator, a, b, &value) == 0;
+            } else if (token.type == TOKEN_UNARY_MINUS) {
+                value = -a;
+            } else {
+                value = apply_function(token.value.function, a, deg_mode);
+                foldable = isfinite(value);
+            }
+        }
+
+        top -= arity - 1;
+        if (arity == 2) {
+            is_const[top] = is_const[top] && is_const[top + 1];
+        }
+
+        if (foldable) {
+            // Replace the operand tokens with the computed value
+            out = start[top];
+            rpn_queue->tokens[out].type = TOKEN_NUMBER;
+            rpn_queue->tokens[out].value.number = value;
+            out++;
+        } else {
+            rpn_queue->tokens[out++] = token;
+            is_const[top] = false;
+        }
+    }
+
+    int removed = rpn_queue->count - out;
+    rpn_queue->count = out;
+    return removed;
+}
+
+// FNV-1a hash of the expression text; also returns its length
+static uint32_t hash_expression(const char *expression, size_t *length)
+{
+    uint32_t hash = 2166136261u;
+    size_t len = 0;
+
+    while (expression[len]) {
+        hash ^= (uint8_t)expression[len++];
+        hash *= 16777619u;
+    }
+    *length = len;
+    return hash;
+}
+
+// Find the cached program for an expression, compiling it on a miss. When
+// the VM cannot compile the RPN, *rpn is set to the scratch queue instead.
+static const expr_program_t *lookup_compiled(const char *expression, bool deg_mode,
+                                             const rpn_queue_t **rpn, int *error)
+{
+    size_t len;
+    uint32_t hash = hash_expression(expression, &len);
+    bool cacheable = len < MAX_EXPRESSION_LENGTH;
+    expr_cache_entry_t *victim = &expr_cache[0];
+
+    *rpn = NULL;
+    *error = 0;
+    expr_cache_clock++;
+
+    for (int i = 0; i < EXPR_CACHE_SIZE && cacheable; i++) {
+        expr_cache_entry_t *entry = &expr_cache[i];
+
+        if (entry->valid && entry->hash == hash && entry->deg_mode == deg_mode &&
+            strcmp(entry->expression, expression) == 0) {
+            entry->last_used = expr_cache_clock;
+            expr_cache_stats.hits++;
+            LOG_DBG("Cache hit for '%s' (slot %d)", expression, i);
+            return &entry->program;
+        }
+
+        // Prefer an empty slot, otherwise the least recently used one
+        if (!entry->valid) {
+            if (victim->valid) {
+                victim = entry;
+            }
+        } else if (victim->valid && entry->last_used < victim->last_used) {
+            victim = entry;
+        }
+    }
+
+    expr_cache_stats.misses++;
+
+    // Compile into scratch so a syntax error leaves the cache untouched
+    *error = parse_expression_to_rpn(expression, &expr_scratch);
+    if (*error < 0) {
+        return NULL;
+    }
+    
+    int folded = optimize_rpn(&expr_scratch, deg_mode);
+    LOG_DBG("Compiled '%s': %d RPN tokens (%d folded)", expression,
+            expr_scratch.count, folded);
+
+    // Vectors, r∠θ and programs past the VM's constant or stack limits are
+    // left to evaluate_rpn(), which reports the same errors the VM would
+    if (expr_vm_compile(&expr_scratch, &program_scratch) < 0) {
+        *rpn = &expr_scratch;
+        return NULL;
+    }
+
+    // Expressions too long to keep a key copy of are used once and dropped
+    if (!cacheable) {
+        return &program_scratch;
+    }
+
+    memcpy(victim->expression, expression, len + 1);
+    victim->program = program_scratch;
+    victim->hash = hash;
+    victim->deg_mode = deg_mode;
+    victim->last_used = expr_cache_clock;
+    victim->valid = true;
+    return &victim->program;
+}
+
+void expression_cache_get_stats(expr_cache_stats_t *stats)
+{
+    *stats = expr_cache_stats;
+}
+
+void expression_cache_clear(void)
+{
+    memset(expr_cache, 0, sizeof(expr_cache));
+    memset(&expr_cache_stats, 0, sizeof(expr_cache_stats));
+    expr_cache_clock = 0;
+}
+
 int evaluate_expression(const char *expression, const eval_context_t *context, double *result)
 {
-    rpn_queue_t rpn_queue;
+    const rpn_queue_t *rpn_queue;
+    int parse_result;
+    int eval_result;
     
-    // Parse expression to RPN
-    int parse_result = parse_expression_to_rpn(expression, &rpn_queue);
-    if (parse_result < 0) {
+    // Reuse the compiled program if this expression was seen recently
+    const expr_program_t *program = lookup_compiled(expression, context->deg_mode,
+                                                    &rpn_queue, &parse_result);
+    if (program != NULL) {
+        eval_result = expr_vm_execute(program, context, result);
+    } else if (rpn_queue != NULL) {
+        eval_result = evaluate_rpn(rpn_queue, context, result);
+    } else {
         LOG_ERR("Failed to parse expression: %s (error %d)", expression, parse_result);
         return parse_result;
     }
     
-    // Evaluate RPN
-    int eval_result = evaluate_rpn(&rpn_queue, context, result);
     if (eval_result < 0) {
-        LOG_ERR("Failed to evaluate RPN (error %d)", eval_result);
+        LOG_ERR("Failed to evaluate expression (error %d)", eval_result);
         return eval_result;
     }
     
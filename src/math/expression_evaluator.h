@@ -16,11 +16,28 @@
 #ifndef EXPRESSION_EVALUATOR_H
 #define EXPRESSION_EVALUATOR_H
 
+#include "eval_numeric.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 #define MAX_TOKENS 64
 #define MAX_EXPRESSION_LENGTH 128
+#define EXPR_CACHE_SIZE 4
+#define RPN_BATCH_BLOCK 16      // Inputs evaluated per op in evaluate_rpn_batch()
+#define RPN_BATCH_MAX_DEPTH 16  // Deeper programs run narrower blocks
+#define OPERATOR_POLAR '@'      // Token for r∠θ; only the complex evaluator applies it
+
+// Error codes
+#define ERR_SYNTAX_ERROR        -1
+#define ERR_DIVISION_BY_ZERO    -2
+#define ERR_DOMAIN_ERROR        -3
+#define ERR_OVERFLOW            -4
+#define ERR_STACK_OVERFLOW      -5
+#define ERR_UNKNOWN_FUNCTION    -6
+#define ERR_MISMATCHED_PARENS   -7
+#define ERR_NO_CONVERGENCE      -8  // Numerical method missed its tolerance within budget
+#define ERR_DIMENSION           -9  // Operand shapes do not fit the operation
 
 /**
  * @brief Token types for expression parsing
@@ -31,8 +48,11 @@ typedef enum {
     TOKEN_FUNCTION,     // Mathematical function (sin, cos, etc.)
     TOKEN_CONSTANT,     // Mathematical constant (π, e)
     TOKEN_VARIABLE,     // Variable (Ans, X, Y, etc.)
+    TOKEN_VECTOR,       // Vector variable (VctA ... VctAns), see vector.h
+    TOKEN_IMAGINARY,    // Imaginary unit i, see complex_number.h
     TOKEN_LEFT_PAREN,   // Left parenthesis
     TOKEN_RIGHT_PAREN,  // Right parenthesis
+    TOKEN_COMMA,        // Argument separator; never reaches the RPN queue
     TOKEN_UNARY_MINUS,  // Unary minus operator
     TOKEN_END           // End of expression marker
 } token_type_t;
@@ -47,6 +67,9 @@ typedef enum {
     FUNC_SQRT, FUNC_ABS, FUNC_EXP,
     FUNC_SINH, FUNC_COSH, FUNC_TANH,
     FUNC_FACTORIAL,
+    FUNC_NORM_PD, FUNC_NORM_CD, FUNC_INV_NORM,  // Standard normal
+    FUNC_DOT, FUNC_ANGLE, FUNC_UNIT_V,          // Vector only, see vector.h
+    FUNC_ARG, FUNC_CONJ,                        // Complex argument, conjugate
     FUNC_COUNT
 } function_type_t;
 
@@ -70,6 +93,15 @@ typedef enum {
     VAR_COUNT
 } variable_type_t;
 
+/**
+ * @brief Vector variables; their values are kept by VECTOR mode
+ */
+typedef enum {
+    VECTOR_A, VECTOR_B, VECTOR_C, VECTOR_D,
+    VECTOR_ANS,     // Result of the last vector expression
+    VECTOR_COUNT
+} vector_name_t;
+
 /**
  * @brief Token structure for expression parsing
  */
@@ -81,6 +113,7 @@ typedef struct {
         function_type_t function;
         constant_type_t constant;
         variable_type_t variable;
+        vector_name_t vector;
     } value;
 } token_t;
 
@@ -110,6 +143,32 @@ typedef struct {
     bool deg_mode;      // True for degrees, false for radians
 } eval_context_t;
 
+/**
+ * @brief Compiled-expression cache statistics
+ */
+typedef struct {
+    uint32_t hits;      // Lookups that reused a compiled program
+    uint32_t misses;    // Lookups that had to tokenize and parse
+} expr_cache_stats_t;
+
+/**
+ * @brief Split an infix expression into tokens
+ * @param expression Input mathematical expression string
+ * @param tokens Output token array (terminated by TOKEN_END)
+ * @param max_tokens Capacity of the token array
+ * @return Number of tokens on success, negative error code on failure
+ */
+int tokenize_expression(const char *expression, token_t *tokens, int max_tokens);
+
+/**
+ * @brief Convert a token array to RPN using Shunting-yard algorithm
+ * @param tokens Tokens produced by tokenize_expression()
+ * @param token_count Number of tokens (excluding TOKEN_END)
+ * @param rpn_queue Output RPN token queue
+ * @return 0 on success, negative error code on failure
+ */
+int parse_tokens_to_rpn(const token_t *tokens, int token_count, rpn_queue_t *rpn_queue);
+
 /**
  * @brief Parse infix expression to RPN using Shunting-yard algorithm
  * @param expression Input mathematical expression string
@@ -118,6 +177,21 @@ typedef struct {
  */
 int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue);
 
+/**
+ * @brief Fold variable-free subexpressions of an RPN program
+ *
+ * Every subtree built only from numbers and constants is replaced by a
+ * single TOKEN_NUMBER computed exactly as evaluate_rpn() would. Trig
+ * functions are folded for the given angle mode, so the result is only
+ * valid for that mode. Subtrees that would fail (division by zero,
+ * domain or overflow errors) are left in place to be reported at run time.
+ *
+ * @param rpn_queue RPN program, optimized in place
+ * @param deg_mode Angle mode the program will be evaluated in
+ * @return Number of tokens removed
+ */
+int optimize_rpn(rpn_queue_t *rpn_queue, bool deg_mode);
+
 /**
  * @brief Evaluate RPN token queue
  * @param rpn_queue RPN tokens to evaluate
@@ -127,8 +201,54 @@ int parse_expression_to_rpn(const char *expression, rpn_queue_t *rpn_queue);
  */
 int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, double *result);
 
+/**
+ * @brief Evaluate an RPN program and its derivative with respect to X
+ *
+ * Forward-mode automatic differentiation: every stack entry carries a
+ * value and its derivative, and each operator and function applies the
+ * chain rule as it goes, so f(x) and f'(x) come out of one pass over the
+ * tokens. Values are computed exactly as evaluate_rpn() computes them;
+ * the derivative is exact up to rounding in the closed-form derivative
+ * of each function. Subtrees that do not depend on X skip the derivative
+ * work. Uses a static stack and is therefore not reentrant.
+ *
+ * @param rpn_queue RPN tokens to evaluate
+ * @param context Evaluation context; variables.x is the point
+ * @param result Pointer to store f(x)
+ * @param derivative Pointer to store f'(x)
+ * @return 0 on success, negative error code on failure; ERR_DOMAIN_ERROR
+ *         also when f(x) exists but f'(x) does not (sqrt(X) at 0)
+ */
+int evaluate_rpn_dual(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                      double *result, double *derivative);
+
+/**
+ * @brief Evaluate one RPN program for many X values
+ *
+ * Each RPN op is applied across a block of RPN_BATCH_BLOCK inputs at a
+ * time (structure-of-arrays value stack), so the dispatch cost is paid
+ * once per block instead of once per value. Failures are tracked per
+ * lane without branching, which lets the compiler vectorize the
+ * arithmetic, abs() and squares; other functions and powers still go
+ * through libm lane by lane. Uses a static workspace and is therefore
+ * not reentrant.
+ *
+ * @param rpn_queue RPN tokens to evaluate
+ * @param context Evaluation context; variables.x is replaced by xs[i]
+ * @param xs Input X values
+ * @param out Output values; NAN for elements that failed to evaluate
+ * @param n Number of elements
+ * @return Number of failed elements (>= 0), negative error code if the
+ *         program itself is invalid
+ */
+int evaluate_rpn_batch(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                       const double *xs, double *out, size_t n);
+
 /**
  * @brief High-level expression evaluation function
+ *
+ * Programs are compiled to VM bytecode (expression_vm.h) and kept in a
+ * small LRU cache keyed by the expression text and angle mode.
  * @param expression Input mathematical expression string
  * @param context Evaluation context
  * @param result Pointer to store the result
@@ -136,6 +256,17 @@ int evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context, do
  */
 int evaluate_expression(const char *expression, const eval_context_t *context, double *result);
 
+/**
+ * @brief Get compiled-expression cache statistics
+ * @param stats Pointer to store the hit/miss counters
+ */
+void expression_cache_get_stats(expr_cache_stats_t *stats);
+
+/**
+ * @brief Drop all cached programs and reset the counters
+ */
+void expression_cache_clear(void);
+
 /**
  * @brief Get operator precedence
  * @param op Operator character
@@ -164,4 +295,32 @@ const char* get_function_name(function_type_t func);
  */
 double get_constant_value(constant_type_t constant);
 
+/**
+ * @brief Get variable value
+ * @param var Variable type
+ * @param storage Variable storage to read from
+ * @return Variable value
+ */
+double get_variable_value(variable_type_t var, const variable_storage_t *storage);
+
+/**
+ * @brief Apply a mathematical function to one argument
+ * @param func Function type
+ * @param arg Function argument (evaluator numeric type, see eval_numeric.h)
+ * @param deg_mode True if trig arguments/results are in degrees
+ * @return Function result (NaN or infinity on domain error)
+ */
+eval_num_t apply_function(function_type_t func, eval_num_t arg, bool deg_mode);
+
+/**
+ * @brief Apply a binary operator
+ * @param op Operator character (+, -, *, /, ^)
+ * @param a Left operand
+ * @param b Right operand
+ * @param result Pointer to store the result
+ * @return 0 on success, ERR_DIVISION_BY_ZERO, ERR_OVERFLOW or
+ *         ERR_SYNTAX_ERROR for an unknown operator
+ */
+int apply_operator(char op, eval_num_t a, eval_num_t b, eval_num_t *result);
+
 #endif /* EXPRESSION_EVALUATOR_H */
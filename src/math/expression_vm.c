@@ -0,0 +1,251 @@
+/*
+ * Expression VM Implementation
+ */
+
+#include "expression_vm.h"
+#include <zephyr/logging/log.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+LOG_MODULE_REGISTER(expression_vm, LOG_LEVEL_INF);
+
+#if defined(__GNUC__) && !defined(EXPR_VM_NO_COMPUTED_GOTO)
+#define EXPR_VM_THREADED 1
+#endif
+
+// Byte offsets of each variable inside variable_storage_t
+static const uint8_t variable_offsets[VAR_COUNT] = {
+    [VAR_ANS] = offsetof(variable_storage_t, ans),
+    [VAR_X] = offsetof(variable_storage_t, x),
+    [VAR_Y] = offsetof(variable_storage_t, y),
+    [VAR_A] = offsetof(variable_storage_t, a),
+    [VAR_B] = offsetof(variable_storage_t, b),
+    [VAR_C] = offsetof(variable_storage_t, c),
+    [VAR_D] = offsetof(variable_storage_t, d),
+    [VAR_M] = offsetof(variable_storage_t, m),
+};
+
+// Add a value to the constant pool (deduplicated); returns its index
+static int add_constant(expr_program_t *program, eval_num_t value)
+{
+    for (int i = 0; i < program->constant_count; i++) {
+        if (memcmp(&program->constants[i], &value, sizeof(value)) == 0) {
+            return i;
+        }
+    }
+    if (program->constant_count >= EXPR_VM_MAX_CONSTANTS) {
+        return ERR_STACK_OVERFLOW;
+    }
+    program->constants[program->constant_count] = value;
+    return program->constant_count++;
+}
+
+int expr_vm_compile(const rpn_queue_t *rpn_queue, expr_program_t *program)
+{
+    int depth = 0;
+    int pc = 0;
+
+    program->constant_count = 0;
+    program->max_depth = 0;
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        const token_t *token = &rpn_queue->tokens[i];
+        int index;
+
+        // Every token emits at most two bytes, plus OP_END at the end
+        if (pc + 3 > EXPR_VM_MAX_CODE) {
+            return ERR_STACK_OVERFLOW;
+        }
+
+        switch (token->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+                index = add_constant(program, token->type == TOKEN_NUMBER ?
+                                     token->value.number :
+                                     get_constant_value(token->value.constant));
+                if (index < 0) {
+                    return index;
+                }
+                program->code[pc++] = OP_CONST;
+                program->code[pc++] = (uint8_t)index;
+                depth++;
+                break;
+
+            case TOKEN_VARIABLE:
+                if (token->value.variable >= VAR_COUNT) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                program->code[pc++] = OP_VAR_BASE + token->value.variable;
+                depth++;
+                break;
+
+            case TOKEN_OPERATOR:
+                if (depth < 2) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                switch (token->value.operator) {
+                    case '+': program->code[pc++] = OP_ADD; break;
+                    case '-': program->code[pc++] = OP_SUB; break;
+                    case '*': program->code[pc++] = OP_MUL; break;
+                    case '/': program->code[pc++] = OP_DIV; break;
+                    case '^': program->code[pc++] = OP_POW; break;
+                    default: return ERR_SYNTAX_ERROR;
+                }
+                depth--;
+                break;
+
+            case TOKEN_UNARY_MINUS:
+                if (depth < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                program->code[pc++] = OP_NEG;
+                break;
+
+            case TOKEN_FUNCTION:
+                if (depth < 1 || token->value.function >= FUNC_COUNT) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                program->code[pc++] = OP_FUNC_BASE + token->value.function;
+                break;
+
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+
+        if (depth > program->max_depth) {
+            program->max_depth = depth;
+        }
+    }
+
+    if (depth != 1) {
+        return ERR_SYNTAX_ERROR;
+    }
+    if (program->max_depth > EXPR_VM_MAX_STACK) {
+        return ERR_STACK_OVERFLOW;
+    }
+
+    program->code[pc++] = OP_END;
+    program->code_size = pc;
+
+    LOG_DBG("Compiled %d RPN tokens into %d bytes, %d constants, depth %d",
+            rpn_queue->count, pc, program->constant_count, program->max_depth);
+    return 0;
+}
+
+// Handler entry and dispatch, shared by the threaded and switch interpreters.
+// Handlers read their own opcode as pc[-1].
+#ifdef EXPR_VM_THREADED
+#define VM_HANDLER(label, opcode) label:
+#define VM_NEXT() goto *dispatch[*pc++]
+#else
+#define VM_HANDLER(label, opcode) case opcode:
+#define VM_NEXT() continue
+#endif
+
+int expr_vm_execute(const expr_program_t *program, const eval_context_t *context, double *result)
+{
+    // Depth was verified by expr_vm_compile(), so pushes are unchecked
+    eval_num_t stack[EXPR_VM_MAX_STACK];
+    eval_num_t *sp = stack - 1;
+    const uint8_t *pc = program->code;
+    const uint8_t *variables = (const uint8_t *)&context->variables;
+    const bool deg_mode = context->deg_mode;
+
+#ifdef EXPR_VM_THREADED
+    static const void *const dispatch[OP_COUNT] = {
+        [OP_END] = &&op_end,
+        [OP_CONST] = &&op_const,
+        [OP_ADD] = &&op_add,
+        [OP_SUB] = &&op_sub,
+        [OP_MUL] = &&op_mul,
+        [OP_DIV] = &&op_div,
+        [OP_POW] = &&op_pow,
+        [OP_NEG] = &&op_neg,
+        [OP_VAR_BASE ... OP_FUNC_BASE - 1] = &&op_var,
+        [OP_FUNC_BASE ... OP_COUNT - 1] = &&op_func,
+    };
+
+    VM_NEXT();
+#else
+    for (;;) {
+        uint8_t opcode = *pc++;
+
+        // Collapse the variable and function ranges onto one case each
+        if (opcode >= OP_FUNC_BASE) {
+            opcode = OP_FUNC_BASE;
+        } else if (opcode >= OP_VAR_BASE) {
+            opcode = OP_VAR_BASE;
+        }
+
+        switch (opcode) {
+#endif
+
+    VM_HANDLER(op_const, OP_CONST)
+        *++sp = program->constants[*pc++];
+        VM_NEXT();
+
+    VM_HANDLER(op_var, OP_VAR_BASE)
+        *++sp = *(const double *)(variables + variable_offsets[pc[-1] - OP_VAR_BASE]);
+        VM_NEXT();
+
+    VM_HANDLER(op_add, OP_ADD)
+        sp[-1] += sp[0];
+        if (!isfinite(*--sp)) {
+            return ERR_OVERFLOW;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_sub, OP_SUB)
+        sp[-1] -= sp[0];
+        if (!isfinite(*--sp)) {
+            return ERR_OVERFLOW;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_mul, OP_MUL)
+        sp[-1] *= sp[0];
+        if (!isfinite(*--sp)) {
+            return ERR_OVERFLOW;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_div, OP_DIV)
+        if (num_fabs(sp[0]) < 1e-15) {
+            return ERR_DIVISION_BY_ZERO;
+        }
+        sp[-1] /= sp[0];
+        if (!isfinite(*--sp)) {
+            return ERR_OVERFLOW;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_pow, OP_POW)
+        sp[-1] = num_power(sp[-1], sp[0]);
+        if (!isfinite(*--sp)) {
+            return ERR_OVERFLOW;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_neg, OP_NEG)
+        *sp = -*sp;
+        VM_NEXT();
+
+    VM_HANDLER(op_func, OP_FUNC_BASE)
+        *sp = apply_function((function_type_t)(pc[-1] - OP_FUNC_BASE), *sp, deg_mode);
+        if (!isfinite(*sp)) {
+            return ERR_DOMAIN_ERROR;
+        }
+        VM_NEXT();
+
+    VM_HANDLER(op_end, OP_END)
+        *result = *sp;
+        return 0;
+
+#ifndef EXPR_VM_THREADED
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+    }
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+ * Expression VM - Compact bytecode for compiled expressions
+ *
+ * An RPN queue is compiled into 1-byte opcodes plus a separate constant
+ * pool. The maximum stack depth is computed at compile time, so the
+ * interpreter runs without per-push bounds checks. On GCC/Clang the
+ * interpreter dispatches through a computed-goto table; other compilers
+ * use a plain switch.
+ *
+ * Bytecode layout:
+ * - OP_CONST <index>           Push constants[index]
+ * - OP_VAR_BASE + variable     Push a variable
+ * - OP_ADD .. OP_POW, OP_NEG   Arithmetic on the top of the stack
+ * - OP_FUNC_BASE + function    Apply a function to the top of the stack
+ * - OP_END                     Return the top of the stack
+ */
+
+#ifndef EXPRESSION_VM_H
+#define EXPRESSION_VM_H
+
+#include "expression_evaluator.h"
+#include <stdint.h>
+
+#define EXPR_VM_MAX_CONSTANTS 32
+#define EXPR_VM_MAX_STACK 32
+#define EXPR_VM_MAX_CODE (2 * MAX_TOKENS + 1)
+
+/**
+ * @brief VM opcodes (one byte each)
+ */
+typedef enum {
+    OP_END,
+    OP_CONST,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,
+    OP_NEG,
+    OP_VAR_BASE,
+    OP_FUNC_BASE = OP_VAR_BASE + VAR_COUNT,
+    OP_COUNT = OP_FUNC_BASE + FUNC_COUNT
+} vm_opcode_t;
+
+/**
+ * @brief Compiled expression program
+ */
+typedef struct {
+    uint8_t code[EXPR_VM_MAX_CODE];
+    uint8_t code_size;
+    uint8_t constant_count;
+    uint8_t max_depth;                      // Stack slots needed at run time
+    eval_num_t constants[EXPR_VM_MAX_CONSTANTS];
+} expr_program_t;
+
+/**
+ * @brief Compile an RPN queue into VM bytecode
+ * @param rpn_queue RPN tokens (ideally constant-folded)
+ * @param program Output program
+ * @return 0 on success, negative error code on failure
+ */
+int expr_vm_compile(const rpn_queue_t *rpn_queue, expr_program_t *program);
+
+/**
+ * @brief Run a compiled program
+ * @param program Program from expr_vm_compile()
+ * @param context Evaluation context (variables, angle mode)
+ * @param result Pointer to store the result
+ * @return 0 on success, negative error code on failure
+ */
+int expr_vm_execute(const expr_program_t *program, const eval_context_t *context, double *result);
+
+#endif /* EXPRESSION_VM_H */
@@ -0,0 +1,564 @@
+/*
+ * Fast Math Implementation
+ *
+ * The sin/cos/exp/atan polynomials are the fdlibm minimax coefficients.
+ * log uses a 23-entry table of log(c) in double-double and an atanh
+ * series on the reduced argument; the extra precision is what keeps
+ * pow() within 2 ULP for large y.
+ */
+
+#include "fast_math.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// Cody-Waite split of pi/2 (33 + 33 + 53 bits)
+#define PIO2_1  1.57079632673412561417e+00
+#define PIO2_2  6.07710050630396597660e-11
+#define PIO2_3  2.02226624871116645580e-21
+#define INVPIO2 6.36619772367581382433e-01
+#define PIO2_HI 1.57079632679489655800e+00
+#define PIO2_LO 6.12323399573676603587e-17
+
+// ln(2) split so that k * LN2_HI is exact for |k| < 2^21
+#define LN2_HI  6.93147180369123816490e-01
+#define LN2_LO  1.90821492927058770002e-10
+#define INVLN2  1.44269504088896338700e+00
+
+#define EXP_OVERFLOW   7.09782712893383973096e+02
+#define EXP_UNDERFLOW -7.45133219101941108420e+02
+// sinh and cosh overflow above ln(2 * DBL_MAX)
+#define HYP_OVERFLOW   7.10475860073943942086e+02
+
+// 1/ln(10) in double-double
+#define IVLN10_HI 0.4342944819032518
+#define IVLN10_LO 1.098319650216765e-17
+
+// Adding and subtracting this rounds |x| < 2^51 to the nearest integer
+#define ROUND_MAGIC 6755399441055744.0
+
+// sin kernel on [-pi/4, pi/4]
+#define S1 -1.66666666666666324348e-01
+#define S2  8.33333333332248946124e-03
+#define S3 -1.98412698298579493134e-04
+#define S4  2.75573137070700676789e-06
+#define S5 -2.50507602534068634195e-08
+#define S6  1.58969099521155010221e-10
+
+// cos kernel on [-pi/4, pi/4]
+#define C1  4.16666666666666019037e-02
+#define C2 -1.38888888888741095749e-03
+#define C3  2.48015872894767294178e-05
+#define C4 -2.75573143513906633035e-07
+#define C5  2.08757232129817482790e-09
+#define C6 -1.13596475577881948265e-11
+
+// exp kernel on [-ln2/2, ln2/2]
+#define P1  1.66666666666666019037e-01
+#define P2 -2.77777777770155933842e-03
+#define P3  6.61375632143793436117e-05
+#define P4 -1.65339022054652515390e-06
+#define P5  4.13813679705723846039e-08
+
+// atan breakpoints atan(0.5), atan(1), atan(1.5), atan(inf) in double-double
+static const double atan_hi[] = {
+    4.63647609000806093515e-01, 7.85398163397448278999e-01,
+    9.82793723247329054082e-01, 1.57079632679489655800e+00,
+};
+static const double atan_lo[] = {
+    2.26987774529616870924e-17, 3.06161699786838301793e-17,
+    1.39033110312309984516e-17, 6.12323399573676603587e-17,
+};
+
+// atan kernel on [-7/16, 7/16]
+static const double atan_coeff[] = {
+    3.33333333333329318027e-01, -1.99999999998764832476e-01,
+    1.42857142725034663711e-01, -1.11111104054623557880e-01,
+    9.09088713343650656196e-02, -7.69187620504482999495e-02,
+    6.66107313738753120669e-02, -5.83357013379057348645e-02,
+    4.97687799461593236017e-02, -3.65315727442169155270e-02,
+    1.62858201153657823623e-02,
+};
+
+// log(c) for c = 1 + j/32, j = -9..13, in double-double
+#define LOG_TABLE_FIRST -9
+static const double log_table[][2] = {
+    {-0.33024168687057687, 1.0828321637483858e-17},     // log(0.71875)
+    {-0.2876820724517809, -2.607160616442564e-17},      // log(0.75)
+    {-0.24686007793152578, -1.361743371748368e-17},     // log(0.78125)
+    {-0.2076393647782445, -1.2053243216686129e-17},     // log(0.8125)
+    {-0.16989903679539747, 4.868008764439071e-19},      // log(0.84375)
+    {-0.13353139262452263, 3.664457663660085e-18},      // log(0.875)
+    {-0.09844007281325252, 4.439009633675136e-18},      // log(0.90625)
+    {-0.06453852113757118, 6.470486661692933e-18},      // log(0.9375)
+    {-0.0317486983145803, -3.0382263084680858e-18},     // log(0.96875)
+    {0.0, 0.0},                                         // log(1.0)
+    {0.030771658666753687, 1.0431732029005968e-18},     // log(1.03125)
+    {0.06062462181643484, 2.6424025938726934e-18},      // log(1.0625)
+    {0.08961215868968714, -5.4268129336647135e-18},     // log(1.09375)
+    {0.11778303565638346, -1.1971685747593677e-18},     // log(1.125)
+    {0.1451820098444979, 8.242418783022475e-18},        // log(1.15625)
+    {0.17185025692665923, -6.0224538210113705e-18},     // log(1.1875)
+    {0.19782574332991987, 1.2821194372980142e-17},      // log(1.21875)
+    {0.22314355131420976, -9.091270597324799e-18},      // log(1.25)
+    {0.24783616390458127, -1.2432209578702523e-17},     // log(1.28125)
+    {0.27193371548364176, 7.83319637697442e-19},        // log(1.3125)
+    {0.2954642128938359, -2.16461086040599e-17},        // log(1.34375)
+    {0.3184537311185346, 2.7114779367326236e-17},       // log(1.375)
+    {0.3409265869705932, 1.7467136443544747e-17},       // log(1.40625)
+};
+
+// 2^k for -1022 <= k <= 1023, built directly from the exponent bits
+static inline double pow2i(int k)
+{
+    uint64_t bits = (uint64_t)(k + 1023) << 52;
+    double result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// y * 2^k for any k an exp() result can need
+static inline double scale_pow2(double y, int k)
+{
+    if (k > 1023) {
+        return y * pow2i(1023) * pow2i(k - 1023);
+    }
+    if (k < -1022) {
+        return y * pow2i(k + 1000) * pow2i(-1000);
+    }
+    return y * pow2i(k);
+}
+
+// Error-free sum: hi + lo == a + b exactly
+static inline void two_sum(double a, double b, double *hi, double *lo)
+{
+    double s = a + b;
+    double bb = s - a;
+    *lo = (a - (s - bb)) + (b - bb);
+    *hi = s;
+}
+
+// Error-free product: hi + lo == a * b exactly
+static inline void two_prod(double a, double b, double *hi, double *lo)
+{
+    *hi = a * b;
+#if defined(FP_FAST_FMA)
+    *lo = fma(a, b, -*hi);
+#else
+    // Dekker's product, for targets where fma() is a library call
+    const double split = 134217729.0;   // 2^27 + 1
+    double ta = split * a, tb = split * b;
+    double a_hi = ta - (ta - a), b_hi = tb - (tb - b);
+    double a_lo = a - a_hi, b_lo = b - b_hi;
+    *lo = ((a_hi * b_hi - *hi) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+}
+
+// sin(x + y) for |x| <= pi/4, y the tail of the reduced argument
+static inline double kernel_sin(double x, double y)
+{
+    double z = x * x;
+    double v = z * x;
+    double r = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+    return x - ((z * (0.5 * y - v * r) - y) - v * S1);
+}
+
+// cos(x + y) for |x| <= pi/4, y the tail of the reduced argument
+static inline double kernel_cos(double x, double y)
+{
+    double z = x * x;
+    double r = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+// Reduce x to hi + lo in [-pi/4, pi/4] with x = hi + lo + n * pi/2
+static inline double reduce_pio2(double x, int *n, double *lo)
+{
+    double fn = (x * INVPIO2 + ROUND_MAGIC) - ROUND_MAGIC;
+    *n = (int)fn;
+
+    // fn * PIO2_1 and fn * PIO2_2 are exact for |fn| < 2^20
+    double t = x - fn * PIO2_1;
+    double w = fn * PIO2_2;
+    double r = t - w;
+    double tail = ((t - r) - w) - fn * PIO2_3;
+    double hi = r + tail;
+    *lo = (r - hi) + tail;
+    return hi;
+}
+
+double fm_sin(double x)
+{
+    double lo;
+    int n;
+
+    if (!(fabs(x) <= FM_TRIG_MAX)) {
+        return sin(x);  // NaN, infinity, or beyond the exact reduction range
+    }
+
+    double r = reduce_pio2(x, &n, &lo);
+    switch (n & 3) {
+        case 0: return kernel_sin(r, lo);
+        case 1: return kernel_cos(r, lo);
+        case 2: return -kernel_sin(r, lo);
+        default: return -kernel_cos(r, lo);
+    }
+}
+
+double fm_cos(double x)
+{
+    double lo;
+    int n;
+
+    if (!(fabs(x) <= FM_TRIG_MAX)) {
+        return cos(x);
+    }
+
+    double r = reduce_pio2(x, &n, &lo);
+    switch (n & 3) {
+        case 0: return kernel_cos(r, lo);
+        case 1: return -kernel_sin(r, lo);
+        case 2: return -kernel_cos(r, lo);
+        default: return kernel_sin(r, lo);
+    }
+}
+
+double fm_tan(double x)
+{
+    double lo;
+    int n;
+
+    if (!(fabs(x) <= FM_TRIG_MAX)) {
+        return tan(x);
+    }
+
+    double r = reduce_pio2(x, &n, &lo);
+    double s = kernel_sin(r, lo);
+    double c = kernel_cos(r, lo);
+    return (n & 1) ? -c / s : s / c;
+}
+
+double fm_sin_pio4(double x)
+{
+    return kernel_sin(x, 0.0);
+}
+
+double fm_cos_pio4(double x)
+{
+    return kernel_cos(x, 0.0);
+}
+
+double fm_tan_pio4(double x)
+{
+    return kernel_sin(x, 0.0) / kernel_cos(x, 0.0);
+}
+
+double fm_atan(double x)
+{
+    double ax = fabs(x);
+    int id;
+
+    if (isnan(x)) {
+        return x;
+    }
+    if (ax >= 0x1p66) {
+        return copysign(PIO2_HI + PIO2_LO, x);
+    }
+
+    if (ax < 0.4375) {
+        if (ax < 0x1p-27) {
+            return x;
+        }
+        id = -1;
+    } else if (ax < 0.6875) {
+        id = 0;
+        ax = (2.0 * ax - 1.0) / (2.0 + ax);
+    } else if (ax < 1.1875) {
+        id = 1;
+        ax = (ax - 1.0) / (ax + 1.0);
+    } else if (ax < 2.4375) {
+        id = 2;
+        ax = (ax - 1.5) / (1.0 + 1.5 * ax);
+    } else {
+        id = 3;
+        ax = -1.0 / ax;
+    }
+
+    const double *a = atan_coeff;
+    double z = ax * ax;
+    double w = z * z;
+    double s1 = z * (a[0] + w * (a[2] + w * (a[4] + w * (a[6] + w * (a[8] + w * a[10])))));
+    double s2 = w * (a[1] + w * (a[3] + w * (a[5] + w * (a[7] + w * a[9]))));
+
+    if (id < 0) {
+        return x - x * (s1 + s2);
+    }
+    double result = atan_hi[id] - ((ax * (s1 + s2) - atan_lo[id]) - ax);
+    return copysign(result, x);
+}
+
+double fm_asin(double x)
+{
+    double ax = fabs(x);
+
+    if (!(ax <= 1.0)) {
+        return NAN;
+    }
+    if (ax == 1.0) {
+        return copysign(PIO2_HI, x);
+    }
+    // (1 - x)(1 + x) keeps full precision near |x| = 1
+    return fm_atan(x / sqrt((1.0 - ax) * (1.0 + ax)));
+}
+
+double fm_acos(double x)
+{
+    if (!(fabs(x) <= 1.0)) {
+        return NAN;
+    }
+    if (x == -1.0) {
+        return 2.0 * PIO2_HI;
+    }
+    // acos(x) = 2 atan(sqrt((1 - x) / (1 + x))), accurate at both ends
+    return 2.0 * fm_atan(sqrt((1.0 - x) / (1.0 + x)));
+}
+
+// exp(x) * (1 + tail) for |tail| << ulp(x); tail carries pow()'s low part
+static double exp_with_tail(double x, double tail)
+{
+    double hi, lo, c, t, y;
+    int k;
+
+    if (isnan(x)) {
+        return x;
+    }
+    if (x > EXP_OVERFLOW) {
+        return INFINITY;
+    }
+    if (x < EXP_UNDERFLOW) {
+        return 0.0;
+    }
+
+    double ax = fabs(x);
+    if (ax > 0.5 * LN2_HI) {
+        double fk = (x * INVLN2 + ROUND_MAGIC) - ROUND_MAGIC;
+        k = (int)fk;
+        hi = x - fk * LN2_HI;
+        lo = fk * LN2_LO;
+        x = hi - lo;
+    } else if (ax < 0x1p-28) {
+        return (1.0 + x) * (1.0 + tail);
+    } else {
+        k = 0;
+        hi = x;
+        lo = 0.0;
+    }
+
+    t = x * x;
+    c = x - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+    y = 1.0 - ((lo - (x * c) / (2.0 - c)) - hi);
+    y += y * tail;
+
+    return k == 0 ? y : scale_pow2(y, k);
+}
+
+double fm_exp(double x)
+{
+    return exp_with_tail(x, 0.0);
+}
+
+// log(x) for finite x > 0 as hi + lo, relative error below 2^-63
+static void log_dd(double x, double *hi, double *lo)
+{
+    uint64_t bits;
+    int k = 0;
+
+    memcpy(&bits, &x, sizeof(bits));
+    if ((bits >> 52) == 0) {
+        // Subnormal: scale into the normal range first
+        x *= 0x1p54;
+        memcpy(&bits, &x, sizeof(bits));
+        k = -54;
+    }
+
+    // x = 2^k * m with m in [sqrt(1/2), sqrt(2)); offsetting by the bits
+    // of sqrt(1/2) picks k without a data-dependent branch
+    uint64_t offset = bits - 0x3FE6A09E667F3BCDull;
+    int shift = (int)((int64_t)offset >> 52);
+    k += shift;
+    bits -= (uint64_t)shift << 52;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+
+    // log(m) = log(c) + 2 atanh((m - c) / (m + c)), c = 1 + j/32 nearest m
+    int j = (int)(((m - 1.0) * 32.0 + ROUND_MAGIC) - ROUND_MAGIC);
+    double c = 1.0 + j * 0.03125;
+    double d = m - c;                               // Exact (Sterbenz)
+    double u_hi, u_lo;
+    two_sum(m, c, &u_hi, &u_lo);
+    // One division; the residual corrects s_hi's rounding to ~2^-104
+    double rcp = 1.0 / u_hi;
+    double s_hi = d * rcp;
+    double p_hi, p_lo;
+    two_prod(s_hi, u_hi, &p_hi, &p_lo);
+    double s_lo = (((d - p_hi) - p_lo) - s_hi * u_lo) * rcp;
+
+    // 2 atanh(s) = 2s + s^3 (2/3 + s^2 (2/5 + s^2 (2/7 + s^2 2/9))), |s| <= 1/128
+    double z = s_hi * s_hi;
+    double tail = s_hi * z * (2.0 / 3 + z * (2.0 / 5 + z * (2.0 / 7 + z * (2.0 / 9))));
+
+    const double *log_c = log_table[j - LOG_TABLE_FIRST];
+    double sum_hi, sum_lo, e1, e2;
+    two_sum(k * LN2_HI, log_c[0], &sum_hi, &e1);
+    two_sum(sum_hi, 2.0 * s_hi, &sum_hi, &e2);
+    sum_lo = e1 + e2 + (k * LN2_LO + log_c[1] + 2.0 * s_lo + tail);
+    two_sum(sum_hi, sum_lo, hi, lo);
+}
+
+double fm_log(double x)
+{
+    double hi, lo;
+
+    if (!(x > 0.0)) {
+        return x == 0.0 ? -INFINITY : NAN;
+    }
+    if (isinf(x)) {
+        return x;
+    }
+    log_dd(x, &hi, &lo);
+    return hi + lo;
+}
+
+double fm_log10(double x)
+{
+    double hi, lo;
+
+    if (!(x > 0.0)) {
+        return x == 0.0 ? -INFINITY : NAN;
+    }
+    if (isinf(x)) {
+        return x;
+    }
+    log_dd(x, &hi, &lo);
+
+    // (hi + lo) / ln(10) in double-double, then round once
+    double p, e;
+    two_prod(hi, IVLN10_HI, &p, &e);
+    return p + (e + (hi * IVLN10_LO + lo * IVLN10_HI));
+}
+
+// True if y is an integer; *odd reports its parity
+static bool is_integer(double y, bool *odd)
+{
+    if (y != floor(y)) {
+        return false;
+    }
+    *odd = fabs(y) < 0x1p53 && fmod(y, 2.0) != 0.0;
+    return true;
+}
+
+double fm_pow(double x, double y)
+{
+    bool odd = false;
+    bool negate = false;
+    double hi, lo;
+
+    if (y == 0.0 || x == 1.0) {
+        return 1.0;
+    }
+    if (isnan(x) || isnan(y)) {
+        return NAN;
+    }
+    if (x == 0.0) {
+        // Signed zero keeps its sign only under odd integer powers
+        double zero_pow = y > 0.0 ? 0.0 : INFINITY;
+        return is_integer(y, &odd) && odd && signbit(x) ? -zero_pow : zero_pow;
+    }
+    if (x < 0.0) {
+        if (!is_integer(y, &odd)) {
+            return NAN;
+        }
+        negate = odd;
+        x = -x;
+    }
+    if (isinf(x) || isinf(y)) {
+        double result = pow(x, y);  // Limits only; no precision involved
+        return negate ? -result : result;
+    }
+
+    // x^y = exp(y * log(x)) with the product carried in double-double
+    log_dd(x, &hi, &lo);
+    double t_hi, t_lo;
+    two_prod(y, hi, &t_hi, &t_lo);
+    double result = exp_with_tail(t_hi, t_lo + y * lo);
+
+    // Integer powers of integers are exact when representable
+    if (x == floor(x) && y > 0.0 && y == floor(y) && result < 0x1p50) {
+        result = floor(result + 0.5);
+    }
+
+    return negate ? -result : result;
+}
+
+// e^x / 2 for 0 <= x <= HYP_OVERFLOW. Split exp so it does not overflow
+// before e^x / 2 does; in the last half unit below HYP_OVERFLOW even
+// e^(x - ln 2) does, so it is taken as twice e^(x - 2 ln 2) there.
+static double half_exp(double x)
+{
+    if (x - LN2_HI <= EXP_OVERFLOW) {
+        return fm_exp(x - LN2_HI) * (1.0 - LN2_LO);
+    }
+    return 2.0 * (fm_exp(x - 2.0 * LN2_HI) * (1.0 - 2.0 * LN2_LO));
+}
+
+double fm_sinh(double x)
+{
+    double ax = fabs(x);
+
+    if (ax < 1.0) {
+        // Taylor series; the x^19 term is below 2^-56 relative
+        double z = x * x;
+        return x + x * z * (1.0 / 6 + z * (1.0 / 120 + z * (1.0 / 5040 +
+               z * (1.0 / 362880 + z * (1.0 / 39916800 + z * (1.0 / 6227020800.0 +
+               z * (1.0 / 1307674368000.0 + z * (1.0 / 355687428096000.0))))))));
+    }
+    if (ax > HYP_OVERFLOW) {
+        return copysign(INFINITY, x);
+    }
+
+    double e = half_exp(ax);
+    return copysign(e - 0.25 / e, x);
+}
+
+double fm_cosh(double x)
+{
+    double ax = fabs(x);
+
+    if (ax > HYP_OVERFLOW) {
+        return INFINITY;
+    }
+    double e = half_exp(ax);
+    return e + 0.25 / e;
+}
+
+double fm_tanh(double x)
+{
+    double ax = fabs(x);
+
+    if (isnan(x)) {
+        return x;
+    }
+    if (ax > 22.0) {
+        return copysign(1.0, x);
+    }
+    if (ax < 1.0) {
+        double s = fm_sinh(ax);
+        return copysign(s / sqrt(1.0 + s * s), x);
+    }
+    // tanh = 1 - 2 / (e^2x + 1)
+    double e = fm_exp(2.0 * ax);
+    return copysign(1.0 - 2.0 / (e + 1.0), x);
+}
@@ -0,0 +1,145 @@
+/*
+ * Fast Math - In-tree elementary function kernels
+ *
+ * Bounded-error replacements for the libm double functions used by
+ * apply_function(). Each kernel does a cheap range reduction followed
+ * by a fixed minimax or series polynomial, so timing does not depend on
+ * the libm build and stays nearly constant across the input domain.
+ *
+ * Maximum error over the domains sampled by the host benchmark
+ * (fast_math section, long double reference):
+ *
+ *   fm_sin, fm_cos       <= 1 ULP   for |x| <= FM_TRIG_MAX
+ *   fm_tan               <= 2 ULP   for |x| <= FM_TRIG_MAX
+ *   fm_asin, fm_acos     <= 2 ULP
+ *   fm_atan              <= 1 ULP
+ *   fm_exp               <= 1 ULP
+ *   fm_log, fm_log10     <= 1 ULP   (log is evaluated in double-double)
+ *   fm_pow               <= 2 ULP
+ *   fm_sinh, fm_cosh     <= 3 ULP
+ *   fm_tanh              <= 3 ULP
+ *
+ * Arguments beyond FM_TRIG_MAX fall back to libm, since the Cody-Waite
+ * reduction used here is only exact for |x / (pi/2)| < 2^19.
+ * Enabled for the evaluator by CONFIG_CALC_FAST_MATH.
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#define FM_TRIG_MAX 823549.0    // 2^19 * pi/2
+
+/**
+ * @brief Sine of x in radians
+ * @param x Argument
+ * @return Result
+ */
+double fm_sin(double x);
+
+/**
+ * @brief Cosine of x in radians
+ * @param x Argument
+ * @return Result
+ */
+double fm_cos(double x);
+
+/**
+ * @brief Tangent of x in radians
+ * @param x Argument
+ * @return Result
+ */
+double fm_tan(double x);
+
+/**
+ * @brief Sine of x already reduced to [-pi/4, pi/4]; no range reduction
+ * @param x Argument, |x| <= pi/4
+ * @return Result
+ */
+double fm_sin_pio4(double x);
+
+/**
+ * @brief Cosine of x already reduced to [-pi/4, pi/4]; no range reduction
+ * @param x Argument, |x| <= pi/4
+ * @return Result
+ */
+double fm_cos_pio4(double x);
+
+/**
+ * @brief Tangent of x already reduced to [-pi/4, pi/4]; no range reduction
+ * @param x Argument, |x| <= pi/4
+ * @return Result
+ */
+double fm_tan_pio4(double x);
+
+/**
+ * @brief Arcsine in radians; NaN outside [-1, 1]
+ * @param x Argument
+ * @return Result
+ */
+double fm_asin(double x);
+
+/**
+ * @brief Arccosine in radians; NaN outside [-1, 1]
+ * @param x Argument
+ * @return Result
+ */
+double fm_acos(double x);
+
+/**
+ * @brief Arctangent in radians
+ * @param x Argument
+ * @return Result
+ */
+double fm_atan(double x);
+
+/**
+ * @brief e^x; infinity above ~709.78, zero below ~-745.13
+ * @param x Argument
+ * @return Result
+ */
+double fm_exp(double x);
+
+/**
+ * @brief Natural logarithm; -infinity at 0, NaN below
+ * @param x Argument
+ * @return Result
+ */
+double fm_log(double x);
+
+/**
+ * @brief Base-10 logarithm; -infinity at 0, NaN below
+ * @param x Argument
+ * @return Result
+ */
+double fm_log10(double x);
+
+/**
+ * @brief x raised to y; negative x only for integer y
+ * @param x Base
+ * @param y Exponent
+ * @return Result, exact for integer powers of integers below 2^50
+ */
+double fm_pow(double x, double y);
+
+/**
+ * @brief Hyperbolic sine
+ * @param x Argument
+ * @return Result
+ */
+double fm_sinh(double x);
+
+/**
+ * @brief Hyperbolic cosine
+ * @param x Argument
+ * @return Result
+ */
+double fm_cosh(double x);
+
+/**
+ * @brief Hyperbolic tangent
+ * @param x Argument
+ * @return Result
+ */
+double fm_tanh(double x);
+
+#endif /* FAST_MATH_H */
@@ -0,0 +1,425 @@
+/*
+ * Numerical Integration Implementation
+ */
+
+#include "integration.h"
+#include <float.h>
+#include <math.h>
+
+#define HALF_PI 1.57079632679489661923
+
+#define GK_POINTS       15
+#define TS_CHUNK        64      // Tanh-sinh nodes per evaluate_rpn_batch() call
+#define TS_MAX_LEVEL    12      // Finest step 2^-12
+#define TS_TAIL         1e-12   // Relative endpoint distance below which failures are dropped
+
+// Kronrod 15-point abscissae on [0, 1]; the odd entries and 0 are the
+// 7-point Gauss nodes
+static const double gk_nodes[8] = {
+    0.991455371120812639206854697526329,
+    0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926,
+    0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013,
+    0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245,
+    0.000000000000000000000000000000000,
+};
+
+static const double kronrod_weights[8] = {
+    0.022935322010529224963732008058970,
+    0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518,
+    0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550,
+    0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649,
+    0.209482141084727828012999174891714,
+};
+
+// Gauss weights for gk_nodes[1], [3], [5] and [7]
+static const double gauss_weights[4] = {
+    0.129484966168869693270611432679082,
+    0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975,
+    0.417959183673469387755102040816327,
+};
+
+typedef struct {
+    double a, b;
+    double value;
+    double abs_value;   // Integral of |f|, the scale for the tolerance
+    double error;
+} gk_panel_t;
+
+// Static so a deep integration does not land on the 4 KB main stack
+static gk_panel_t panels[INTEGRATION_MAX_PANELS];
+static double sample_x[TS_CHUNK];
+static double sample_w[TS_CHUNK];
+static double sample_f[TS_CHUNK];
+static bool sample_tail[TS_CHUNK];
+
+void integration_config_default(integration_config_t *config)
+{
+    config->tolerance = INTEGRATION_DEFAULT_TOLERANCE;
+    config->max_evaluations = INTEGRATION_DEFAULT_MAX_EVALS;
+}
+
+// G7/K15 on one panel, with the QUADPACK error estimate
+static int gk15(const rpn_queue_t *integrand, const eval_context_t *context,
+                double a, double b, gk_panel_t *panel)
+{
+    const double center = 0.5 * (a + b);
+    const double half = 0.5 * (b - a);
+
+    sample_x[0] = center;
+    for (int j = 0; j < 7; j++) {
+        sample_x[1 + 2 * j] = center - half * gk_nodes[j];
+        sample_x[2 + 2 * j] = center + half * gk_nodes[j];
+    }
+
+    int failed = evaluate_rpn_batch(integrand, context, sample_x, sample_f, GK_POINTS);
+    if (failed != 0) {
+        return failed < 0 ? failed : ERR_DOMAIN_ERROR;
+    }
+
+    const double fc = sample_f[0];
+    double kronrod = kronrod_weights[7] * fc;
+    double gauss = gauss_weights[3] * fc;
+    double abs_sum = fabs(kronrod);
+
+    for (int j = 0; j < 7; j++) {
+        double f1 = sample_f[1 + 2 * j];
+        double f2 = sample_f[2 + 2 * j];
+
+        kronrod += kronrod_weights[j] * (f1 + f2);
+        abs_sum += kronrod_weights[j] * (fabs(f1) + fabs(f2));
+        if (j & 1) {
+            gauss += gauss_weights[j >> 1] * (f1 + f2);
+        }
+    }
+
+    // Spread of f around its mean; keeps the error estimate honest when
+    // K15 and G7 agree by accident
+    const double mean = 0.5 * kronrod;
+    double spread = kronrod_weights[7] * fabs(fc - mean);
+    for (int j = 0; j < 7; j++) {
+        spread += kronrod_weights[j] * (fabs(sample_f[1 + 2 * j] - mean) +
+                                        fabs(sample_f[2 + 2 * j] - mean));
+    }
+
+    panel->a = a;
+    panel->b = b;
+    panel->value = kronrod * half;
+    panel->abs_value = abs_sum * half;
+    spread *= half;
+
+    double error = fabs((kronrod - gauss) * half);
+    if (spread != 0.0 && error != 0.0) {
+        error = spread * fmin(1.0, pow(200.0 * error / spread, 1.5));
+    }
+    // Never claim more than the evaluator's own rounding allows
+    if (panel->abs_value > DBL_MIN / (50.0 * EVAL_NUM_EPSILON)) {
+        error = fmax(50.0 * EVAL_NUM_EPSILON * panel->abs_value, error);
+    }
+    panel->error = error;
+
+    if (!isfinite(panel->value) || !isfinite(error)) {
+        return ERR_OVERFLOW;
+    }
+    return 0;
+}
+
+// Adaptive Gauss-Kronrod on a < b: bisect the worst panel until the
+// summed error meets the tolerance, the budget or the panel array runs out
+static int gauss_kronrod(const rpn_queue_t *integrand, const eval_context_t *context,
+                         double a, double b, double tolerance, int budget,
+                         integration_result_t *result)
+{
+    int count = 1;
+    int status = gk15(integrand, context, a, b, &panels[0]);
+
+    result->method = INTEGRATION_GAUSS_KRONROD;
+    if (status != 0) {
+        return status;
+    }
+    result->evaluations += GK_POINTS;
+
+    double value = panels[0].value;
+    double abs_value = panels[0].abs_value;
+    double error = panels[0].error;
+
+    while (error > tolerance * abs_value &&
+           count < INTEGRATION_MAX_PANELS &&
+           result->evaluations + 2 * GK_POINTS <= budget) {
+        int worst = 0;
+        for (int i = 1; i < count; i++) {
+            if (panels[i].error > panels[worst].error) {
+                worst = i;
+            }
+        }
+
+        gk_panel_t *panel = &panels[worst];
+        const double mid = 0.5 * (panel->a + panel->b);
+        if (mid <= panel->a || mid >= panel->b) {
+            break;      // Panel is down to adjacent doubles
+        }
+
+        gk_panel_t left, right;
+        status = gk15(integrand, context, panel->a, mid, &left);
+        if (status == 0) {
+            status = gk15(integrand, context, mid, panel->b, &right);
+        }
+        if (status != 0) {
+            return status;
+        }
+        result->evaluations += 2 * GK_POINTS;
+
+        value += left.value + right.value - panel->value;
+        abs_value += left.abs_value + right.abs_value - panel->abs_value;
+        error += left.error + right.error - panel->error;
+        *panel = left;
+        panels[count++] = right;
+    }
+
+    // Re-sum so the running updates leave no drift in the result
+    value = abs_value = error = 0.0;
+    for (int i = 0; i < count; i++) {
+        value += panels[i].value;
+        abs_value += panels[i].abs_value;
+        error += panels[i].error;
+    }
+
+    result->value = value;
+    result->error_estimate = error;
+    result->subdivisions = count;
+    return error <= tolerance * abs_value ? 0 : ERR_NO_CONVERGENCE;
+}
+
+typedef struct {
+    int count;          // Nodes buffered in sample_x / sample_w
+    double sum;         // Sum of w * f over the levels so far
+    double abs_sum;     // Sum of w * |f|
+} tanh_sinh_sums_t;
+
+// Evaluate the buffered tanh-sinh nodes and add them to the sums. Next
+// to a singular endpoint f can fail to evaluate before the nodes run out
+// (1/sqrt(X) divides by less than the evaluator's zero threshold below
+// X = 1e-30, and a float evaluator rounds nodes onto the endpoint); such
+// tail nodes are dropped, as their weight is negligible.
+static int tanh_sinh_flush(const rpn_queue_t *integrand, const eval_context_t *context,
+                           int budget, tanh_sinh_sums_t *sums, integration_result_t *result)
+{
+    const int n = sums->count;
+
+    if (n == 0) {
+        return 0;
+    }
+    if (result->evaluations + n > budget) {
+        return ERR_NO_CONVERGENCE;
+    }
+
+    int failed = evaluate_rpn_batch(integrand, context, sample_x, sample_f, n);
+    if (failed < 0) {
+        return failed;
+    }
+    result->evaluations += n;
+    sums->count = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (isnan(sample_f[i])) {
+            if (!sample_tail[i]) {
+                return ERR_DOMAIN_ERROR;
+            }
+            continue;
+        }
+        sums->sum += sample_w[i] * sample_f[i];
+        sums->abs_sum += sample_w[i] * fabs(sample_f[i]);
+    }
+    return 0;
+}
+
+static int tanh_sinh_add(const rpn_queue_t *integrand, const eval_context_t *context,
+                         double x, double w, bool tail, int budget, tanh_sinh_sums_t *sums,
+                         integration_result_t *result)
+{
+    sample_x[sums->count] = x;
+    sample_w[sums->count] = w;
+    sample_tail[sums->count] = tail;
+    if (++sums->count < TS_CHUNK) {
+        return 0;
+    }
+    return tanh_sinh_flush(integrand, context, budget, sums, result);
+}
+
+// Tanh-sinh on a < b. Level 0 samples t = 0, +-1, +-2, ...; each later
+// level halves the step and adds only the new odd multiples, reusing the
+// sums so far. Nodes are placed from the nearest endpoint using
+// s = (1 - tanh(u)) / 2 = 1 / (1 + e^2u), which keeps full relative
+// precision in the distance to an endpoint where f is singular. A side
+// stops once its node rounds onto the endpoint or the weight underflows.
+static int tanh_sinh(const rpn_queue_t *integrand, const eval_context_t *context,
+                     double a, double b, double tolerance, int budget,
+                     integration_result_t *result)
+{
+    const double half = 0.5 * (b - a);
+    tanh_sinh_sums_t sums = {0};
+    double h = 1.0;
+
+    result->method = INTEGRATION_TANH_SINH;
+    result->value = 0.0;
+    result->error_estimate = INFINITY;
+    result->subdivisions = 0;
+
+    for (int level = 0; level <= TS_MAX_LEVEL; level++, h *= 0.5) {
+        const int step = level == 0 ? 1 : 2;
+        bool lower_done = false, upper_done = false;
+        int status = 0;
+
+        for (int k = level == 0 ? 0 : 1; status == 0 && !(lower_done && upper_done); k += step) {
+            const double t = k * h;
+            const double u = HALF_PI * sinh(t);
+            const double s = 1.0 / (1.0 + exp(2.0 * u));
+            const double w = HALF_PI * cosh(t) * 4.0 * s * (1.0 - s);
+            const double dist = (b - a) * s;
+
+            if (w == 0.0) {
+                break;
+            }
+            const double lower = a + dist;
+            const double upper = b - dist;
+            const bool tail = s < TS_TAIL;
+
+            if (!lower_done) {
+                if (lower <= a) {
+                    lower_done = true;
+                } else {
+                    status = tanh_sinh_add(integrand, context, lower, w,
+                                           tail || (eval_num_t)lower == (eval_num_t)a,
+                                           budget, &sums, result);
+                }
+            }
+            if (k == 0 || status != 0) {
+                continue;   // t = 0 is the single center node
+            }
+            if (!upper_done) {
+                if (upper >= b) {
+                    upper_done = true;
+                } else {
+                    status = tanh_sinh_add(integrand, context, upper, w,
+                                           tail || (eval_num_t)upper == (eval_num_t)b,
+                                           budget, &sums, result);
+                }
+            }
+        }
+        if (status == 0) {
+            status = tanh_sinh_flush(integrand, context, budget, &sums, result);
+        }
+        if (status != 0) {
+            // Out of budget mid-level: the previous level's estimate stands
+            return status;
+        }
+
+        const double estimate = half * h * sums.sum;
+        const double abs_estimate = half * h * sums.abs_sum;
+        if (!isfinite(estimate)) {
+            return ERR_OVERFLOW;
+        }
+        if (level > 0) {
+            result->error_estimate = fabs(estimate - result->value);
+        }
+        result->value = estimate;
+        result->subdivisions = level + 1;
+
+        if (level >= 2 && result->error_estimate <= tolerance * abs_estimate) {
+            return 0;
+        }
+    }
+    return ERR_NO_CONVERGENCE;
+}
+
+int integrate_rpn(const rpn_queue_t *integrand, const eval_context_t *context,
+                  double a, double b, const integration_config_t *config,
+                  integration_result_t *result)
+{
+    integration_config_t defaults;
+    if (config == NULL) {
+        integration_config_default(&defaults);
+        config = &defaults;
+    }
+
+    *result = (integration_result_t){0};
+    if (!isfinite(a) || !isfinite(b)) {
+        return ERR_DOMAIN_ERROR;
+    }
+    if (a == b) {
+        return 0;
+    }
+
+    double sign = 1.0;
+    if (a > b) {
+        double tmp = a;
+        a = b;
+        b = tmp;
+        sign = -1.0;
+    }
+
+    // Probe the endpoints: if f is not finite there, only tanh-sinh,
+    // which never samples them, can handle the integrand
+    sample_x[0] = a;
+    sample_x[1] = b;
+    int failed = evaluate_rpn_batch(integrand, context, sample_x, sample_f, 2);
+    if (failed < 0) {
+        return failed;
+    }
+    const bool singular = failed > 0 || !isfinite(sample_f[0]) || !isfinite(sample_f[1]);
+
+    integration_result_t gk = { .evaluations = 2 };
+    int status = ERR_NO_CONVERGENCE;
+    if (!singular) {
+        // Gauss-Kronrod gets half the budget; the rest is kept for
+        // tanh-sinh in case the endpoint behaviour defeats bisection
+        status = gauss_kronrod(integrand, context, a, b, config->tolerance,
+                               config->max_evaluations / 2, &gk);
+        if (status != ERR_NO_CONVERGENCE) {
+            *result = gk;
+            result->value *= sign;
+            return status;
+        }
+    }
+
+    integration_result_t ts = { .evaluations = gk.evaluations };
+    status = tanh_sinh(integrand, context, a, b, config->tolerance,
+                       config->max_evaluations, &ts);
+
+    if (singular || status == 0 ||
+        (status == ERR_NO_CONVERGENCE && ts.error_estimate < gk.error_estimate)) {
+        *result = ts;
+    } else {
+        // Gauss-Kronrod missed the tolerance and tanh-sinh did no better
+        *result = gk;
+        result->evaluations = ts.evaluations;
+        status = ERR_NO_CONVERGENCE;
+    }
+    result->value *= sign;
+    return status;
+}
+
+int integrate_expression(const char *expression, const eval_context_t *context,
+                         double a, double b, const integration_config_t *config,
+                         integration_result_t *result)
+{
+    // Static for the same reason as the batch workspace: ~1 KB of tokens
+    static rpn_queue_t integrand;
+
+    // Callers may log the counters even when the expression does not parse
+    *result = (integration_result_t){0};
+
+    int status = parse_expression_to_rpn(expression, &integrand);
+    if (status != 0) {
+        return status;
+    }
+    optimize_rpn(&integrand, context->deg_mode);
+
+    return integrate_rpn(&integrand, context, a, b, config, result);
+}
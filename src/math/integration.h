@@ -0,0 +1,104 @@
+/*
+ * Numerical Integration
+ *
+ * Definite integrals of an expression in X for the integration key. The
+ * integrand is compiled once into an rpn_queue_t and constant-folded,
+ * then sampled with evaluate_rpn_batch(), so each quadrature panel costs
+ * one batch call instead of one parse per point.
+ *
+ * - Adaptive Gauss-Kronrod (G7/K15): the panel with the largest error
+ *   estimate is bisected until the total error meets the tolerance.
+ *   Exact for polynomials up to degree 22 on each panel and very fast on
+ *   smooth integrands.
+ * - Tanh-sinh (double exponential): used when the integrand is not
+ *   finite at an endpoint, e.g. 1/sqrt(X) or ln(X) from 0, and as the
+ *   fallback when Gauss-Kronrod runs out of budget. The nodes cluster
+ *   at the endpoints fast enough to absorb algebraic and logarithmic
+ *   singularities, and the endpoints themselves are never evaluated.
+ *
+ * Both stop at the configured function-evaluation budget, so the worst
+ * case run time is bounded by budget * (cost of one evaluation).
+ */
+
+#ifndef INTEGRATION_H
+#define INTEGRATION_H
+
+#include "expression_evaluator.h"
+
+#if defined(CONFIG_CALC_EVAL_FLOAT)
+#define INTEGRATION_DEFAULT_TOLERANCE   1e-5    // Single-precision integrand values
+#else
+#define INTEGRATION_DEFAULT_TOLERANCE   1e-10
+#endif
+#define INTEGRATION_DEFAULT_MAX_EVALS   4000
+#define INTEGRATION_MAX_PANELS          64      // Gauss-Kronrod panels kept at once
+
+/**
+ * @brief Quadrature rule that produced an integration result
+ */
+typedef enum {
+    INTEGRATION_GAUSS_KRONROD,
+    INTEGRATION_TANH_SINH
+} integration_method_t;
+
+/**
+ * @brief Integration settings
+ */
+typedef struct {
+    double tolerance;       // Target error, relative to the integral of |f|
+    int max_evaluations;    // Integrand evaluation budget
+} integration_config_t;
+
+/**
+ * @brief Integration result and cost
+ */
+typedef struct {
+    double value;                   // Integral estimate
+    double error_estimate;          // Estimated absolute error
+    int evaluations;                // Integrand evaluations spent
+    int subdivisions;               // Gauss-Kronrod panels or tanh-sinh levels
+    integration_method_t method;    // Rule the value comes from
+} integration_result_t;
+
+/**
+ * @brief Fill in the default tolerance and evaluation budget
+ * @param config Configuration to initialize
+ */
+void integration_config_default(integration_config_t *config);
+
+/**
+ * @brief Integrate a compiled integrand over [a, b]
+ *
+ * Reversed limits give the negated integral. Uses the static batch
+ * workspace of evaluate_rpn_batch() and is therefore not reentrant.
+ *
+ * @param integrand RPN program in the variable X
+ * @param context Evaluation context; variables.x is replaced by the nodes
+ * @param a Lower limit
+ * @param b Upper limit
+ * @param config Tolerance and budget, NULL for the defaults
+ * @param result Filled in on success and on ERR_NO_CONVERGENCE
+ * @return 0 on success, ERR_NO_CONVERGENCE with the best estimate in
+ *         result, or another negative error code if the integrand cannot
+ *         be evaluated on [a, b]
+ */
+int integrate_rpn(const rpn_queue_t *integrand, const eval_context_t *context,
+                  double a, double b, const integration_config_t *config,
+                  integration_result_t *result);
+
+/**
+ * @brief Compile an integrand expression and integrate it over [a, b]
+ * @param expression Integrand in the variable X
+ * @param context Evaluation context (variables, angle mode)
+ * @param a Lower limit
+ * @param b Upper limit
+ * @param config Tolerance and budget, NULL for the defaults
+ * @param result Filled in on success and on ERR_NO_CONVERGENCE; zeroed
+ *        when the expression does not parse
+ * @return 0 on success, negative error code on failure
+ */
+int integrate_expression(const char *expression, const eval_context_t *context,
+                         double a, double b, const integration_config_t *config,
+                         integration_result_t *result);
+
+#endif /* INTEGRATION_H */
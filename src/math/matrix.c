@@ -0,0 +1,327 @@
+/*
+ * Matrices Implementation
+ */
+
+#include "matrix.h"
+#include <math.h>
+#include <string.h>
+
+// The kernels take the size as an argument and are forced inline into a
+// switch over it, so the 2, 3 and 4 cases see a constant size. The
+// unroll pragma then flattens their loops even in a size-optimized
+// build, which would otherwise keep them rolled.
+#define MATRIX_KERNEL static inline __attribute__((always_inline))
+#define MATRIX_UNROLL _Pragma("GCC unroll 4")
+
+// Instantiate KERNEL(args..., size) for the specialized sizes
+#define MATRIX_DISPATCH(n, KERNEL, ...)                 \
+    switch (n) {                                        \
+        case 2: KERNEL(__VA_ARGS__, 2); break;          \
+        case 3: KERNEL(__VA_ARGS__, 3); break;          \
+        case 4: KERNEL(__VA_ARGS__, 4); break;          \
+        default: KERNEL(__VA_ARGS__, n); break;         \
+    }
+
+static const char *const names[MATRIX_COUNT] = {
+    "MatA", "MatB", "MatC", "MatD", "MatAns",
+};
+
+const char *matrix_name(matrix_name_t name)
+{
+    return (unsigned)name < MATRIX_COUNT ? names[name] : "Mat?";
+}
+
+int matrix_init(matrix_t *m, int rows, int cols)
+{
+    if (rows < 1 || rows > MATRIX_MAX_DIM || cols < 1 || cols > MATRIX_MAX_DIM) {
+        return ERR_DIMENSION;
+    }
+    m->rows = (uint8_t)rows;
+    m->cols = (uint8_t)cols;
+    memset(m->data, 0, sizeof(m->data));
+    return 0;
+}
+
+static bool all_finite(const double *data, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (!isfinite(data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int elementwise(const matrix_t *a, const matrix_t *b, matrix_t *out, double sign)
+{
+    if (a->rows == 0 || a->rows != b->rows || a->cols != b->cols) {
+        return ERR_DIMENSION;
+    }
+    int count = a->rows * a->cols;
+    for (int i = 0; i < count; i++) {
+        out->data[i] = a->data[i] + sign * b->data[i];
+    }
+    out->rows = a->rows;
+    out->cols = a->cols;
+    return all_finite(out->data, count) ? 0 : ERR_OVERFLOW;
+}
+
+int matrix_add(const matrix_t *a, const matrix_t *b, matrix_t *out)
+{
+    return elementwise(a, b, out, 1.0);
+}
+
+int matrix_subtract(const matrix_t *a, const matrix_t *b, matrix_t *out)
+{
+    return elementwise(a, b, out, -1.0);
+}
+
+// out (n x n) = a b, all packed with stride n
+MATRIX_KERNEL void multiply_square(const double *a, const double *b, double *out, int n)
+{
+    MATRIX_UNROLL
+    for (int i = 0; i < n; i++) {
+        MATRIX_UNROLL
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            MATRIX_UNROLL
+            for (int k = 0; k < n; k++) {
+                sum += a[i * n + k] * b[k * n + j];
+            }
+            out[i * n + j] = sum;
+        }
+    }
+}
+
+int matrix_multiply(const matrix_t *a, const matrix_t *b, matrix_t *out)
+{
+    if (a->rows == 0 || b->rows == 0 || a->cols != b->rows) {
+        return ERR_DIMENSION;
+    }
+    int rows = a->rows;
+    int inner = a->cols;
+    int cols = b->cols;
+    double product[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+
+    if (rows == inner && inner == cols) {
+        MATRIX_DISPATCH(rows, multiply_square, a->data, b->data, product);
+    } else {
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                double sum = 0.0;
+                for (int k = 0; k < inner; k++) {
+                    sum += a->data[i * inner + k] * b->data[k * cols + j];
+                }
+                product[i * cols + j] = sum;
+            }
+        }
+    }
+    memcpy(out->data, product, (size_t)(rows * cols) * sizeof(double));
+    out->rows = (uint8_t)rows;
+    out->cols = (uint8_t)cols;
+    return all_finite(out->data, rows * cols) ? 0 : ERR_OVERFLOW;
+}
+
+int matrix_transpose(const matrix_t *a, matrix_t *out)
+{
+    if (a->rows == 0) {
+        return ERR_DIMENSION;
+    }
+    int rows = a->rows;
+    int cols = a->cols;
+    double transposed[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            transposed[j * rows + i] = a->data[i * cols + j];
+        }
+    }
+    memcpy(out->data, transposed, (size_t)(rows * cols) * sizeof(double));
+    out->rows = (uint8_t)cols;
+    out->cols = (uint8_t)rows;
+    return 0;
+}
+
+// Doolittle LU of the packed n x n matrix a in place, choosing the
+// largest pivot in each column; returns the sign of the permutation
+MATRIX_KERNEL int lu_kernel(double *a, uint8_t *perm, int n)
+{
+    int sign = 1;
+
+    MATRIX_UNROLL
+    for (int i = 0; i < n; i++) {
+        perm[i] = (uint8_t)i;
+    }
+    MATRIX_UNROLL
+    for (int k = 0; k < n; k++) {
+        int pivot_row = k;
+        double largest = fabs(a[k * n + k]);
+        MATRIX_UNROLL
+        for (int i = k + 1; i < n; i++) {
+            double magnitude = fabs(a[i * n + k]);
+            if (magnitude > largest) {
+                largest = magnitude;
+                pivot_row = i;
+            }
+        }
+        if (pivot_row != k) {
+            MATRIX_UNROLL
+            for (int j = 0; j < n; j++) {
+                double t = a[k * n + j];
+                a[k * n + j] = a[pivot_row * n + j];
+                a[pivot_row * n + j] = t;
+            }
+            uint8_t t = perm[k];
+            perm[k] = perm[pivot_row];
+            perm[pivot_row] = t;
+            sign = -sign;
+        }
+        if (largest == 0.0) {
+            continue;   // Column already eliminated; U is singular
+        }
+        double reciprocal = 1.0 / a[k * n + k];
+        MATRIX_UNROLL
+        for (int i = k + 1; i < n; i++) {
+            double l = a[i * n + k] * reciprocal;
+            a[i * n + k] = l;
+            MATRIX_UNROLL
+            for (int j = k + 1; j < n; j++) {
+                a[i * n + j] -= l * a[k * n + j];
+            }
+        }
+    }
+    return sign;
+}
+
+int matrix_lu(const matrix_t *a, matrix_lu_t *lu)
+{
+    if (a->rows == 0 || a->rows != a->cols) {
+        return ERR_DIMENSION;
+    }
+    int n = a->rows;
+    int sign = 1;
+
+    lu->n = (uint8_t)n;
+    memcpy(lu->lu, a->data, (size_t)(n * n) * sizeof(double));
+    MATRIX_DISPATCH(n, sign = lu_kernel, lu->lu, lu->perm);
+    lu->sign = (int8_t)sign;
+    return 0;
+}
+
+void matrix_lu_solve(const matrix_lu_t *lu, const double *b, double *x)
+{
+    int n = lu->n;
+    double y[MATRIX_MAX_DIM];
+
+    for (int i = 0; i < n; i++) {
+        double sum = b[lu->perm[i]];
+        for (int j = 0; j < i; j++) {
+            sum -= lu->lu[i * n + j] * y[j];
+        }
+        y[i] = sum;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double sum = y[i];
+        for (int j = i + 1; j < n; j++) {
+            sum -= lu->lu[i * n + j] * y[j];
+        }
+        y[i] = sum / lu->lu[i * n + i];
+    }
+    memcpy(x, y, (size_t)n * sizeof(double));
+}
+
+MATRIX_KERNEL double pivot_product(const double *lu, int sign, int n)
+{
+    double det = sign;
+    MATRIX_UNROLL
+    for (int i = 0; i < n; i++) {
+        det *= lu[i * n + i];
+    }
+    // A zero pivot times a negative sign or pivot is -0, not a det to show
+    return det == 0.0 ? 0.0 : det;
+}
+
+int matrix_determinant(const matrix_t *a, double *det)
+{
+    matrix_lu_t lu;
+    int status = matrix_lu(a, &lu);
+    if (status != 0) {
+        return status;
+    }
+    double value = 0.0;
+    MATRIX_DISPATCH(lu.n, value = pivot_product, lu.lu, lu.sign);
+    *det = value;
+    return isfinite(value) ? 0 : ERR_OVERFLOW;
+}
+
+// Largest |element| of the packed n x n matrix
+static double max_magnitude(const double *data, int n)
+{
+    double largest = 0.0;
+    for (int i = 0; i < n * n; i++) {
+        double magnitude = fabs(data[i]);
+        if (magnitude > largest) {
+            largest = magnitude;
+        }
+    }
+    return largest;
+}
+
+// Column c of the inverse solves L U x = P e_c: forward substitution
+// with the unit lower triangle, then back substitution with U using the
+// pivot reciprocals
+MATRIX_KERNEL void inverse_kernel(const double *lu, const uint8_t *perm,
+                                  const double *reciprocal, double *out, int n)
+{
+    MATRIX_UNROLL
+    for (int c = 0; c < n; c++) {
+        double x[MATRIX_MAX_DIM];
+        MATRIX_UNROLL
+        for (int i = 0; i < n; i++) {
+            double sum = perm[i] == c ? 1.0 : 0.0;
+            MATRIX_UNROLL
+            for (int j = 0; j < i; j++) {
+                sum -= lu[i * n + j] * x[j];
+            }
+            x[i] = sum;
+        }
+        MATRIX_UNROLL
+        for (int i = n - 1; i >= 0; i--) {
+            double sum = x[i];
+            MATRIX_UNROLL
+            for (int j = i + 1; j < n; j++) {
+                sum -= lu[i * n + j] * x[j];
+            }
+            x[i] = sum * reciprocal[i];
+        }
+        MATRIX_UNROLL
+        for (int i = 0; i < n; i++) {
+            out[i * n + c] = x[i];
+        }
+    }
+}
+
+int matrix_inverse(const matrix_t *a, matrix_t *out)
+{
+    matrix_lu_t lu;
+    int status = matrix_lu(a, &lu);
+    if (status != 0) {
+        return status;
+    }
+    int n = lu.n;
+    double threshold = MATRIX_SINGULAR_EPS * max_magnitude(a->data, n);
+    double reciprocal[MATRIX_MAX_DIM];
+
+    for (int i = 0; i < n; i++) {
+        double pivot = lu.lu[i * n + i];
+        if (fabs(pivot) <= threshold) {
+            return ERR_DIVISION_BY_ZERO;
+        }
+        reciprocal[i] = 1.0 / pivot;
+    }
+    // a is no longer read, so out may alias it
+    MATRIX_DISPATCH(n, inverse_kernel, lu.lu, lu.perm, reciprocal, out->data);
+    out->rows = (uint8_t)n;
+    out->cols = (uint8_t)n;
+    return all_finite(out->data, n * n) ? 0 : ERR_OVERFLOW;
+}
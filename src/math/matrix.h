@@ -0,0 +1,157 @@
+/*
+ * Matrices
+ *
+ * Fixed-capacity matrices for MATRIX mode, up to MATRIX_MAX_DIM square.
+ * A matrix is a value: the dimensions and a packed row-major array, so
+ * element (i, j) is data[i * cols + j] and the whole matrix is one
+ * contiguous run of doubles whatever its shape. Nothing is allocated.
+ *
+ * Determinant and inverse come from an in-place LU factorization with
+ * partial pivoting, PA = LU. The kernels (LU, the triangular solves and
+ * the product) are written once with the size as a parameter and
+ * instantiated for 2x2, 3x3 and 4x4 with the size a constant, so the
+ * loops are unrolled and the indexing is fixed at compile time; other
+ * sizes run the same code with a run-time size. Addition is a single
+ * pass over the packed elements and needs no specialization.
+ *
+ * A pivot at or below MATRIX_SINGULAR_EPS times the largest element
+ * makes the matrix singular for the inverse; the determinant is still
+ * the product of the pivots.
+ */
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "expression_evaluator.h"
+
+#define MATRIX_MAX_DIM      6
+#define MATRIX_SINGULAR_EPS 1e-14   // Relative pivot size treated as zero
+
+/**
+ * @brief Named matrices of MATRIX mode
+ */
+typedef enum {
+    MATRIX_A,
+    MATRIX_B,
+    MATRIX_C,
+    MATRIX_D,
+    MATRIX_ANS,         // Result of the last matrix operation
+    MATRIX_COUNT
+} matrix_name_t;
+
+/**
+ * @brief Matrix; 0 rows means undefined
+ */
+typedef struct {
+    uint8_t rows;
+    uint8_t cols;
+    double data[MATRIX_MAX_DIM * MATRIX_MAX_DIM];   // Packed row-major
+} matrix_t;
+
+/**
+ * @brief LU factorization PA = LU of a square matrix
+ *
+ * L (unit diagonal, not stored) and U share the packed n x n array.
+ */
+typedef struct {
+    uint8_t n;
+    int8_t sign;                        // Sign of the permutation
+    uint8_t perm[MATRIX_MAX_DIM];       // Row i of PA is row perm[i] of A
+    double lu[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+} matrix_lu_t;
+
+static inline double matrix_get(const matrix_t *m, int i, int j)
+{
+    return m->data[i * m->cols + j];
+}
+
+static inline void matrix_set(matrix_t *m, int i, int j, double value)
+{
+    m->data[i * m->cols + j] = value;
+}
+
+/**
+ * @brief Display name of a named matrix
+ * @param name Matrix name
+ * @return "MatA" ... "MatD", "MatAns"
+ */
+const char *matrix_name(matrix_name_t name);
+
+/**
+ * @brief Set the dimensions and zero the elements
+ * @param m Matrix
+ * @param rows Rows, 1 to MATRIX_MAX_DIM
+ * @param cols Columns, 1 to MATRIX_MAX_DIM
+ * @return 0 on success, ERR_DIMENSION for a size out of range
+ */
+int matrix_init(matrix_t *m, int rows, int cols);
+
+/**
+ * @brief a + b
+ * @param a First operand
+ * @param b Second operand, same shape
+ * @param out Result (may alias an operand)
+ * @return 0 on success, ERR_DIMENSION if the shapes differ
+ */
+int matrix_add(const matrix_t *a, const matrix_t *b, matrix_t *out);
+
+/**
+ * @brief a - b
+ * @param a First operand
+ * @param b Second operand, same shape
+ * @param out Result (may alias an operand)
+ * @return 0 on success, ERR_DIMENSION if the shapes differ
+ */
+int matrix_subtract(const matrix_t *a, const matrix_t *b, matrix_t *out);
+
+/**
+ * @brief Matrix product a b
+ * @param a Left operand
+ * @param b Right operand with as many rows as a has columns
+ * @param out Result (may alias an operand)
+ * @return 0 on success, ERR_DIMENSION if the shapes do not chain
+ */
+int matrix_multiply(const matrix_t *a, const matrix_t *b, matrix_t *out);
+
+/**
+ * @brief Transpose
+ * @param a Matrix
+ * @param out Result (may alias a)
+ * @return 0 on success, ERR_DIMENSION if a is undefined
+ */
+int matrix_transpose(const matrix_t *a, matrix_t *out);
+
+/**
+ * @brief LU factorization with partial pivoting
+ * @param a Square matrix
+ * @param lu Output factorization
+ * @return 0 on success, ERR_DIMENSION if a is not square
+ */
+int matrix_lu(const matrix_t *a, matrix_lu_t *lu);
+
+/**
+ * @brief Solve A x = b from the LU factorization of A
+ * @param lu Factorization from matrix_lu(), with nonzero pivots
+ * @param b Right-hand side, lu->n values
+ * @param x Solution, lu->n values (may alias b)
+ */
+void matrix_lu_solve(const matrix_lu_t *lu, const double *b, double *x);
+
+/**
+ * @brief Determinant, the signed product of the LU pivots
+ * @param a Square matrix
+ * @param det Output determinant
+ * @return 0 on success, ERR_DIMENSION if a is not square, ERR_OVERFLOW
+ */
+int matrix_determinant(const matrix_t *a, double *det);
+
+/**
+ * @brief Inverse, by LU and one pair of triangular solves per column
+ * @param a Square matrix
+ * @param out Result (may alias a)
+ * @return 0 on success, ERR_DIMENSION if a is not square,
+ *         ERR_DIVISION_BY_ZERO if a is singular, ERR_OVERFLOW
+ */
+int matrix_inverse(const matrix_t *a, matrix_t *out);
+
+#endif /* MATRIX_H */
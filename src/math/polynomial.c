@@ -0,0 +1,430 @@
+/*
+ * Polynomial Equations Implementation
+ */
+
+#include "polynomial.h"
+#include <float.h>
+#include <math.h>
+
+#define PI              3.14159265358979323846
+#define SQRT3_2         0.86602540378443864676  // sqrt(3) / 2
+#define NEWTON_STEPS    2                       // Polishing steps per cubic root
+
+// Horner's rule at z: p(z), p'(z) and sum |a_k| |z|^k for the error bound
+typedef struct {
+    complex_t value;
+    complex_t slope;
+    double magnitude;
+} poly_eval_t;
+
+static complex_t real(double x)
+{
+    return (complex_t){ x, 0.0 };
+}
+
+static complex_t add(complex_t a, complex_t b)
+{
+    return (complex_t){ a.re + b.re, a.im + b.im };
+}
+
+static complex_t sub(complex_t a, complex_t b)
+{
+    return (complex_t){ a.re - b.re, a.im - b.im };
+}
+
+// complex_multiply() inlined for the Horner and Aberth inner loops
+static inline complex_t multiply(complex_t a, complex_t b)
+{
+    return (complex_t){ a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+}
+
+// a[0] is the leading coefficient
+static void evaluate(const double *a, int n, complex_t z, poly_eval_t *out)
+{
+    complex_t value = real(a[0]), slope = real(0.0);
+    double abs_z = complex_abs(z), magnitude = fabs(a[0]);
+
+    for (int k = 1; k <= n; k++) {
+        slope = add(multiply(slope, z), value);
+        value = multiply(value, z);
+        value.re += a[k];
+        magnitude = magnitude * abs_z + fabs(a[k]);
+    }
+    out->value = value;
+    out->slope = slope;
+    out->magnitude = magnitude;
+}
+
+// Whether |p(z)| is within the rounding error of evaluating it
+static bool within_rounding(const poly_eval_t *e, int n)
+{
+    return complex_abs(e->value) <= 4.0 * n * DBL_EPSILON * e->magnitude;
+}
+
+// Scale by a power of two so the largest coefficient is in [0.5, 1)
+static int scale(const double *coeffs, int n, double *a)
+{
+    double largest = 0.0;
+    int exponent;
+
+    for (int k = 0; k <= n; k++) {
+        if (!isfinite(coeffs[k])) {
+            return ERR_OVERFLOW;
+        }
+        largest = fmax(largest, fabs(coeffs[k]));
+    }
+    frexp(largest, &exponent);
+    for (int k = 0; k <= n; k++) {
+        a[k] = ldexp(coeffs[k], -exponent);
+    }
+    return 0;
+}
+
+int poly_quadratic(double a, double b, double c, complex_t roots[2])
+{
+    const double in[3] = { a, b, c };
+    double s[3];
+
+    if (a == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+    int status = scale(in, 2, s);
+    if (status != 0) {
+        return status;
+    }
+    a = s[0];
+    b = s[1];
+    c = s[2];
+
+    // b^2 - 4ac, with the rounding error of both products added back
+    double bb = b * b, ac4 = 4.0 * a * c;
+    double disc = (bb - ac4) + (fma(b, b, -bb) - fma(4.0 * a, c, -ac4));
+
+    if (disc < 0.0) {
+        double re = -b / (2.0 * a);
+        double im = sqrt(-disc) / (2.0 * fabs(a));
+        roots[0] = (complex_t){ re, -im };
+        roots[1] = (complex_t){ re, im };
+        return 0;
+    }
+
+    double q = -0.5 * (b + copysign(sqrt(disc), b));
+    if (q == 0.0) {
+        // b and c are both 0
+        roots[0] = roots[1] = real(0.0);
+        return 0;
+    }
+    double x1 = q / a, x2 = c / q;
+    roots[0] = real(fmin(x1, x2));
+    roots[1] = real(fmax(x1, x2));
+    return 0;
+}
+
+// Newton steps on the original polynomial, kept while the residual falls
+static complex_t polish(const double *a, int n, complex_t z)
+{
+    poly_eval_t e;
+    evaluate(a, n, z, &e);
+
+    for (int step = 0; step < NEWTON_STEPS && !within_rounding(&e, n); step++) {
+        complex_t delta, next;
+        poly_eval_t next_e;
+        if (complex_divide(e.value, e.slope, &delta) != 0) {
+            break;
+        }
+        next = sub(z, delta);
+        evaluate(a, n, next, &next_e);
+        if (complex_abs(next_e.value) >= complex_abs(e.value)) {
+            break;
+        }
+        z = next;
+        e = next_e;
+    }
+    return z;
+}
+
+int poly_cubic(double a, double b, double c, double d, complex_t roots[3])
+{
+    const double in[4] = { a, b, c, d };
+    double s[4];
+
+    if (a == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+    int status = scale(in, 3, s);
+    if (status != 0) {
+        return status;
+    }
+
+    // x^3 + Ax^2 + Bx + C
+    double A = s[1] / s[0], B = s[2] / s[0], C = s[3] / s[0];
+    double Q = (A * A - 3.0 * B) / 9.0;
+    double R = (A * (2.0 * A * A - 9.0 * B) + 27.0 * C) / 54.0;
+    double R2 = R * R, Q3 = Q * Q * Q;
+    double shift = A / 3.0;
+
+    if (!isfinite(R2) || !isfinite(Q3)) {
+        return ERR_OVERFLOW;
+    }
+
+    // One real root from the closed form: the largest of three, or the
+    // only one. The others follow from it by deflation, which is stable
+    // where the closed form is not (a tiny leading coefficient leaves
+    // the small roots to cancellation).
+    double r;
+    if (C == 0.0) {
+        r = 0.0;
+    } else if (R2 < Q3) {
+        // Three real roots; the largest is the one of the same sign as -R
+        double cosine = R / sqrt(Q3);
+        double theta = acos(cosine > 1.0 ? 1.0 : (cosine < -1.0 ? -1.0 : cosine));
+        r = -2.0 * sqrt(Q) * cos(theta / 3.0) - shift;
+        for (int k = 1; k < 3; k++) {
+            double x = -2.0 * sqrt(Q) * cos((theta + (k == 1 ? 2.0 : -2.0) * PI) / 3.0) - shift;
+            r = fabs(x) > fabs(r) ? x : r;
+        }
+    } else {
+        // The cube root takes the sign opposite to R so |R| + sqrt(R^2 - Q^3)
+        // adds magnitudes
+        double S = -copysign(cbrt(fabs(R) + sqrt(R2 - Q3)), R);
+        double T = S == 0.0 ? 0.0 : Q / S;
+        r = S + T - shift;
+    }
+    if (r != 0.0) {
+        r = polish(s, 3, real(r)).re;
+    }
+
+    // x^2 + px + q = (x^3 + Ax^2 + Bx + C) / (x - r), from the constant
+    // end when r is the larger root and from the leading end otherwise
+    double p, q;
+    if (r != 0.0 && fabs(r) * r * r >= fabs(C)) {
+        q = -C / r;
+        p = (q - B) / r;
+    } else {
+        p = A + r;
+        q = B + r * p;
+    }
+    status = poly_quadratic(1.0, p, q, &roots[1]);
+    if (status != 0) {
+        return status;
+    }
+    roots[0] = real(r);
+
+    for (int k = 1; k < 3; k++) {
+        bool is_real = roots[k].im == 0.0;
+        roots[k] = polish(s, 3, roots[k]);
+        if (is_real) {
+            roots[k].im = 0.0;
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        if (!isfinite(roots[k].re) || !isfinite(roots[k].im)) {
+            return ERR_OVERFLOW;
+        }
+    }
+    return 0;
+}
+
+// Starting points on circles from the Newton polygon: the upper convex
+// hull of (k, log|a_k|) over the coefficients of x^k. A hull edge from k
+// to l holds l - k roots of magnitude near (|a_k| / |a_l|)^(1 / (l - k)),
+// so roots many decades apart each start near their own size.
+static void starting_points(const double *a, int n, complex_t *z)
+{
+    int hull[POLY_MAX_DEGREE + 1];
+    int count = 0;
+
+    for (int k = 0; k <= n; k++) {
+        if (a[n - k] == 0.0) {
+            continue;
+        }
+        // Pop the last vertex while it lies on or under the new edge
+        while (count >= 2) {
+            int i = hull[count - 2], j = hull[count - 1];
+            double li = log(fabs(a[n - i])), lj = log(fabs(a[n - j])), lk = log(fabs(a[n - k]));
+            if ((lj - li) * (k - i) > (lk - li) * (j - i)) {
+                break;
+            }
+            count--;
+        }
+        hull[count++] = k;
+    }
+
+    int m = 0;
+    for (int h = 0; h + 1 < count; h++) {
+        int k = hull[h], l = hull[h + 1];
+        double radius = pow(fabs(a[n - k] / a[n - l]), 1.0 / (l - k));
+        // Turned off the real axis so no start is its own conjugate
+        for (int i = 0; i < l - k; i++, m++) {
+            double angle = 2.0 * PI * i / (l - k) + 2.0 * PI * h / n + 0.4;
+            z[m] = (complex_t){ radius * cos(angle), radius * sin(angle) };
+        }
+    }
+}
+
+// Aberth-Ehrlich iteration for all n roots of a, whose constant term is
+// nonzero
+static int aberth(const double *a, int n, complex_t *z, int *iterations)
+{
+    bool done[POLY_MAX_DEGREE] = { false };
+
+    starting_points(a, n, z);
+
+    for (int it = 1; it <= POLY_MAX_ITERATIONS; it++) {
+        int active = 0;
+
+        for (int i = 0; i < n; i++) {
+            poly_eval_t e;
+            complex_t ratio, sum = real(0.0), w;
+
+            if (done[i]) {
+                continue;
+            }
+            evaluate(a, n, z[i], &e);
+            if (!isfinite(e.magnitude)) {
+                // A root near the top of the double range
+                return ERR_OVERFLOW;
+            }
+            if (within_rounding(&e, n)) {
+                done[i] = true;
+                continue;
+            }
+            if (complex_divide(e.value, e.slope, &ratio) != 0) {
+                // Stationary point: nudge the start and try again
+                z[i] = complex_multiply(z[i], (complex_t){ 1.0, 1e-3 });
+                active++;
+                continue;
+            }
+
+            // w = ratio / (1 - ratio * sum over j != i of 1 / (z_i - z_j)).
+            // |z_i - z_j|^2 cannot overflow, since |z|^n is finite for n >= 4
+            for (int j = 0; j < n; j++) {
+                complex_t d = sub(z[i], z[j]);
+                double norm = d.re * d.re + d.im * d.im;
+                if (j != i && norm >= DBL_MIN) {
+                    sum.re += d.re / norm;
+                    sum.im -= d.im / norm;
+                }
+            }
+            complex_t denominator = sub(real(1.0), multiply(ratio, sum));
+            if (complex_divide(ratio, denominator, &w) != 0) {
+                w = ratio;
+            }
+            z[i] = sub(z[i], w);
+
+            if (!isfinite(z[i].re) || !isfinite(z[i].im)) {
+                return ERR_OVERFLOW;
+            }
+            if (complex_abs(w) <= DBL_EPSILON * complex_abs(z[i])) {
+                done[i] = true;
+            } else {
+                active++;
+            }
+        }
+
+        if (active == 0) {
+            *iterations = it;
+            return 0;
+        }
+    }
+    *iterations = POLY_MAX_ITERATIONS;
+    return ERR_NO_CONVERGENCE;
+}
+
+// A root whose real part is a root to within rounding is real
+static void clean_real_roots(const double *a, int n, complex_t *z)
+{
+    for (int i = 0; i < n; i++) {
+        poly_eval_t e;
+        if (z[i].im == 0.0) {
+            continue;
+        }
+        evaluate(a, n, real(z[i].re), &e);
+        if (within_rounding(&e, n)) {
+            z[i].im = 0.0;
+        }
+    }
+}
+
+// Real roots first, then by real part, +i before -i
+static bool comes_before(complex_t x, complex_t y)
+{
+    if ((x.im == 0.0) != (y.im == 0.0)) {
+        return x.im == 0.0;
+    }
+    if (x.re != y.re) {
+        return x.re < y.re;
+    }
+    return x.im > y.im;
+}
+
+static void sort_roots(complex_t *z, int n)
+{
+    for (int i = 1; i < n; i++) {
+        complex_t key = z[i];
+        int j = i - 1;
+        while (j >= 0 && comes_before(key, z[j])) {
+            z[j + 1] = z[j];
+            j--;
+        }
+        z[j + 1] = key;
+    }
+}
+
+int poly_solve(const double *coeffs, int degree, poly_roots_t *out)
+{
+    double a[POLY_MAX_DEGREE + 1];
+    int n = degree;
+    int status;
+
+    if (degree < POLY_MIN_DEGREE || degree > POLY_MAX_DEGREE) {
+        return ERR_DIMENSION;
+    }
+    if (coeffs[0] == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+    if ((status = scale(coeffs, n, a)) != 0) {
+        return status;
+    }
+    out->degree = (uint8_t)degree;
+    out->iterations = 0;
+
+    // Zero roots are exact; the rest is the polynomial divided by x^k
+    while (n > 0 && a[n] == 0.0) {
+        out->roots[--n] = real(0.0);
+    }
+
+    switch (n) {
+        case 0:
+            break;
+        case 1:
+            out->roots[0] = real(-a[1] / a[0]);
+            break;
+        case 2:
+            status = poly_quadratic(a[0], a[1], a[2], out->roots);
+            break;
+        case 3:
+            status = poly_cubic(a[0], a[1], a[2], a[3], out->roots);
+            if (status == ERR_OVERFLOW) {
+                status = aberth(a, n, out->roots, &out->iterations);
+            }
+            break;
+        default:
+            status = aberth(a, n, out->roots, &out->iterations);
+            break;
+    }
+    if (status != 0) {
+        return status;
+    }
+
+    if (out->iterations > 0) {
+        clean_real_roots(a, n, out->roots);
+    }
+    for (int i = 0; i < degree; i++) {
+        // -0 (from -b / 2a with b = 0) shows as "-0"; adding 0 clears the sign
+        out->roots[i].re += 0.0;
+        out->roots[i].im += 0.0;
+    }
+    sort_roots(out->roots, degree);
+    return 0;
+}
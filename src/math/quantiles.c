@@ -0,0 +1,311 @@
+/*
+ * Quantiles Implementation
+ */
+
+#include "quantiles.h"
+#include <math.h>
+
+#define INSERTION_SORT_MAX 16   // Ranges this short are finished by insertion sort
+
+// Marker i tracks quantile i/8; markers 2, 4 and 6 are Q1, median and Q3
+static const double marker_fraction[QUANTILE_MARKERS] = {
+    0.0, 0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875, 1.0
+};
+
+void quantile_reset(quantile_state_t *state)
+{
+    state->mode = QUANTILE_EXACT;
+    state->count = 0;
+}
+
+static void swap(double *a, double *b)
+{
+    double t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void insertion_sort(double *a, int n)
+{
+    for (int i = 1; i < n; i++) {
+        double v = a[i];
+        int j = i;
+        for (; j > 0 && a[j - 1] > v; j--) {
+            a[j] = a[j - 1];
+        }
+        a[j] = v;
+    }
+}
+
+static void sift_down(double *a, int root, int n)
+{
+    for (int child = 2 * root + 1; child < n; root = child, child = 2 * root + 1) {
+        if (child + 1 < n && a[child + 1] > a[child]) {
+            child++;
+        }
+        if (a[root] >= a[child]) {
+            return;
+        }
+        swap(&a[root], &a[child]);
+    }
+}
+
+static void heap_sort(double *a, int n)
+{
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        sift_down(a, i, n);
+    }
+    for (int i = n - 1; i > 0; i--) {
+        swap(&a[0], &a[i]);
+        sift_down(a, 0, i);
+    }
+}
+
+// Put the k-th smallest of a[lo, hi) at a[k], smaller ones before it and
+// larger ones after it
+static void introselect(double *a, int lo, int hi, int k)
+{
+    int depth = 0;
+    for (int n = hi - lo; n > 1; n >>= 1) {
+        depth += 2;
+    }
+
+    while (hi - lo > INSERTION_SORT_MAX) {
+        if (depth-- == 0) {
+            // Partitioning is going quadratic; bound the rest by n log n
+            heap_sort(a + lo, hi - lo);
+            return;
+        }
+
+        // Median of three, which also sentinels both scans
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < a[lo]) swap(&a[mid], &a[lo]);
+        if (a[hi - 1] < a[lo]) swap(&a[hi - 1], &a[lo]);
+        if (a[hi - 1] < a[mid]) swap(&a[hi - 1], &a[mid]);
+        double pivot = a[mid];
+
+        // Hoare partition: afterwards a[lo..j] <= pivot <= a[i..hi-1] and
+        // everything strictly between j and i equals the pivot
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (a[i] < pivot) i++;
+            while (a[j] > pivot) j--;
+            if (i <= j) {
+                swap(&a[i++], &a[j--]);
+            }
+        }
+
+        if (k <= j) {
+            hi = j + 1;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            return;
+        }
+    }
+    insertion_sort(a + lo, hi - lo);
+}
+
+// Switch a full column to P² markers at the exact order statistics
+static void start_streaming(quantile_state_t *state)
+{
+    double height[QUANTILE_MARKERS];
+    double position[QUANTILE_MARKERS];
+    const int n = (int)state->count;
+    int lo = 0;
+
+    for (int i = 0; i < QUANTILE_MARKERS; i++) {
+        int k = (int)lround(marker_fraction[i] * (n - 1));
+        introselect(state->data.column, lo, n, k);
+        height[i] = state->data.column[k];
+        position[i] = k;
+        lo = k + 1;
+    }
+
+    for (int i = 0; i < QUANTILE_MARKERS; i++) {
+        state->data.markers.height[i] = height[i];
+        state->data.markers.position[i] = position[i];
+    }
+    state->mode = QUANTILE_STREAMING;
+}
+
+// One P² step: place x among the markers, then move each inner marker
+// that is a whole rank or more from where it should be by one rank,
+// interpolating its height with a parabola through its neighbours
+static void markers_add(quantile_state_t *state, double x)
+{
+    double *h = state->data.markers.height;
+    double *pos = state->data.markers.position;
+    const int last = QUANTILE_MARKERS - 1;
+    int k;
+
+    if (x < h[0]) {
+        h[0] = x;
+        k = 0;
+    } else if (x >= h[last]) {
+        h[last] = x;
+        k = last - 1;
+    } else {
+        for (k = 0; x >= h[k + 1]; k++) {
+        }
+    }
+    for (int i = k + 1; i <= last; i++) {
+        pos[i] += 1.0;
+    }
+    state->count++;
+
+    for (int i = 1; i < last; i++) {
+        double d = marker_fraction[i] * (state->count - 1) - pos[i];
+        if ((d >= 1.0 && pos[i + 1] - pos[i] > 1.0) || (d <= -1.0 && pos[i - 1] - pos[i] < -1.0)) {
+            int s = d > 0.0 ? 1 : -1;
+            double parabolic = h[i] + s / (pos[i + 1] - pos[i - 1]) *
+                ((pos[i] - pos[i - 1] + s) * (h[i + 1] - h[i]) / (pos[i + 1] - pos[i]) +
+                 (pos[i + 1] - pos[i] - s) * (h[i] - h[i - 1]) / (pos[i] - pos[i - 1]));
+            if (h[i - 1] < parabolic && parabolic < h[i + 1]) {
+                h[i] = parabolic;
+            } else {
+                h[i] += s * (h[i + s] - h[i]) / (pos[i + s] - pos[i]);
+            }
+            pos[i] += s;
+        }
+    }
+}
+
+static void add_one(quantile_state_t *state, double x)
+{
+    if (state->mode == QUANTILE_EXACT) {
+        if (state->count < QUANTILE_EXACT_CAPACITY) {
+            state->data.column[state->count++] = x;
+            return;
+        }
+        start_streaming(state);
+    }
+    markers_add(state, x);
+}
+
+// Integer frequency that can be replayed one sample at a time, else 0
+static int repeat_count(double freq)
+{
+    return freq == floor(freq) && freq <= QUANTILE_MAX_FREQUENCY ? (int)freq : 0;
+}
+
+void quantile_add(quantile_state_t *state, double x, double freq)
+{
+    int repeat = repeat_count(freq);
+
+    if (state->mode == QUANTILE_UNAVAILABLE) {
+        return;
+    }
+    if (repeat == 0) {
+        state->mode = QUANTILE_UNAVAILABLE;
+        return;
+    }
+    while (repeat-- > 0) {
+        add_one(state, x);
+    }
+}
+
+void quantile_remove(quantile_state_t *state, double x, double freq)
+{
+    int repeat = repeat_count(freq);
+
+    if (state->mode != QUANTILE_EXACT || repeat == 0) {
+        state->mode = QUANTILE_UNAVAILABLE;
+        return;
+    }
+
+    // Order in the column does not matter: swap in the last sample
+    for (int i = 0; i < (int)state->count && repeat > 0; ) {
+        if (state->data.column[i] == x) {
+            state->data.column[i] = state->data.column[--state->count];
+            repeat--;
+        } else {
+            i++;
+        }
+    }
+}
+
+// Median of the sorted block a[lo, lo + n), whose order statistics have
+// already been put in place
+static double block_median(const double *a, int lo, int n)
+{
+    int mid = lo + n / 2;
+    return n % 2 != 0 ? a[mid] : 0.5 * (a[mid - 1] + a[mid]);
+}
+
+int quantile_get(quantile_state_t *state, quantile_summary_t *summary)
+{
+    const int n = (int)state->count;
+
+    if (n == 0 || state->mode == QUANTILE_UNAVAILABLE) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    if (state->mode == QUANTILE_STREAMING) {
+        const double *h = state->data.markers.height;
+        *summary = (quantile_summary_t){
+            .min = h[0], .q1 = h[2], .median = h[4], .q3 = h[6],
+            .max = h[QUANTILE_MARKERS - 1], .exact = false
+        };
+        return 0;
+    }
+
+    // Ranks needed, ascending: min, the halves' middles, the median's, max.
+    // Each selection only searches above the previous one.
+    double *a = state->data.column;
+    const int half = n / 2;
+    int ranks[8];
+    int count = 0;
+
+    ranks[count++] = 0;
+    if (half > 0) {
+        ranks[count++] = (half - 1) / 2;
+        ranks[count++] = half / 2;
+    }
+    ranks[count++] = (n - 1) / 2;
+    ranks[count++] = n / 2;
+    if (half > 0) {
+        ranks[count++] = n - half + (half - 1) / 2;
+        ranks[count++] = n - half + half / 2;
+    }
+    ranks[count++] = n - 1;
+
+    int lo = 0;
+    for (int i = 0; i < count; i++) {
+        if (ranks[i] >= lo) {
+            introselect(a, lo, n, ranks[i]);
+            lo = ranks[i] + 1;
+        }
+    }
+
+    summary->min = a[0];
+    summary->max = a[n - 1];
+    summary->median = block_median(a, 0, n);
+    summary->q1 = half > 0 ? block_median(a, 0, half) : summary->median;
+    summary->q3 = half > 0 ? block_median(a, n - half, half) : summary->median;
+    summary->exact = true;
+    return 0;
+}
+
+int quantile_extremes(const quantile_state_t *state, double *min, double *max)
+{
+    const int n = (int)state->count;
+
+    if (n == 0 || state->mode == QUANTILE_UNAVAILABLE) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    if (state->mode == QUANTILE_STREAMING) {
+        *min = state->data.markers.height[0];
+        *max = state->data.markers.height[QUANTILE_MARKERS - 1];
+        return 0;
+    }
+
+    const double *a = state->data.column;
+    *min = *max = a[0];
+    for (int i = 1; i < n; i++) {
+        *min = fmin(*min, a[i]);
+        *max = fmax(*max, a[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Quantiles
+ *
+ * Median, quartiles and the five-number summary of STAT x data without
+ * sorting it.
+ *
+ * - Exact, up to QUANTILE_EXACT_CAPACITY samples: the samples are kept in
+ *   a column and the order statistics are found with introselect
+ *   (quickselect with a median-of-three pivot, falling back to heapsort
+ *   if partitioning goes quadratic), in place and in expected O(n). The
+ *   quartiles follow the calculator's definition: Q1 and Q3 are the
+ *   medians of the lower and upper halves, excluding the median itself
+ *   for odd n.
+ * - Streaming, beyond that: the column is turned into the markers of an
+ *   extended P² estimator (Jain & Chlamtac, with Raatikainen's markers
+ *   for several quantiles) at 0, 1/8, 1/4, ..., 1, and every further
+ *   sample is O(1) in a fixed 144 bytes. Min and max stay exact. P² has
+ *   no worst-case guarantee; on the host benchmark (uniform, normal,
+ *   exponential, sorted and reverse-sorted streams of 10^5 samples) the
+ *   rank error of Q1, median and Q3 stays below 0.05% of n, and the
+ *   value error below 0.1% of the interquartile range.
+ *
+ * Removal is exact in the column. Once streaming, samples cannot be taken
+ * back out of the markers, so a removal makes the quantiles unavailable
+ * until the data is cleared; so does a non-integer frequency.
+ */
+
+#ifndef QUANTILES_H
+#define QUANTILES_H
+
+#include "expression_evaluator.h"
+
+#define QUANTILE_EXACT_CAPACITY 256     // Samples kept for exact selection
+#define QUANTILE_MARKERS        9       // P² markers at 0, 1/8, ..., 1
+#define QUANTILE_MAX_FREQUENCY  1000    // Larger frequencies are not replayed
+
+/**
+ * @brief How quantiles are currently computed
+ */
+typedef enum {
+    QUANTILE_EXACT,         // Samples in the column; zeroed state is empty exact
+    QUANTILE_STREAMING,     // P² markers
+    QUANTILE_UNAVAILABLE    // Removal while streaming, or unusable frequency
+} quantile_mode_t;
+
+/**
+ * @brief Quantile state; the column and the markers share storage
+ */
+typedef struct {
+    quantile_mode_t mode;
+    uint32_t count;                                 // Samples held or streamed
+    union {
+        double column[QUANTILE_EXACT_CAPACITY];
+        struct {
+            double height[QUANTILE_MARKERS];        // Marker values
+            double position[QUANTILE_MARKERS];      // Marker ranks, 0 to count - 1
+        } markers;
+    } data;
+} quantile_state_t;
+
+/**
+ * @brief Five-number summary
+ */
+typedef struct {
+    double min;
+    double q1;
+    double median;
+    double q3;
+    double max;
+    bool exact;             // False for P² estimates
+} quantile_summary_t;
+
+/**
+ * @brief Clear the samples
+ * @param state Quantile state
+ */
+void quantile_reset(quantile_state_t *state);
+
+/**
+ * @brief Add a sample; integer frequencies are added as repeated samples
+ * @param state Quantile state
+ * @param x Finite sample value
+ * @param freq Frequency, > 0
+ */
+void quantile_add(quantile_state_t *state, double x, double freq);
+
+/**
+ * @brief Remove a sample added earlier
+ * @param state Quantile state
+ * @param x Sample value
+ * @param freq Frequency, > 0
+ */
+void quantile_remove(quantile_state_t *state, double x, double freq);
+
+/**
+ * @brief Compute the five-number summary
+ *
+ * In exact mode this partially reorders the column.
+ *
+ * @param state Quantile state
+ * @param summary Output min, quartiles and max
+ * @return 0 on success, ERR_DOMAIN_ERROR with no samples or when the
+ *         quantiles are unavailable
+ */
+int quantile_get(quantile_state_t *state, quantile_summary_t *summary);
+
+/**
+ * @brief Smallest and largest sample, without reordering the column
+ * @param state Quantile state
+ * @param min Output minimum
+ * @param max Output maximum
+ * @return 0 on success, ERR_DOMAIN_ERROR with no samples or when the
+ *         quantiles are unavailable
+ */
+int quantile_extremes(const quantile_state_t *state, double *min, double *max);
+
+#endif /* QUANTILES_H */
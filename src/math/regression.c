@@ -0,0 +1,279 @@
+/*
+ * Regression Implementation
+ */
+
+#include "regression.h"
+#include <math.h>
+
+static const char *const model_names[REG_MODEL_COUNT] = {
+    "Linear", "Quad", "Log", "e^Exp", "ab^Exp", "Power", "Inverse"
+};
+
+void regression_reset(regression_sums_t *sums)
+{
+    *sums = (regression_sums_t){0};
+}
+
+// Transformed variables of one sample; 0 stands in outside a domain, the
+// models that would read it being unavailable until it is removed again
+static void transform(const regression_sums_t *sums, double x, double y, double z[REG_VAR_COUNT])
+{
+    double u = x - sums->x0;
+
+    z[REG_VAR_U] = u;
+    z[REG_VAR_U2] = u * u;
+    z[REG_VAR_LN_X] = x > 0.0 ? log(x) : 0.0;
+    z[REG_VAR_INV_X] = x != 0.0 ? 1.0 / x : 0.0;
+    z[REG_VAR_Y] = y;
+    z[REG_VAR_LN_Y] = y > 0.0 ? log(y) : 0.0;
+}
+
+static void count_outside(regression_sums_t *sums, double x, double y, double freq)
+{
+    sums->outside_ln_x += x <= 0.0 ? freq : 0.0;
+    sums->outside_inv_x += x == 0.0 ? freq : 0.0;
+    sums->outside_ln_y += y <= 0.0 ? freq : 0.0;
+}
+
+// Weighted Welford step for every variable and pair at once; a negative
+// weight runs it backwards
+static void update(regression_sums_t *sums, const double z[REG_VAR_COUNT], double weight)
+{
+    double delta[REG_VAR_COUNT];
+
+    sums->n += weight;
+    for (int i = 0; i < REG_VAR_COUNT; i++) {
+        delta[i] = z[i] - sums->shift[i] - sums->mean[i];
+        sums->mean[i] += weight * delta[i] / sums->n;
+    }
+    for (int i = 0; i < REG_VAR_COUNT; i++) {
+        for (int j = i; j < REG_VAR_COUNT; j++) {
+            sums->comoment[i][j] += weight * delta[i] * (z[j] - sums->shift[j] - sums->mean[j]);
+        }
+    }
+}
+
+void regression_add(regression_sums_t *sums, double x, double y, double freq)
+{
+    double z[REG_VAR_COUNT];
+
+    if (sums->n == 0.0) {
+        sums->x0 = x;
+    }
+    transform(sums, x, y, z);
+    if (sums->n == 0.0) {
+        for (int i = 0; i < REG_VAR_COUNT; i++) {
+            sums->shift[i] = z[i];
+        }
+    }
+
+    count_outside(sums, x, y, freq);
+    update(sums, z, freq);
+}
+
+void regression_remove(regression_sums_t *sums, double x, double y, double freq)
+{
+    double z[REG_VAR_COUNT];
+
+    if (freq >= sums->n) {
+        regression_reset(sums);
+        return;
+    }
+
+    transform(sums, x, y, z);
+    count_outside(sums, x, y, -freq);
+    update(sums, z, -freq);
+    for (int i = 0; i < REG_VAR_COUNT; i++) {
+        sums->comoment[i][i] = fmax(sums->comoment[i][i], 0.0);
+    }
+}
+
+static double comoment(const regression_sums_t *sums, regression_var_t a, regression_var_t b)
+{
+    return a <= b ? sums->comoment[a][b] : sums->comoment[b][a];
+}
+
+static double mean(const regression_sums_t *sums, regression_var_t var)
+{
+    return sums->shift[var] + sums->mean[var];
+}
+
+// Least-squares line of v on u from the co-moments
+static int fit_line(const regression_sums_t *sums, regression_var_t u, regression_var_t v,
+                    regression_fit_t *fit)
+{
+    double suu = comoment(sums, u, u);
+    double svv = comoment(sums, v, v);
+    double suv = comoment(sums, u, v);
+
+    // Equal x transforms agree exactly after the shift, so suu is exactly
+    // 0 when there is only one distinct x
+    if (sums->n < 2.0 || suu <= 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    fit->mean_u = mean(sums, u);
+    fit->mean_v = mean(sums, v);
+    fit->slope = suv / suu;
+    fit->r = svv > 0.0 ? fmax(-1.0, fmin(1.0, suv / sqrt(suu * svv))) : NAN;
+    return 0;
+}
+
+// y = a + b*u + c*u^2 in u = x - x0, from the 2x2 normal equations
+static int fit_quadratic(const regression_sums_t *sums, regression_fit_t *fit)
+{
+    double suu = comoment(sums, REG_VAR_U, REG_VAR_U);
+    double suq = comoment(sums, REG_VAR_U, REG_VAR_U2);
+    double sqq = comoment(sums, REG_VAR_U2, REG_VAR_U2);
+    double suy = comoment(sums, REG_VAR_U, REG_VAR_Y);
+    double sqy = comoment(sums, REG_VAR_U2, REG_VAR_Y);
+    double det = suu * sqq - suq * suq;
+
+    // Fewer than three distinct x leave u and u^2 collinear up to rounding
+    if (sums->n < 3.0 || !(det > 1e-12 * suu * sqq)) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    fit->x0 = sums->x0;
+    fit->mean_u = mean(sums, REG_VAR_U);
+    fit->mean_u2 = mean(sums, REG_VAR_U2);
+    fit->mean_v = mean(sums, REG_VAR_Y);
+    fit->slope = (sqq * suy - suq * sqy) / det;
+    fit->slope2 = (suu * sqy - suq * suy) / det;
+
+    // Back from u to x for the displayed coefficients
+    double a = fit->mean_v - fit->slope * fit->mean_u - fit->slope2 * fit->mean_u2;
+    fit->c = fit->slope2;
+    fit->b = fit->slope - 2.0 * fit->slope2 * fit->x0;
+    fit->a = a - fit->slope * fit->x0 + fit->slope2 * fit->x0 * fit->x0;
+    fit->r = NAN;
+    return 0;
+}
+
+int regression_fit(const regression_sums_t *sums, regression_model_t model,
+                   regression_fit_t *fit)
+{
+    *fit = (regression_fit_t){ .model = model };
+
+    bool needs_ln_x = model == REG_LOG || model == REG_POWER;
+    bool needs_inv_x = model == REG_INVERSE;
+    bool needs_ln_y = model == REG_EXP || model == REG_AB_EXP || model == REG_POWER;
+    if ((needs_ln_x && sums->outside_ln_x > 0.0) ||
+        (needs_inv_x && sums->outside_inv_x > 0.0) ||
+        (needs_ln_y && sums->outside_ln_y > 0.0)) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    if (model == REG_QUADRATIC) {
+        return fit_quadratic(sums, fit);
+    }
+
+    regression_var_t u = needs_ln_x ? REG_VAR_LN_X : needs_inv_x ? REG_VAR_INV_X : REG_VAR_U;
+    regression_var_t v = needs_ln_y ? REG_VAR_LN_Y : REG_VAR_Y;
+    int status = fit_line(sums, u, v, fit);
+    if (status != 0) {
+        return status;
+    }
+
+    // Lines in x itself are centered on the mean of x, not of x - x0
+    if (u == REG_VAR_U) {
+        fit->mean_u += sums->x0;
+    }
+
+    double intercept = fit->mean_v - fit->slope * fit->mean_u;
+    fit->a = needs_ln_y ? exp(intercept) : intercept;
+    fit->b = model == REG_AB_EXP ? exp(fit->slope) : fit->slope;
+    return 0;
+}
+
+// The model's x transform, NAN outside its domain
+static double transform_x(const regression_fit_t *fit, double x)
+{
+    switch (fit->model) {
+        case REG_QUADRATIC:
+            return x - fit->x0;
+        case REG_LOG:
+        case REG_POWER:
+            return x > 0.0 ? log(x) : NAN;
+        case REG_INVERSE:
+            return x != 0.0 ? 1.0 / x : NAN;
+        default:
+            return x;
+    }
+}
+
+static bool log_y(regression_model_t model)
+{
+    return model == REG_EXP || model == REG_AB_EXP || model == REG_POWER;
+}
+
+double regression_predict_y(const regression_fit_t *fit, double x)
+{
+    double u = transform_x(fit, x);
+    double v = fit->mean_v + fit->slope * (u - fit->mean_u);
+
+    if (fit->model == REG_QUADRATIC) {
+        v += fit->slope2 * (u * u - fit->mean_u2);
+    }
+    return log_y(fit->model) ? exp(v) : v;
+}
+
+int regression_predict_x(const regression_fit_t *fit, double y, double *x1, double *x2)
+{
+    if (x2 != NULL) {
+        *x2 = NAN;
+    }
+    if (log_y(fit->model) && !(y > 0.0)) {
+        return ERR_DOMAIN_ERROR;
+    }
+    double v = log_y(fit->model) ? log(y) : y;
+
+    if (fit->model == REG_QUADRATIC && fit->slope2 != 0.0) {
+        // slope2*u^2 + slope*u + k = 0, solved without cancellation;
+        // x1 is the (-b + sqrt(D)) / 2c root
+        double k = fit->mean_v - v - fit->slope * fit->mean_u - fit->slope2 * fit->mean_u2;
+        double disc = fit->slope * fit->slope - 4.0 * fit->slope2 * k;
+        if (disc < 0.0) {
+            return ERR_DOMAIN_ERROR;
+        }
+        double q = -0.5 * (fit->slope + copysign(sqrt(disc), fit->slope));
+        double root_q = q / fit->slope2;
+        double root_k = q != 0.0 ? k / q : root_q;
+        *x1 = fit->x0 + (fit->slope >= 0.0 ? root_k : root_q);
+        if (x2 != NULL) {
+            *x2 = fit->x0 + (fit->slope >= 0.0 ? root_q : root_k);
+        }
+        return 0;
+    }
+
+    if (fit->slope == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+    double u = fit->mean_u + (v - fit->mean_v) / fit->slope;
+
+    switch (fit->model) {
+        case REG_QUADRATIC:
+            // Degenerate to a line: slope2 is 0
+            *x1 = fit->x0 + u;
+            break;
+        case REG_LOG:
+        case REG_POWER:
+            *x1 = exp(u);
+            break;
+        case REG_INVERSE:
+            if (u == 0.0) {
+                return ERR_DOMAIN_ERROR;
+            }
+            *x1 = 1.0 / u;
+            break;
+        default:
+            *x1 = u;
+            break;
+    }
+    return isfinite(*x1) ? 0 : ERR_DOMAIN_ERROR;
+}
+
+const char *regression_model_name(regression_model_t model)
+{
+    return model < REG_MODEL_COUNT ? model_names[model] : "";
+}
@@ -0,0 +1,151 @@
+/*
+ * Regression
+ *
+ * The STAT mode regression models, all fitted from one set of streaming
+ * moment sums so that switching models costs O(1) rather than a pass over
+ * the data:
+ *
+ *   Linear     y = a + b*x             Logarithmic  y = a + b*ln(x)
+ *   Quadratic  y = a + b*x + c*x^2     e exponential y = a*e^(b*x)
+ *   Inverse    y = a + b/x             ab exponential y = a*b^x
+ *   Power      y = a*x^b
+ *
+ * Every model except the quadratic is a straight line through one of
+ * x, ln x, 1/x against y or ln y, so the sums are kept for the vector
+ * (u, u^2, ln x, 1/x, y, ln y) with u = x - x0 for the first sample x0.
+ * Rather than raw power sums (Σx, Σx², Σx³, Σx⁴, Σy·ln x, ...), which
+ * cancel catastrophically for data far from zero, they are the means and
+ * central co-moments, updated in one weighted Welford step per sample.
+ * Fitting is then a 1x1 or 2x2 solve on those co-moments.
+ *
+ * Samples outside a transform's domain (x <= 0 for ln x, x = 0 for 1/x,
+ * y <= 0 for ln y) are counted; the models that need the transform are
+ * unavailable while any such sample is present.
+ */
+
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include "expression_evaluator.h"
+
+/**
+ * @brief Regression models, in the order of the STAT model menu
+ */
+typedef enum {
+    REG_LINEAR,
+    REG_QUADRATIC,
+    REG_LOG,
+    REG_EXP,            // y = a*e^(b*x)
+    REG_AB_EXP,         // y = a*b^x
+    REG_POWER,
+    REG_INVERSE,
+    REG_MODEL_COUNT
+} regression_model_t;
+
+/**
+ * @brief Transformed variables the moment sums are kept for
+ */
+typedef enum {
+    REG_VAR_U,          // x - x0
+    REG_VAR_U2,         // (x - x0)^2
+    REG_VAR_LN_X,
+    REG_VAR_INV_X,
+    REG_VAR_Y,
+    REG_VAR_LN_Y,
+    REG_VAR_COUNT
+} regression_var_t;
+
+/**
+ * @brief Streaming moment sums shared by all models
+ */
+typedef struct {
+    double n;                                   // Total frequency
+    double x0;                                  // First x; u = x - x0
+    double shift[REG_VAR_COUNT];                // First sample, subtracted before the update
+    double mean[REG_VAR_COUNT];                 // Means of the shifted variables
+    double comoment[REG_VAR_COUNT][REG_VAR_COUNT]; // Σ(zi - mean_i)(zj - mean_j), j >= i
+    double outside_ln_x;                        // Frequency with x <= 0
+    double outside_inv_x;                       // Frequency with x = 0
+    double outside_ln_y;                        // Frequency with y <= 0
+} regression_sums_t;
+
+/**
+ * @brief Fitted regression
+ *
+ * a, b and c are the coefficients in the model's own form. Predictions
+ * use the centered form (ū, v̄ and the slopes against the centered
+ * variables), which stays accurate where a + b*x would cancel.
+ */
+typedef struct {
+    regression_model_t model;
+    double a, b, c;         // c is 0 except for the quadratic
+    double r;               // Correlation coefficient; NAN for the quadratic
+    double x0;              // Centering of the quadratic's u = x - x0
+    double mean_u;          // Mean of the model's x transform
+    double mean_u2;         // Mean of u^2 (quadratic only)
+    double mean_v;          // Mean of the model's y transform
+    double slope;           // dv/du against the centered variable
+    double slope2;          // dv/d(u^2) (quadratic only)
+} regression_fit_t;
+
+/**
+ * @brief Clear the sums
+ * @param sums Moment sums
+ */
+void regression_reset(regression_sums_t *sums);
+
+/**
+ * @brief Add a sample with a frequency (caller checks that it is finite)
+ * @param sums Moment sums
+ * @param x X value
+ * @param y Y value
+ * @param freq Frequency, > 0
+ */
+void regression_add(regression_sums_t *sums, double x, double y, double freq);
+
+/**
+ * @brief Remove a sample added earlier with regression_add()
+ * @param sums Moment sums
+ * @param x X value
+ * @param y Y value
+ * @param freq Frequency, > 0 and at most the total
+ */
+void regression_remove(regression_sums_t *sums, double x, double y, double freq);
+
+/**
+ * @brief Fit a model to the current sums, O(1)
+ * @param sums Moment sums
+ * @param model Model to fit
+ * @param fit Output coefficients and prediction state
+ * @return 0 on success, ERR_DOMAIN_ERROR if the data does not determine
+ *         the model (too few distinct x, or samples outside its domain)
+ */
+int regression_fit(const regression_sums_t *sums, regression_model_t model,
+                   regression_fit_t *fit);
+
+/**
+ * @brief Predicted y for an x (ŷ)
+ * @param fit Fitted model
+ * @param x X value
+ * @return ŷ, NAN outside the model's domain
+ */
+double regression_predict_y(const regression_fit_t *fit, double x);
+
+/**
+ * @brief Estimated x for a y (x̂)
+ * @param fit Fitted model
+ * @param y Y value
+ * @param x1 First estimate
+ * @param x2 Second estimate for the quadratic, NAN otherwise (may be NULL)
+ * @return 0 on success, ERR_DOMAIN_ERROR if no x gives y
+ */
+int regression_predict_x(const regression_fit_t *fit, double y, double *x1, double *x2);
+
+/**
+ * @brief Model name for display
+ * @param model Regression model
+ * @return Short name ("Linear", "Quad", ...)
+ */
+const char *regression_model_name(regression_model_t model);
+
+#endif /* REGRESSION_H */
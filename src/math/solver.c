@@ -0,0 +1,399 @@
+/*
+ * Equation Solver Implementation
+ */
+
+#include "solver.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NEWTON_MAX_ITERATIONS   40
+#define NEWTON_MAX_HALVINGS     8
+#define MULTIPLICITY_MAX        8
+#define SEARCH_FIRST_STEP       0.01    // Relative to max(|x0|, 1)
+#define SEARCH_GROWTH           1.6
+#define SEARCH_MAX_STEPS        80      // Per side; reaches ~1e14 times the first step
+#define JUMP_RATIO              1e-3    // Final |f| above this share of the bracket's |f| is no root
+
+typedef struct {
+    const rpn_queue_t *function;
+    eval_context_t context;
+    const solver_config_t *config;
+    solver_result_t *result;
+    int64_t start_ms;
+    int last_error;             // Most recent evaluation error, 0 if none
+    bool evaluated;             // At least one evaluation succeeded
+    double best_x, best_f;      // Smallest |f| seen
+    bool bracketed;             // [lo, hi] holds a sign change of f
+    double lo, f_lo, hi, f_hi;
+} solver_t;
+
+void solver_config_default(solver_config_t *config)
+{
+    config->tolerance = SOLVER_DEFAULT_TOLERANCE;
+    config->max_evaluations = SOLVER_DEFAULT_MAX_EVALS;
+    config->uptime_ms = NULL;
+    config->time_budget_ms = SOLVER_DEFAULT_TIME_MS;
+}
+
+static bool opposite_signs(double f1, double f2)
+{
+    return (f1 < 0) != (f2 < 0) && f1 != 0 && f2 != 0;
+}
+
+// Keep (x1, x2) as the bracket if f changes sign there and it is narrower
+static void offer_bracket(solver_t *s, double x1, double f1, double x2, double f2)
+{
+    if (!opposite_signs(f1, f2)) {
+        return;
+    }
+    if (s->bracketed && fabs(x2 - x1) >= s->hi - s->lo) {
+        return;
+    }
+    s->bracketed = true;
+    if (x1 < x2) {
+        s->lo = x1; s->f_lo = f1; s->hi = x2; s->f_hi = f2;
+    } else {
+        s->lo = x2; s->f_lo = f2; s->hi = x1; s->f_hi = f1;
+    }
+}
+
+static void record(solver_t *s, double x, double fx)
+{
+    s->evaluated = true;
+    if (isfinite(s->best_f)) {
+        offer_bracket(s, s->best_x, s->best_f, x, fx);
+    }
+    if (fabs(fx) < fabs(s->best_f)) {
+        s->best_x = x;
+        s->best_f = fx;
+    }
+}
+
+static bool out_of_budget(solver_t *s)
+{
+    const solver_config_t *config = s->config;
+
+    if (s->result->evaluations >= config->max_evaluations ||
+        (config->uptime_ms != NULL &&
+         config->uptime_ms() - s->start_ms >= config->time_budget_ms)) {
+        s->result->out_of_budget = true;
+    }
+    return s->result->out_of_budget;
+}
+
+// f(x), counted against the budget; ERR_NO_CONVERGENCE once it is spent
+static int evaluate(solver_t *s, double x, double *fx)
+{
+    if (out_of_budget(s)) {
+        return ERR_NO_CONVERGENCE;
+    }
+    s->context.variables.x = x;
+    s->result->evaluations++;
+
+    int status = evaluate_rpn(s->function, &s->context, fx);
+    if (status == 0) {
+        record(s, x, *fx);
+    } else {
+        s->last_error = status;
+    }
+    return status;
+}
+
+// f(x) and f'(x) from one dual-number pass
+static int evaluate_dual(solver_t *s, double x, double *fx, double *dfx)
+{
+    if (out_of_budget(s)) {
+        return ERR_NO_CONVERGENCE;
+    }
+    s->context.variables.x = x;
+    s->result->evaluations++;
+
+    int status = evaluate_rpn_dual(s->function, &s->context, fx, dfx);
+    if (status == 0) {
+        record(s, x, *fx);
+    } else {
+        s->last_error = status;
+    }
+    return status;
+}
+
+static bool within_tolerance(const solver_t *s, double step, double x)
+{
+    return fabs(step) <= s->config->tolerance * fmax(fabs(x), 1.0);
+}
+
+static void accept(solver_t *s, double x, double fx)
+{
+    s->result->root = x;
+    s->result->residual = fx;
+}
+
+// Damped Newton from x. Returns 1 when converged, 0 when it stalled
+// (the caller falls back to Brent), or the budget / evaluation error.
+static int newton(solver_t *s, double x)
+{
+    double fx, dfx;
+    double previous_step = 0.0;
+
+    int status = evaluate_dual(s, x, &fx, &dfx);
+    if (status != 0) {
+        return status;
+    }
+
+    for (int i = 0; i < NEWTON_MAX_ITERATIONS; i++) {
+        if (fx == 0.0) {
+            accept(s, x, fx);
+            return 1;
+        }
+        if (dfx == 0.0) {
+            return 0;
+        }
+
+        double step = fx / dfx;
+        if (within_tolerance(s, step, x)) {
+            accept(s, x, fx);
+            return 1;
+        }
+
+        // Raw steps shrinking by a steady ratio r < 1 mean a root of
+        // multiplicity ~1 / (1 - r); scaling by it restores fast convergence
+        double scaled = step;
+        if (previous_step != 0.0) {
+            double ratio = step / previous_step;
+            if (ratio >= 0.5 && ratio < 0.95) {
+                scaled *= fmin(round(1.0 / (1.0 - ratio)), MULTIPLICITY_MAX);
+            }
+        }
+        previous_step = step;
+
+        // Halve until |f| decreases, staying inside any known bracket
+        double x_new = x, f_new = fx, df_new = dfx;
+        bool descended = false;
+        for (int h = 0; h <= NEWTON_MAX_HALVINGS && !descended; h++, scaled *= 0.5) {
+            x_new = x - scaled;
+            if (s->bracketed && !(x_new > s->lo && x_new < s->hi)) {
+                continue;
+            }
+            status = evaluate_dual(s, x_new, &f_new, &df_new);
+            if (status == ERR_NO_CONVERGENCE) {
+                return status;
+            }
+            descended = status == 0 && fabs(f_new) < fabs(fx);
+        }
+        if (!descended) {
+            return 0;
+        }
+        s->result->iterations++;
+
+        if (within_tolerance(s, x_new - x, x_new)) {
+            accept(s, x_new, f_new);
+            return 1;
+        }
+        x = x_new;
+        fx = f_new;
+        dfx = df_new;
+    }
+    return 0;
+}
+
+// Step out geometrically on both sides of x0 until f changes sign
+static int search_bracket(solver_t *s, double x0)
+{
+    double step = SEARCH_FIRST_STEP * fmax(fabs(x0), 1.0);
+    double x_prev[2] = { x0, x0 };
+    double f_prev[2];
+    bool valid[2] = { false, false };
+
+    if (evaluate(s, x0, &f_prev[0]) == 0) {
+        f_prev[1] = f_prev[0];
+        valid[0] = valid[1] = true;
+    }
+
+    for (int i = 0; i < SEARCH_MAX_STEPS && !s->bracketed && s->best_f != 0.0; i++) {
+        for (int side = 0; side < 2 && !s->bracketed; side++) {
+            const double x = side == 0 ? x0 + step : x0 - step;
+            double fx;
+
+            int status = evaluate(s, x, &fx);
+            if (status == ERR_NO_CONVERGENCE) {
+                return status;
+            }
+            if (status != 0) {
+                continue;       // Outside the domain on this side; keep going
+            }
+            if (valid[side]) {
+                offer_bracket(s, x_prev[side], f_prev[side], x, fx);
+            }
+            x_prev[side] = x;
+            f_prev[side] = fx;
+            valid[side] = true;
+        }
+        step *= SEARCH_GROWTH;
+    }
+    return 0;
+}
+
+// Brent's method (zeroin) on the bracket. Returns 1 on a root, 0 when
+// the bracket collapsed onto a jump or pole, or the budget / error.
+static int brent(solver_t *s)
+{
+    double a = s->lo, fa = s->f_lo;
+    double b = s->hi, fb = s->f_hi;
+    double c = a, fc = fa;
+    double d = b - a, e = d;
+    const double scale = fmax(fabs(fa), fabs(fb));
+
+    for (;;) {
+        if ((fb > 0) == (fc > 0)) {
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+
+        const double tol = 2.0 * EVAL_NUM_EPSILON * fabs(b) +
+                           0.5 * s->config->tolerance * fmax(fabs(b), 1.0);
+        const double m = 0.5 * (c - b);
+        if (fabs(m) <= tol || fb == 0.0) {
+            break;
+        }
+
+        if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+            // Secant or inverse quadratic interpolation
+            double p, q, r;
+            double ratio = fb / fa;
+            if (a == c) {
+                p = 2.0 * m * ratio;
+                q = 1.0 - ratio;
+            } else {
+                q = fa / fc;
+                r = fb / fc;
+                p = ratio * (2.0 * m * q * (q - r) - (b - a) * (r - 1.0));
+                q = (q - 1.0) * (r - 1.0) * (ratio - 1.0);
+            }
+            if (p > 0) {
+                q = -q;
+            } else {
+                p = -p;
+            }
+            if (2.0 * p < 3.0 * m * q - fabs(tol * q) && p < fabs(0.5 * e * q)) {
+                e = d;
+                d = p / q;
+            } else {
+                d = e = m;
+            }
+        } else {
+            d = e = m;
+        }
+
+        double next = b + (fabs(d) > tol ? d : (m > 0 ? tol : -tol));
+        double f_next;
+        int status = evaluate(s, next, &f_next);
+        if (status != 0 && status != ERR_NO_CONVERGENCE && d != m) {
+            // Undefined at the interpolated point: bisect instead
+            d = e = m;
+            next = b + m;
+            status = evaluate(s, next, &f_next);
+        }
+        if (status != 0) {
+            return status;
+        }
+        s->result->iterations++;
+
+        a = b;
+        fa = fb;
+        b = next;
+        fb = f_next;
+    }
+
+    if (fabs(fb) > JUMP_RATIO * scale) {
+        return 0;
+    }
+    accept(s, b, fb);
+    return 1;
+}
+
+int solve_rpn(const rpn_queue_t *function, const eval_context_t *context,
+              double x0, const solver_config_t *config, solver_result_t *result)
+{
+    solver_config_t defaults;
+    if (config == NULL) {
+        solver_config_default(&defaults);
+        config = &defaults;
+    }
+
+    *result = (solver_result_t){ .root = x0, .residual = NAN };
+    if (!isfinite(x0)) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    solver_t s = {
+        .function = function,
+        .context = *context,
+        .config = config,
+        .result = result,
+        .start_ms = config->uptime_ms != NULL ? config->uptime_ms() : 0,
+        .best_x = x0,
+        .best_f = INFINITY,
+    };
+
+    int status = newton(&s, x0);
+    if (status == ERR_SYNTAX_ERROR || status == ERR_STACK_OVERFLOW) {
+        return status;      // Malformed program, not a property of x0
+    }
+    if (status != 1 && status != ERR_NO_CONVERGENCE && !s.bracketed) {
+        status = search_bracket(&s, x0);
+    }
+    if (status != 1 && status != ERR_NO_CONVERGENCE && s.bracketed) {
+        status = brent(&s);
+    }
+    if (status == 1) {
+        return 0;
+    }
+    if (!s.evaluated) {
+        return s.last_error != 0 ? s.last_error : ERR_NO_CONVERGENCE;
+    }
+
+    // Otherwise report the point closest to a root; an exact zero met
+    // along the way is one
+    accept(&s, s.best_x, s.best_f);
+    return s.best_f == 0.0 ? 0 : ERR_NO_CONVERGENCE;
+}
+
+int solve_expression(const char *equation, const eval_context_t *context,
+                     double x0, const solver_config_t *config, solver_result_t *result)
+{
+    // Static for the same reason as the batch workspace: ~1 KB of tokens
+    static rpn_queue_t function;
+    char difference[MAX_EXPRESSION_LENGTH + 8];
+    const char *expression = equation;
+
+    // Callers may log the result even when the equation does not parse
+    *result = (solver_result_t){ .root = x0, .residual = NAN };
+
+    // lhs = rhs is solved as (lhs)-(rhs) = 0
+    const char *equals = strchr(equation, '=');
+    if (equals != NULL) {
+        if (strchr(equals + 1, '=') != NULL) {
+            return ERR_SYNTAX_ERROR;
+        }
+        int length = snprintf(difference, sizeof(difference), "(%.*s)-(%s)",
+                              (int)(equals - equation), equation, equals + 1);
+        if (length < 0 || length >= (int)sizeof(difference)) {
+            return ERR_SYNTAX_ERROR;
+        }
+        expression = difference;
+    }
+
+    int status = parse_expression_to_rpn(expression, &function);
+    if (status != 0) {
+        return status;
+    }
+    optimize_rpn(&function, context->deg_mode);
+
+    return solve_rpn(&function, context, x0, config, result);
+}
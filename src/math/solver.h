@@ -0,0 +1,90 @@
+/*
+ * Equation Solver
+ *
+ * Root finding for the SOLVE key. The equation, "lhs = rhs" or an
+ * expression taken as "= 0", is compiled once into an rpn_queue_t and
+ * solved for X from an initial guess:
+ *
+ * 1. Newton steps with f'(x) from evaluate_rpn_dual(), damped by step
+ *    halving whenever |f| does not decrease. When successive steps shrink
+ *    at a steady ratio r (a multiple root, where Newton is only linear)
+ *    the step is scaled by the estimated multiplicity 1 / (1 - r).
+ * 2. Every sign change seen on the way is kept as a bracket. If Newton
+ *    stalls, diverges or leaves the bracket, Brent's method finishes
+ *    inside it; without a bracket one is searched for by stepping out
+ *    geometrically on both sides of the initial guess.
+ *
+ * A bracket that collapses onto a jump or a pole rather than a root
+ * (1/(X-2) = 0) is rejected by its residual. Each evaluation counts
+ * against an evaluation budget and, when a clock is supplied, a
+ * wall-clock budget, so a solve can never stall the UI.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "expression_evaluator.h"
+
+#if defined(CONFIG_CALC_EVAL_FLOAT)
+#define SOLVER_DEFAULT_TOLERANCE    1e-6    // Single-precision function values
+#else
+#define SOLVER_DEFAULT_TOLERANCE    1e-12
+#endif
+#define SOLVER_DEFAULT_MAX_EVALS    500
+#define SOLVER_DEFAULT_TIME_MS      2000
+
+/**
+ * @brief Solver settings
+ */
+typedef struct {
+    double tolerance;           // Relative accuracy of the root in X
+    int max_evaluations;        // Function evaluation budget
+    int64_t (*uptime_ms)(void); // Millisecond clock, NULL for no time limit
+    int64_t time_budget_ms;     // Wall-clock budget when uptime_ms is set
+} solver_config_t;
+
+/**
+ * @brief Solver result and cost
+ */
+typedef struct {
+    double root;                // Root, or the best point found on failure
+    double residual;            // f(root), i.e. lhs - rhs
+    int iterations;             // Newton and Brent iterations
+    int evaluations;            // Function evaluations, dual ones included
+    bool out_of_budget;         // Stopped by the evaluation or time budget
+} solver_result_t;
+
+/**
+ * @brief Fill in the default tolerance and budgets (no clock)
+ * @param config Configuration to initialize
+ */
+void solver_config_default(solver_config_t *config);
+
+/**
+ * @brief Solve f(X) = 0 for a compiled f
+ * @param function RPN program in the variable X
+ * @param context Evaluation context; variables.x is replaced by the iterates
+ * @param x0 Initial guess
+ * @param config Tolerance and budgets, NULL for the defaults
+ * @param result Filled in on success and on ERR_NO_CONVERGENCE
+ * @return 0 on success, ERR_NO_CONVERGENCE if no root was found within
+ *         the budget (out_of_budget tells the two apart), or another
+ *         negative error code if f cannot be evaluated at all
+ */
+int solve_rpn(const rpn_queue_t *function, const eval_context_t *context,
+              double x0, const solver_config_t *config, solver_result_t *result);
+
+/**
+ * @brief Compile an equation in X and solve it
+ * @param equation "lhs = rhs", or an expression to be solved for 0
+ * @param context Evaluation context (variables, angle mode)
+ * @param x0 Initial guess
+ * @param config Tolerance and budgets, NULL for the defaults
+ * @param result Filled in on success and on ERR_NO_CONVERGENCE; root x0
+ *        and no counts when the equation does not parse
+ * @return 0 on success, negative error code on failure
+ */
+int solve_expression(const char *equation, const eval_context_t *context,
+                     double x0, const solver_config_t *config, solver_result_t *result);
+
+#endif /* SOLVER_H */
@@ -0,0 +1,153 @@
+/*
+ * Streaming Statistics Implementation
+ */
+
+#include "statistics.h"
+#include <math.h>
+
+void stat_reset(stat_accumulator_t *acc)
+{
+    *acc = (stat_accumulator_t){0};
+}
+
+// Fold a sample into a running minimum (is_min) or maximum
+static void extreme_add(stat_extreme_t *e, double v, double w, bool is_min, bool first)
+{
+    bool beyond = is_min ? v < e->value : v > e->value;
+
+    // Every remaining sample lies strictly inside an unknown extreme's old
+    // value, so a sample at or beyond it is the new extreme
+    if (first || beyond || (!e->valid && v == e->value)) {
+        e->value = v;
+        e->weight = w;
+        e->valid = true;
+    } else if (v == e->value) {
+        e->weight += w;
+    }
+}
+
+static void extreme_remove(stat_extreme_t *e, double v, double w)
+{
+    if (e->valid && v == e->value) {
+        e->weight -= w;
+        if (e->weight <= 0.0) {
+            e->valid = false;
+        }
+    }
+}
+
+int stat_add(stat_accumulator_t *acc, double x, double y, double freq)
+{
+    if (!isfinite(x) || !isfinite(y) || !isfinite(freq) || freq <= 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    regression_add(&acc->regression, x, y, freq);
+    quantile_add(&acc->quantiles, x, freq);
+    quantile_add(&acc->quantiles_y, y, freq);
+
+    bool first = acc->n == 0.0;
+    extreme_add(&acc->min_x, x, freq, true, first);
+    extreme_add(&acc->max_x, x, freq, false, first);
+    extreme_add(&acc->min_y, y, freq, true, first);
+    extreme_add(&acc->max_y, y, freq, false, first);
+    if (first) {
+        acc->shift_x = x;
+        acc->shift_y = y;
+    }
+    x -= acc->shift_x;
+    y -= acc->shift_y;
+
+    // Weighted Welford update; the deviation from the old mean times the
+    // deviation from the new one adds exactly this sample's share of M2
+    acc->n += freq;
+    double dx = x - acc->mean_x;
+    double dy = y - acc->mean_y;
+    acc->mean_x += freq * dx / acc->n;
+    acc->mean_y += freq * dy / acc->n;
+    acc->m2_x += freq * dx * (x - acc->mean_x);
+    acc->m2_y += freq * dy * (y - acc->mean_y);
+    acc->c_xy += freq * dx * (y - acc->mean_y);
+    return 0;
+}
+
+int stat_remove(stat_accumulator_t *acc, double x, double y, double freq)
+{
+    if (!isfinite(x) || !isfinite(y) || !isfinite(freq) || freq <= 0.0 || freq > acc->n) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    if (freq == acc->n) {
+        stat_reset(acc);
+        return 0;
+    }
+
+    regression_remove(&acc->regression, x, y, freq);
+    quantile_remove(&acc->quantiles, x, freq);
+    quantile_remove(&acc->quantiles_y, y, freq);
+    extreme_remove(&acc->min_x, x, freq);
+    extreme_remove(&acc->max_x, x, freq);
+    extreme_remove(&acc->min_y, y, freq);
+    extreme_remove(&acc->max_y, y, freq);
+    x -= acc->shift_x;
+    y -= acc->shift_y;
+
+    // The add update run backwards
+    acc->n -= freq;
+    double dx = x - acc->mean_x;
+    double dy = y - acc->mean_y;
+    acc->mean_x -= freq * dx / acc->n;
+    acc->mean_y -= freq * dy / acc->n;
+    acc->m2_x = fmax(acc->m2_x - freq * dx * (x - acc->mean_x), 0.0);
+    acc->m2_y = fmax(acc->m2_y - freq * dy * (y - acc->mean_y), 0.0);
+    acc->c_xy -= freq * dx * (y - acc->mean_y);
+    return 0;
+}
+
+// An extreme whose samples were all removed is looked up in the samples
+// the quantile state still holds
+static double extreme_value(const stat_extreme_t *e, const quantile_state_t *q,
+                            double n, bool is_min)
+{
+    double min, max;
+
+    if (n <= 0.0) {
+        return NAN;
+    }
+    if (e->valid) {
+        return e->value;
+    }
+    if (quantile_extremes(q, &min, &max) != 0) {
+        return NAN;
+    }
+    return is_min ? min : max;
+}
+
+void stat_get_summary(const stat_accumulator_t *acc, stat_summary_t *summary)
+{
+    const double n = acc->n;
+    const double mean_x = acc->shift_x + acc->mean_x;
+    const double mean_y = acc->shift_y + acc->mean_y;
+
+    summary->n = n;
+    summary->mean_x = n > 0.0 ? mean_x : NAN;
+    summary->mean_y = n > 0.0 ? mean_y : NAN;
+
+    // Raw sums from the central ones: both terms of Σx² are non-negative,
+    // so nothing cancels
+    summary->sum_x = n * mean_x;
+    summary->sum_y = n * mean_y;
+    summary->sum_x2 = acc->m2_x + n * mean_x * mean_x;
+    summary->sum_y2 = acc->m2_y + n * mean_y * mean_y;
+    summary->sum_xy = acc->c_xy + n * mean_x * mean_y;
+
+    summary->pop_sd_x = n > 0.0 ? sqrt(acc->m2_x / n) : NAN;
+    summary->pop_sd_y = n > 0.0 ? sqrt(acc->m2_y / n) : NAN;
+    summary->sample_sd_x = n > 1.0 ? sqrt(acc->m2_x / (n - 1.0)) : NAN;
+    summary->sample_sd_y = n > 1.0 ? sqrt(acc->m2_y / (n - 1.0)) : NAN;
+
+    summary->min_x = extreme_value(&acc->min_x, &acc->quantiles, n, true);
+    summary->max_x = extreme_value(&acc->max_x, &acc->quantiles, n, false);
+    summary->min_y = extreme_value(&acc->min_y, &acc->quantiles_y, n, true);
+    summary->max_y = extreme_value(&acc->max_y, &acc->quantiles_y, n, false);
+}
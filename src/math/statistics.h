@@ -0,0 +1,117 @@
+/*
+ * Streaming Statistics
+ *
+ * One- and two-variable statistics for STAT mode from running
+ * accumulators, without keeping the data. Adding or removing a sample
+ * (with a frequency) is O(1) and the summary is available at any time.
+ *
+ * The accumulators are the weighted form of Welford's update: the mean
+ * and the sums of squared deviations from it, Σ(x - x̄)², Σ(y - ȳ)² and
+ * Σ(x - x̄)(y - ȳ). Unlike raw Σx² these do not cancel when the data is
+ * large and nearly constant (1e9 + 4, 1e9 + 7, ...), and the raw sums
+ * are derived from them instead of the other way round. The samples are
+ * also shifted by the first one before they reach the accumulators, so
+ * the updates work on small deviations and removal, which runs the
+ * update backwards, does not lose the digits the offset would take.
+ *
+ * The same samples feed the regression moment sums (regression.h), so
+ * every regression model is available from the accumulator as well, and
+ * the x values feed the quantile state (quantiles.h): exact up to a few
+ * hundred samples, a fixed-size estimate beyond.
+ *
+ * Minimum and maximum are kept with the weight of samples at that value.
+ * Removing the last of them is answered from the quantile states, which
+ * also keep the y values for this: exactly while they still hold the
+ * samples, and from the end markers once streaming. Only a removal after
+ * that, which drops the samples for good, leaves the extreme unknown
+ * until a sample at or beyond the old one is added again.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "expression_evaluator.h"
+#include "quantiles.h"
+#include "regression.h"
+
+/**
+ * @brief Running minimum or maximum
+ */
+typedef struct {
+    double value;       // Extreme, or the bound on it when not valid
+    double weight;      // Frequency of samples at value
+    bool valid;
+} stat_extreme_t;
+
+/**
+ * @brief Streaming accumulators for paired samples (x, y)
+ */
+typedef struct {
+    double n;           // Total frequency
+    double shift_x;     // First sample; the accumulators hold x - shift_x
+    double shift_y;
+    double mean_x;      // Mean of x - shift_x
+    double mean_y;
+    double m2_x;        // Σ(x - mean_x)²
+    double m2_y;        // Σ(y - mean_y)²
+    double c_xy;        // Σ(x - mean_x)(y - mean_y)
+    stat_extreme_t min_x, max_x;
+    stat_extreme_t min_y, max_y;
+    regression_sums_t regression;   // Moment sums for regression_fit()
+    quantile_state_t quantiles;     // x samples for quantile_get()
+    quantile_state_t quantiles_y;   // y samples, for the extremes only
+} stat_accumulator_t;
+
+/**
+ * @brief Statistics of the accumulated samples
+ *
+ * Values that are undefined for the current data (sample deviations for
+ * n <= 1, extremes of an empty or depleted set) are NAN.
+ */
+typedef struct {
+    double n;
+    double mean_x, sum_x, sum_x2, pop_sd_x, sample_sd_x, min_x, max_x;
+    double mean_y, sum_y, sum_y2, pop_sd_y, sample_sd_y, min_y, max_y;
+    double sum_xy;
+} stat_summary_t;
+
+/**
+ * @brief Clear all samples
+ * @param acc Accumulator
+ */
+void stat_reset(stat_accumulator_t *acc);
+
+/**
+ * @brief Add a sample
+ * @param acc Accumulator
+ * @param x X value (the only value for one-variable data)
+ * @param y Y value, 0 for one-variable data
+ * @param freq Frequency of the sample, > 0
+ * @return 0 on success, ERR_DOMAIN_ERROR for a non-finite value or freq
+ */
+int stat_add(stat_accumulator_t *acc, double x, double y, double freq);
+
+/**
+ * @brief Remove a sample added earlier with stat_add()
+ *
+ * The accumulators cannot tell whether the sample was ever added; only
+ * the total frequency is checked.
+ *
+ * @param acc Accumulator
+ * @param x X value
+ * @param y Y value
+ * @param freq Frequency to remove, > 0
+ * @return 0 on success, ERR_DOMAIN_ERROR for a non-finite value or freq or
+ *         more frequency than was added
+ */
+int stat_remove(stat_accumulator_t *acc, double x, double y, double freq);
+
+/**
+ * @brief Compute the summary statistics; O(1) unless an extreme was
+ *        removed, then O(n) in the held samples
+ * @param acc Accumulator
+ * @param summary Output statistics
+ */
+void stat_get_summary(const stat_accumulator_t *acc, stat_summary_t *summary);
+
+#endif /* STATISTICS_H */
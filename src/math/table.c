@@ -0,0 +1,113 @@
+/*
+ * Function Table Implementation
+ */
+
+#include "table.h"
+#include <math.h>
+
+// Compile one column and fold its constants for the table's angle mode
+static int compile_column(const char *expression, bool deg_mode, rpn_queue_t *rpn)
+{
+    int status = parse_expression_to_rpn(expression, rpn);
+    if (status == 0) {
+        optimize_rpn(rpn, deg_mode);
+    }
+    return status;
+}
+
+int table_init(table_t *table, const char *f, const char *g, const eval_context_t *context,
+               double start, double end, double step)
+{
+    table->row_count = 0;
+    if (!isfinite(start) || !isfinite(end) || !isfinite(step) || step == 0.0) {
+        return ERR_DOMAIN_ERROR;
+    }
+
+    // Allow for the rounding in (end - start) / step so that 0 to 1 in
+    // steps of 0.1 still ends on 1
+    double span = (end - start) / step;
+    if (span < -1e-9) {
+        return ERR_DOMAIN_ERROR;
+    }
+    if (span >= TABLE_MAX_ROWS) {
+        return ERR_OVERFLOW;
+    }
+
+    int status = compile_column(f, context->deg_mode, &table->f);
+    if (status != 0) {
+        return status;
+    }
+    table->has_g = g != NULL && g[0] != '\0';
+    if (table->has_g) {
+        status = compile_column(g, context->deg_mode, &table->g);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    table->context = *context;
+    table->start = start;
+    table->step = step;
+    table->row_count = (int)floor(fmax(span, 0.0) + 1e-9) + 1;
+    for (int i = 0; i < TABLE_RING_BLOCKS; i++) {
+        table->slot_block[i] = -1;
+    }
+    table->blocks_evaluated = 0;
+    return 0;
+}
+
+int table_row_count(const table_t *table)
+{
+    return table->row_count;
+}
+
+// Evaluate one block of rows into its ring slot
+static void evaluate_block(table_t *table, int block)
+{
+    table_row_t *rows = &table->rows[(block % TABLE_RING_BLOCKS) * TABLE_BLOCK_ROWS];
+    int first = block * TABLE_BLOCK_ROWS;
+    int count = table->row_count - first;
+    double xs[TABLE_BLOCK_ROWS] = {0};
+    double fx[TABLE_BLOCK_ROWS];
+    double gx[TABLE_BLOCK_ROWS];
+
+    if (count > TABLE_BLOCK_ROWS) {
+        count = TABLE_BLOCK_ROWS;
+    }
+
+    // start + i * step rather than a running sum, so long tables do not drift
+    for (int i = 0; i < count; i++) {
+        xs[i] = table->start + (double)(first + i) * table->step;
+    }
+
+    if (evaluate_rpn_batch(&table->f, &table->context, xs, fx, count) < 0) {
+        for (int i = 0; i < count; i++) {
+            fx[i] = NAN;
+        }
+    }
+    if (!table->has_g || evaluate_rpn_batch(&table->g, &table->context, xs, gx, count) < 0) {
+        for (int i = 0; i < count; i++) {
+            gx[i] = NAN;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        rows[i] = (table_row_t){ .x = xs[i], .fx = fx[i], .gx = gx[i] };
+    }
+    table->slot_block[block % TABLE_RING_BLOCKS] = block;
+    table->blocks_evaluated++;
+}
+
+const table_row_t *table_get_row(table_t *table, int index)
+{
+    if (index < 0 || index >= table->row_count) {
+        return NULL;
+    }
+
+    int block = index / TABLE_BLOCK_ROWS;
+    int slot = block % TABLE_RING_BLOCKS;
+    if (table->slot_block[slot] != block) {
+        evaluate_block(table, block);
+    }
+    return &table->rows[slot * TABLE_BLOCK_ROWS + index % TABLE_BLOCK_ROWS];
+}
@@ -0,0 +1,89 @@
+/*
+ * Function Table
+ *
+ * Rows of f(X) and optionally g(X) for TABLE mode, over X = start,
+ * start + step, ... up to end. Both functions are compiled once; rows are
+ * evaluated lazily, a block of TABLE_BLOCK_ROWS at a time with
+ * evaluate_rpn_batch(), the first time a row in that block is requested.
+ *
+ * Evaluated blocks live in a ring of TABLE_RING_BLOCKS slots, block n in
+ * slot n % TABLE_RING_BLOCKS, so scrolling in either direction replaces
+ * the block farthest behind and a jump costs at most one block. RAM is
+ * fixed by the ring, not by the range: a table with a million rows
+ * starts as fast as one with ten. Rows hold numbers only; formatting is
+ * left to the display, which only formats the rows it shows.
+ */
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "expression_evaluator.h"
+
+#define TABLE_BLOCK_ROWS    RPN_BATCH_BLOCK     // Rows evaluated per batch
+#define TABLE_RING_BLOCKS   4                   // Blocks kept at once
+#define TABLE_MAX_ROWS      1000000
+
+/**
+ * @brief One table row; fx and gx are NAN where the function fails
+ */
+typedef struct {
+    double x;
+    double fx;
+    double gx;
+} table_row_t;
+
+/**
+ * @brief Table generator state
+ */
+typedef struct {
+    rpn_queue_t f;
+    rpn_queue_t g;
+    bool has_g;                 // Second column present
+    eval_context_t context;     // Variables and angle mode at table_init()
+    double start;
+    double step;
+    int row_count;
+    table_row_t rows[TABLE_RING_BLOCKS * TABLE_BLOCK_ROWS];
+    int slot_block[TABLE_RING_BLOCKS];  // Block held by each slot, -1 if empty
+    uint32_t blocks_evaluated;  // Block evaluations since table_init()
+} table_t;
+
+/**
+ * @brief Compile the table functions and set the X range
+ *
+ * No row is evaluated here. The evaluation context is copied, so later
+ * changes to the calculator's variables do not change the table.
+ *
+ * @param table Table to initialize
+ * @param f First column expression in X
+ * @param g Second column expression in X, NULL or "" for none
+ * @param context Evaluation context (variables, angle mode)
+ * @param start First X
+ * @param end Last X (included when the range is a whole number of steps)
+ * @param step X increment, negative for a decreasing range
+ * @return 0 on success, a parse error, ERR_DOMAIN_ERROR for an empty or
+ *         non-finite range, or ERR_OVERFLOW for more than TABLE_MAX_ROWS rows
+ */
+int table_init(table_t *table, const char *f, const char *g, const eval_context_t *context,
+               double start, double end, double step);
+
+/**
+ * @brief Number of rows in the table
+ * @param table Initialized table
+ * @return Row count
+ */
+int table_row_count(const table_t *table);
+
+/**
+ * @brief Get a row, evaluating its block if it is not in the ring
+ *
+ * The pointer stays valid until a row from another block that maps to
+ * the same ring slot is requested.
+ *
+ * @param table Initialized table
+ * @param index Row index, 0 to table_row_count() - 1
+ * @return Row, or NULL if the index is out of range
+ */
+const table_row_t *table_get_row(table_t *table, int index);
+
+#endif /* TABLE_H */
@@ -0,0 +1,350 @@
+/*
+ * Vectors Implementation
+ */
+
+#include "vector.h"
+#include <float.h>
+#include <math.h>
+
+#define RADIANS_TO_DEGREES  (180.0 / 3.14159265358979323846)
+
+// The three sums every two-vector kernel is built from
+typedef struct {
+    double dot;     // a.b
+    double aa;      // |a|^2
+    double bb;      // |b|^2
+} vector_products_t;
+
+static const char *const names[VECTOR_COUNT] = {
+    "VctA", "VctB", "VctC", "VctD", "VctAns",
+};
+
+// Evaluation stack and compiled program, kept off the caller's stack
+static vector_t stack[MAX_TOKENS];
+static rpn_queue_t program;
+
+const char *vector_name(vector_name_t name)
+{
+    return (unsigned)name < VECTOR_COUNT ? names[name] : "Vct?";
+}
+
+static bool is_vector(const vector_t *a)
+{
+    return a->dim == 2 || a->dim == 3;
+}
+
+static bool all_finite(const vector_t *a)
+{
+    for (int i = 0; i < a->dim; i++) {
+        if (!isfinite(a->v[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void set_scalar(vector_t *a, double value)
+{
+    a->dim = 1;
+    a->v[0] = value;
+}
+
+// a.b, |a|^2 and |b|^2 in one pass over the components
+static void products(const vector_t *a, const vector_t *b, vector_products_t *p)
+{
+    double dot = 0.0, aa = 0.0, bb = 0.0;
+    for (int i = 0; i < a->dim; i++) {
+        dot += a->v[i] * b->v[i];
+        aa += a->v[i] * a->v[i];
+        bb += b->v[i] * b->v[i];
+    }
+    p->dot = dot;
+    p->aa = aa;
+    p->bb = bb;
+}
+
+static double sum_of_squares(const vector_t *a)
+{
+    double sum = 0.0;
+    for (int i = 0; i < a->dim; i++) {
+        sum += a->v[i] * a->v[i];
+    }
+    return sum;
+}
+
+int vector_dot(const vector_t *a, const vector_t *b, double *dot)
+{
+    if (!is_vector(a) || a->dim != b->dim) {
+        return ERR_DIMENSION;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < a->dim; i++) {
+        sum += a->v[i] * b->v[i];
+    }
+    *dot = sum;
+    return isfinite(sum) ? 0 : ERR_OVERFLOW;
+}
+
+int vector_cross(const vector_t *a, const vector_t *b, vector_t *out)
+{
+    if (!is_vector(a) || !is_vector(b)) {
+        return ERR_DIMENSION;
+    }
+    double ax = a->v[0], ay = a->v[1], az = a->dim == 3 ? a->v[2] : 0.0;
+    double bx = b->v[0], by = b->v[1], bz = b->dim == 3 ? b->v[2] : 0.0;
+
+    out->dim = 3;
+    out->v[0] = ay * bz - az * by;
+    out->v[1] = az * bx - ax * bz;
+    out->v[2] = ax * by - ay * bx;
+    return all_finite(out) ? 0 : ERR_OVERFLOW;
+}
+
+int vector_norm(const vector_t *a, double *norm)
+{
+    if (!is_vector(a)) {
+        return ERR_DIMENSION;
+    }
+    *norm = sqrt(sum_of_squares(a));
+    return isfinite(*norm) ? 0 : ERR_OVERFLOW;
+}
+
+int vector_unit(const vector_t *a, vector_t *out)
+{
+    if (!is_vector(a)) {
+        return ERR_DIMENSION;
+    }
+    double norm = sqrt(sum_of_squares(a));
+    if (norm == 0.0) {
+        return ERR_DIVISION_BY_ZERO;
+    }
+    if (!isfinite(norm)) {
+        return ERR_OVERFLOW;
+    }
+    double reciprocal = 1.0 / norm;
+    out->dim = a->dim;
+    for (int i = 0; i < a->dim; i++) {
+        out->v[i] = a->v[i] * reciprocal;
+    }
+    return 0;
+}
+
+int vector_angle(const vector_t *a, const vector_t *b, double *radians)
+{
+    if (!is_vector(a) || a->dim != b->dim) {
+        return ERR_DIMENSION;
+    }
+    vector_products_t p;
+    products(a, b, &p);
+    if (!isfinite(p.dot) || !isfinite(p.aa) || !isfinite(p.bb)) {
+        return ERR_OVERFLOW;
+    }
+    if (p.aa == 0.0 || p.bb == 0.0) {
+        return ERR_DIVISION_BY_ZERO;
+    }
+
+    // |a| |b| with one square root, unless the product of the squares
+    // leaves the normal range
+    double squares = p.aa * p.bb;
+    double norms = (squares >= DBL_MIN && squares <= DBL_MAX) ?
+                   sqrt(squares) : sqrt(p.aa) * sqrt(p.bb);
+
+    // Rounding can push parallel vectors just past +-1
+    double cosine = p.dot / norms;
+    if (cosine > 1.0) {
+        cosine = 1.0;
+    } else if (cosine < -1.0) {
+        cosine = -1.0;
+    }
+    *radians = acos(cosine);
+    return 0;
+}
+
+// a op b into a; scalars have dim 1
+static int apply_vector_operator(char op, vector_t *a, const vector_t *b)
+{
+    if (a->dim == 1 && b->dim == 1) {
+        eval_num_t value;
+        int status = apply_operator(op, a->v[0], b->v[0], &value);
+        a->v[0] = value;
+        return status;
+    }
+
+    switch (op) {
+        case '+':
+        case '-': {
+            if (a->dim != b->dim) {
+                return ERR_DIMENSION;
+            }
+            double sign = op == '+' ? 1.0 : -1.0;
+            for (int i = 0; i < a->dim; i++) {
+                a->v[i] += sign * b->v[i];
+            }
+            break;
+        }
+        case '*':
+            if (a->dim == 1) {
+                double scale = a->v[0];
+                *a = *b;
+                for (int i = 0; i < a->dim; i++) {
+                    a->v[i] *= scale;
+                }
+            } else if (b->dim == 1) {
+                for (int i = 0; i < a->dim; i++) {
+                    a->v[i] *= b->v[0];
+                }
+            } else {
+                return vector_cross(a, b, a);
+            }
+            break;
+        case '/':
+            if (b->dim != 1) {
+                return ERR_DIMENSION;
+            }
+            if (b->v[0] == 0.0) {
+                return ERR_DIVISION_BY_ZERO;
+            }
+            for (int i = 0; i < a->dim; i++) {
+                a->v[i] /= b->v[0];
+            }
+            break;
+        default:
+            return ERR_DIMENSION;
+    }
+    return all_finite(a) ? 0 : ERR_OVERFLOW;
+}
+
+// func(a) into a for the one-argument functions
+static int apply_vector_function(function_type_t func, vector_t *a, bool deg_mode)
+{
+    if (a->dim == 1) {
+        if (func == FUNC_UNIT_V) {
+            return ERR_DIMENSION;
+        }
+        eval_num_t value = apply_function(func, a->v[0], deg_mode);
+        if (!isfinite(value)) {
+            return ERR_DOMAIN_ERROR;
+        }
+        a->v[0] = value;
+        return 0;
+    }
+
+    double norm = 0.0;
+    int status;
+    switch (func) {
+        case FUNC_ABS:
+            status = vector_norm(a, &norm);
+            set_scalar(a, norm);
+            return status;
+        case FUNC_UNIT_V:
+            return vector_unit(a, a);
+        default:
+            return ERR_DIMENSION;
+    }
+}
+
+int vector_evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                        const vector_t *vectors, vector_t *result)
+{
+    int top = -1;
+
+    for (int i = 0; i < rpn_queue->count; i++) {
+        const token_t *token = &rpn_queue->tokens[i];
+        int status = 0;
+
+        switch (token->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_CONSTANT:
+            case TOKEN_VARIABLE:
+                if (top >= MAX_TOKENS - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                top++;
+                if (token->type == TOKEN_NUMBER) {
+                    set_scalar(&stack[top], token->value.number);
+                } else if (token->type == TOKEN_CONSTANT) {
+                    set_scalar(&stack[top], get_constant_value(token->value.constant));
+                } else {
+                    set_scalar(&stack[top], get_variable_value(token->value.variable,
+                                                               &context->variables));
+                }
+                break;
+
+            case TOKEN_VECTOR:
+                if (top >= MAX_TOKENS - 1) {
+                    return ERR_STACK_OVERFLOW;
+                }
+                if ((unsigned)token->value.vector >= VECTOR_COUNT ||
+                    !is_vector(&vectors[token->value.vector])) {
+                    return ERR_DIMENSION;
+                }
+                stack[++top] = vectors[token->value.vector];
+                break;
+
+            case TOKEN_OPERATOR:
+                if (top < 1) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                top--;
+                status = apply_vector_operator(token->value.operator, &stack[top], &stack[top + 1]);
+                break;
+
+            case TOKEN_UNARY_MINUS:
+                if (top < 0) {
+                    return ERR_SYNTAX_ERROR;
+                }
+                for (int j = 0; j < stack[top].dim; j++) {
+                    stack[top].v[j] = -stack[top].v[j];
+                }
+                break;
+
+            case TOKEN_FUNCTION:
+                if (token->value.function == FUNC_DOT || token->value.function == FUNC_ANGLE) {
+                    if (top < 1) {
+                        return ERR_SYNTAX_ERROR;
+                    }
+                    top--;
+                    double value = 0.0;
+                    if (token->value.function == FUNC_DOT) {
+                        status = vector_dot(&stack[top], &stack[top + 1], &value);
+                    } else {
+                        status = vector_angle(&stack[top], &stack[top + 1], &value);
+                        if (context->deg_mode) {
+                            value *= RADIANS_TO_DEGREES;
+                        }
+                    }
+                    set_scalar(&stack[top], value);
+                } else {
+                    if (top < 0) {
+                        return ERR_SYNTAX_ERROR;
+                    }
+                    status = apply_vector_function(token->value.function, &stack[top],
+                                                   context->deg_mode);
+                }
+                break;
+
+            default:
+                return ERR_SYNTAX_ERROR;
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (top != 0) {
+        return ERR_SYNTAX_ERROR;
+    }
+    *result = stack[0];
+    return 0;
+}
+
+int vector_evaluate_expression(const char *expression, const eval_context_t *context,
+                               const vector_t *vectors, vector_t *result)
+{
+    int status = parse_expression_to_rpn(expression, &program);
+    if (status != 0) {
+        return status;
+    }
+    return vector_evaluate_rpn(&program, context, vectors, result);
+}
@@ -0,0 +1,116 @@
+/*
+ * Vectors
+ *
+ * 2D and 3D vectors for VECTOR mode. A vector is a value, the dimension
+ * and a packed array of components, so VctA-VctD and VctAns are plain
+ * fixed-size structs and nothing is allocated.
+ *
+ * The kernels that share work are fused so it is done once: the angle
+ * comes from a single pass that accumulates a.b, |a|^2 and |b|^2
+ * together and takes one square root of |a|^2 |b|^2, rather than calling
+ * the dot product and two norms; the unit vector takes one norm and
+ * multiplies by its reciprocal. A 2D operand of the cross product is
+ * taken in the z = 0 plane, so the result is always 3D.
+ *
+ * vector_evaluate_rpn() runs the evaluator's RPN programs with vector
+ * operands: VctA+VctB, 2*VctA, VctA*VctB (cross product), abs(VctA)
+ * (norm), unitV(VctA), dot(VctA,VctB) and angle(VctA,VctB), mixed freely
+ * with scalar expressions. Its value stack is static, so it is not
+ * reentrant.
+ */
+
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include "expression_evaluator.h"
+
+#define VECTOR_MAX_DIM  3
+
+/**
+ * @brief Vector; dim 0 means undefined
+ *
+ * Stored vectors have 2 or 3 components. On the evaluation stack and as
+ * an expression result, dim 1 is a scalar.
+ */
+typedef struct {
+    uint8_t dim;
+    double v[VECTOR_MAX_DIM];
+} vector_t;
+
+/**
+ * @brief Display name of a named vector
+ * @param name Vector name
+ * @return "VctA" ... "VctD", "VctAns"
+ */
+const char *vector_name(vector_name_t name);
+
+/**
+ * @brief Dot product a.b
+ * @param a First vector
+ * @param b Second vector, same dimension
+ * @param dot Output dot product
+ * @return 0 on success, ERR_DIMENSION if the dimensions differ, ERR_OVERFLOW
+ */
+int vector_dot(const vector_t *a, const vector_t *b, double *dot);
+
+/**
+ * @brief Cross product a x b
+ * @param a First vector, 2D operands lie in the z = 0 plane
+ * @param b Second vector
+ * @param out 3D result (may alias an operand)
+ * @return 0 on success, ERR_DIMENSION if an operand is undefined, ERR_OVERFLOW
+ */
+int vector_cross(const vector_t *a, const vector_t *b, vector_t *out);
+
+/**
+ * @brief Euclidean norm |a|
+ * @param a Vector
+ * @param norm Output norm
+ * @return 0 on success, ERR_DIMENSION if a is undefined, ERR_OVERFLOW
+ */
+int vector_norm(const vector_t *a, double *norm);
+
+/**
+ * @brief Unit vector a / |a|
+ * @param a Vector
+ * @param out Result (may alias a)
+ * @return 0 on success, ERR_DIMENSION if a is undefined,
+ *         ERR_DIVISION_BY_ZERO for the zero vector, ERR_OVERFLOW
+ */
+int vector_unit(const vector_t *a, vector_t *out);
+
+/**
+ * @brief Angle between two vectors, acos(a.b / (|a| |b|))
+ * @param a First vector
+ * @param b Second vector, same dimension
+ * @param radians Output angle in [0, pi]
+ * @return 0 on success, ERR_DIMENSION if the dimensions differ,
+ *         ERR_DIVISION_BY_ZERO if either is the zero vector, ERR_OVERFLOW
+ */
+int vector_angle(const vector_t *a, const vector_t *b, double *radians);
+
+/**
+ * @brief Evaluate an RPN program whose operands may be vectors
+ * @param rpn_queue RPN tokens from parse_expression_to_rpn()
+ * @param context Evaluation context (scalar variables, angle mode)
+ * @param vectors Values of VctA ... VctAns, indexed by vector_name_t
+ * @param result Output vector, or a scalar with dim 1
+ * @return 0 on success, ERR_DIMENSION for an undefined vector or
+ *         operands whose shapes do not fit, other negative error codes
+ *         as evaluate_rpn()
+ */
+int vector_evaluate_rpn(const rpn_queue_t *rpn_queue, const eval_context_t *context,
+                        const vector_t *vectors, vector_t *result);
+
+/**
+ * @brief Parse and evaluate an expression whose operands may be vectors
+ * @param expression Input expression, for example "angle(VctA,VctB)"
+ * @param context Evaluation context
+ * @param vectors Values of VctA ... VctAns, indexed by vector_name_t
+ * @param result Output vector, or a scalar with dim 1
+ * @return 0 on success, negative error code on failure
+ */
+int vector_evaluate_expression(const char *expression, const eval_context_t *context,
+                               const vector_t *vectors, vector_t *result);
+
+#endif /* VECTOR_H */
@@ -3,19 +3,55 @@
  */
 
 #include "calculator_state.h"
+#include "../math/differentiation.h"
+#include "../math/eigen.h"
+#include "../math/integration.h"
+#include "../math/solver.h"
+#include "../math/statistics.h"
+#include "../math/table.h"
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <math.h>
 
 LOG_MODULE_REGISTER(calculator_state, LOG_LEVEL_INF);
 
+// TABLE mode rows; too large for calculator_t, which lives on the main stack
+static table_t table;
+
+// STAT mode samples; only the accumulators are kept, not the data
+static stat_accumulator_t stats;
+
+// MATRIX mode matrices MatA-MatD and MatAns
+static matrix_t matrices[MATRIX_COUNT];
+
+// Ans with its imaginary part for CMPLX mode; memory.ans is the real part
+static complex_t complex_ans;
+
+// Ans as the BASE-N integer; memory.ans holds it rounded to a double
+static int64_t base_n_ans;
+
+// VECTOR mode vectors VctA-VctD and VctAns
+static vector_t vectors[VECTOR_COUNT];
+
+// EQUATION mode roots of the last polynomial solved, degree 0 if none
+static poly_roots_t equation;
+
+// Eigen and SVD results, kept off the main stack
+static union {
+    eigen_result_t eigen;
+    svd_result_t svd;
+} decomposition;
+
 // State name strings for debugging
 static const char* state_names[] = {
     "INPUT_NORMAL", "SHOW_RESULT", "SHOW_ERROR", "MENU_MODE", "MENU_SETUP",
     "MATRIX_MODE", "VECTOR_MODE", "SOLVE_MODE", "STAT_MODE", "BASE_N_MODE",
-    "COMPLEX_MODE", "TABLE_MODE", "EQUATION_MODE", "INTEGRAL_MODE", "DIFFERENTIAL_MODE"
+    "COMPLEX_MODE", "TABLE_MODE", "EQUATION_MODE", "INTEGRAL_MODE", "DIFFERENTIAL_MODE",
+    "CATALOG_MODE"
 };
 
 const char* get_state_name(calculator_state_t state)
@@ -37,6 +73,8 @@ void calculator_init(calculator_t *calc)
     // Set default modes
     calc->mode.deg_mode = true;  // Default to degree mode
     calc->mode.decimal_places = 2;
+    calc->mode.base_n_radix = BASE_N_DEC;
+    calc->mode.base_n_bits = 32;
     
     // Initialize buffers
     strcpy(calc->input_buffer, "0");
@@ -52,188 +90,1499 @@ void calculator_init(calculator_t *calc)
     LOG_INF("Calculator initialized in %s state", get_state_name(calc->state));
 }
 
-void calculator_clear(calculator_t *calc)
+void calculator_clear(calculator_t *calc)
+{
+    memset(calc->input_buffer, 0, sizeof(calc->input_buffer));
+    strcpy(calc->input_buffer, "0");
+    calc->input_pos = 1;
+    calc->cursor_pos = 1;
+    calc->new_number = true;
+    calc->calculation_done = false;
+    calc->error_state = false;
+    calc->state = STATE_INPUT_NORMAL;
+    memset(calc->result_buffer, 0, sizeof(calc->result_buffer));
+    memset(calc->error_buffer, 0, sizeof(calc->error_buffer));
+}
+
+void calculator_clear_memory(calculator_t *calc)
+{
+    memset(&calc->memory, 0, sizeof(calc->memory));
+    memset(&calc->eval_context.variables, 0, sizeof(calc->eval_context.variables));
+    LOG_INF("All memory cleared");
+}
+
+void calculator_set_error(calculator_t *calc, const char *error_msg)
+{
+    strncpy(calc->error_buffer, error_msg, sizeof(calc->error_buffer) - 1);
+    calc->error_buffer[sizeof(calc->error_buffer) - 1] = '\0';
+    calc->state = STATE_SHOW_ERROR;
+    calc->error_state = true;
+    LOG_WRN("Calculator error: %s", error_msg);
+}
+
+static void append_char(calculator_t *calc, char ch)
+{
+    if (calc->new_number) {
+        // Starting a new number, clear the display
+        calculator_clear(calc);
+        calc->new_number = false;
+    }
+    
+    // Remove leading zero if we're entering the first digit
+    if (calc->input_pos == 1 && calc->input_buffer[0] == '0' && ch != '.') {
+        calc->input_buffer[0] = ch;
+        calc->cursor_pos = 1;
+        return;
+    }
+    
+    if (calc->input_pos < sizeof(calc->input_buffer) - 1) {
+        calc->input_buffer[calc->input_pos++] = ch;
+        calc->input_buffer[calc->input_pos] = '\0';
+        calc->cursor_pos = calc->input_pos;
+    }
+}
+
+static void append_string(calculator_t *calc, const char *str)
+{
+    if (calc->new_number && strcmp(str, "Ans") != 0) {
+        calculator_clear(calc);
+        calc->new_number = false;
+    }
+    
+    // A function, constant or name replaces the 0 of a cleared input, as
+    // a digit does; "0sin(X)" would read as 0*sin(X)
+    if (strcmp(calc->input_buffer, "0") == 0 && (isalpha((unsigned char)str[0]) || (uint8_t)str[0] >= 0x80)) {
+        calc->input_buffer[0] = '\0';
+        calc->input_pos = 0;
+    }
+    
+    int len = strlen(str);
+    if (calc->input_pos + len < sizeof(calc->input_buffer) - 1) {
+        strcpy(&calc->input_buffer[calc->input_pos], str);
+        calc->input_pos += len;
+        calc->cursor_pos = calc->input_pos;
+    }
+}
+
+static void append_operator(calculator_t *calc, char op)
+{
+    // If we're showing a result, use it as the start of new expression
+    if (calc->state == STATE_SHOW_RESULT) {
+        snprintf(calc->input_buffer, sizeof(calc->input_buffer), 
+                 "%.10g%c", calc->memory.ans, op);
+        calc->input_pos = strlen(calc->input_buffer);
+        calc->cursor_pos = calc->input_pos;
+        calc->state = STATE_INPUT_NORMAL;
+        calc->new_number = false;
+        return;
+    }
+    
+    // Don't allow operators at the beginning (except minus)
+    if (calc->input_pos == 0 && op != '-') {
+        return;
+    }
+    
+    // Replace last character if it's already an operator
+    if (calc->input_pos > 0) {
+        char last_char = calc->input_buffer[calc->input_pos - 1];
+        if (last_char == '+' || last_char == '-' || last_char == '*' || last_char == '/') {
+            calc->input_buffer[calc->input_pos - 1] = op;
+            calc->cursor_pos = calc->input_pos;
+            return;
+        }
+    }
+    
+    if (calc->input_pos < sizeof(calc->input_buffer) - 1) {
+        calc->input_buffer[calc->input_pos++] = op;
+        calc->input_buffer[calc->input_pos] = '\0';
+        calc->cursor_pos = calc->input_pos;
+    }
+    calc->new_number = false;
+}
+
+static void backspace(calculator_t *calc)
+{
+    if (calc->state == STATE_SHOW_RESULT || calc->state == STATE_SHOW_ERROR) {
+        // Return to input mode
+        calculator_clear(calc);
+        return;
+    }
+    
+    if (calc->input_pos > 1) {
+        calc->input_buffer[--calc->input_pos] = '\0';
+        calc->cursor_pos = calc->input_pos;
+    } else if (calc->input_pos == 1) {
+        // Replace with 0
+        calc->input_buffer[0] = '0';
+        calc->input_buffer[1] = '\0';
+        calc->cursor_pos = 1;
+    }
+}
+
+// Copy memory variables and angle mode into the evaluation context
+static void sync_eval_context(calculator_t *calc)
+{
+    calc->eval_context.variables = (variable_storage_t){
+        .ans = calc->memory.ans,
+        .x = calc->memory.x, .y = calc->memory.y,
+        .a = calc->memory.a, .b = calc->memory.b,
+        .c = calc->memory.c, .d = calc->memory.d,
+        .m = calc->memory.m
+    };
+    calc->eval_context.deg_mode = calc->mode.deg_mode;
+}
+
+// Format a number in the current display format
+static void format_number(calculator_t *calc, double value, char *buffer, size_t size)
+{
+    if (calc->mode.sci_mode) {
+        snprintf(buffer, size, "%.6e", value);
+    } else if (calc->mode.fix_mode) {
+        char format[16];
+        snprintf(format, sizeof(format), "%%.%df", calc->mode.decimal_places);
+        snprintf(buffer, size, format, value);
+    } else {
+        snprintf(buffer, size, "%.10g", value);
+    }
+}
+
+// Store a result in Ans and show it in the current display format
+static void show_result(calculator_t *calc, double result)
+{
+    calc->memory.ans = result;
+    calc->memory.has_ans = true;
+    complex_ans = (complex_t){ result, 0.0 };
+    
+    format_number(calc, result, calc->result_buffer, sizeof(calc->result_buffer));
+    
+    calc->state = STATE_SHOW_RESULT;
+    calc->calculation_done = true;
+    calc->new_number = true;
+}
+
+// Format a complex number as a+bi or r∠θ. A part under 1e-12 of the
+// other is rounding (e^(iπ) is -1+1.2e-16i) and cannot show in 10
+// digits, so it is dropped.
+static void format_complex(calculator_t *calc, complex_t z, char *buffer, size_t size)
+{
+    char first[24], second[24];
+    
+    if (calc->mode.polar_form) {
+        format_number(calc, complex_abs(z), first, sizeof(first));
+        format_number(calc, complex_arg(z, calc->mode.deg_mode), second, sizeof(second));
+        snprintf(buffer, size, "%s∠%s", first, second);
+        return;
+    }
+    
+    double noise = 1e-12 * fmax(fabs(z.re), fabs(z.im));
+    double re = fabs(z.re) < noise ? 0.0 : z.re;
+    double im = fabs(z.im) < noise ? 0.0 : z.im;
+    if (im == 0.0) {
+        format_number(calc, re, buffer, size);
+        return;
+    }
+    
+    // i rather than 1i, also when rounding to 10 digits gives the 1
+    format_number(calc, fabs(im), first, sizeof(first));
+    if (strcmp(first, "1") == 0) {
+        first[0] = '\0';
+    }
+    if (re == 0.0) {
+        snprintf(buffer, size, "%s%si", im < 0.0 ? "-" : "", first);
+    } else {
+        format_number(calc, re, second, sizeof(second));
+        snprintf(buffer, size, "%s%c%si", second, im < 0.0 ? '-' : '+', first);
+    }
+}
+
+// Store a complex result in Ans and show it in the current form
+static void show_complex_result(calculator_t *calc, complex_t result)
+{
+    show_result(calc, result.re);
+    complex_ans = result;
+    format_complex(calc, result, calc->result_buffer, sizeof(calc->result_buffer));
+}
+
+// Store a BASE-N result in Ans and show it in the current radix, with
+// the integer formatter rather than through a double
+static void show_base_n_result(calculator_t *calc, int64_t result)
+{
+    show_result(calc, (double)result);
+    base_n_ans = result;
+    base_n_format(result, calc->mode.base_n_radix, calc->mode.base_n_bits,
+                  calc->result_buffer, sizeof(calc->result_buffer));
+}
+
+static const char *error_message(int error)
+{
+    switch (error) {
+        case ERR_SYNTAX_ERROR: return "Syntax Error";
+        case ERR_DIVISION_BY_ZERO: return "Math Error";
+        case ERR_DOMAIN_ERROR: return "Domain Error";
+        case ERR_OVERFLOW: return "Overflow";
+        case ERR_NO_CONVERGENCE: return "Time Out";
+        case ERR_DIMENSION: return "Dim Error";
+        default: return "Error";
+    }
+}
+
+void calculator_execute(calculator_t *calc)
+{
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        return;
+    }
+    
+    // Update evaluation context with current variables
+    sync_eval_context(calc);
+    
+    if (calc->mode.base_n_mode) {
+        // Integers from the literals to the display; no double on the way
+        base_n_context_t context = {
+            .radix = calc->mode.base_n_radix,
+            .bits = calc->mode.base_n_bits,
+            .ans = base_n_ans
+        };
+        int64_t value;
+        int status = base_n_evaluate_expression(calc->input_buffer, &context, &value);
+        if (status == 0) {
+            show_base_n_result(calc, value);
+            LOG_INF("Calculation: %s = %s", calc->input_buffer, calc->result_buffer);
+        } else {
+            calculator_set_error(calc, error_message(status));
+        }
+        return;
+    }
+    
+    if (calc->mode.complex_mode) {
+        // Separate evaluator, so the real path below keeps its speed
+        complex_t value;
+        int status = complex_evaluate_expression(calc->input_buffer, &calc->eval_context,
+                                                 &complex_ans, &value);
+        if (status == 0) {
+            show_complex_result(calc, value);
+            LOG_INF("Calculation: %s = %g%+gi", calc->input_buffer, value.re, value.im);
+        } else {
+            calculator_set_error(calc, error_message(status));
+        }
+        return;
+    }
+    
+    double result;
+    int eval_result = evaluate_expression(calc->input_buffer, &calc->eval_context, &result);
+    
+    expr_cache_stats_t cache_stats;
+    expression_cache_get_stats(&cache_stats);
+    LOG_DBG("Expression cache: %u hits, %u misses", cache_stats.hits, cache_stats.misses);
+    
+    if (eval_result == 0) {
+        show_result(calc, result);
+        LOG_INF("Calculation: %s = %g", calc->input_buffer, result);
+    } else {
+        calculator_set_error(calc, error_message(eval_result));
+    }
+}
+
+void calculator_complex(calculator_t *calc, bool toggle_form)
+{
+    if (toggle_form) {
+        calc->mode.polar_form = !calc->mode.polar_form;
+        if (calc->state == STATE_SHOW_RESULT && calc->mode.complex_mode) {
+            format_complex(calc, complex_ans, calc->result_buffer, sizeof(calc->result_buffer));
+        }
+        LOG_INF("Complex form: %s", calc->mode.polar_form ? "r∠θ" : "a+bi");
+        return;
+    }
+    
+    calc->mode.complex_mode = !calc->mode.complex_mode;
+    calc->mode.base_n_mode = false;
+    strcpy(calc->status_buffer, calc->mode.complex_mode ? "CMPLX" : "COMP");
+    LOG_INF("%s mode", calc->status_buffer);
+}
+
+// Status line for BASE-N mode, such as "BASE-N HEX 32"
+static void update_base_n_status(calculator_t *calc)
+{
+    snprintf(calc->status_buffer, sizeof(calc->status_buffer), "BASE-N %s %d",
+             base_n_radix_name(calc->mode.base_n_radix), calc->mode.base_n_bits);
+}
+
+// Show the BASE-N result again after the radix or word size changed
+static void reformat_base_n_result(calculator_t *calc)
+{
+    if (calc->state == STATE_SHOW_RESULT && calc->mode.base_n_mode) {
+        base_n_format(base_n_ans, calc->mode.base_n_radix, calc->mode.base_n_bits,
+                      calc->result_buffer, sizeof(calc->result_buffer));
+    }
+}
+
+void calculator_base_n(calculator_t *calc, bool cycle_word)
+{
+    if (cycle_word) {
+        calc->mode.base_n_bits = calc->mode.base_n_bits >= BASE_N_MAX_BITS ?
+                                 8 : (uint8_t)(calc->mode.base_n_bits * 2);
+        base_n_ans = base_n_wrap((uint64_t)base_n_ans, calc->mode.base_n_bits);
+        reformat_base_n_result(calc);
+        if (calc->mode.base_n_mode) {
+            update_base_n_status(calc);
+        }
+        LOG_INF("BASE-N word: %d bits", calc->mode.base_n_bits);
+        return;
+    }
+    
+    calc->mode.base_n_mode = !calc->mode.base_n_mode;
+    if (calc->mode.base_n_mode) {
+        calc->mode.complex_mode = false;
+        update_base_n_status(calc);
+    } else {
+        strcpy(calc->status_buffer, "COMP");
+    }
+    LOG_INF("%s mode", calc->status_buffer);
+}
+
+// BASE-N radix selected by a key: sqrt, ^, log and ln as on the fx-991
+static base_n_radix_t base_n_radix_key(key_code_t key)
+{
+    switch (key) {
+        case KEY_SQRT: return BASE_N_DEC;
+        case KEY_X_POW_Y: return BASE_N_HEX;
+        case KEY_LOG: return BASE_N_BIN;
+        case KEY_LN: return BASE_N_OCT;
+        default: return 0;
+    }
+}
+
+static void set_base_n_radix(calculator_t *calc, base_n_radix_t radix)
+{
+    calc->mode.base_n_radix = radix;
+    reformat_base_n_result(calc);
+    update_base_n_status(calc);
+}
+
+// BASE-N input keys: hex digits, logic and shifts, each with its SHIFT text
+static const struct {
+    key_code_t key;
+    const char *text;
+    const char *shifted;
+} base_n_keys[] = {
+    { KEY_SIN, "D", "A" },
+    { KEY_COS, "E", "B" },
+    { KEY_TAN, "F", "C" },
+    { KEY_OPTN, " and ", " or " },
+    { KEY_FUNC, " xor ", " xnor " },
+    { KEY_FACTORIAL, "<<", ">>" },
+    { KEY_X_POW_MINUS1, "not(", "neg(" },
+};
+
+// Binary operators of BASE-N mode continue from Ans like + - * /
+static bool is_base_n_operator_key(key_code_t key)
+{
+    return key == KEY_OPTN || key == KEY_FUNC || key == KEY_FACTORIAL;
+}
+
+// Handle the keys BASE-N mode gives another meaning; false for the rest
+static bool handle_base_n_key(calculator_t *calc, key_code_t key)
+{
+    base_n_radix_t radix = base_n_radix_key(key);
+    if (radix != 0) {
+        set_base_n_radix(calc, radix);
+        return true;
+    }
+    if (key == KEY_DOT) {
+        // Integers only
+        return true;
+    }
+    
+    for (size_t i = 0; i < sizeof(base_n_keys) / sizeof(base_n_keys[0]); i++) {
+        if (base_n_keys[i].key != key) {
+            continue;
+        }
+        const char *text = calc->mode.shift_mode ? base_n_keys[i].shifted : base_n_keys[i].text;
+        if (text[1] == '\0') {
+            append_char(calc, text[0]);
+            return true;
+        }
+        if (text[strlen(text) - 1] == '(' && strcmp(calc->input_buffer, "0") == 0) {
+            // A prefix operator replaces the 0 of a cleared input, as a digit does
+            calc->input_buffer[0] = '\0';
+            calc->input_pos = 0;
+            calc->new_number = false;
+        }
+        append_string(calc, text);
+        return true;
+    }
+    return false;
+}
+
+// ALPHA letters and separators, as printed on the keypad; each letter is
+// also the STO/RCL key of its variable where the evaluator has one
+static const struct {
+    key_code_t key;
+    char letter;
+} alpha_keys[] = {
+    { KEY_1, 'A' }, { KEY_2, 'B' }, { KEY_3, 'C' },
+    { KEY_4, 'D' }, { KEY_5, 'E' }, { KEY_6, 'F' },
+    { KEY_7, 'Y' }, { KEY_8, 'M' }, { KEY_ANS, 'X' },
+    // Separators of "x:y", "a:b:c", "MatA=1:2;3:4"
+    { KEY_EXP, ':' }, { KEY_DOT, ';' }, { KEY_EQUAL, '=' },
+};
+
+static char alpha_letter(key_code_t key)
+{
+    for (size_t i = 0; i < sizeof(alpha_keys) / sizeof(alpha_keys[0]); i++) {
+        if (alpha_keys[i].key == key) {
+            return alpha_keys[i].letter;
+        }
+    }
+    return '\0';
+}
+
+// Memory slot of a variable letter, NULL for E and F (BASE-N digits only)
+static double *variable_slot(calculator_t *calc, char letter)
+{
+    switch (letter) {
+        case 'A': return &calc->memory.a;
+        case 'B': return &calc->memory.b;
+        case 'C': return &calc->memory.c;
+        case 'D': return &calc->memory.d;
+        case 'X': return &calc->memory.x;
+        case 'Y': return &calc->memory.y;
+        case 'M': return &calc->memory.m;
+        default: return NULL;
+    }
+}
+
+// Handle the key after ALPHA; false if it has no letter or separator
+static bool handle_alpha_key(calculator_t *calc, key_code_t key)
+{
+    char letter = alpha_letter(key);
+    if (letter == '\0') {
+        return false;
+    }
+    append_char(calc, letter);
+    return true;
+}
+
+// Handle the key after STO or RCL. STO evaluates the input if it has not
+// been and stores the result; RCL evaluates the variable alone. Any key
+// without a variable cancels.
+static void handle_variable_key(calculator_t *calc, key_code_t key)
+{
+    bool store = calc->mode.store_mode;
+    calc->mode.store_mode = false;
+    calc->mode.recall_mode = false;
+    
+    char letter = alpha_letter(key);
+    double *slot = variable_slot(calc, letter);
+    if (slot == NULL) {
+        return;
+    }
+    
+    if (!store && calc->mode.base_n_mode) {
+        // A-F are digits to the BASE-N lexer; recall the slot itself,
+        // truncated to an integer and reduced to the word
+        calculator_clear(calc);
+        calc->input_buffer[0] = letter;
+        if (!(fabs(*slot) < 0x1p63)) {
+            calculator_set_error(calc, error_message(ERR_OVERFLOW));
+            return;
+        }
+        show_base_n_result(calc, base_n_wrap((uint64_t)(int64_t)*slot,
+                                             calc->mode.base_n_bits));
+        LOG_INF("Recalled %c = %s", letter, calc->result_buffer);
+        return;
+    }
+    if (!store) {
+        calculator_clear(calc);
+        calc->input_buffer[0] = letter;
+        calculator_execute(calc);
+        return;
+    }
+    if (calc->state == STATE_INPUT_NORMAL && strcmp(calc->input_buffer, "0") == 0) {
+        // calculator_execute() leaves the cleared input alone
+        show_result(calc, 0.0);
+    } else if (calc->state == STATE_INPUT_NORMAL) {
+        calculator_execute(calc);
+    }
+    if (calc->state == STATE_SHOW_RESULT) {
+        *slot = calc->memory.ans;
+        LOG_INF("Stored %s in %c", calc->result_buffer, letter);
+    }
+}
+
+void calculator_integrate(calculator_t *calc)
+{
+    // The cleared input is not an expression the user typed
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        return;
+    }
+    
+    sync_eval_context(calc);
+    calc->state = STATE_INTEGRAL_MODE;
+    
+    integration_result_t result;
+    int64_t start = k_uptime_get();
+    int status = integrate_expression(calc->input_buffer, &calc->eval_context,
+                                      calc->memory.a, calc->memory.b, NULL, &result);
+    int64_t elapsed_ms = k_uptime_get() - start;
+    
+    LOG_INF("Integral of %s over [%g, %g]: %d evaluations (%s, %d subdivisions) in %lld ms, %lld evals/s",
+            calc->input_buffer, calc->memory.a, calc->memory.b, result.evaluations,
+            result.method == INTEGRATION_TANH_SINH ? "tanh-sinh" : "Gauss-Kronrod",
+            result.subdivisions, (long long)elapsed_ms,
+            elapsed_ms > 0 ? (long long)result.evaluations * 1000 / elapsed_ms : 0LL);
+    
+    if (status == 0) {
+        show_result(calc, result.value);
+    } else {
+        calculator_set_error(calc, error_message(status));
+    }
+}
+
+void calculator_differentiate(calculator_t *calc)
+{
+    // The cleared input is not an expression the user typed
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        return;
+    }
+    
+    sync_eval_context(calc);
+    calc->state = STATE_DIFFERENTIAL_MODE;
+    
+    diff_result_t result;
+    int status = differentiate_expression(calc->input_buffer, &calc->eval_context,
+                                          calc->memory.x, &result);
+    
+    LOG_INF("d/dX %s at X=%g: %d evaluations, error estimate %g",
+            calc->input_buffer, calc->memory.x, result.evaluations, result.error_estimate);
+    
+    if (status == 0) {
+        show_result(calc, result.value);
+    } else {
+        calculator_set_error(calc, error_message(status));
+    }
+}
+
+void calculator_solve(calculator_t *calc)
+{
+    // The cleared input is not an expression the user typed
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        return;
+    }
+    
+    sync_eval_context(calc);
+    calc->state = STATE_SOLVE_MODE;
+    
+    // Bounded in wall-clock time as well, so a hard equation cannot stall the keypad
+    solver_config_t config;
+    solver_config_default(&config);
+    config.uptime_ms = k_uptime_get;
+    
+    solver_result_t result;
+    int status = solve_expression(calc->input_buffer, &calc->eval_context,
+                                  calc->memory.x, &config, &result);
+    
+    LOG_INF("Solve %s from X=%g: X=%g, L-R=%g, %d iterations, %d evaluations",
+            calc->input_buffer, calc->memory.x, result.root, result.residual,
+            result.iterations, result.evaluations);
+    
+    if (status == 0) {
+        calc->memory.x = result.root;
+        show_result(calc, result.root);
+    } else if (status == ERR_NO_CONVERGENCE) {
+        calculator_set_error(calc, result.out_of_budget ? "Time Out" : "Can't Solve");
+    } else {
+        calculator_set_error(calc, error_message(status));
+    }
+}
+
+void calculator_table(calculator_t *calc)
+{
+    // The cleared input is not an expression the user typed
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        return;
+    }
+    
+    sync_eval_context(calc);
+    
+    // "f:g" gives a second column
+    char f[sizeof(calc->input_buffer)];
+    strcpy(f, calc->input_buffer);
+    char *g = strchr(f, ':');
+    if (g != NULL) {
+        *g++ = '\0';
+    }
+    
+    double step = calc->memory.c != 0.0 ? calc->memory.c : 1.0;
+    int status = table_init(&table, f, g, &calc->eval_context,
+                            calc->memory.a, calc->memory.b, step);
+    if (status != 0) {
+        calculator_set_error(calc, error_message(status));
+        return;
+    }
+    
+    calc->table_top_row = 0;
+    calc->table_rows = table_row_count(&table);
+    calc->table_has_g = g != NULL;
+    calc->state = STATE_TABLE_MODE;
+    LOG_INF("Table of %s from %g to %g step %g: %d rows",
+            calc->input_buffer, calc->memory.a, calc->memory.b, step, calc->table_rows);
+}
+
+static void format_table_cell(double value, char *buffer, size_t size)
+{
+    if (isnan(value)) {
+        snprintf(buffer, size, "ERROR");
+    } else {
+        snprintf(buffer, size, "%.6g", value);
+    }
+}
+
+bool calculator_format_table_row(calculator_t *calc, int index, char *buffer, size_t size)
+{
+    if (calc->state != STATE_TABLE_MODE) {
+        return false;
+    }
+    
+    const table_row_t *row = table_get_row(&table, index);
+    if (row == NULL) {
+        return false;
+    }
+    
+    char x[16], fx[16], gx[16];
+    format_table_cell(row->x, x, sizeof(x));
+    format_table_cell(row->fx, fx, sizeof(fx));
+    if (calc->table_has_g) {
+        format_table_cell(row->gx, gx, sizeof(gx));
+        snprintf(buffer, size, "%-12s %-12s %s", x, fx, gx);
+    } else {
+        snprintf(buffer, size, "%-12s %s", x, fx);
+    }
+    return true;
+}
+
+// Scroll a list view with 8/2 (one line) and 9/3 (one page), keeping a
+// full screen of lines where possible; returns false for other keys
+static bool scroll_list(int *top, int count, key_code_t key)
+{
+    int delta;
+    
+    switch (key) {
+        case KEY_2: delta = 1; break;
+        case KEY_8: delta = -1; break;
+        case KEY_3: delta = CALC_LIST_VISIBLE_ROWS; break;
+        case KEY_9: delta = -CALC_LIST_VISIBLE_ROWS; break;
+        default: return false;
+    }
+    
+    int new_top = *top + delta;
+    if (new_top > count - CALC_LIST_VISIBLE_ROWS) {
+        new_top = count - CALC_LIST_VISIBLE_ROWS;
+    }
+    if (new_top < 0) {
+        new_top = 0;
+    }
+    *top = new_top;
+    return true;
+}
+
+// Handle table mode
+static void handle_table_input(calculator_t *calc, key_code_t key)
+{
+    if (scroll_list(&calc->table_top_row, calc->table_rows, key)) {
+        return;
+    }
+    if (key == KEY_CLEAR || key == KEY_ON_AC) {
+        // Back to the expression for editing
+        calc->state = STATE_INPUT_NORMAL;
+    }
+}
+
+static const char *const stat_line_names[] = {
+    "n", "mean x", "sum x", "sum x2", "pop sd x", "sd x", "min x", "max x",
+    "Q1", "med", "Q3",
+    "mean y", "sum y", "sum y2", "pop sd y", "sd y", "min y", "max y", "sum xy"
+};
+
+#define STAT_ONE_VAR_LINES  11
+#define STAT_QUARTILE_LINE  8
+#define STAT_TWO_VAR_LINES  (int)(sizeof(stat_line_names) / sizeof(stat_line_names[0]))
+
+#define REGRESSION_MAX_LINES 6
+
+// Regression lines for the selected model: coefficients, r, then ŷ at X
+// and x̂ at Y; NAN where the model cannot be fitted or predicted
+static int regression_lines(calculator_t *calc, const char **names, double *values)
+{
+    regression_fit_t fit;
+    bool fitted = regression_fit(&stats.regression, calc->stat_model, &fit) == 0;
+    bool quadratic = calc->stat_model == REG_QUADRATIC;
+    double x1 = NAN, x2 = NAN;
+    int count = 0;
+    
+    if (fitted && regression_predict_x(&fit, calc->memory.y, &x1, &x2) != 0) {
+        x1 = x2 = NAN;
+    }
+    
+    names[count] = "a";
+    values[count++] = fitted ? fit.a : NAN;
+    names[count] = "b";
+    values[count++] = fitted ? fit.b : NAN;
+    if (quadratic) {
+        names[count] = "c";
+        values[count++] = fitted ? fit.c : NAN;
+    } else {
+        names[count] = "r";
+        values[count++] = fitted ? fit.r : NAN;
+    }
+    names[count] = "y^(X)";
+    values[count++] = fitted ? regression_predict_y(&fit, calc->memory.x) : NAN;
+    names[count] = quadratic ? "x1^(Y)" : "x^(Y)";
+    values[count++] = x1;
+    if (quadratic) {
+        names[count] = "x2^(Y)";
+        values[count++] = x2;
+    }
+    return count;
+}
+
+// Lines in the statistics view: the summary, then for two-variable data
+// the model name and its regression lines
+static int stat_line_count(calculator_t *calc)
+{
+    if (stats.n == 0.0) {
+        return 1;
+    }
+    if (!calc->stat_two_var) {
+        return STAT_ONE_VAR_LINES;
+    }
+    
+    const char *names[REGRESSION_MAX_LINES];
+    double values[REGRESSION_MAX_LINES];
+    return STAT_TWO_VAR_LINES + 1 + regression_lines(calc, names, values);
+}
+
+// Show the statistics view from its first line
+static void open_stat_view(calculator_t *calc)
+{
+    calc->stat_top_line = 0;
+    calc->stat_lines = stat_line_count(calc);
+    calc->state = STATE_STAT_MODE;
+}
+
+void calculator_stat(calculator_t *calc, bool remove)
+{
+    // The cleared input just opens the view
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        open_stat_view(calc);
+        return;
+    }
+    
+    sync_eval_context(calc);
+    
+    // "x:y" is a two-variable sample
+    char x_expr[sizeof(calc->input_buffer)];
+    strcpy(x_expr, calc->input_buffer);
+    char *y_expr = strchr(x_expr, ':');
+    if (y_expr != NULL) {
+        *y_expr++ = '\0';
+    }
+    bool two_var = y_expr != NULL;
+    
+    // One- and two-variable samples cannot be mixed in one data set
+    if (stats.n > 0.0 && two_var != calc->stat_two_var) {
+        calculator_set_error(calc, error_message(ERR_SYNTAX_ERROR));
+        return;
+    }
+    
+    double x, y = 0.0;
+    int status = evaluate_expression(x_expr, &calc->eval_context, &x);
+    if (status == 0 && two_var) {
+        status = evaluate_expression(y_expr, &calc->eval_context, &y);
+    }
+    if (status == 0) {
+        status = remove ? stat_remove(&stats, x, y, 1.0) : stat_add(&stats, x, y, 1.0);
+    }
+    if (status != 0) {
+        calculator_set_error(calc, error_message(status));
+        return;
+    }
+    
+    calc->stat_two_var = two_var;
+    LOG_INF("STAT %s (%g, %g): n=%g", remove ? "remove" : "add", x, y, stats.n);
+    open_stat_view(calc);
+}
+
+static void format_stat_value(const char *name, double value, char *buffer, size_t size)
+{
+    if (isnan(value)) {
+        snprintf(buffer, size, "%-9s = ---", name);
+    } else {
+        snprintf(buffer, size, "%-9s = %.10g", name, value);
+    }
+}
+
+bool calculator_format_stat_line(calculator_t *calc, int index, char *buffer, size_t size)
+{
+    if (calc->state != STATE_STAT_MODE || index < 0 || index >= calc->stat_lines) {
+        return false;
+    }
+    
+    if (index == STAT_TWO_VAR_LINES) {
+        snprintf(buffer, size, "%-9s = %s  (4/6)", "model", regression_model_name(calc->stat_model));
+        return true;
+    }
+    if (index > STAT_TWO_VAR_LINES) {
+        const char *names[REGRESSION_MAX_LINES];
+        double values[REGRESSION_MAX_LINES];
+        regression_lines(calc, names, values);
+        index -= STAT_TWO_VAR_LINES + 1;
+        format_stat_value(names[index], values[index], buffer, size);
+        return true;
+    }
+    
+    stat_summary_t summary;
+    stat_get_summary(&stats, &summary);
+    
+    quantile_summary_t quartiles = { .q1 = NAN, .median = NAN, .q3 = NAN, .exact = true };
+    if (index >= STAT_QUARTILE_LINE && index < STAT_QUARTILE_LINE + 3) {
+        quantile_get(&stats.quantiles, &quartiles);
+    }
+    
+    // Same order as stat_line_names
+    const double values[] = {
+        summary.n, summary.mean_x, summary.sum_x, summary.sum_x2,
+        summary.pop_sd_x, summary.sample_sd_x, summary.min_x, summary.max_x,
+        quartiles.q1, quartiles.median, quartiles.q3,
+        summary.mean_y, summary.sum_y, summary.sum_y2,
+        summary.pop_sd_y, summary.sample_sd_y, summary.min_y, summary.max_y,
+        summary.sum_xy
+    };
+    
+    format_stat_value(stat_line_names[index], values[index], buffer, size);
+    if (!quartiles.exact) {
+        // Estimated past the exact column's capacity
+        char *equals = strchr(buffer, '=');
+        if (equals != NULL) {
+            *equals = '~';
+        }
+    }
+    return true;
+}
+
+// Handle statistics view: 4/6 select the regression model, SHIFT+AC
+// clears the data, AC returns to input
+static void handle_stat_input(calculator_t *calc, key_code_t key)
+{
+    if (scroll_list(&calc->stat_top_line, calc->stat_lines, key)) {
+        return;
+    }
+    if ((key == KEY_4 || key == KEY_6) && calc->stat_two_var) {
+        // Every model comes from the same moment sums, so switching is O(1)
+        int step = key == KEY_6 ? 1 : REG_MODEL_COUNT - 1;
+        calc->stat_model = (regression_model_t)((calc->stat_model + step) % REG_MODEL_COUNT);
+        calc->stat_lines = stat_line_count(calc);
+        return;
+    }
+    if (key == KEY_CLEAR || key == KEY_ON_AC) {
+        if (calc->mode.shift_mode) {
+            stat_reset(&stats);
+            LOG_INF("STAT data cleared");
+        }
+        calculator_clear(calc);
+    }
+}
+
+// Show a matrix from its first column
+static void open_matrix_view(calculator_t *calc, matrix_name_t name)
+{
+    calc->matrix_shown = name;
+    calc->matrix_left_col = 0;
+    calc->state = STATE_MATRIX_MODE;
+}
+
+// Parse "MatA" ... "MatD" or "MatAns" at *text, advancing past it
+static bool parse_matrix_name(const char **text, matrix_name_t *name)
+{
+    const char *p = *text;
+    if (strncmp(p, "Mat", 3) != 0) {
+        return false;
+    }
+    p += 3;
+    if (strncmp(p, "Ans", 3) == 0) {
+        *name = MATRIX_ANS;
+        p += 3;
+    } else if (*p >= 'A' && *p <= 'D') {
+        *name = (matrix_name_t)(MATRIX_A + (*p - 'A'));
+        p++;
+    } else {
+        return false;
+    }
+    *text = p;
+    return true;
+}
+
+// Match exactly "function(MatX)"
+static bool parse_matrix_call(const char *text, const char *function, matrix_name_t *name)
+{
+    size_t length = strlen(function);
+    if (strncmp(text, function, length) != 0 || text[length] != '(') {
+        return false;
+    }
+    text += length + 1;
+    return parse_matrix_name(&text, name) && strcmp(text, ")") == 0;
+}
+
+// Evaluate "e11:e12;e21:e22" into a matrix; every row needs the same
+// number of elements
+static int parse_matrix_elements(calculator_t *calc, char *elements, matrix_t *m)
+{
+    int rows = 0, cols = 0;
+    char *row = elements;
+    
+    while (row != NULL) {
+        char *next_row = strchr(row, ';');
+        if (next_row != NULL) {
+            *next_row++ = '\0';
+        }
+        if (rows == MATRIX_MAX_DIM) {
+            return ERR_DIMENSION;
+        }
+        
+        int col = 0;
+        char *element = row;
+        while (element != NULL) {
+            char *next = strchr(element, ':');
+            if (next != NULL) {
+                *next++ = '\0';
+            }
+            if (col == MATRIX_MAX_DIM || (rows > 0 && col == cols)) {
+                return ERR_DIMENSION;
+            }
+            double value;
+            int status = evaluate_expression(element, &calc->eval_context, &value);
+            if (status != 0) {
+                return status;
+            }
+            // cols is still 0 while the first row is read, which is
+            // where its elements go anyway
+            m->data[rows * cols + col++] = value;
+            element = next;
+        }
+        if (rows == 0) {
+            cols = col;
+        } else if (col != cols) {
+            return ERR_DIMENSION;
+        }
+        rows++;
+        row = next_row;
+    }
+    
+    m->rows = (uint8_t)rows;
+    m->cols = (uint8_t)cols;
+    return 0;
+}
+
+// Eigenvalues into MatAns as a column, with a second column of imaginary
+// parts if any are complex; or the eigenvectors as its columns
+static int run_eigen_command(calculator_t *calc, const matrix_t *a, bool vectors)
+{
+    eigen_result_t *eigen = &decomposition.eigen;
+    bool symmetric = eigen_is_symmetric(a);
+    int status = symmetric ? eigen_symmetric(a, eigen) : eigen_general(a, eigen);
+    if (status != 0) {
+        return status;
+    }
+    LOG_INF("Eigen %s: %d %s", symmetric ? "Jacobi" : "QR", eigen->iterations,
+            symmetric ? "sweeps" : "steps");
+    
+    matrix_t *ans = &matrices[MATRIX_ANS];
+    int n = eigen->n;
+    if (vectors) {
+        *ans = eigen->vectors;
+    } else {
+        bool complex = false;
+        for (int i = 0; i < n; i++) {
+            complex |= eigen->imag[i] != 0.0;
+        }
+        matrix_init(ans, n, complex ? 2 : 1);
+        for (int i = 0; i < n; i++) {
+            matrix_set(ans, i, 0, eigen->real[i]);
+            if (complex) {
+                matrix_set(ans, i, 1, eigen->imag[i]);
+            }
+        }
+    }
+    open_matrix_view(calc, MATRIX_ANS);
+    return 0;
+}
+
+// Singular values into MatAns as a column
+static int run_svd_command(calculator_t *calc, const matrix_t *a)
+{
+    svd_result_t *svd = &decomposition.svd;
+    int status = svd_jacobi(a, svd);
+    if (status != 0) {
+        return status;
+    }
+    LOG_INF("SVD: %d sweeps", svd->sweeps);
+    
+    matrix_t *ans = &matrices[MATRIX_ANS];
+    matrix_init(ans, svd->k, 1);
+    for (int i = 0; i < svd->k; i++) {
+        matrix_set(ans, i, 0, svd->values[i]);
+    }
+    open_matrix_view(calc, MATRIX_ANS);
+    return 0;
+}
+
+static int run_matrix_command(calculator_t *calc, char *command)
+{
+    matrix_name_t a, b;
+    matrix_t result;
+    int status;
+    
+    if (parse_matrix_call(command, "det", &a)) {
+        double det;
+        status = matrix_determinant(&matrices[a], &det);
+        if (status == 0) {
+            show_result(calc, det);
+        }
+        return status;
+    }
+    
+    if (parse_matrix_call(command, "eig", &a) || parse_matrix_call(command, "eigv", &a)) {
+        return run_eigen_command(calc, &matrices[a], command[3] == 'v');
+    }
+    if (parse_matrix_call(command, "svd", &a)) {
+        return run_svd_command(calc, &matrices[a]);
+    }
+    if (parse_matrix_call(command, "trn", &a)) {
+        status = matrix_transpose(&matrices[a], &result);
+    } else if (parse_matrix_call(command, "inv", &a)) {
+        status = matrix_inverse(&matrices[a], &result);
+    } else {
+        const char *p = command;
+        if (!parse_matrix_name(&p, &a)) {
+            return ERR_SYNTAX_ERROR;
+        }
+        if (*p == '\0') {
+            open_matrix_view(calc, a);
+            return 0;
+        }
+        if (*p == '=' && a != MATRIX_ANS) {
+            status = parse_matrix_elements(calc, strchr(command, '=') + 1, &result);
+            if (status == 0) {
+                matrices[a] = result;
+                open_matrix_view(calc, a);
+            }
+            return status;
+        }
+        
+        char op = *p++;
+        if (!parse_matrix_name(&p, &b) || *p != '\0') {
+            return ERR_SYNTAX_ERROR;
+        }
+        switch (op) {
+            case '+': status = matrix_add(&matrices[a], &matrices[b], &result); break;
+            case '-': status = matrix_subtract(&matrices[a], &matrices[b], &result); break;
+            case '*': status = matrix_multiply(&matrices[a], &matrices[b], &result); break;
+            default: return ERR_SYNTAX_ERROR;
+        }
+    }
+    
+    // MatAns is only replaced by a successful result
+    if (status == 0) {
+        matrices[MATRIX_ANS] = result;
+        open_matrix_view(calc, MATRIX_ANS);
+    }
+    return status;
+}
+
+void calculator_matrix(calculator_t *calc)
+{
+    // The cleared input just opens the view
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        open_matrix_view(calc, calc->matrix_shown);
+        return;
+    }
+    
+    sync_eval_context(calc);
+    
+    char command[sizeof(calc->input_buffer)];
+    strcpy(command, calc->input_buffer);
+    int status = run_matrix_command(calc, command);
+    if (status != 0) {
+        calculator_set_error(calc, error_message(status));
+        return;
+    }
+    LOG_INF("Matrix command %s", calc->input_buffer);
+}
+
+const matrix_t *calculator_shown_matrix(calculator_t *calc)
+{
+    return &matrices[calc->matrix_shown];
+}
+
+bool calculator_format_matrix_row(calculator_t *calc, int row, char *buffer, size_t size)
 {
-    memset(calc->input_buffer, 0, sizeof(calc->input_buffer));
-    strcpy(calc->input_buffer, "0");
-    calc->input_pos = 1;
-    calc->cursor_pos = 1;
-    calc->new_number = true;
-    calc->calculation_done = false;
-    calc->error_state = false;
-    calc->state = STATE_INPUT_NORMAL;
-    memset(calc->result_buffer, 0, sizeof(calc->result_buffer));
-    memset(calc->error_buffer, 0, sizeof(calc->error_buffer));
+    const matrix_t *m = &matrices[calc->matrix_shown];
+    if (calc->state != STATE_MATRIX_MODE || row < 0 || row >= m->rows) {
+        return false;
+    }
+    
+    size_t used = 0;
+    buffer[0] = '\0';
+    for (int col = calc->matrix_left_col;
+         col < m->cols && col < calc->matrix_left_col + CALC_MATRIX_VISIBLE_COLS && used < size;
+         col++) {
+        char cell[16];
+        format_table_cell(matrix_get(m, row, col), cell, sizeof(cell));
+        used += snprintf(buffer + used, size - used, "%-12s ", cell);
+    }
+    return true;
 }
 
-void calculator_clear_memory(calculator_t *calc)
+// Handle matrix view: 8/2 step through the matrices, 4/6 scroll the
+// columns, AC returns to input
+static void handle_matrix_input(calculator_t *calc, key_code_t key)
 {
-    memset(&calc->memory, 0, sizeof(calc->memory));
-    memset(&calc->eval_context.variables, 0, sizeof(calc->eval_context.variables));
-    LOG_INF("All memory cleared");
+    const matrix_t *m = &matrices[calc->matrix_shown];
+    
+    switch (key) {
+        case KEY_2:
+        case KEY_8: {
+            int step = key == KEY_2 ? 1 : MATRIX_COUNT - 1;
+            calc->matrix_shown = (matrix_name_t)((calc->matrix_shown + step) % MATRIX_COUNT);
+            calc->matrix_left_col = 0;
+            break;
+        }
+        case KEY_6:
+            if (calc->matrix_left_col + CALC_MATRIX_VISIBLE_COLS < m->cols) {
+                calc->matrix_left_col++;
+            }
+            break;
+        case KEY_4:
+            if (calc->matrix_left_col > 0) {
+                calc->matrix_left_col--;
+            }
+            break;
+        case KEY_CLEAR:
+        case KEY_ON_AC:
+            // Back to the command for editing
+            calc->state = STATE_INPUT_NORMAL;
+            break;
+        default:
+            break;
+    }
 }
 
-void calculator_set_error(calculator_t *calc, const char *error_msg)
+// Show a vector
+static void open_vector_view(calculator_t *calc, vector_name_t name)
 {
-    strncpy(calc->error_buffer, error_msg, sizeof(calc->error_buffer) - 1);
-    calc->error_buffer[sizeof(calc->error_buffer) - 1] = '\0';
-    calc->state = STATE_SHOW_ERROR;
-    calc->error_state = true;
-    LOG_WRN("Calculator error: %s", error_msg);
+    calc->vector_shown = name;
+    calc->state = STATE_VECTOR_MODE;
 }
 
-static void append_char(calculator_t *calc, char ch)
+// Parse "VctA" ... "VctD" or "VctAns" at *text, advancing past it
+static bool parse_vector_name(const char **text, vector_name_t *name)
 {
-    if (calc->new_number) {
-        // Starting a new number, clear the display
-        calculator_clear(calc);
-        calc->new_number = false;
+    const char *p = *text;
+    if (strncmp(p, "Vct", 3) != 0) {
+        return false;
     }
-    
-    // Remove leading zero if we're entering the first digit
-    if (calc->input_pos == 1 && calc->input_buffer[0] == '0' && ch != '.') {
-        calc->input_buffer[0] = ch;
-        calc->cursor_pos = 1;
-        return;
+    p += 3;
+    if (strncmp(p, "Ans", 3) == 0) {
+        *name = VECTOR_ANS;
+        p += 3;
+    } else if (*p >= 'A' && *p <= 'D') {
+        *name = (vector_name_t)(VECTOR_A + (*p - 'A'));
+        p++;
+    } else {
+        return false;
     }
+    *text = p;
+    return true;
+}
+
+// Evaluate "x:y" or "x:y:z" into a vector
+static int parse_vector_components(calculator_t *calc, char *components, vector_t *v)
+{
+    int dim = 0;
+    char *component = components;
     
-    if (calc->input_pos < sizeof(calc->input_buffer) - 1) {
-        calc->input_buffer[calc->input_pos++] = ch;
-        calc->input_buffer[calc->input_pos] = '\0';
-        calc->cursor_pos = calc->input_pos;
+    while (component != NULL) {
+        char *next = strchr(component, ':');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        if (dim == VECTOR_MAX_DIM) {
+            return ERR_DIMENSION;
+        }
+        double value;
+        int status = evaluate_expression(component, &calc->eval_context, &value);
+        if (status != 0) {
+            return status;
+        }
+        v->v[dim++] = value;
+        component = next;
     }
+    if (dim < 2) {
+        return ERR_DIMENSION;
+    }
+    v->dim = (uint8_t)dim;
+    return 0;
 }
 
-static void append_string(calculator_t *calc, const char *str)
+static int run_vector_command(calculator_t *calc, char *command)
 {
-    if (calc->new_number && strcmp(str, "Ans") != 0) {
-        calculator_clear(calc);
-        calc->new_number = false;
+    vector_name_t name;
+    vector_t result;
+    const char *p = command;
+    int status;
+    
+    if (parse_vector_name(&p, &name)) {
+        if (*p == '\0') {
+            open_vector_view(calc, name);
+            return 0;
+        }
+        if (*p == '=' && name != VECTOR_ANS) {
+            status = parse_vector_components(calc, strchr(command, '=') + 1, &result);
+            if (status == 0) {
+                vectors[name] = result;
+                open_vector_view(calc, name);
+            }
+            return status;
+        }
     }
     
-    int len = strlen(str);
-    if (calc->input_pos + len < sizeof(calc->input_buffer) - 1) {
-        strcpy(&calc->input_buffer[calc->input_pos], str);
-        calc->input_pos += len;
-        calc->cursor_pos = calc->input_pos;
+    status = vector_evaluate_expression(command, &calc->eval_context, vectors, &result);
+    if (status != 0) {
+        return status;
+    }
+    if (result.dim == 1) {
+        show_result(calc, result.v[0]);
+    } else {
+        // VctAns is only replaced by a successful vector result
+        vectors[VECTOR_ANS] = result;
+        open_vector_view(calc, VECTOR_ANS);
     }
+    return 0;
 }
 
-static void append_operator(calculator_t *calc, char op)
+void calculator_vector(calculator_t *calc)
 {
-    // If we're showing a result, use it as the start of new expression
-    if (calc->state == STATE_SHOW_RESULT) {
-        snprintf(calc->input_buffer, sizeof(calc->input_buffer), 
-                 "%.10g%c", calc->memory.ans, op);
-        calc->input_pos = strlen(calc->input_buffer);
-        calc->cursor_pos = calc->input_pos;
-        calc->state = STATE_INPUT_NORMAL;
-        calc->new_number = false;
+    // The cleared input just opens the view
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        open_vector_view(calc, calc->vector_shown);
         return;
     }
     
-    // Don't allow operators at the beginning (except minus)
-    if (calc->input_pos == 0 && op != '-') {
+    sync_eval_context(calc);
+    
+    char command[sizeof(calc->input_buffer)];
+    strcpy(command, calc->input_buffer);
+    int status = run_vector_command(calc, command);
+    if (status != 0) {
+        calculator_set_error(calc, error_message(status));
         return;
     }
+    LOG_INF("Vector command %s", calc->input_buffer);
+}
+
+const vector_t *calculator_shown_vector(calculator_t *calc)
+{
+    return &vectors[calc->vector_shown];
+}
+
+bool calculator_format_vector_line(calculator_t *calc, int index, char *buffer, size_t size)
+{
+    static const char axis[VECTOR_MAX_DIM] = { 'x', 'y', 'z' };
+    const vector_t *v = &vectors[calc->vector_shown];
+    if (calc->state != STATE_VECTOR_MODE || index < 0 || index >= v->dim) {
+        return false;
+    }
     
-    // Replace last character if it's already an operator
-    if (calc->input_pos > 0) {
-        char last_char = calc->input_buffer[calc->input_pos - 1];
-        if (last_char == '+' || last_char == '-' || last_char == '*' || last_char == '/') {
-            calc->input_buffer[calc->input_pos - 1] = op;
-            calc->cursor_pos = calc->input_pos;
-            return;
+    char value[16];
+    format_table_cell(v->v[index], value, sizeof(value));
+    snprintf(buffer, size, "%c = %s", axis[index], value);
+    return true;
+}
+
+// Handle vector view: 8/2 step through the vectors, AC returns to input
+static void handle_vector_input(calculator_t *calc, key_code_t key)
+{
+    switch (key) {
+        case KEY_2:
+        case KEY_8: {
+            int step = key == KEY_2 ? 1 : VECTOR_COUNT - 1;
+            calc->vector_shown = (vector_name_t)((calc->vector_shown + step) % VECTOR_COUNT);
+            break;
         }
+        case KEY_CLEAR:
+        case KEY_ON_AC:
+            // Back to the command for editing
+            calc->state = STATE_INPUT_NORMAL;
+            break;
+        default:
+            break;
     }
+}
+
+// Evaluate "a:b:c[:d...]", highest power first, into coefficients;
+// returns the count
+static int parse_equation_coefficients(calculator_t *calc, char *text, double *coeffs)
+{
+    int count = 0;
+    char *coefficient = text;
     
-    if (calc->input_pos < sizeof(calc->input_buffer) - 1) {
-        calc->input_buffer[calc->input_pos++] = op;
-        calc->input_buffer[calc->input_pos] = '\0';
-        calc->cursor_pos = calc->input_pos;
+    while (coefficient != NULL) {
+        char *next = strchr(coefficient, ':');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        if (count == POLY_MAX_DEGREE + 1) {
+            return ERR_DIMENSION;
+        }
+        int status = evaluate_expression(coefficient, &calc->eval_context, &coeffs[count]);
+        if (status != 0) {
+            return status;
+        }
+        count++;
+        coefficient = next;
     }
-    calc->new_number = false;
+    return count < POLY_MIN_DEGREE + 1 ? ERR_DIMENSION : count;
 }
 
-static void backspace(calculator_t *calc)
+void calculator_equation(calculator_t *calc)
 {
-    if (calc->state == STATE_SHOW_RESULT || calc->state == STATE_SHOW_ERROR) {
-        // Return to input mode
-        calculator_clear(calc);
+    // The cleared input just opens the view on the last roots
+    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
+        calc->state = STATE_EQUATION_MODE;
         return;
     }
     
-    if (calc->input_pos > 1) {
-        calc->input_buffer[--calc->input_pos] = '\0';
-        calc->cursor_pos = calc->input_pos;
-    } else if (calc->input_pos == 1) {
-        // Replace with 0
-        calc->input_buffer[0] = '0';
-        calc->input_buffer[1] = '\0';
-        calc->cursor_pos = 1;
+    sync_eval_context(calc);
+    
+    char text[sizeof(calc->input_buffer)];
+    double coeffs[POLY_MAX_DEGREE + 1];
+    strcpy(text, calc->input_buffer);
+    int count = parse_equation_coefficients(calc, text, coeffs);
+    int status = count < 0 ? count : poly_solve(coeffs, count - 1, &equation);
+    if (status != 0) {
+        calculator_set_error(calc, error_message(status));
+        return;
     }
+    calc->state = STATE_EQUATION_MODE;
+    LOG_INF("Equation of degree %d solved in %d iterations", equation.degree, equation.iterations);
 }
 
-void calculator_execute(calculator_t *calc)
+const poly_roots_t *calculator_equation_roots(calculator_t *calc)
 {
-    if (strlen(calc->input_buffer) == 0 || strcmp(calc->input_buffer, "0") == 0) {
-        return;
+    (void)calc;
+    return &equation;
+}
+
+bool calculator_format_equation_line(calculator_t *calc, int index, char *buffer, size_t size)
+{
+    if (calc->state != STATE_EQUATION_MODE || index < 0 || index >= equation.degree) {
+        return false;
     }
     
-    // Update evaluation context with current variables
-    calc->eval_context.variables = (variable_storage_t){
-        .ans = calc->memory.ans,
-        .x = calc->memory.x, .y = calc->memory.y,
-        .a = calc->memory.a, .b = calc->memory.b,
-        .c = calc->memory.c, .d = calc->memory.d,
-        .m = calc->memory.m
-    };
-    calc->eval_context.deg_mode = calc->mode.deg_mode;
-    
-    double result;
-    int eval_result = evaluate_expression(calc->input_buffer, &calc->eval_context, &result);
+    char value[56];
+    format_complex(calc, equation.roots[index], value, sizeof(value));
+    snprintf(buffer, size, "x%d = %s", index + 1, value);
+    return true;
+}
+
+// Handle equation view: AC returns to the coefficients for editing
+static void handle_equation_input(calculator_t *calc, key_code_t key)
+{
+    if (key == KEY_CLEAR || key == KEY_ON_AC) {
+        calc->state = STATE_INPUT_NORMAL;
+    }
+}
+
+// Catalog entries, inserted as they read
+static const char *const matrix_catalog[] = {
+    "MatA", "MatB", "MatC", "MatD", "MatAns",
+    "det(", "trn(", "inv(", "eig(", "eigv(", "svd(",
+};
+
+static const char *const vector_catalog[] = {
+    "VctA", "VctB", "VctC", "VctD", "VctAns",
+    "dot(", "angle(", "unitV(", "abs(",
+};
+
+static const char *const complex_catalog[] = {
+    "i", "∠", "abs(", "arg(", "conj(",
+};
+
+static const struct {
+    const char *title;
+    const char *const *entries;
+    int count;
+} catalogs[] = {
+    [CATALOG_MATRIX] = { "MATRIX", matrix_catalog, sizeof(matrix_catalog) / sizeof(matrix_catalog[0]) },
+    [CATALOG_VECTOR] = { "VECTOR", vector_catalog, sizeof(vector_catalog) / sizeof(vector_catalog[0]) },
+    [CATALOG_COMPLEX] = { "CMPLX", complex_catalog, sizeof(complex_catalog) / sizeof(complex_catalog[0]) },
+};
+
+void calculator_catalog(calculator_t *calc, catalog_t catalog)
+{
+    calc->catalog = catalog;
+    calc->catalog_selection = 0;
+    calc->state = STATE_CATALOG_MODE;
+}
+
+const char *calculator_catalog_title(calculator_t *calc)
+{
+    return catalogs[calc->catalog].title;
+}
+
+bool calculator_format_catalog_line(calculator_t *calc, int index, char *buffer, size_t size)
+{
+    if (calc->state != STATE_CATALOG_MODE || index < 0 || index >= catalogs[calc->catalog].count) {
+        return false;
+    }
+    snprintf(buffer, size, "%s", catalogs[calc->catalog].entries[index]);
+    return true;
+}
+
+// Handle catalog view: 8/2 move the highlight, = inserts, AC cancels
+static void handle_catalog_input(calculator_t *calc, key_code_t key)
+{
+    int count = catalogs[calc->catalog].count;
     
-    if (eval_result == 0) {
-        // Success
-        calc->memory.ans = result;
-        calc->memory.has_ans = true;
-        
-        // Format result based on display mode
-        if (calc->mode.sci_mode) {
-            snprintf(calc->result_buffer, sizeof(calc->result_buffer), 
-                     "%.6e", result);
-        } else if (calc->mode.fix_mode) {
-            char format[16];
-            snprintf(format, sizeof(format), "%%.%df", calc->mode.decimal_places);
-            snprintf(calc->result_buffer, sizeof(calc->result_buffer), 
-                     format, result);
-        } else {
-            snprintf(calc->result_buffer, sizeof(calc->result_buffer), 
-                     "%.10g", result);
-        }
-        
-        calc->state = STATE_SHOW_RESULT;
-        calc->calculation_done = true;
-        calc->new_number = true;
-        
-        LOG_INF("Calculation: %s = %g", calc->input_buffer, result);
-    } else {
-        // Error
-        const char *error_msg;
-        switch (eval_result) {
-            case -1: error_msg = "Syntax Error"; break;
-            case -2: error_msg = "Math Error"; break;
-            case -3: error_msg = "Domain Error"; break;
-            case -4: error_msg = "Overflow"; break;
-            default: error_msg = "Error"; break;
-        }
-        calculator_set_error(calc, error_msg);
+    switch (key) {
+        case KEY_2:
+            calc->catalog_selection = (calc->catalog_selection + 1) % count;
+            break;
+        case KEY_8:
+            calc->catalog_selection = (calc->catalog_selection + count - 1) % count;
+            break;
+        case KEY_EQUAL:
+            calc->state = STATE_INPUT_NORMAL;
+            append_string(calc, catalogs[calc->catalog].entries[calc->catalog_selection]);
+            break;
+        case KEY_CLEAR:
+        case KEY_ON_AC:
+            calc->state = STATE_INPUT_NORMAL;
+            break;
+        default:
+            break;
     }
 }
 
 // Handle normal input state
 static void handle_normal_input(calculator_t *calc, key_code_t key)
 {
+    if (calc->mode.alpha_mode && handle_alpha_key(calc, key)) {
+        return;
+    }
+    if (calc->mode.base_n_mode && handle_base_n_key(calc, key)) {
+        return;
+    }
+    
     switch (key) {
         // Numbers
         case KEY_0: case KEY_1: case KEY_2: case KEY_3: case KEY_4:
@@ -241,12 +1590,18 @@ static void handle_normal_input(calculator_t *calc, key_code_t key)
             append_char(calc, '0' + (key - KEY_0));
             break;
             
-        case KEY_DOT:
-            // Don't allow multiple decimal points
-            if (strchr(calc->input_buffer, '.') == NULL) {
+        case KEY_DOT: {
+            // One decimal point per number; "1.5:2.5" has two
+            int start = calc->input_pos;
+            while (start > 0 && (isdigit((unsigned char)calc->input_buffer[start - 1]) ||
+                                 calc->input_buffer[start - 1] == '.')) {
+                start--;
+            }
+            if (memchr(&calc->input_buffer[start], '.', calc->input_pos - start) == NULL) {
                 append_char(calc, '.');
             }
             break;
+        }
             
         // Basic operators
         case KEY_PLUS:
@@ -306,7 +1661,28 @@ static void handle_normal_input(calculator_t *calc, key_code_t key)
                 append_string(calc, "sqrt(");
             }
             break;
-            
+        case KEY_FUNC:
+            // Standard normal distribution: P(X <= x) and its inverse
+            if (calc->mode.shift_mode) {
+                append_string(calc, "invnorm(");
+            } else {
+                append_string(calc, "normcd(");
+            }
+            break;
+        case KEY_OPTN:
+            if (calc->mode.complex_mode) {
+                calculator_catalog(calc, CATALOG_COMPLEX);
+            } else {
+                append_string(calc, "normpd(");
+            }
+            break;
+        case KEY_ENG:
+            // The imaginary unit, as on the fx-991ES in CMPLX mode
+            if (calc->mode.complex_mode) {
+                append_string(calc, "i");
+            }
+            break;
+
         // Constants
         case KEY_EXP:
             if (calc->mode.shift_mode) {
@@ -338,6 +1714,44 @@ static void handle_normal_input(calculator_t *calc, key_code_t key)
         case KEY_EQUAL:
             calculator_execute(calc);
             break;
+        case KEY_INTEGRATE:
+            calculator_integrate(calc);
+            break;
+        case KEY_DIFF:
+            calculator_differentiate(calc);
+            break;
+        case KEY_SOLVE:
+            calculator_solve(calc);
+            break;
+        case KEY_TABLE:
+            calculator_table(calc);
+            break;
+        case KEY_STAT:
+            calculator_stat(calc, calc->mode.shift_mode);
+            break;
+        case KEY_MATRIX:
+            if (calc->mode.shift_mode) {
+                calculator_catalog(calc, CATALOG_MATRIX);
+            } else {
+                calculator_matrix(calc);
+            }
+            break;
+        case KEY_VECTOR:
+            if (calc->mode.shift_mode) {
+                calculator_catalog(calc, CATALOG_VECTOR);
+            } else {
+                calculator_vector(calc);
+            }
+            break;
+        case KEY_CMPLX:
+            calculator_complex(calc, calc->mode.shift_mode);
+            break;
+        case KEY_BASE_N:
+            calculator_base_n(calc, calc->mode.shift_mode);
+            break;
+        case KEY_EQUATION:
+            calculator_equation(calc);
+            break;
             
         // Clear and backspace
         case KEY_CLEAR:
@@ -381,6 +1795,25 @@ void calculator_update_state(calculator_t *calc, key_code_t key)
         return;
     }
     
+    // STO (SHIFT+RCL) and RCL take the next key as the variable
+    if ((calc->mode.store_mode || calc->mode.recall_mode) && key != KEY_NONE) {
+        handle_variable_key(calc, key);
+        calc->mode.shift_mode = false;
+        calc->mode.alpha_mode = false;
+        return;
+    }
+    if ((key == KEY_STO || key == KEY_RCL) &&
+        (calc->state == STATE_INPUT_NORMAL || calc->state == STATE_SHOW_RESULT)) {
+        if (key == KEY_STO || calc->mode.shift_mode) {
+            calc->mode.store_mode = true;
+        } else {
+            calc->mode.recall_mode = true;
+        }
+        calc->mode.shift_mode = false;
+        calc->mode.alpha_mode = false;
+        return;
+    }
+    
     // Handle state-specific keys
     switch (calc->state) {
         case STATE_INPUT_NORMAL:
@@ -398,10 +1831,25 @@ void calculator_update_state(calculator_t *calc, key_code_t key)
                 calculator_clear(calc);
                 calc->state = STATE_INPUT_NORMAL;
                 handle_normal_input(calc, key);
-            } else if (key == KEY_PLUS || key == KEY_MINUS || key == KEY_MULTIPLY || key == KEY_DIVIDE) {
-                // Operator keys continue with the result
-                snprintf(calc->input_buffer, sizeof(calc->input_buffer), 
-                         "%.10g", calc->memory.ans);
+            } else if (key == KEY_CMPLX) {
+                // Switching the form redraws the result in place
+                calculator_complex(calc, calc->mode.shift_mode);
+            } else if (key == KEY_BASE_N) {
+                calculator_base_n(calc, calc->mode.shift_mode);
+            } else if (calc->mode.base_n_mode && base_n_radix_key(key) != 0) {
+                // So does a new radix
+                set_base_n_radix(calc, base_n_radix_key(key));
+            } else if (key == KEY_PLUS || key == KEY_MINUS || key == KEY_MULTIPLY || key == KEY_DIVIDE ||
+                       (calc->mode.base_n_mode && is_base_n_operator_key(key))) {
+                // Operator keys continue with the result; a complex one
+                // only fits in the input as Ans, and a BASE-N one is
+                // exact only as Ans
+                if (calc->mode.complex_mode || calc->mode.base_n_mode) {
+                    strcpy(calc->input_buffer, "Ans");
+                } else {
+                    snprintf(calc->input_buffer, sizeof(calc->input_buffer), 
+                             "%.10g", calc->memory.ans);
+                }
                 calc->input_pos = strlen(calc->input_buffer);
                 calc->cursor_pos = calc->input_pos;
                 calc->state = STATE_INPUT_NORMAL;
@@ -434,6 +1882,30 @@ void calculator_update_state(calculator_t *calc, key_code_t key)
             }
             break;
             
+        case STATE_TABLE_MODE:
+            handle_table_input(calc, key);
+            break;
+            
+        case STATE_STAT_MODE:
+            handle_stat_input(calc, key);
+            break;
+            
+        case STATE_MATRIX_MODE:
+            handle_matrix_input(calc, key);
+            break;
+            
+        case STATE_VECTOR_MODE:
+            handle_vector_input(calc, key);
+            break;
+            
+        case STATE_EQUATION_MODE:
+            handle_equation_input(calc, key);
+            break;
+            
+        case STATE_CATALOG_MODE:
+            handle_catalog_input(calc, key);
+            break;
+            
         case STATE_MENU_MODE:
             // Handle menu navigation
             // TODO: Implement menu selection logic
@@ -447,8 +1919,10 @@ void calculator_update_state(calculator_t *calc, key_code_t key)
             break;
     }
     
-    // Clear mode flags after processing (except for SHIFT/ALPHA keys)
-    if (key != KEY_SHIFT && key != KEY_ALPHA && key != KEY_MODE) {
+    // Clear mode flags after processing (except for SHIFT/ALPHA keys and
+    // the idle KEY_NONE of every frame, which would clear them before the
+    // key they modify arrives)
+    if (key != KEY_SHIFT && key != KEY_ALPHA && key != KEY_MODE && key != KEY_NONE) {
         if (calc->mode.shift_mode || calc->mode.alpha_mode) {
             calc->mode.shift_mode = false;
             calc->mode.alpha_mode = false;
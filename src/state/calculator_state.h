@@ -11,9 +11,18 @@
 
 #include "../keypad_handler.h"
 #include "../math/expression_evaluator.h"
+#include "../math/base_n.h"
+#include "../math/complex_number.h"
+#include "../math/matrix.h"
+#include "../math/polynomial.h"
+#include "../math/vector.h"
+#include "../math/regression.h"
 #include <stdint.h>
 #include <stdbool.h>
 
+#define CALC_LIST_VISIBLE_ROWS  9   // TABLE rows or STAT lines on screen at once
+#define CALC_MATRIX_VISIBLE_COLS 3  // MATRIX columns on screen at once
+
 /**
  * @brief Calculator states
  */
@@ -32,17 +41,33 @@ typedef enum {
     STATE_TABLE_MODE,       // Table calculation mode
     STATE_EQUATION_MODE,    // Equation mode
     STATE_INTEGRAL_MODE,    // Integration mode
-    STATE_DIFFERENTIAL_MODE // Differentiation mode
+    STATE_DIFFERENTIAL_MODE,// Differentiation mode
+    STATE_CATALOG_MODE      // Name and function list to insert from
 } calculator_state_t;
 
+/**
+ * @brief Insert lists of the MATRIX, VECTOR and CMPLX names and functions
+ */
+typedef enum {
+    CATALOG_MATRIX,         // SHIFT+MATRIX
+    CATALOG_VECTOR,         // SHIFT+VECTOR
+    CATALOG_COMPLEX         // OPTN in CMPLX mode
+} catalog_t;
+
 /**
  * @brief Calculator mode flags
  */
 typedef struct {
     bool shift_mode;        // SHIFT key active
     bool alpha_mode;        // ALPHA key active  
+    bool store_mode;        // STO pressed, the next key names the variable
+    bool recall_mode;       // RCL pressed, the next key names the variable
     bool deg_mode;          // Degree mode (vs radians)
     bool complex_mode;      // Complex number mode
+    bool polar_form;        // Complex results as r∠θ rather than a+bi
+    bool base_n_mode;       // BASE-N integer mode
+    base_n_radix_t base_n_radix;    // BASE-N display and literal radix
+    uint8_t base_n_bits;    // BASE-N word size: 8, 16, 32 or 64
     bool stat_mode;         // Statistics mode
     bool fix_mode;          // Fixed decimal places
     bool sci_mode;          // Scientific notation
@@ -73,7 +98,7 @@ typedef struct {
     char input_buffer[128];         // User input expression
     int input_pos;                  // Current position in input buffer
     int cursor_pos;                 // Cursor position for editing
-    char result_buffer[64];         // Calculation result display
+    char result_buffer[72];         // Calculation result display, up to 64 BIN digits
     char error_buffer[64];          // Error message display
     char status_buffer[32];         // Status line (COMP, STAT, etc.)
     
@@ -89,6 +114,28 @@ typedef struct {
     int menu_selection;             // Current menu selection
     int setup_selection;            // Current setup selection
     
+    // Table mode view; the rows themselves live in the state module
+    int table_top_row;              // First row on screen
+    int table_rows;                 // Rows in the table
+    bool table_has_g;               // Second function column present
+    
+    // STAT mode view; the accumulators live in the state module
+    int stat_top_line;              // First summary line on screen
+    int stat_lines;                 // Summary lines for the current data
+    bool stat_two_var;              // Data entered as "x:y" pairs
+    regression_model_t stat_model;  // Regression shown for two-variable data
+    
+    // MATRIX mode view; the matrices live in the state module
+    matrix_name_t matrix_shown;     // Matrix on screen
+    int matrix_left_col;            // First column on screen
+    
+    // VECTOR mode view; the vectors live in the state module
+    vector_name_t vector_shown;     // Vector on screen
+    
+    // Catalog view
+    catalog_t catalog;              // List on screen
+    int catalog_selection;          // Highlighted entry
+    
     // Evaluation context
     eval_context_t eval_context;
 } calculator_t;
@@ -138,6 +185,239 @@ void calculator_set_error(calculator_t *calc, const char *error_msg);
  */
 void calculator_execute(calculator_t *calc);
 
+/**
+ * @brief Integrate the input expression in X from A to B and show the result
+ *
+ * The limits are the memory variables A and B. A result that misses the
+ * integration tolerance within its evaluation budget shows "Time Out".
+ *
+ * @param calc Calculator instance
+ */
+void calculator_integrate(calculator_t *calc);
+
+/**
+ * @brief Differentiate the input expression in X at the value of X and show the result
+ * @param calc Calculator instance
+ */
+void calculator_differentiate(calculator_t *calc);
+
+/**
+ * @brief Solve the input equation for X, starting from the value of X
+ *
+ * The input is "lhs = rhs" or an expression solved for 0. On success the
+ * root is stored in X and shown; otherwise "Can't Solve", or "Time Out"
+ * when the evaluation or time budget ran out.
+ *
+ * @param calc Calculator instance
+ */
+void calculator_solve(calculator_t *calc);
+
+/**
+ * @brief Start TABLE mode for the input expression in X
+ *
+ * The input is "f" or "f:g". X runs from A to B in steps of C (1 when C
+ * is 0). Rows are evaluated in blocks as they scroll into view. In
+ * TABLE mode 8/2 scroll one row, 9/3 one page, and AC leaves.
+ *
+ * @param calc Calculator instance
+ */
+void calculator_table(calculator_t *calc);
+
+/**
+ * @brief Format one table row for display
+ * @param calc Calculator instance in TABLE mode
+ * @param index Row index
+ * @param buffer Output line: X, f(X) and, if present, g(X)
+ * @param size Size of buffer
+ * @return True if the row exists
+ */
+bool calculator_format_table_row(calculator_t *calc, int index, char *buffer, size_t size);
+
+/**
+ * @brief Add the input as a STAT sample, or remove it, and show the statistics
+ *
+ * The input is "x" or "x:y"; the two kinds cannot be mixed in one data
+ * set. The cleared input only opens the statistics view, where 8/2 and
+ * 9/3 scroll, AC returns to input and SHIFT+AC also clears the data.
+ * Quartiles beyond the exact capacity are estimates, shown with "~".
+ * Two-variable data also shows a regression, selected with 4/6, with
+ * ŷ at the value of X and x̂ at the value of Y.
+ *
+ * @param calc Calculator instance
+ * @param remove True to remove a sample added earlier (SHIFT+STAT)
+ */
+void calculator_stat(calculator_t *calc, bool remove);
+
+/**
+ * @brief Format one line of the statistics view
+ * @param calc Calculator instance in STAT mode
+ * @param index Line index
+ * @param buffer Output line, "name = value"
+ * @param size Size of buffer
+ * @return True if the line exists
+ */
+bool calculator_format_stat_line(calculator_t *calc, int index, char *buffer, size_t size);
+
+/**
+ * @brief Switch CMPLX mode on or off, or the form of complex results
+ *
+ * In CMPLX mode "=" evaluates the input over complex numbers: "i" (also
+ * "4i", "iπ"), "r∠θ" in the current angle unit, abs(, arg(, conj( and
+ * the principal branches of sqrt(, ln(, log( and ^. Results show as
+ * a+bi or r∠θ and Ans keeps the imaginary part.
+ *
+ * @param calc Calculator instance
+ * @param toggle_form True to switch between a+bi and r∠θ, showing the
+ *        last result again in the new form; false to switch the mode
+ */
+void calculator_complex(calculator_t *calc, bool toggle_form);
+
+/**
+ * @brief Switch BASE-N mode on or off, or its word size
+ *
+ * In BASE-N mode "=" evaluates the input over integers of the word size
+ * with base_n.c: literals in the current radix or prefixed with d, h, b
+ * or o, Ans, + - * /, and, or, xor, xnor, not(, neg(, << and >>. The
+ * keys for sqrt, ^, log and ln select DEC, HEX, BIN and OCT, showing the
+ * last result again in the new radix. sin, cos and tan enter D, E and F
+ * (A, B and C with SHIFT), OPTN and/or, FUNC xor/xnor, x! the shifts and
+ * x^-1 not(/neg(.
+ *
+ * @param calc Calculator instance
+ * @param cycle_word True to step the word size 8, 16, 32, 64 and keep
+ *        Ans in it; false to switch the mode
+ */
+void calculator_base_n(calculator_t *calc, bool cycle_word);
+
+/**
+ * @brief Run the input as a MATRIX command and show the matrix it names
+ *
+ * The commands are "MatA=1:2;3:4" (elements separated by ':', rows by
+ * ';', each element an expression), "MatA+MatB", "MatA-MatB",
+ * "MatA*MatB", "trn(MatA)" and "inv(MatA)", which store their result in
+ * MatAns, "det(MatA)", which shows a number, and a bare name such as
+ * "MatB", which only shows it. "eig(MatA)" puts the eigenvalues in
+ * MatAns as a column (a second column holds imaginary parts if any are
+ * complex), "eigv(MatA)" the eigenvectors as columns and "svd(MatA)"
+ * the singular values; a symmetric matrix uses the Jacobi solver. The
+ * cleared input opens the view on the last matrix shown. In the view 8/2
+ * step through MatA-MatD and MatAns, 4/6 scroll the columns and AC
+ * returns to input.
+ *
+ * @param calc Calculator instance
+ */
+void calculator_matrix(calculator_t *calc);
+
+/**
+ * @brief Format one row of the matrix on screen
+ * @param calc Calculator instance in MATRIX mode
+ * @param row Row index
+ * @param buffer Output line: the visible columns of the row
+ * @param size Size of buffer
+ * @return True if the row exists
+ */
+bool calculator_format_matrix_row(calculator_t *calc, int row, char *buffer, size_t size);
+
+/**
+ * @brief Get the matrix on screen
+ * @param calc Calculator instance
+ * @return Matrix, with 0 rows if it is undefined
+ */
+const matrix_t *calculator_shown_matrix(calculator_t *calc);
+
+/**
+ * @brief Run the input as a VECTOR command and show the vector it names
+ *
+ * "VctA=1:2:3" defines a 2D or 3D vector (each component an expression)
+ * and a bare name such as "VctB" only shows it. Any other input is an
+ * expression over VctA-VctD, VctAns and the scalar variables: "+", "-",
+ * scaling by "*" and "/", "*" between two vectors for the cross product,
+ * "abs(" for the norm, "unitV(", "dot(VctA,VctB)" and "angle(VctA,VctB)"
+ * (in the current angle unit). A vector result is stored in VctAns and
+ * shown; a number is shown as a normal result. The cleared input opens
+ * the view on the last vector shown. In the view 8/2 step through
+ * VctA-VctD and VctAns and AC returns to input.
+ *
+ * @param calc Calculator instance
+ */
+void calculator_vector(calculator_t *calc);
+
+/**
+ * @brief Format one component of the vector on screen
+ * @param calc Calculator instance in VECTOR mode
+ * @param index Component index
+ * @param buffer Output line, "x = value"
+ * @param size Size of buffer
+ * @return True if the component exists
+ */
+bool calculator_format_vector_line(calculator_t *calc, int index, char *buffer, size_t size);
+
+/**
+ * @brief Get the vector on screen
+ * @param calc Calculator instance
+ * @return Vector, with dim 0 if it is undefined
+ */
+const vector_t *calculator_shown_vector(calculator_t *calc);
+
+/**
+ * @brief Solve the input as a polynomial equation and show its roots
+ *
+ * The input is the coefficients "a:b:c" of aX^2+bX+c=0, highest power
+ * first, each an expression; 4 to 7 of them give degree 3 to 6. The
+ * roots, complex ones included, are shown in the current complex form.
+ * The cleared input opens the view on the last roots and AC returns to
+ * the coefficients.
+ *
+ * @param calc Calculator instance
+ */
+void calculator_equation(calculator_t *calc);
+
+/**
+ * @brief Format one root of the equation on screen
+ * @param calc Calculator instance in EQUATION mode
+ * @param index Root index
+ * @param buffer Output line, "x1 = value"
+ * @param size Size of buffer
+ * @return True if the root exists
+ */
+bool calculator_format_equation_line(calculator_t *calc, int index, char *buffer, size_t size);
+
+/**
+ * @brief Get the roots of the last equation solved
+ * @param calc Calculator instance
+ * @return Roots, with degree 0 if no equation has been solved
+ */
+const poly_roots_t *calculator_equation_roots(calculator_t *calc);
+
+/**
+ * @brief Open a catalog of names and functions to insert into the input
+ *
+ * The keypad has no letters for MatA, VctB, det( and the like, so they
+ * are picked from a list: 8/2 move the highlight, = inserts the entry
+ * and AC returns to the input unchanged.
+ *
+ * @param calc Calculator instance
+ * @param catalog List to show
+ */
+void calculator_catalog(calculator_t *calc, catalog_t catalog);
+
+/**
+ * @brief Format one entry of the catalog on screen
+ * @param calc Calculator instance in catalog mode
+ * @param index Entry index
+ * @param buffer Output line, the text the entry inserts
+ * @param size Size of buffer
+ * @return True if the entry exists
+ */
+bool calculator_format_catalog_line(calculator_t *calc, int index, char *buffer, size_t size);
+
+/**
+ * @brief Get the title of the catalog on screen
+ * @param calc Calculator instance
+ * @return Title such as "MATRIX"
+ */
+const char *calculator_catalog_title(calculator_t *calc);
+
 /**
  * @brief Handle mode selection
  * @param calc Calculator instance
@@ -16,6 +16,8 @@ LOG_MODULE_REGISTER(calculator_ui, LOG_LEVEL_INF);
 #define STATUS_HEIGHT   20
 #define MAIN_DISPLAY_Y  STATUS_HEIGHT
 #define MAIN_DISPLAY_HEIGHT (DISPLAY_HEIGHT - STATUS_HEIGHT)
+#define RESULT_LINE_CHARS   32  // Small-font result characters per line
+#define RESULT_LINE_HEIGHT  16
 
 // Colors for ARGB 8888 format (32-bit)
 #define COLOR_BLACK     0xFF000000  // Alpha=255, RGB=0,0,0 (opaque black)
@@ -54,6 +56,30 @@ void calculator_render_ui(calculator_t *calc)
             render_setup_menu(calc);
             break;
             
+        case STATE_TABLE_MODE:
+            render_table(calc);
+            break;
+            
+        case STATE_STAT_MODE:
+            render_stat(calc);
+            break;
+            
+        case STATE_MATRIX_MODE:
+            render_matrix(calc);
+            break;
+            
+        case STATE_VECTOR_MODE:
+            render_vector(calc);
+            break;
+            
+        case STATE_EQUATION_MODE:
+            render_equation(calc);
+            break;
+            
+        case STATE_CATALOG_MODE:
+            render_catalog(calc);
+            break;
+            
         default:
             render_main_display(calc);
             break;
@@ -74,6 +100,11 @@ void render_status_bar(calculator_t *calc)
     // Mode indicators (right side)
     int x_pos = DISPLAY_WIDTH - 80;
     
+    // STO/RCL waiting for the variable key
+    if (calc->mode.store_mode || calc->mode.recall_mode) {
+        display_engine_draw_text(calc->mode.store_mode ? "STO" : "RCL", x_pos - 35, 2, COLOR_GREEN);
+    }
+    
     // Angle mode indicator
     if (calc->mode.deg_mode) {
         display_engine_draw_text("D", x_pos, 2, COLOR_BLACK);
@@ -104,6 +135,27 @@ void render_status_bar(calculator_t *calc)
     }
 }
 
+// Right-align a result in the small font, wrapped from the right into
+// lines of RESULT_LINE_CHARS so a 64-bit BIN word shows as two 32-bit halves
+static void render_result_lines(const char *text, int y_pos)
+{
+    char line[RESULT_LINE_CHARS + 1];
+    int len = strlen(text);
+    int lines = (len + RESULT_LINE_CHARS - 1) / RESULT_LINE_CHARS;
+    int start = 0;
+    
+    // The last line stays on the usual result row; earlier lines go above it
+    y_pos -= (lines - 1) * RESULT_LINE_HEIGHT;
+    for (int i = 0; i < lines; i++) {
+        int count = len - (lines - 1 - i) * RESULT_LINE_CHARS - start;
+        memcpy(line, text + start, count);
+        line[count] = '\0';
+        display_engine_draw_text(line, DISPLAY_WIDTH - count * 8 - 10, y_pos, COLOR_WHITE);
+        start += count;
+        y_pos += RESULT_LINE_HEIGHT;
+    }
+}
+
 void render_main_display(calculator_t *calc)
 {
     int y_pos = MAIN_DISPLAY_Y + 10;
@@ -128,7 +180,12 @@ void render_main_display(calculator_t *calc)
         // Right-align the result
         int text_width = strlen(calc->result_buffer) * 12; // Assuming 12 pixels per character for large font
         int x_pos = DISPLAY_WIDTH - text_width - 10;
-        display_engine_draw_text_large(calc->result_buffer, x_pos, y_pos + 20, COLOR_WHITE);
+        if (x_pos < 0) {
+            // Long BASE-N binary results only fit in the small font
+            render_result_lines(calc->result_buffer, y_pos + 30);
+        } else {
+            display_engine_draw_text_large(calc->result_buffer, x_pos, y_pos + 20, COLOR_WHITE);
+        }
     } else if (calc->state == STATE_SHOW_ERROR) {
         // Center the error message
         int text_width = strlen(calc->error_buffer) * 8;
@@ -220,6 +277,166 @@ void render_setup_menu(calculator_t *calc)
     display_engine_draw_text("AC: Exit", 10, y_pos, COLOR_GRAY);
 }
 
+void render_table(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    
+    // Column headers, aligned with calculator_format_table_row()
+    display_engine_draw_text(calc->table_has_g ? "X            F(X)         G(X)"
+                                               : "X            F(X)",
+                             10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    // Only the rows on screen are fetched and formatted
+    char line[48];
+    for (int i = 0; i < CALC_LIST_VISIBLE_ROWS; i++) {
+        if (!calculator_format_table_row(calc, calc->table_top_row + i, line, sizeof(line))) {
+            break;
+        }
+        display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        y_pos += 18;
+    }
+    
+    // Position and help text
+    char footer[48];
+    snprintf(footer, sizeof(footer), "Row %d/%d  8/2 9/3: Scroll  AC: Exit",
+             calc->table_top_row + 1, calc->table_rows);
+    display_engine_draw_text(footer, 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
+void render_stat(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    
+    display_engine_draw_text(calc->stat_two_var ? "STAT 2-VAR" : "STAT 1-VAR",
+                             10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    char line[48];
+    for (int i = 0; i < CALC_LIST_VISIBLE_ROWS; i++) {
+        if (!calculator_format_stat_line(calc, calc->stat_top_line + i, line, sizeof(line))) {
+            break;
+        }
+        display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        y_pos += 18;
+    }
+    
+    display_engine_draw_text("8/2 9/3: Scroll  AC: Exit", 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
+void render_matrix(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    const matrix_t *m = calculator_shown_matrix(calc);
+    
+    // Name, size and the columns on screen
+    char header[48];
+    if (m->rows == 0) {
+        snprintf(header, sizeof(header), "%s  (undefined)", matrix_name(calc->matrix_shown));
+    } else {
+        int last_col = calc->matrix_left_col + CALC_MATRIX_VISIBLE_COLS;
+        if (last_col > m->cols) {
+            last_col = m->cols;
+        }
+        snprintf(header, sizeof(header), "%s %dx%d  cols %d-%d", matrix_name(calc->matrix_shown),
+                 m->rows, m->cols, calc->matrix_left_col + 1, last_col);
+    }
+    display_engine_draw_text(header, 10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    char line[48];
+    for (int i = 0; i < MATRIX_MAX_DIM; i++) {
+        if (!calculator_format_matrix_row(calc, i, line, sizeof(line))) {
+            break;
+        }
+        display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        y_pos += 18;
+    }
+    
+    display_engine_draw_text("8/2: Matrix  4/6: Cols  AC: Exit", 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
+void render_vector(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    const vector_t *v = calculator_shown_vector(calc);
+    
+    char header[48];
+    if (v->dim == 0) {
+        snprintf(header, sizeof(header), "%s  (undefined)", vector_name(calc->vector_shown));
+    } else {
+        snprintf(header, sizeof(header), "%s  %dD", vector_name(calc->vector_shown), v->dim);
+    }
+    display_engine_draw_text(header, 10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    char line[48];
+    for (int i = 0; i < VECTOR_MAX_DIM; i++) {
+        if (!calculator_format_vector_line(calc, i, line, sizeof(line))) {
+            break;
+        }
+        display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        y_pos += 18;
+    }
+    
+    display_engine_draw_text("8/2: Vector  AC: Exit", 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
+void render_equation(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    const poly_roots_t *roots = calculator_equation_roots(calc);
+    
+    char header[48];
+    if (roots->degree == 0) {
+        snprintf(header, sizeof(header), "EQN  (no equation)");
+    } else {
+        snprintf(header, sizeof(header), "EQN  Degree %d", roots->degree);
+    }
+    display_engine_draw_text(header, 10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    // At most six roots, which all fit without scrolling
+    char line[72];
+    for (int i = 0; i < POLY_MAX_DEGREE; i++) {
+        if (!calculator_format_equation_line(calc, i, line, sizeof(line))) {
+            break;
+        }
+        display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        y_pos += 18;
+    }
+    
+    display_engine_draw_text("AC: Exit", 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
+void render_catalog(calculator_t *calc)
+{
+    int y_pos = MAIN_DISPLAY_Y + 10;
+    
+    display_engine_draw_text(calculator_catalog_title(calc), 10, y_pos, COLOR_GRAY);
+    y_pos += 20;
+    
+    // Scroll so the highlighted entry stays on screen
+    int top = calc->catalog_selection - (CALC_LIST_VISIBLE_ROWS - 1);
+    top = top < 0 ? 0 : top;
+    
+    char line[24];
+    for (int i = top; i < top + CALC_LIST_VISIBLE_ROWS; i++) {
+        if (!calculator_format_catalog_line(calc, i, line, sizeof(line))) {
+            break;
+        }
+        if (i == calc->catalog_selection) {
+            display_engine_fill_rect(5, y_pos - 2, DISPLAY_WIDTH - 10, 16, COLOR_GRAY);
+            display_engine_draw_text(line, 10, y_pos, COLOR_BLACK);
+        } else {
+            display_engine_draw_text(line, 10, y_pos, COLOR_WHITE);
+        }
+        y_pos += 18;
+    }
+    
+    display_engine_draw_text("8/2: Select  =: Insert  AC: Exit", 10, DISPLAY_HEIGHT - 18, COLOR_GRAY);
+}
+
 void render_cursor(calculator_t *calc, int x, int y)
 {
     static bool cursor_visible = true;
@@ -44,6 +44,42 @@ void render_mode_menu(calculator_t *calc);
  */
 void render_setup_menu(calculator_t *calc);
 
+/**
+ * @brief Render the visible rows of TABLE mode
+ * @param calc Calculator instance
+ */
+void render_table(calculator_t *calc);
+
+/**
+ * @brief Render the STAT mode summary lines
+ * @param calc Calculator instance
+ */
+void render_stat(calculator_t *calc);
+
+/**
+ * @brief Render the matrix shown in MATRIX mode
+ * @param calc Calculator instance
+ */
+void render_matrix(calculator_t *calc);
+
+/**
+ * @brief Render the vector shown in VECTOR mode
+ * @param calc Calculator instance
+ */
+void render_vector(calculator_t *calc);
+
+/**
+ * @brief Render the roots shown in EQUATION mode
+ * @param calc Calculator instance
+ */
+void render_equation(calculator_t *calc);
+
+/**
+ * @brief Render the catalog of names and functions to insert
+ * @param calc Calculator instance
+ */
+void render_catalog(calculator_t *calc);
+
 /**
  * @brief Render cursor at current position
  * @param calc Calculator instance